@@ -11,6 +11,15 @@
 #include <ios>
 #include <iterator>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace SVE
 {
 
@@ -90,4 +99,63 @@ std::string DesktopFS::getSavePath() const
     return std::string(path);
 }
 
+FileView DesktopFS::mapFile(const std::string& path)
+{
+#ifdef _WIN32
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw VulkanException("Can't open file " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    auto mapping = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0
+                   ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                   : nullptr;
+    // Mapping keeps file open
+    CloseHandle(file);
+    if (!mapping)
+    {
+        throw VulkanException("Can't map file " + path);
+    }
+
+    auto* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data)
+    {
+        throw VulkanException("Can't map file " + path);
+    }
+
+    std::shared_ptr<const char> dataPtr(static_cast<const char*>(data), [](const char* ptr)
+    {
+        UnmapViewOfFile(ptr);
+    });
+    return FileView(std::move(dataPtr), static_cast<size_t>(fileSize.QuadPart));
+#else
+    auto file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw VulkanException("Can't open file " + path);
+    }
+
+    struct stat fileStat {};
+    auto* data = fstat(file, &fileStat) == 0 && fileStat.st_size > 0
+                 ? mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0)
+                 : MAP_FAILED;
+    // Mapping keeps file open
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        throw VulkanException("Can't map file " + path);
+    }
+
+    auto size = static_cast<size_t>(fileStat.st_size);
+    std::shared_ptr<const char> dataPtr(static_cast<const char*>(data), [size](const char* ptr)
+    {
+        munmap(const_cast<char*>(ptr), size);
+    });
+    return FileView(std::move(dataPtr), size);
+#endif
+}
+
 } // namespace SVE
\ No newline at end of file
@@ -31,6 +31,9 @@ public:
     std::string getFileContent(FSEntityPtr file) const override;
     FSEntityPtr getEntity(const std::string& localPath, bool isDirectory = false) const override;
     std::string getSavePath() const override;
+
+    // Read-only memory mapping of whole file, it's unmapped with the last view
+    static FileView mapFile(const std::string& path);
 };
 
 } // namespace SVE
\ No newline at end of file
@@ -6,7 +6,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtx/quaternion.hpp>
-#include <numeric>
+#include <algorithm>
+#include <unordered_map>
 
 namespace Chewman
 {
@@ -33,6 +34,45 @@ glm::quat rotationBetweenVectors(glm::vec3 start, glm::vec3 dest){
     );
 }
 
+struct Vertex
+{
+    glm::vec3 point;
+    glm::vec2 texCoord;
+    glm::vec3 normal;
+    glm::vec3 binormal;
+    glm::vec3 tangent;
+    glm::vec3 color;
+
+    bool operator==(const Vertex& other) const
+    {
+        return point == other.point && texCoord == other.texCoord && normal == other.normal &&
+               binormal == other.binormal && tangent == other.tangent && color == other.color;
+    }
+};
+
+struct VertexHash
+{
+    size_t operator()(const Vertex& vertex) const
+    {
+        size_t seed = 0;
+        const auto combine = [&seed](float value)
+        {
+            seed ^= std::hash<float>()(value) + 0x9e3779b9 + (seed << 6u) + (seed >> 2u);
+        };
+        for (auto i = 0; i < 3; ++i)
+        {
+            combine(vertex.point[i]);
+            combine(vertex.normal[i]);
+            combine(vertex.binormal[i]);
+            combine(vertex.tangent[i]);
+            combine(vertex.color[i]);
+        }
+        combine(vertex.texCoord.x);
+        combine(vertex.texCoord.y);
+        return seed;
+    }
+};
+
 enum class VerticalPlaneType : uint8_t
 {
     Left,
@@ -58,8 +98,6 @@ Submesh constructVerticalPlane(glm::vec3 center, float width, float height, Vert
                             {0.0f,   1.0f, -1.0f},
                             {0.0f,   1.0f,  1.0f},
                             {0.0f,  -1.0f, -1.0f},
-                            {0.0f,  -1.0f, -1.0f},
-                            {0.0f,   1.0f,  1.0f},
                             {0.0f,  -1.0f,  1.0f},
                     };
             normal = glm::vec3(-1, 0, 0);
@@ -75,8 +113,6 @@ Submesh constructVerticalPlane(glm::vec3 center, float width, float height, Vert
                             {0.0f,   1.0f,  1.0f},
                             {0.0f,   1.0f, -1.0f},
                             {0.0f,  -1.0f,  1.0f},
-                            {0.0f,  -1.0f,  1.0f},
-                            {0.0f,   1.0f, -1.0f},
                             {0.0f,  -1.0f, -1.0f},
                     };
 
@@ -93,8 +129,6 @@ Submesh constructVerticalPlane(glm::vec3 center, float width, float height, Vert
                             { -1.0f, 1.0f, 0.0f},
                             { 1.0f,  1.0f, 0.0f},
                             {-1.0f,  -1.0f, 0.0f},
-                            {-1.0f,  -1.0f, 0.0f},
-                            { 1.0f,  1.0f, 0.0f},
                             { 1.0f, -1.0f, 0.0f},
                     };
 
@@ -111,8 +145,6 @@ Submesh constructVerticalPlane(glm::vec3 center, float width, float height, Vert
                             { 1.0f,  1.0f, 0.0f},
                             {-1.0f,  1.0f, 0.0f},
                             { 1.0f, -1.0f, 0.0f},
-                            { 1.0f, -1.0f, 0.0f},
-                            {-1.0f,  1.0f, 0.0f},
                             {-1.0f, -1.0f, 0.0f},
                     };
 
@@ -124,13 +156,12 @@ Submesh constructVerticalPlane(glm::vec3 center, float width, float height, Vert
         }
     }
 
+    submesh.indices = { 0, 1, 2, 2, 1, 3 };
     submesh.texCoords =
             {
                     {0, 0},
                     {1, 0},
                     {0, 1},
-                    {0, 1},
-                    {1, 0},
                     {1, 1}
             };
 
@@ -140,11 +171,11 @@ Submesh constructVerticalPlane(glm::vec3 center, float width, float height, Vert
         texCoord.y = texCoord.y < 0.5f ? deltaY : texY;
     }
 
-    submesh.normals = Vec3List(6, normal);
-    submesh.colors = Vec3List(6, glm::vec3(1.0f, 1.0f, 1.0f));
+    submesh.normals = Vec3List(4, normal);
+    submesh.colors = Vec3List(4, glm::vec3(1.0f, 1.0f, 1.0f));
 
-    submesh.binormals = Vec3List(6, bitangent);
-    submesh.tangents = Vec3List(6, tangent);
+    submesh.binormals = Vec3List(4, bitangent);
+    submesh.tangents = Vec3List(4, tangent);
 
     for (auto& point : submesh.points)
     {
@@ -164,21 +195,18 @@ Submesh constructPlane(glm::vec3 center, float width, float height, glm::vec3 no
                     {-1.0f,  0.0f,  1.0f},
                     {-1.0f,  0.0f, -1.0f},
                     {1.0f,   0.0f, -1.0f},
-                    {1.0f,   0.0f, -1.0f},
                     {1.0f,   0.0f, 1.0f},
-                    {-1.0f,  0.0f, 1.0f},
             };
+    submesh.indices = { 0, 1, 2, 2, 3, 0 };
     submesh.texCoords =
             {
                     {1, 1},
                     {0, 1},
                     {0, 0},
-                    {0, 0},
-                    {1, 0},
-                    {1, 1}
+                    {1, 0}
             };
-    submesh.normals = Vec3List(6, normal);
-    submesh.colors = Vec3List(6, glm::vec3(1.0f, 1.0f, 1.0f));
+    submesh.normals = Vec3List(4, normal);
+    submesh.colors = Vec3List(4, glm::vec3(1.0f, 1.0f, 1.0f));
 
     for (auto& texCoord : submesh.texCoords)
     {
@@ -191,8 +219,8 @@ Submesh constructPlane(glm::vec3 center, float width, float height, glm::vec3 no
     glm::vec3 tangent = glm::vec3(0.0, 0.0, 1.0);
     glm::vec3 bitangent = glm::vec3(1.0, 0.0, 0.0);
 
-    submesh.binormals = Vec3List(6, bitangent);
-    submesh.tangents = Vec3List(6, tangent);
+    submesh.binormals = Vec3List(4, bitangent);
+    submesh.tangents = Vec3List(4, tangent);
 
     mat = mat * glm::scale(glm::mat4(1), glm::vec3(width / 2, 0, height / 2));
     for (auto& point : submesh.points)
@@ -204,6 +232,75 @@ Submesh constructPlane(glm::vec3 center, float width, float height, glm::vec3 no
     return submesh;
 }
 
+// Corners are in constructPlane order, s goes from corner 1 to corner 2 and t from corner 1 to corner 0
+template <typename T>
+T interpolateCorners(const std::vector<T>& corners, float s, float t)
+{
+    return corners[1] * ((1 - s) * (1 - t)) + corners[2] * (s * (1 - t)) + corners[3] * (s * t) + corners[0] * ((1 - s) * t);
+}
+
+// Faces of neighbour cells have vertices at every cell corner, so merged plane gets vertices there too.
+// Otherwise these vertices lie inside of long plane edges (T-junctions) and rasterization can leave cracks.
+// Plane is triangulated as fan around its center, plane one cell wide is strip of cell quads.
+Submesh splitPlaneEdges(const Submesh& plane, size_t columns, size_t rows)
+{
+    if (columns == 1 && rows == 1)
+        return plane;
+
+    Submesh submesh {};
+    const auto addVertex = [&submesh, &plane](float s, float t)
+    {
+        submesh.points.push_back(interpolateCorners(plane.points, s, t));
+        submesh.texCoords.push_back(interpolateCorners(plane.texCoords, s, t));
+        submesh.normals.push_back(plane.normals[0]);
+        submesh.binormals.push_back(plane.binormals[0]);
+        submesh.tangents.push_back(plane.tangents[0]);
+        submesh.colors.push_back(plane.colors[0]);
+    };
+
+    if (columns == 1 || rows == 1)
+    {
+        // Pairs of vertices across the strip, pair order keeps winding of source plane
+        auto cellCount = std::max(columns, rows);
+        for (size_t i = 0; i <= cellCount; ++i)
+        {
+            auto position = static_cast<float>(i) / cellCount;
+            if (columns > 1)
+            {
+                addVertex(position, 0.0f);
+                addVertex(position, 1.0f);
+            }
+            else
+            {
+                addVertex(1.0f, position);
+                addVertex(0.0f, position);
+            }
+        }
+        for (uint32_t i = 0; i < cellCount; ++i)
+        {
+            auto index = i * 2;
+            submesh.indices.insert(submesh.indices.end(), { index, index + 2, index + 3, index + 3, index + 1, index });
+        }
+        return submesh;
+    }
+
+    // Edge vertices go around the plane in the same direction as source plane corners
+    addVertex(0.5f, 0.5f);
+    for (size_t i = 0; i < columns; ++i)
+        addVertex(static_cast<float>(i) / columns, 0.0f);
+    for (size_t i = 0; i < rows; ++i)
+        addVertex(1.0f, static_cast<float>(i) / rows);
+    for (size_t i = columns; i > 0; --i)
+        addVertex(static_cast<float>(i) / columns, 1.0f);
+    for (size_t i = rows; i > 0; --i)
+        addVertex(0.0f, static_cast<float>(i) / rows);
+
+    auto edgeVertexCount = static_cast<uint32_t>(submesh.points.size() - 1);
+    for (uint32_t i = 0; i < edgeVertexCount; ++i)
+        submesh.indices.insert(submesh.indices.end(), { 0, i + 1, (i + 1) % edgeVertexCount + 1 });
+    return submesh;
+}
+
 } // anon namespace
 
 BlockMeshGenerator::BlockMeshGenerator(float size)
@@ -211,13 +308,15 @@ BlockMeshGenerator::BlockMeshGenerator(float size)
 {
 }
 
-std::vector<Submesh> BlockMeshGenerator::GenerateFloor(glm::vec3 position, ModelType type)
+std::vector<Submesh> BlockMeshGenerator::GenerateFloor(glm::vec3 position, ModelType type, glm::ivec2 cellCount)
 {
     std::vector<Submesh> floorMeshes;
     float height = _size;
     if (type == ModelType::Bottom)
     {
-        floorMeshes.push_back(constructPlane(position, _size, _size, glm::vec3(0, 1, 0), 1.0, 1.0, 0.0, 0.0));
+        // Texture is repeated for every cell, so merged plane looks the same as separate cells
+        floorMeshes.push_back(constructPlane(position, _size * cellCount.x, _size * cellCount.y, glm::vec3(0, 1, 0),
+                                             cellCount.y, cellCount.x, 0.0, 0.0));
     }
     else if (type == ModelType::Vertical)
     {
@@ -234,7 +333,7 @@ std::vector<Submesh> BlockMeshGenerator::GenerateFloor(glm::vec3 position, Model
     return floorMeshes;
 }
 
-std::vector<Submesh> BlockMeshGenerator::GenerateWall(glm::vec3 position, ModelType type)
+std::vector<Submesh> BlockMeshGenerator::GenerateWall(glm::vec3 position, ModelType type, glm::ivec2 cellCount)
 {
     std::vector<Submesh> floorMeshes;
     float subheight = _size; // / 5
@@ -242,7 +341,8 @@ std::vector<Submesh> BlockMeshGenerator::GenerateWall(glm::vec3 position, ModelT
     float height = mainheight + subheight;
     if (type == ModelType::Top)
     {
-        floorMeshes.push_back(constructPlane(position + glm::vec3(0, mainheight, 0), _size, _size, glm::vec3(0, 1, 0)));
+        floorMeshes.push_back(constructPlane(position + glm::vec3(0, mainheight, 0), _size * cellCount.x, _size * cellCount.y,
+                                             glm::vec3(0, 1, 0), cellCount.y, cellCount.x));
     } else if (type == ModelType::Vertical) {
         floorMeshes.push_back(constructVerticalPlane(position + glm::vec3(_size / 2, mainheight/2 - subheight / 2, 0),
                               height, _size, VerticalPlaneType::Right, 1.0f, 3.0,  0.0f,  0.0f));
@@ -286,24 +386,162 @@ std::vector<Submesh> BlockMeshGenerator::GenerateLiquid(glm::vec3 position, Mode
     return floorMeshes;
 }
 
+std::vector<Submesh> BlockMeshGenerator::GenerateHorizontalPlane(glm::vec3 position, const PlaneRect& rect)
+{
+    const auto shiftY = (rect.columns - 1) * 0.5f * _size;
+    const auto shiftX = (rect.rows - 1) * 0.5f * _size;
+    glm::vec3 center = position + glm::vec3(shiftY, 0, -shiftX);
+    glm::ivec2 cellCount(rect.columns, rect.rows);
+    std::vector<Submesh> planes;
+    if (rect.plane == HorizontalPlane::WallTop)
+        planes = GenerateWall(center, Top, cellCount);
+    else if (rect.plane == HorizontalPlane::Floor)
+        planes = GenerateFloor(center, Bottom, cellCount);
+
+    for (auto& plane : planes)
+        plane = splitPlaneEdges(plane, rect.columns, rect.rows);
+    return planes;
+}
+
+std::vector<PlaneRect> BlockMeshGenerator::MergePlanes(std::vector<HorizontalPlane> planes, size_t width)
+{
+    std::vector<PlaneRect> rects;
+    const auto height = width > 0 ? planes.size() / width : 0;
+
+    // Grow each plane along row, then add following rows while they fully match
+    for (size_t i = 0; i < height; ++i)
+    {
+        for (size_t j = 0; j < width; ++j)
+        {
+            auto plane = planes[i * width + j];
+            if (plane == HorizontalPlane::None)
+                continue;
+
+            const auto isSamePlane = [plane](HorizontalPlane other) { return other == plane; };
+            size_t columns = 1;
+            while (j + columns < width && isSamePlane(planes[i * width + j + columns]))
+                ++columns;
+            size_t rows = 1;
+            while (i + rows < height)
+            {
+                auto rowStart = planes.begin() + (i + rows) * width + j;
+                if (!std::all_of(rowStart, rowStart + columns, isSamePlane))
+                    break;
+                ++rows;
+            }
+
+            for (size_t row = i; row < i + rows; ++row)
+                std::fill_n(planes.begin() + row * width + j, columns, HorizontalPlane::None);
+
+            rects.push_back({ plane, i, j, rows, columns });
+        }
+    }
+
+    return rects;
+}
+
+std::array<std::vector<Submesh>, 3> BlockMeshGenerator::GenerateChunk(const CellInfoMap& mapData, size_t width, size_t height,
+                                                                      size_t chunkColumns, size_t chunkIndex)
+{
+    auto startX = (chunkIndex / chunkColumns) * MapChunkSize;
+    auto startY = (chunkIndex % chunkColumns) * MapChunkSize;
+    auto endX = std::min(startX + MapChunkSize, height);
+    auto endY = std::min(startY + MapChunkSize, width);
+
+    // Horizontal planes are collected per cell and merged later, vertical ones are generated right away
+    const auto chunkHeight = endX - startX;
+    const auto chunkWidth = endY - startY;
+    std::vector<HorizontalPlane> planes(chunkHeight * chunkWidth, HorizontalPlane::None);
+
+    std::array<std::vector<Submesh>, 3> submeshes;
+    for (auto x = startX; x < endX; ++x)
+    {
+        for (auto y = startY; y < endY; ++y)
+        {
+            std::vector<Submesh> cellV;
+            auto& plane = planes[(x - startX) * chunkWidth + (y - startY)];
+            glm::vec3 position(y * _size, 0, -(float)x * _size);
+            switch (mapData[x][y].cellType)
+            {
+                case CellType::Wall:
+                    plane = HorizontalPlane::WallTop;
+                    cellV = GenerateWall(position, Vertical);
+                    break;
+                case CellType::Floor:
+                case CellType::InvisibleWallWithFloor:
+                    plane = HorizontalPlane::Floor;
+                    cellV = GenerateFloor(position, Vertical);
+                    break;
+                case CellType::Liquid:
+                    cellV = GenerateLiquid(position, Vertical, x, y, height - 1, width - 1);
+                    break;
+                case CellType::InvisibleWallEmpty:
+                    break;
+            }
+            submeshes[2].insert(submeshes[2].end(), cellV.begin(), cellV.end());
+        }
+    }
+
+    for (const auto& rect : MergePlanes(std::move(planes), chunkWidth))
+    {
+        auto x = startX + rect.row;
+        auto y = startY + rect.column;
+        glm::vec3 position(y * _size, 0, -(float)x * _size);
+        auto cellH = GenerateHorizontalPlane(position, rect);
+        auto& target = submeshes[rect.plane == HorizontalPlane::WallTop ? 0 : 1];
+        target.insert(target.end(), cellH.begin(), cellH.end());
+    }
+
+    return submeshes;
+}
+
 SVE::MeshSettings BlockMeshGenerator::CombineMeshes(std::string name, std::vector<Submesh> meshes)
 {
     SVE::MeshSettings meshSettings {};
 
-    uint32_t totalPoints = 0;
+    size_t totalPoints = 0;
+    size_t totalIndices = 0;
     for (const auto& submesh : meshes)
     {
-        std::copy(submesh.points.begin(), submesh.points.end(), std::back_inserter(meshSettings.vertexPosData));
-        std::copy(submesh.texCoords.begin(), submesh.texCoords.end(), std::back_inserter(meshSettings.vertexTexData));
-        std::copy(submesh.normals.begin(), submesh.normals.end(), std::back_inserter(meshSettings.vertexNormalData));
-        std::copy(submesh.binormals.begin(), submesh.binormals.end(), std::back_inserter(meshSettings.vertexBinormalData));
-        std::copy(submesh.tangents.begin(), submesh.tangents.end(), std::back_inserter(meshSettings.vertexTangentData));
-        std::copy(submesh.colors.begin(), submesh.colors.end(), std::back_inserter(meshSettings.vertexColorData));
         totalPoints += submesh.points.size();
+        totalIndices += submesh.indices.size();
+    }
+
+    meshSettings.vertexPosData.reserve(totalPoints);
+    meshSettings.vertexTexData.reserve(totalPoints);
+    meshSettings.vertexNormalData.reserve(totalPoints);
+    meshSettings.vertexBinormalData.reserve(totalPoints);
+    meshSettings.vertexTangentData.reserve(totalPoints);
+    meshSettings.vertexColorData.reserve(totalPoints);
+    meshSettings.indexData.reserve(totalIndices);
+
+    std::unordered_map<Vertex, uint32_t, VertexHash> vertexMap(totalPoints);
+    std::vector<uint32_t> remap;
+    for (const auto& submesh : meshes)
+    {
+        remap.resize(submesh.points.size());
+        for (size_t i = 0; i < submesh.points.size(); ++i)
+        {
+            Vertex vertex { submesh.points[i], submesh.texCoords[i], submesh.normals[i],
+                            submesh.binormals[i], submesh.tangents[i], submesh.colors[i] };
+            auto newIndex = static_cast<uint32_t>(meshSettings.vertexPosData.size());
+            auto result = vertexMap.emplace(vertex, newIndex);
+            if (result.second)
+            {
+                meshSettings.vertexPosData.push_back(vertex.point);
+                meshSettings.vertexTexData.push_back(vertex.texCoord);
+                meshSettings.vertexNormalData.push_back(vertex.normal);
+                meshSettings.vertexBinormalData.push_back(vertex.binormal);
+                meshSettings.vertexTangentData.push_back(vertex.tangent);
+                meshSettings.vertexColorData.push_back(vertex.color);
+            }
+            remap[i] = result.first->second;
+        }
+
+        for (auto index : submesh.indices)
+            meshSettings.indexData.push_back(remap[index]);
     }
 
-    meshSettings.indexData.resize(totalPoints);
-    std::iota(meshSettings.indexData.begin(), meshSettings.indexData.end(), 0);
     meshSettings.boneNum = 0;
     meshSettings.name = std::move(name);
 
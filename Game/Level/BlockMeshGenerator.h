@@ -3,17 +3,24 @@
 // Licensed under the MIT License
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include "SVE/MeshSettings.h"
+#include "GameMapDefs.h"
 
 namespace Chewman
 {
 
 using Vec3List = std::vector<glm::vec3>;
 
+// Level geometry is split into square chunks of cells, so map change rebuilds only affected chunks
+constexpr size_t MapChunkSize = 8;
+
+// Indexed submesh, every quad face is 4 points and 6 indices
 struct Submesh
 {
     Vec3List points;
+    std::vector<uint32_t> indices;
     std::vector<glm::vec2> texCoords;
     Vec3List normals;
     Vec3List tangents;
@@ -28,15 +35,52 @@ enum ModelType
     Bottom
 };
 
+enum class HorizontalPlane : uint8_t
+{
+    None,
+    WallTop,
+    Floor
+};
+
+// Rectangle of cells covered by single horizontal plane, rows go along map x and columns along map y
+struct PlaneRect
+{
+    HorizontalPlane plane;
+    size_t row;
+    size_t column;
+    size_t rows;
+    size_t columns;
+};
+
+// Chunks go row by row, chunkColumns chunks in every row
+inline size_t getChunkIndex(glm::ivec2 cell, size_t chunkColumns)
+{
+    return (cell.x / MapChunkSize) * chunkColumns + cell.y / MapChunkSize;
+}
+
 class BlockMeshGenerator
 {
 public:
     BlockMeshGenerator(float size);
 
-    std::vector<Submesh> GenerateFloor(glm::vec3 position, ModelType type);
-    std::vector<Submesh> GenerateWall(glm::vec3 position, ModelType type);
+    // Horizontal planes (floor Bottom and wall Top) can cover rectangle of cells with center in position,
+    // cellCount.x is number of cells along X axis, cellCount.y along Z axis
+    std::vector<Submesh> GenerateFloor(glm::vec3 position, ModelType type, glm::ivec2 cellCount = {1, 1});
+    std::vector<Submesh> GenerateWall(glm::vec3 position, ModelType type, glm::ivec2 cellCount = {1, 1});
     std::vector<Submesh> GenerateLiquid(glm::vec3 position, ModelType type, int x, int y, int xMax, int yMax);
+    // Plane of merged rectangle, position is the center of its first cell.
+    // Plane edges have vertex at every cell corner, so they match faces of neighbour cells
+    std::vector<Submesh> GenerateHorizontalPlane(glm::vec3 position, const PlaneRect& rect);
+
+    // Greedy meshing of row-major planes grid: every cell except None is covered by exactly one rectangle
+    std::vector<PlaneRect> MergePlanes(std::vector<HorizontalPlane> planes, size_t width);
+
+    // Wall top, floor and vertical submeshes of level chunk. Cell geometry depends only on its own type,
+    // so chunk is generated without its neighbours
+    std::array<std::vector<Submesh>, 3> GenerateChunk(const CellInfoMap& mapData, size_t width, size_t height,
+                                                      size_t chunkColumns, size_t chunkIndex);
 
+    // Merge submeshes to single indexed mesh, identical vertices are welded
     SVE::MeshSettings CombineMeshes(std::string name, std::vector<Submesh> meshes);
 
 private:
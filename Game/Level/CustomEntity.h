@@ -8,6 +8,8 @@
 #include <SVE/Utils.h>
 #include <SVE/VulkanMaterial.h>
 #include <SVE/VulkanInstance.h>
+#include <SVE/RecordingContext.h>
+#include <SVE/FrameUniforms.h>
 
 namespace SVE
 {
@@ -25,14 +27,20 @@ public:
         : _material(SVE::Engine::getInstance()->getMaterialManager()->getMaterial(material))
         , _currentInfo(startInfo)
     {
-        _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
+        _materialInstance = _material->getVulkanMaterial()->createInstance();
         _renderLast = true;
     }
 
+    ~CustomEntity() override
+    {
+        _material->getVulkanMaterial()->deleteInstance(_materialInstance);
+    }
+
     void setMaterial(const std::string& materialName) override
     {
+        _material->getVulkanMaterial()->deleteInstance(_materialInstance);
         _material = SVE::Engine::getInstance()->getMaterialManager()->getMaterial(materialName);
-        _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
+        _materialInstance = _material->getVulkanMaterial()->createInstance();
     }
 
     void updateInfo(InfoStruct info)
@@ -45,32 +53,31 @@ public:
         return _currentInfo;
     }
 
-    void updateUniforms(SVE::UniformDataList uniformDataList) const override
+    void updateUniforms(SVE::FrameUniforms& frameUniforms, const glm::mat4& model) const override
     {
-        auto mainUniform = uniformDataList[toInt(SVE::CommandsType::MainPass)];
-        mainUniform->customMat4 = _currentInfo.toMat4();
-        mainUniform->spritesheetSize = _material->getVulkanMaterial()->getSpritesheetSize();
-        mainUniform->materialInfo.diffuse = glm::vec4(1);
+        auto& objectData = frameUniforms.createObjectData(model);
+        objectData.customMat4 = _currentInfo.toMat4();
+        objectData.spritesheetSize = _material->getVulkanMaterial()->getSpritesheetSize();
+        objectData.materialInfo.diffuse = glm::vec4(1);
 
-        _material->getVulkanMaterial()->setUniformData(_materialIndex, *mainUniform);
+        _material->getVulkanMaterial()->setUniformData(
+                _materialInstance, { frameUniforms.getPassData(SVE::CommandsType::MainPass), objectData });
     }
 
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override
+    void applyDrawingCommands(const SVE::RecordingContext& context) const override
     {
-        auto passType = SVE::Engine::getInstance()->getPassType();
-        if (passType == SVE::CommandsType::MainPass
-            || passType == SVE::CommandsType::ScreenQuadPass
-            || passType == SVE::CommandsType::ScreenQuadLatePass)
+        if (context.passType == SVE::CommandsType::MainPass
+            || context.passType == SVE::CommandsType::ScreenQuadPass
+            || context.passType == SVE::CommandsType::ScreenQuadLatePass)
         {
-            _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _materialIndex);
-            auto commandBuffer = SVE::Engine::getInstance()->getVulkanInstance()->getCommandBuffer(bufferIndex);
-            vkCmdDraw(commandBuffer, _currentInfo.maxParticles, 1, 0, 0);
+            _material->getVulkanMaterial()->applyDrawingCommands(context, _materialInstance);
+            vkCmdDraw(context.commandBuffer, _currentInfo.maxParticles, 1, 0, 0);
         }
     }
 
 private:
     SVE::Material* _material = nullptr;
-    uint32_t _materialIndex = 0;
+    SVE::MaterialInstance _materialInstance;
     InfoStruct _currentInfo;
 };
 
@@ -6,93 +6,8 @@
 
 namespace Chewman
 {
-namespace
-{
-
-TargetPathMap createPathMapForTarget(glm::ivec2 target, GameMap* gameMap)
-{
-    TargetPathMap pathMap;
-    std::vector<std::vector<int>> stepMap;
-
-    const auto initMapSize = [&gameMap](auto& map, auto initValue)
-    {
-        map.resize(gameMap->height);
-        for (auto& row : map)
-            row.resize(gameMap->width, initValue);
-    };
-
-    initMapSize(pathMap, MoveDirection::None);
-    initMapSize(stepMap, -1);
-
-    stepMap[target.x][target.y] = 0;
-    int currentStep = 0;
-    bool changes = true;
-
-    auto tryGoCell = [&](int x, int y)
-    {
-        if (x >= 0 && x < gameMap->height && y >= 0 && y < gameMap->width)
-        {
-            if (gameMap->mapData[x][y].cellType == CellType::Floor && stepMap[x][y] < 0)
-            {
-                changes = true;
-                stepMap[x][y] = currentStep + 1;
-            }
-        }
-    };
-    auto isCorrectDirection = [&](int x, int y, int step) -> bool
-    {
-        if (x >= 0 && x < gameMap->height && y >= 0 && y < gameMap->width)
-        {
-            return stepMap[x][y] >= 0 && stepMap[x][y] == step - 1;
-        }
-        return false;
-    };
-
-    // Simple BFS map traversal
-    while (changes)
-    {
-        changes = false;
-        for (int x = 0; x < gameMap->height; ++x)
-        {
-            for (int y = 0; y < gameMap->width; ++y)
-            {
-                if (stepMap[x][y] == currentStep)
-                {
-                    tryGoCell(x+1, y);
-                    tryGoCell(x-1, y);
-                    tryGoCell(x, y+1);
-                    tryGoCell(x, y-1);
-                }
-            }
-        }
-        ++currentStep;
-    }
-
-    for (int x = 0; x < gameMap->height; ++x)
-    {
-        for (int y = 0; y < gameMap->width; ++y)
-        {
-            auto step = stepMap[x][y];
-            if (step == 0)
-                continue;
 
-            if (isCorrectDirection(x+1, y, step))
-                pathMap[x][y] = MoveDirection::Right;
-            else if (isCorrectDirection(x-1, y, step))
-                pathMap[x][y] = MoveDirection::Left;
-            else if (isCorrectDirection(x, y+1, step))
-                pathMap[x][y] = MoveDirection::Up;
-            else if (isCorrectDirection(x, y-1, step))
-                pathMap[x][y] = MoveDirection::Down;
-        }
-    }
-
-    return pathMap;
-}
-
-} // anon namespace
-
-std::unordered_map<glm::ivec2, TargetPathMap, GlmHash> HuntAI::_pathMapList = {};
+PathMap HuntAI::_pathMap = {};
 
 HuntAI::HuntAI(MapTraveller& mapWalker)
     : RandomWalkerAI(mapWalker)
@@ -104,18 +19,13 @@ void HuntAI::update(float deltaTime)
     if (_mapTraveller->isTargetReached())
     {
         auto target = _mapTraveller->getGameMap()->player->getMapTraveller()->getMapPosition();
-        auto pathIter = _pathMapList.find(target);
-        if (pathIter != _pathMapList.end())
+        auto currentPos = _mapTraveller->getMapPosition();
+        auto direction = _pathMap.getDirection(target, currentPos);
+        if (currentPos.x - target.x <= 7 && currentPos.y - target.y <= 7 && direction != MoveDirection::None)
         {
-            auto pathMap = pathIter->second;
-            auto currentPos = _mapTraveller->getMapPosition();
-            auto direction = pathMap[currentPos.x][currentPos.y];
-            if (currentPos.x - target.x <= 7 && currentPos.y - target.y <= 7 && direction != MoveDirection::None)
-            {
-                if (_mapTraveller->tryMove(direction))
-                    return;
-                assert(!"Invalid pathmap");
-            }
+            if (_mapTraveller->tryMove(direction))
+                return;
+            assert(!"Invalid pathmap");
         }
     }
     RandomWalkerAI::update(deltaTime);
@@ -123,19 +33,12 @@ void HuntAI::update(float deltaTime)
 
 void HuntAI::updatePathMap(GameMap* map)
 {
-    _pathMapList.clear();
+    _pathMap.build(map->mapData, map->width, map->height);
+}
 
-    for (auto x = 0; x < map->height; ++x)
-    {
-        for (auto y = 0; y < map->width; ++y)
-        {
-            if (map->mapData[x][y].cellType == CellType::Floor)
-            {
-                auto target = glm::ivec2(x, y);
-                _pathMapList.emplace(target, createPathMapForTarget(target, map));
-            }
-        }
-    }
+void HuntAI::updatePathMap(GameMap* map, const std::vector<glm::ivec2>& changedCells)
+{
+    _pathMap.update(map->mapData, map->width, map->height, changedCells);
 }
 
 } // namespace Chewman
\ No newline at end of file
@@ -3,16 +3,11 @@
 // Licensed under the MIT License
 #pragma once
 #include "RandomWalkerAI.h"
-#include "Game/Level/GameUtils.h"
-#include <vector>
-#include <unordered_map>
+#include "PathMap.h"
 
 namespace Chewman
 {
-
-// path map for single target
-using TargetPathMap = std::vector<std::vector<MoveDirection>>;
-using PathMapList = std::unordered_map<glm::ivec2, TargetPathMap, GlmHash>;
+struct GameMap;
 
 class HuntAI : public RandomWalkerAI
 {
@@ -21,11 +16,12 @@ public:
 
     void update(float deltaTime) override;
     static void updatePathMap(GameMap* map);
+    static void updatePathMap(GameMap* map, const std::vector<glm::ivec2>& changedCells);
 
 private:
 
     // path map for all possible targets
-    static std::unordered_map<glm::ivec2, TargetPathMap, GlmHash> _pathMapList;
+    static PathMap _pathMap;
 };
 
 } // namespace Chewman
\ No newline at end of file
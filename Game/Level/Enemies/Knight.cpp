@@ -47,6 +47,11 @@ void Knight::updatePathMap(GameMap* map)
     HuntAI::updatePathMap(map);
 }
 
+void Knight::updatePathMap(GameMap* map, const std::vector<glm::ivec2>& changedCells)
+{
+    HuntAI::updatePathMap(map, changedCells);
+}
+
 void Knight::init()
 {
     Enemy::init();
@@ -23,6 +23,7 @@ public:
     void resetAll() override;
 
     static void updatePathMap(GameMap* map);
+    static void updatePathMap(GameMap* map, const std::vector<glm::ivec2>& changedCells);
 private:
     std::shared_ptr<SVE::SceneNode> _attachmentNode;
     std::shared_ptr<SVE::MeshEntity> _attackMesh;
@@ -0,0 +1,330 @@
+// Chewman Vulkan game
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "PathMap.h"
+#include <algorithm>
+#include <future>
+#include <thread>
+
+namespace Chewman
+{
+namespace
+{
+
+constexpr int32_t NoTarget = -1;
+constexpr uint16_t Unreachable = 0xFFFF;
+
+} // anon namespace
+
+void PathMap::build(const CellInfoMap& mapData, size_t width, size_t height)
+{
+    _width = width;
+    _height = height;
+
+    const auto cellCount = width * height;
+    _passable.assign(cellCount, 0);
+    _cellToTarget.assign(cellCount, NoTarget);
+    _targetToCell.clear();
+    _directions.clear();
+    _distances.clear();
+
+    for (size_t x = 0; x < height; ++x)
+    {
+        for (size_t y = 0; y < width; ++y)
+        {
+            if (mapData[x][y].cellType == CellType::Floor)
+                addTarget(static_cast<uint32_t>(x * width + y));
+        }
+    }
+
+    processTargets(0, _targetToCell.size(), [this](size_t target, std::vector<uint32_t>& queue)
+    {
+        buildForTarget(target, queue);
+    });
+}
+
+void PathMap::update(const CellInfoMap& mapData, size_t width, size_t height, const std::vector<glm::ivec2>& changedCells)
+{
+    if (width != _width || height != _height)
+    {
+        build(mapData, width, height);
+        return;
+    }
+
+    std::vector<uint32_t> newCells;
+    for (auto& pos : changedCells)
+    {
+        auto cell = static_cast<uint32_t>(pos.x * _width + pos.y);
+        auto passable = mapData[pos.x][pos.y].cellType == CellType::Floor;
+        if (passable == static_cast<bool>(_passable[cell]))
+            continue;
+
+        // Removing floor can make distances grow, that needs full recalculation
+        if (!passable)
+        {
+            build(mapData, width, height);
+            return;
+        }
+        _passable[cell] = 1;
+        newCells.push_back(cell);
+    }
+    if (newCells.empty())
+        return;
+
+    // Old targets only get shorter paths through new cells, new targets need full BFS
+    const auto oldTargetCount = _targetToCell.size();
+    for (auto cell : newCells)
+        addTarget(cell);
+
+    processTargets(0, oldTargetCount, [this, &newCells](size_t target, std::vector<uint32_t>& queue)
+    {
+        repairForTarget(target, newCells, queue);
+    });
+    processTargets(oldTargetCount, _targetToCell.size(), [this](size_t target, std::vector<uint32_t>& queue)
+    {
+        buildForTarget(target, queue);
+    });
+}
+
+void PathMap::clear()
+{
+    _width = 0;
+    _height = 0;
+    _passable.clear();
+    _cellToTarget.clear();
+    _targetToCell.clear();
+    _directions.clear();
+    _distances.clear();
+}
+
+void PathMap::setThreadCount(unsigned threadCount)
+{
+    _threadCount = threadCount;
+}
+
+MoveDirection PathMap::getDirection(glm::ivec2 target, glm::ivec2 from) const
+{
+    const auto width = static_cast<int>(_width);
+    const auto height = static_cast<int>(_height);
+    if (target.x < 0 || target.x >= height || target.y < 0 || target.y >= width ||
+        from.x < 0 || from.x >= height || from.y < 0 || from.y >= width)
+        return MoveDirection::None;
+
+    auto targetIndex = _cellToTarget[target.x * width + target.y];
+    if (targetIndex == NoTarget)
+        return MoveDirection::None;
+
+    auto cellCount = _width * _height;
+    return static_cast<MoveDirection>(_directions[targetIndex * cellCount + from.x * width + from.y]);
+}
+
+void PathMap::addTarget(uint32_t cell)
+{
+    const auto cellCount = _width * _height;
+    _passable[cell] = 1;
+    _cellToTarget[cell] = static_cast<int32_t>(_targetToCell.size());
+    _targetToCell.push_back(cell);
+    _directions.resize(_directions.size() + cellCount, static_cast<uint8_t>(MoveDirection::None));
+    _distances.resize(_distances.size() + cellCount, Unreachable);
+}
+
+void PathMap::processTargets(size_t firstTarget, size_t lastTarget, const TargetFunc& func)
+{
+    if (firstTarget >= lastTarget)
+        return;
+
+    // Every target writes only its own row, so targets can be processed in parallel
+    const auto cellCount = _width * _height;
+    const auto targetCount = lastTarget - firstTarget;
+    auto threadCount = std::max(1u, _threadCount > 0 ? _threadCount : std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, static_cast<unsigned>(targetCount));
+
+    const auto processRange = [&func, firstTarget, lastTarget, threadCount, cellCount](unsigned threadIndex)
+    {
+        std::vector<uint32_t> queue(cellCount);
+        for (auto target = firstTarget + threadIndex; target < lastTarget; target += threadCount)
+            func(target, queue);
+    };
+
+    if (threadCount == 1)
+    {
+        processRange(0);
+        return;
+    }
+
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(threadCount);
+    for (auto threadIndex = 0u; threadIndex < threadCount; ++threadIndex)
+        tasks.push_back(std::async(std::launch::async, processRange, threadIndex));
+    for (auto& task : tasks)
+        task.get();
+}
+
+void PathMap::buildForTarget(size_t targetIndex, std::vector<uint32_t>& queue)
+{
+    const auto width = static_cast<int>(_width);
+    const auto height = static_cast<int>(_height);
+    const auto cellCount = _width * _height;
+    auto* distance = _distances.data() + targetIndex * cellCount;
+
+    std::fill(distance, distance + cellCount, Unreachable);
+    std::fill(_directions.begin() + targetIndex * cellCount,
+              _directions.begin() + (targetIndex + 1) * cellCount,
+              static_cast<uint8_t>(MoveDirection::None));
+
+    // Queue based BFS from target
+    auto targetCell = _targetToCell[targetIndex];
+    size_t queueHead = 0;
+    size_t queueTail = 0;
+    distance[targetCell] = 0;
+    queue[queueTail++] = targetCell;
+
+    const auto tryGoCell = [&](int x, int y, uint16_t step)
+    {
+        if (x >= 0 && x < height && y >= 0 && y < width)
+        {
+            auto cell = x * width + y;
+            if (_passable[cell] && distance[cell] == Unreachable)
+            {
+                distance[cell] = step;
+                queue[queueTail++] = cell;
+            }
+        }
+    };
+
+    while (queueHead < queueTail)
+    {
+        auto cell = queue[queueHead++];
+        int x = cell / width;
+        int y = cell % width;
+        auto step = static_cast<uint16_t>(distance[cell] + 1);
+        tryGoCell(x+1, y, step);
+        tryGoCell(x-1, y, step);
+        tryGoCell(x, y+1, step);
+        tryGoCell(x, y-1, step);
+    }
+
+    // Next hop for every reached cell (queue holds all of them in BFS order)
+    for (size_t i = 1; i < queueTail; ++i)
+        updateDirection(targetIndex, queue[i]);
+}
+
+void PathMap::repairForTarget(size_t targetIndex, const std::vector<uint32_t>& newCells, std::vector<uint32_t>& queue)
+{
+    const auto width = static_cast<int>(_width);
+    const auto height = static_cast<int>(_height);
+    const auto cellCount = _width * _height;
+    auto* distance = _distances.data() + targetIndex * cellCount;
+
+    // Distances can only decrease when cells are opened, so relax from new cells
+    // and collect every cell with changed distance for direction update.
+    // New cells are seeded in distance order and merged with BFS queue, so cells
+    // are processed in non-decreasing distance and each one is queued at most once.
+    size_t queueHead = 0;
+    size_t queueTail = 0;
+    std::vector<uint32_t> changed;
+    std::vector<std::pair<uint16_t, uint32_t>> seeds;
+
+    const auto relax = [&](int x, int y, uint16_t step)
+    {
+        if (x >= 0 && x < height && y >= 0 && y < width)
+        {
+            auto cell = x * width + y;
+            if (_passable[cell] && step < distance[cell])
+            {
+                distance[cell] = step;
+                queue[queueTail++] = cell;
+                changed.push_back(cell);
+            }
+        }
+    };
+    const auto getMinNeighbour = [&](int x, int y) -> uint16_t
+    {
+        uint16_t result = Unreachable;
+        if (x + 1 < height) result = std::min(result, distance[(x + 1) * width + y]);
+        if (x > 0) result = std::min(result, distance[(x - 1) * width + y]);
+        if (y + 1 < width) result = std::min(result, distance[x * width + y + 1]);
+        if (y > 0) result = std::min(result, distance[x * width + y - 1]);
+        return result;
+    };
+
+    for (auto cell : newCells)
+    {
+        auto minNeighbour = getMinNeighbour(cell / width, cell % width);
+        if (minNeighbour != Unreachable)
+            seeds.emplace_back(static_cast<uint16_t>(minNeighbour + 1), cell);
+    }
+    std::sort(seeds.begin(), seeds.end());
+
+    size_t seedIndex = 0;
+    while (seedIndex < seeds.size() || queueHead < queueTail)
+    {
+        uint32_t cell;
+        if (queueHead == queueTail ||
+            (seedIndex < seeds.size() && seeds[seedIndex].first <= distance[queue[queueHead]]))
+        {
+            auto seed = seeds[seedIndex++];
+            if (seed.first >= distance[seed.second])
+                continue;
+            cell = seed.second;
+            distance[cell] = seed.first;
+            changed.push_back(cell);
+        } else {
+            cell = queue[queueHead++];
+        }
+
+        int x = cell / width;
+        int y = cell % width;
+        auto step = static_cast<uint16_t>(distance[cell] + 1);
+        relax(x+1, y, step);
+        relax(x-1, y, step);
+        relax(x, y+1, step);
+        relax(x, y-1, step);
+    }
+
+    // Direction depends on neighbours distances, so neighbours of changed cells need update too
+    for (auto cell : changed)
+    {
+        int x = cell / width;
+        int y = cell % width;
+        updateDirection(targetIndex, cell);
+        if (x + 1 < height) updateDirection(targetIndex, cell + width);
+        if (x > 0) updateDirection(targetIndex, cell - width);
+        if (y + 1 < width) updateDirection(targetIndex, cell + 1);
+        if (y > 0) updateDirection(targetIndex, cell - 1);
+    }
+}
+
+void PathMap::updateDirection(size_t targetIndex, uint32_t cell)
+{
+    const auto width = static_cast<int>(_width);
+    const auto height = static_cast<int>(_height);
+    const auto cellCount = _width * _height;
+    const auto* distance = _distances.data() + targetIndex * cellCount;
+
+    const auto isCorrectDirection = [&](int x, int y, uint16_t step) -> bool
+    {
+        if (x >= 0 && x < height && y >= 0 && y < width)
+            return distance[x * width + y] == step - 1;
+        return false;
+    };
+
+    int x = cell / width;
+    int y = cell % width;
+    auto step = distance[cell];
+
+    MoveDirection direction = MoveDirection::None;
+    if (!_passable[cell] || step == 0 || step == Unreachable)
+        direction = MoveDirection::None;
+    else if (isCorrectDirection(x+1, y, step))
+        direction = MoveDirection::Right;
+    else if (isCorrectDirection(x-1, y, step))
+        direction = MoveDirection::Left;
+    else if (isCorrectDirection(x, y+1, step))
+        direction = MoveDirection::Up;
+    else if (isCorrectDirection(x, y-1, step))
+        direction = MoveDirection::Down;
+    _directions[targetIndex * cellCount + cell] = static_cast<uint8_t>(direction);
+}
+
+} // namespace Chewman
\ No newline at end of file
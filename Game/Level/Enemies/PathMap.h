@@ -0,0 +1,49 @@
+// Chewman Vulkan game
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "Game/Level/MapTraveller.h"
+#include <functional>
+#include <vector>
+
+namespace Chewman
+{
+
+// Next-hop table for all floor targets on the map.
+// Directions and distances are stored as flat [target][cell] arrays, cell index is x * width + y.
+class PathMap
+{
+public:
+    void build(const CellInfoMap& mapData, size_t width, size_t height);
+    // Repair table after some cells changed type. Cells which became floor are
+    // processed incrementally, any other change falls back to full rebuild.
+    void update(const CellInfoMap& mapData, size_t width, size_t height, const std::vector<glm::ivec2>& changedCells);
+    void clear();
+    // Worker threads used for targets processing, 0 is one per hardware thread
+    void setThreadCount(unsigned threadCount);
+
+    // Direction to move from cell "from" to get closer to "target" (None if unreachable)
+    MoveDirection getDirection(glm::ivec2 target, glm::ivec2 from) const;
+
+private:
+    using TargetFunc = std::function<void(size_t targetIndex, std::vector<uint32_t>& queue)>;
+
+    void addTarget(uint32_t cell);
+    void processTargets(size_t firstTarget, size_t lastTarget, const TargetFunc& func);
+    void buildForTarget(size_t targetIndex, std::vector<uint32_t>& queue);
+    void repairForTarget(size_t targetIndex, const std::vector<uint32_t>& newCells, std::vector<uint32_t>& queue);
+    void updateDirection(size_t targetIndex, uint32_t cell);
+
+private:
+    size_t _width = 0;
+    size_t _height = 0;
+    unsigned _threadCount = 0;
+
+    std::vector<uint8_t> _passable;
+    std::vector<int32_t> _cellToTarget;
+    std::vector<uint32_t> _targetToCell;
+    std::vector<uint8_t> _directions;
+    std::vector<uint16_t> _distances;
+};
+
+} // namespace Chewman
\ No newline at end of file
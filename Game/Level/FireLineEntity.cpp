@@ -5,6 +5,8 @@
 #include "SVE/MaterialManager.h"
 #include "SVE/VulkanMaterial.h"
 #include "SVE/VulkanInstance.h"
+#include "SVE/RecordingContext.h"
+#include "SVE/FrameUniforms.h"
 #include <SVE/Utils.h>
 
 namespace Chewman
@@ -14,7 +16,12 @@ FireLineEntity::FireLineEntity(const std::string& material, FireLineInfo startIn
     : _material(SVE::Engine::getInstance()->getMaterialManager()->getMaterial(material))
     , _currentInfo(startInfo)
 {
-    _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
+    _materialInstance = _material->getVulkanMaterial()->createInstance();
+}
+
+FireLineEntity::~FireLineEntity()
+{
+    _material->getVulkanMaterial()->deleteInstance(_materialInstance);
 }
 
 void FireLineEntity::updateInfo(FireLineInfo info)
@@ -27,30 +34,31 @@ FireLineInfo& FireLineEntity::getInfo()
     return _currentInfo;
 }
 
-void FireLineEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
+void FireLineEntity::applyDrawingCommands(const SVE::RecordingContext& context) const
 {
-    auto passType = SVE::Engine::getInstance()->getPassType();
-    if (passType == SVE::CommandsType::MainPass
-        || passType == SVE::CommandsType::ScreenQuadPass
-        || passType == SVE::CommandsType::ScreenQuadLatePass)
+    if (context.passType == SVE::CommandsType::MainPass
+        || context.passType == SVE::CommandsType::ScreenQuadPass
+        || context.passType == SVE::CommandsType::ScreenQuadLatePass)
     {
-        _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _materialIndex);
-        auto commandBuffer = SVE::Engine::getInstance()->getVulkanInstance()->getCommandBuffer(bufferIndex);
-        vkCmdDraw(commandBuffer, _currentInfo.maxParticles, 1, 0, 0);
+        _material->getVulkanMaterial()->applyDrawingCommands(context, _materialInstance);
+        vkCmdDraw(context.commandBuffer, _currentInfo.maxParticles, 1, 0, 0);
     }
 }
 
-void FireLineEntity::updateUniforms(SVE::UniformDataList uniformDataList) const
+void FireLineEntity::updateUniforms(SVE::FrameUniforms& frameUniforms, const glm::mat4& model) const
 {
-    auto mainUniform = uniformDataList[toInt(SVE::CommandsType::MainPass)];
-    mainUniform->customMat4 = glm::mat4(
+    auto& objectData = frameUniforms.createObjectData(model);
+    objectData.customMat4 = glm::mat4(
             glm::vec4(_currentInfo.startPos, 1),
             glm::vec4(_currentInfo.direction, 1),
             glm::vec4(_currentInfo.percent, _currentInfo.maxParticles, _currentInfo.maxLength, _currentInfo.alpha),
             glm::vec4(0.0));
-    mainUniform->spritesheetSize = _material->getVulkanMaterial()->getSpritesheetSize();
+    objectData.spritesheetSize = _material->getVulkanMaterial()->getSpritesheetSize();
+    // Object block doesn't inherit material info of previously updated entity anymore
+    objectData.materialInfo.diffuse = glm::vec4(1);
 
-    _material->getVulkanMaterial()->setUniformData(_materialIndex, *mainUniform);
+    _material->getVulkanMaterial()->setUniformData(
+            _materialInstance, { frameUniforms.getPassData(SVE::CommandsType::MainPass), objectData });
 }
 
 } // namespace Chewman
\ No newline at end of file
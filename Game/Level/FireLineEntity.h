@@ -3,6 +3,7 @@
 // Licensed under the MIT License
 #pragma once
 #include <SVE/Entity.h>
+#include <SVE/MaterialInstance.h>
 
 namespace SVE
 {
@@ -26,15 +27,16 @@ class FireLineEntity : public SVE::Entity
 {
 public:
     FireLineEntity(const std::string& material, FireLineInfo startInfo);
+    ~FireLineEntity() override;
 
     void updateInfo(FireLineInfo info);
     FireLineInfo& getInfo();
-    void updateUniforms(SVE::UniformDataList uniformDataList) const override;
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
+    void updateUniforms(SVE::FrameUniforms& frameUniforms, const glm::mat4& model) const override;
+    void applyDrawingCommands(const SVE::RecordingContext& context) const override;
 
 private:
     SVE::Material* _material = nullptr;
-    uint32_t _materialIndex = 0;
+    SVE::MaterialInstance _materialInstance;
     FireLineInfo _currentInfo;
 };
 
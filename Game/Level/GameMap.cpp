@@ -281,8 +281,13 @@ void GameMapProcessor::switchDayNight()
         enemy->enableLight(_gameMap->isNight);
     _gameMap->player->enableLight(_gameMap->isNight);
 
-    _gameMap->mapEntity[0]->getMaterialInfo()->diffuse = getCeilingMaterialDiffuse(_gameMap->style, _gameMap->isNight);
-    _gameMap->mapEntity[1]->getMaterialInfo()->diffuse = getFloorMaterialDiffuse(_gameMap->style, _gameMap->isNight);
+    for (auto& chunk : _gameMap->mapChunks)
+    {
+        if (chunk.mapEntity[0])
+            chunk.mapEntity[0]->getMaterialInfo()->diffuse = getCeilingMaterialDiffuse(_gameMap->style, _gameMap->isNight);
+        if (chunk.mapEntity[1])
+            chunk.mapEntity[1]->getMaterialInfo()->diffuse = getFloorMaterialDiffuse(_gameMap->style, _gameMap->isNight);
+    }
 
     auto currentLevel = Game::getInstance()->getProgressManager().getCurrentLevel() - 1;
     auto& settingsManager = Game::getInstance()->getGameSettingsManager();
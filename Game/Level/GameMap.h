@@ -23,12 +23,20 @@
 namespace Chewman
 {
 
+struct MapChunk
+{
+    // top, bottom and vertical parts, empty when chunk has no such geometry
+    std::shared_ptr<SVE::MeshEntity> mapEntity[3];
+};
+
 struct GameMap
 {
     std::string name;
+    std::string meshSuffix;
     std::shared_ptr<SVE::SceneNode> mapNode;
     std::shared_ptr<SVE::SceneNode> upperLevelMeshNode;
-    std::shared_ptr<SVE::MeshEntity> mapEntity[3];
+    std::vector<MapChunk> mapChunks;
+    size_t chunkColumns;
     std::shared_ptr<SVE::MeshEntity> smokeEntity;
     std::shared_ptr<SVE::MeshEntity> smokeNAEntity;
     std::shared_ptr<SVE::MeshEntity> lavaEntity;
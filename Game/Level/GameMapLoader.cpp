@@ -18,6 +18,7 @@
 #include "Game/Level/Enemies/Witch.h"
 #include "Game/Level/Enemies/Knight.h"
 
+#include <set>
 #include <sstream>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/matrix_transform.hpp>
@@ -122,6 +123,68 @@ void initSmokeMesh()
     SVE::Engine::getInstance()->getMeshManager()->registerMesh(smokeMeshBottom);*/
 }
 
+std::string getLevelMaterialName(const GameMap& level, size_t meshType)
+{
+    auto styleStr = std::to_string(level.style);
+    switch (meshType)
+    {
+        case 0:
+            return "CeilingNormals" + styleStr;
+        case 1:
+            return level.style == 4 ? "FloorNormals4" : "FloorParallax" + styleStr;
+        default:
+            return "WallParallax" + styleStr;
+    }
+}
+
+void buildLevelChunk(GameMap& level, BlockMeshGenerator& meshGenerator, size_t chunkIndex)
+{
+    const std::string meshNames[] = { "MapT", "MapB", "MapV" };
+    std::shared_ptr<SVE::SceneNode> nodes[] = {
+            level.upperLevelMeshNode,
+            level.mapNode,
+            level.upperLevelMeshNode
+    };
+
+    auto submeshes = meshGenerator.GenerateChunk(level.mapData, level.width, level.height, level.chunkColumns, chunkIndex);
+
+    auto* engine = SVE::Engine::getInstance();
+    auto& chunk = level.mapChunks[chunkIndex];
+    for (auto i = 0; i < 3; ++i)
+    {
+        auto& entity = chunk.mapEntity[i];
+        if (submeshes[i].empty())
+        {
+            if (entity)
+            {
+                nodes[i]->detachEntity(entity);
+                entity.reset();
+            }
+            continue;
+        }
+
+        auto meshName = meshNames[i] + level.meshSuffix + "_" + std::to_string(chunkIndex);
+        auto meshSettings = meshGenerator.CombineMeshes(meshName, std::move(submeshes[i]));
+        meshSettings.materialName = getLevelMaterialName(level, i);
+
+        if (entity)
+        {
+            // Entity stays attached, only geometry buffers are reuploaded
+            engine->getMeshManager()->getMesh(meshName)->updateMesh(std::move(meshSettings));
+            continue;
+        }
+
+        engine->getMeshManager()->registerMesh(std::make_shared<SVE::Mesh>(meshSettings));
+        entity = std::make_shared<SVE::MeshEntity>(meshName);
+        entity->setRenderToDepth(true);
+        if (i == 0)
+            entity->getMaterialInfo()->diffuse = getCeilingMaterialDiffuse(level.style, level.isNight);
+        else if (i == 1)
+            entity->getMaterialInfo()->diffuse = getFloorMaterialDiffuse(level.style, level.isNight);
+        nodes[i]->attachEntity(entity);
+    }
+}
+
 } // anon namespace
 
 GameMapLoader::GameMapLoader()
@@ -351,83 +414,34 @@ void GameMapLoader::initMeshes(GameMap& level, const std::string& suffix)
 {
     if (_callback)
         _callback(0.15);
-    buildLevelMeshes(level, _meshGenerator, suffix);
 
-    if (_callback)
-        _callback(0.7);
-
-    level.mapEntity[0] = std::make_shared<SVE::MeshEntity>("MapT" + suffix);
-    level.mapEntity[0]->getMaterialInfo()->diffuse = getCeilingMaterialDiffuse(level.style, level.isNight);
-    level.mapEntity[1] = std::make_shared<SVE::MeshEntity>("MapB" + suffix);
-    level.mapEntity[1]->getMaterialInfo()->diffuse = getFloorMaterialDiffuse(level.style, level.isNight);
-    level.mapEntity[2] = std::make_shared<SVE::MeshEntity>("MapV" + suffix);
-    for (auto i = 0; i < 3; ++i)
-        level.mapEntity[i]->setRenderToDepth(true);
+    level.meshSuffix = suffix;
+    buildLevelMeshes(level, _meshGenerator);
 
     if (_callback)
         _callback(0.9);
-
-    level.upperLevelMeshNode->attachEntity(level.mapEntity[0]);
-    level.mapNode->attachEntity(level.mapEntity[1]);
-    level.upperLevelMeshNode->attachEntity(level.mapEntity[2]);
 }
 
-void buildLevelMeshes(const GameMap& level, BlockMeshGenerator& meshGenerator, const std::string& suffix)
+void buildLevelMeshes(GameMap& level, BlockMeshGenerator& meshGenerator)
 {
-    std::vector<Submesh> top;
-    std::vector<Submesh> bottom;
-    std::vector<Submesh> vertical;
-    for (auto x = 0; x < level.height; ++x)
-    {
-        for (auto y = 0; y < level.width; ++y)
-        {
-            std::vector<Submesh> cellT;
-            std::vector<Submesh> cellB;
-            std::vector<Submesh> cellV;
-            glm::vec3 position(y * CellSize, 0, -x * CellSize);
-            switch (level.mapData[x][y].cellType)
-            {
-                case CellType::Wall:
-                    cellT = meshGenerator.GenerateWall(position, Top);
-                    cellB = meshGenerator.GenerateWall(position, Bottom);
-                    cellV = meshGenerator.GenerateWall(position, Vertical);
-                    break;
-                case CellType::Floor:
-                case CellType::InvisibleWallWithFloor:
-                    cellT = meshGenerator.GenerateFloor(position, Top);
-                    cellB = meshGenerator.GenerateFloor(position, Bottom);
-                    cellV = meshGenerator.GenerateFloor(position, Vertical);
-                    break;
-                case CellType::Liquid:
-                    cellV = meshGenerator.GenerateLiquid(position, Vertical, x, y, level.height - 1, level.width - 1);
-                    break;
-            }
-            top.insert(top.end(), cellT.begin(), cellT.end());
-            bottom.insert(bottom.end(), cellB.begin(), cellB.end());
-            vertical.insert(vertical.end(), cellV.begin(), cellV.end());
-        }
-    }
+    auto chunkRows = (level.height + MapChunkSize - 1) / MapChunkSize;
+    level.chunkColumns = (level.width + MapChunkSize - 1) / MapChunkSize;
+    level.mapChunks.clear();
+    level.mapChunks.resize(chunkRows * level.chunkColumns);
 
-    auto styleStr = std::to_string(level.style);
-    auto meshSettingsT = meshGenerator.CombineMeshes("MapT" + suffix, top);
-    meshSettingsT.materialName = "CeilingNormals" + styleStr;
-    auto meshSettingsB = meshGenerator.CombineMeshes("MapB" + suffix, bottom);
-    if (level.style == 4)
-        meshSettingsB.materialName = "FloorNormals4";
-    else
-        meshSettingsB.materialName = "FloorParallax" + styleStr;
-    auto meshSettingsV = meshGenerator.CombineMeshes("MapV" + suffix, vertical);
-    meshSettingsV.materialName = "WallParallax" + styleStr;
+    for (size_t chunkIndex = 0; chunkIndex < level.mapChunks.size(); ++chunkIndex)
+        buildLevelChunk(level, meshGenerator, chunkIndex);
+}
 
-    auto* engine = SVE::Engine::getInstance();
+void updateLevelMeshes(GameMap& level, BlockMeshGenerator& meshGenerator, const std::vector<glm::ivec2>& changedCells)
+{
+    // Cell geometry depends only on its own type, so neighbour chunks never change
+    std::set<size_t> changedChunks;
+    for (auto& cell : changedCells)
+        changedChunks.insert(getChunkIndex(cell, level.chunkColumns));
 
-    std::shared_ptr<SVE::Mesh> mapMesh[3];
-    mapMesh[0] = std::make_shared<SVE::Mesh>(meshSettingsT);
-    engine->getMeshManager()->registerMesh(mapMesh[0]);
-    mapMesh[1] = std::make_shared<SVE::Mesh>(meshSettingsB);
-    engine->getMeshManager()->registerMesh(mapMesh[1]);
-    mapMesh[2] = std::make_shared<SVE::Mesh>(meshSettingsV);
-    engine->getMeshManager()->registerMesh(mapMesh[2]);
+    for (auto chunkIndex : changedChunks)
+        buildLevelChunk(level, meshGenerator, chunkIndex);
 }
 
 void GameMapLoader::createGargoyle(GameMap& level, int row, int column, char mapType)
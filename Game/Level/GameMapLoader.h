@@ -33,7 +33,10 @@ private:
     CallbackFunc _callback = nullptr;
 };
 
-void buildLevelMeshes(const GameMap& level, BlockMeshGenerator& meshGenerator, const std::string& suffix = "");
+// Create meshes and entities for all level chunks
+void buildLevelMeshes(GameMap& level, BlockMeshGenerator& meshGenerator);
+// Rebuild only chunks containing changed cells
+void updateLevelMeshes(GameMap& level, BlockMeshGenerator& meshGenerator, const std::vector<glm::ivec2>& changedCells);
 
 
 } // namespace Chewman
\ No newline at end of file
@@ -188,7 +188,7 @@ void GameRulesProcessor::update(float deltaTime)
                 gameMap->mapData[mapPos.x][mapPos.y].cellType = CellType::Floor;
                 gameMap->eatEffectManager->addEffect(EatEffectType::Walls, mapPos);
                 Game::getInstance()->getSoundsManager().playSound(SoundType::ChewWall);
-                regenerateMap();
+                regenerateMap({ mapPos });
             }
         } else {
             _insideTeleport = false;
@@ -492,7 +492,7 @@ void GameRulesProcessor::deactivatePowerUp(PowerUpType type)
                 gameMap->mapData[mapPos.x][mapPos.y].cellType = CellType::Floor;
                 gameMap->eatEffectManager->addEffect(EatEffectType::Walls, mapPos);
                 Game::getInstance()->getSoundsManager().playSound(SoundType::ChewWall);
-                regenerateMap();
+                regenerateMap({ mapPos });
             }
             break;
         }
@@ -628,6 +628,7 @@ void GameRulesProcessor::updateCameraAnimation(float deltaTime)
 void GameRulesProcessor::destroyWalls(glm::ivec2 pos)
 {
     auto gameMap = _gameMapProcessor.getGameMap();
+    std::vector<glm::ivec2> changedCells;
     for (auto x = pos.x - 2; x <= pos.x + 2; x++)
     {
         for (auto y = pos.y - 2; y <= pos.y + 2; y++)
@@ -638,11 +639,12 @@ void GameRulesProcessor::destroyWalls(glm::ivec2 pos)
             if (gameMap->mapData[x][y].cellType == CellType::Wall)
             {
                 gameMap->mapData[x][y].cellType = CellType::Floor;
+                changedCells.emplace_back(x, y);
             }
         }
     }
 
-    regenerateMap();
+    regenerateMap(changedCells);
 }
 
 void GameRulesProcessor::updateWallsDown(float deltaTime)
@@ -663,31 +665,17 @@ void GameRulesProcessor::updateWallsDown(float deltaTime)
     gameMap->upperLevelMeshNode->setNodeTransformation(glm::scale(glm::mat4(1), glm::vec3(1.0f, scale, 1.0)));
 }
 
-void GameRulesProcessor::regenerateMap()
+void GameRulesProcessor::regenerateMap(const std::vector<glm::ivec2>& changedCells)
 {
     auto gameMap = _gameMapProcessor.getGameMap();
 
     BlockMeshGenerator blockMeshGenerator(CellSize);
-    buildLevelMeshes(*gameMap, blockMeshGenerator);
-
-    std::string meshNames[] = { "MapT", "MapB", "MapV" };
-    std::shared_ptr<SVE::SceneNode> nodes[] = {
-            gameMap->upperLevelMeshNode,
-            gameMap->mapNode,
-            gameMap->upperLevelMeshNode
-    };
-    for (auto i = 0; i < 3; ++i)
-    {
-        nodes[i]->detachEntity(gameMap->mapEntity[i]);
-        gameMap->mapEntity[i] = std::make_shared<SVE::MeshEntity>(meshNames[i]);
-        gameMap->mapEntity[i]->setRenderToDepth(true);
-        nodes[i]->attachEntity(gameMap->mapEntity[i]);
-    }
+    updateLevelMeshes(*gameMap, blockMeshGenerator, changedCells);
 
     if (std::any_of(gameMap->enemies.begin(), gameMap->enemies.end(),
                     [](std::unique_ptr<Enemy>& enemy) { return enemy->getEnemyType() == EnemyType::Knight; }))
     {
-        Knight::updatePathMap(gameMap.get());
+        Knight::updatePathMap(gameMap.get(), changedCells);
     }
 }
 
@@ -52,7 +52,7 @@ private:
     void updateCameraAnimation(float deltaTime);
     void destroyWalls(glm::ivec2 pos);
     void updateWallsDown(float deltaTime);
-    void regenerateMap();
+    void regenerateMap(const std::vector<glm::ivec2>& changedCells);
     bool eatCoin(glm::ivec2 pos);
     void setShadowCamera(bool isZoomed);
 
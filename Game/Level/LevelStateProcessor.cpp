@@ -2,6 +2,7 @@
 // Copyright (c) 2018-2019, Igor Barinov
 // Licensed under the MIT License
 #include <sstream>
+#include <iostream>
 #include <iomanip>
 #include <glm/gtc/matrix_transform.hpp>
 #include "LevelStateProcessor.h"
@@ -9,6 +10,7 @@
 #include "Game/SystemApi.h"
 #include "Game/Level/GameMapLoader.h"
 #include "Game/Controls/ControlDocument.h"
+#include "SVE/Engine.h"
 #include "SVE/SceneManager.h"
 #include "SVE/LightManager.h"
 #include "GameUtils.h"
@@ -86,6 +88,9 @@ GameState LevelStateProcessor::update(float deltaTime)
                 _counterControl->setVisible(false);
                 _loadingControl->setVisible(false);
                 _counterTime = -1;
+                // Draw calls are reported along with HUD statistics only
+                if (_showFPS)
+                    reportDrawCalls();
             }
             break;
         case GameMapState::Pause:
@@ -329,19 +334,38 @@ void LevelStateProcessor::updateHUD(float deltaTime)
 
     static auto fps = _document->getControlByName("FPS");
     static std::list<float> fpsList;
+    static std::list<float> recordingTimeList;
     fpsList.push_back(1.0f/deltaTime);
+    recordingTimeList.push_back(SVE::Engine::getInstance()->getFrameStatistics().recordingTime);
     if (fpsList.size() > 100)
+    {
         fpsList.pop_front();
+        recordingTimeList.pop_front();
+    }
 
     if (_showFPS)
     {
+        // Commands recording CPU time is shown to compare serial and parallel recording
         auto fpsValue = std::accumulate(fpsList.begin(), fpsList.end(), 0.0f) / fpsList.size();
-        fps->setText("FPS: " + std::to_string((int) fpsValue));
+        auto recordingTime = std::accumulate(recordingTimeList.begin(), recordingTimeList.end(), 0.0f) / recordingTimeList.size();
+        stream.str("");
+        const auto& statistics = SVE::Engine::getInstance()->getFrameStatistics();
+        stream << "FPS: " << (int) fpsValue << " REC: " << std::fixed << std::setprecision(2) << recordingTime << "ms"
+               << " DC: " << statistics.drawCalls << "/" << statistics.drawCalls + statistics.mergedDrawCalls;
+        fps->setText(stream.str());
     }
 
     updatePowerUps();
 }
 
+void LevelStateProcessor::reportDrawCalls()
+{
+    // Statistics of the first game frame, whole level is visible at that moment
+    const auto& statistics = SVE::Engine::getInstance()->getFrameStatistics();
+    std::cout << "Level " << _progressManager.getCurrentLevel() << " draw calls: " << statistics.drawCalls
+              << " (without instancing: " << statistics.drawCalls + statistics.mergedDrawCalls << ")" << std::endl;
+}
+
 void LevelStateProcessor::updatePowerUps()
 {
     static const std::map<PowerUpType, std::pair<std::string /*Material*/, float /*maxTime*/>> iconInfo =
@@ -35,6 +35,7 @@ public:
 private:
     void updateHUD(float deltaTime);
     void updatePowerUps();
+    void reportDrawCalls();
 
 private:
     ProgressManager& _progressManager;
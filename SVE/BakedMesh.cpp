@@ -0,0 +1,294 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "BakedMesh.h"
+#include "VulkanException.h"
+#include <cstring>
+#include <type_traits>
+
+namespace SVE
+{
+namespace
+{
+
+const char BakedMeshMagic[4] = {'S', 'V', 'E', 'M'};
+
+struct BakedMeshHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t boneNum;
+    uint32_t hasAnimation;
+};
+
+class BakedMeshWriter
+{
+public:
+    template <typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be baked");
+        _data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const std::vector<T>& list)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be baked");
+        write(static_cast<uint32_t>(list.size()));
+        _data.resize((_data.size() + BakedMeshAlignment - 1) / BakedMeshAlignment * BakedMeshAlignment, 0);
+        _data.append(reinterpret_cast<const char*>(list.data()), list.size() * sizeof(T));
+    }
+
+    void writeString(const std::string& value)
+    {
+        write(static_cast<uint32_t>(value.size()));
+        _data.append(value);
+    }
+
+    std::string& getData()
+    {
+        return _data;
+    }
+
+private:
+    std::string _data;
+};
+
+class BakedMeshReader
+{
+public:
+    explicit BakedMeshReader(const FileView& data)
+        : _data(data)
+    {
+    }
+
+    template <typename T>
+    T read()
+    {
+        T value;
+        memcpy(&value, getRange(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void readArray(std::vector<T>& list)
+    {
+        auto count = read<uint32_t>();
+        _offset = (_offset + BakedMeshAlignment - 1) / BakedMeshAlignment * BakedMeshAlignment;
+        auto size = static_cast<size_t>(count) * sizeof(T);
+        // Range is checked before resize, so corrupted count can't allocate more than file size
+        auto* range = getRange(size);
+        list.resize(count);
+        if (count > 0)
+            memcpy(list.data(), range, size);
+    }
+
+    // Count of elements stored one by one, every element takes at least minElementSize bytes
+    uint32_t readCount(size_t minElementSize)
+    {
+        auto count = read<uint32_t>();
+        if (count > (_data.size() - _offset) / minElementSize)
+            throw VulkanException("Baked mesh data is corrupted");
+        return count;
+    }
+
+    std::string readString()
+    {
+        auto size = read<uint32_t>();
+        return std::string(getRange(size), size);
+    }
+
+private:
+    const char* getRange(size_t size)
+    {
+        if (_offset > _data.size() || size > _data.size() - _offset)
+            throw VulkanException("Baked mesh data is corrupted");
+
+        auto* range = _data.data() + _offset;
+        _offset += size;
+        return range;
+    }
+
+private:
+    const FileView& _data;
+    size_t _offset = 0;
+};
+
+void checkData(bool condition)
+{
+    if (!condition)
+        throw VulkanException("Baked mesh data is corrupted");
+}
+
+bool isValidIndex(int32_t index, size_t count)
+{
+    return index >= -1 && index < static_cast<int64_t>(count);
+}
+
+// Indices are used for drawing and animation without checks, so all of them are validated on load
+void validateMesh(const MeshSettings& meshSettings)
+{
+    auto vertexCount = meshSettings.vertexPosData.size();
+    for (auto index : meshSettings.indexData)
+        checkData(index < vertexCount);
+
+    if (!meshSettings.animation)
+        return;
+
+    const auto& animation = *meshSettings.animation;
+    for (auto i = 0u; i < animation.nodes.size(); i++)
+    {
+        const auto& node = animation.nodes[i];
+        checkData(node.parent >= -1 && node.parent < static_cast<int64_t>(i));
+        checkData(isValidIndex(node.boneIndex, animation.boneOffset.size()));
+        checkData(isValidIndex(node.attachmentBoneIndex, animation.boneOffset.size()));
+    }
+
+    for (const auto& skeletonAnimation : animation.animations)
+    {
+        checkData(skeletonAnimation.nodeChannels.size() == animation.nodes.size());
+        for (auto channel : skeletonAnimation.nodeChannels)
+            checkData(isValidIndex(channel, skeletonAnimation.channels.size()));
+        for (const auto& channel : skeletonAnimation.channels)
+        {
+            checkData(!channel.positionKeys.empty() && !channel.rotationKeys.empty() && !channel.scalingKeys.empty());
+        }
+    }
+}
+
+} // anon namespace
+
+bool isBakedMesh(const FileView& data)
+{
+    return data.size() >= sizeof(BakedMeshHeader) && memcmp(data.data(), BakedMeshMagic, sizeof(BakedMeshMagic)) == 0;
+}
+
+std::string bakeMesh(const MeshSettings& meshSettings)
+{
+    BakedMeshWriter writer;
+
+    BakedMeshHeader header {};
+    memcpy(header.magic, BakedMeshMagic, sizeof(BakedMeshMagic));
+    header.version = BakedMeshVersion;
+    header.vertexCount = static_cast<uint32_t>(meshSettings.vertexPosData.size());
+    header.indexCount = static_cast<uint32_t>(meshSettings.indexData.size());
+    header.boneNum = meshSettings.boneNum;
+    header.hasAnimation = meshSettings.animation ? 1 : 0;
+    writer.write(header);
+    writer.writeString(meshSettings.materialName);
+
+    writer.writeArray(meshSettings.vertexPosData);
+    writer.writeArray(meshSettings.vertexColorData);
+    writer.writeArray(meshSettings.vertexTexData);
+    writer.writeArray(meshSettings.vertexNormalData);
+    writer.writeArray(meshSettings.vertexBinormalData);
+    writer.writeArray(meshSettings.vertexTangentData);
+    writer.writeArray(meshSettings.indexData);
+    writer.writeArray(meshSettings.vertexBoneIndexData);
+    writer.writeArray(meshSettings.vertexBoneWeightData);
+
+    if (meshSettings.animation)
+    {
+        const auto& animation = *meshSettings.animation;
+        writer.writeArray(animation.boneOffset);
+        writer.write(animation.globalInverse);
+
+        writer.write(static_cast<uint32_t>(animation.nodes.size()));
+        for (const auto& node : animation.nodes)
+        {
+            writer.writeString(node.name);
+            writer.write(node.transformation);
+            writer.write(node.parent);
+            writer.write(node.boneIndex);
+            writer.write(node.attachmentBoneIndex);
+            writer.write(node.attachmentScale);
+        }
+
+        writer.write(static_cast<uint32_t>(animation.animations.size()));
+        for (const auto& skeletonAnimation : animation.animations)
+        {
+            writer.write(skeletonAnimation.duration);
+            writer.writeArray(skeletonAnimation.nodeChannels);
+            writer.write(static_cast<uint32_t>(skeletonAnimation.channels.size()));
+            for (const auto& channel : skeletonAnimation.channels)
+            {
+                writer.writeArray(channel.positionKeys);
+                writer.writeArray(channel.rotationKeys);
+                writer.writeArray(channel.scalingKeys);
+            }
+        }
+    }
+
+    return std::move(writer.getData());
+}
+
+MeshSettings loadBakedMesh(const FileView& data)
+{
+    BakedMeshReader reader(data);
+
+    auto header = reader.read<BakedMeshHeader>();
+    if (memcmp(header.magic, BakedMeshMagic, sizeof(BakedMeshMagic)) != 0)
+        throw VulkanException("Data isn't a baked mesh");
+    if (header.version != BakedMeshVersion)
+        throw VulkanException("Baked mesh version " + std::to_string(header.version) + " isn't supported, mesh should be baked again");
+
+    MeshSettings meshSettings {};
+    meshSettings.boneNum = header.boneNum;
+    meshSettings.materialName = reader.readString();
+
+    reader.readArray(meshSettings.vertexPosData);
+    reader.readArray(meshSettings.vertexColorData);
+    reader.readArray(meshSettings.vertexTexData);
+    reader.readArray(meshSettings.vertexNormalData);
+    reader.readArray(meshSettings.vertexBinormalData);
+    reader.readArray(meshSettings.vertexTangentData);
+    reader.readArray(meshSettings.indexData);
+    reader.readArray(meshSettings.vertexBoneIndexData);
+    reader.readArray(meshSettings.vertexBoneWeightData);
+
+    checkData(meshSettings.vertexPosData.size() == header.vertexCount && meshSettings.indexData.size() == header.indexCount);
+
+    if (header.hasAnimation)
+    {
+        meshSettings.animation = std::make_shared<AnimationSettings>();
+        auto& animation = *meshSettings.animation;
+        reader.readArray(animation.boneOffset);
+        animation.globalInverse = reader.read<aiMatrix4x4>();
+
+        // name size, transformation, parent, bone, attachment bone, attachment scale
+        animation.nodes.resize(reader.readCount(sizeof(uint32_t) * 4 + sizeof(aiMatrix4x4) * 2));
+        for (auto& node : animation.nodes)
+        {
+            node.name = reader.readString();
+            node.transformation = reader.read<aiMatrix4x4>();
+            node.parent = reader.read<int32_t>();
+            node.boneIndex = reader.read<int32_t>();
+            node.attachmentBoneIndex = reader.read<int32_t>();
+            node.attachmentScale = reader.read<aiMatrix4x4>();
+        }
+
+        // duration, node channels count
+        animation.animations.resize(reader.readCount(sizeof(double) + sizeof(uint32_t)));
+        for (auto& skeletonAnimation : animation.animations)
+        {
+            skeletonAnimation.duration = reader.read<double>();
+            reader.readArray(skeletonAnimation.nodeChannels);
+            // three key counts
+            skeletonAnimation.channels.resize(reader.readCount(sizeof(uint32_t) * 3));
+            for (auto& channel : skeletonAnimation.channels)
+            {
+                reader.readArray(channel.positionKeys);
+                reader.readArray(channel.rotationKeys);
+                reader.readArray(channel.scalingKeys);
+            }
+        }
+    }
+
+    validateMesh(meshSettings);
+    return meshSettings;
+}
+
+} // namespace SVE
\ No newline at end of file
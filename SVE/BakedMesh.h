@@ -0,0 +1,25 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "FileSystem.h"
+#include "MeshSettings.h"
+#include <string>
+
+namespace SVE
+{
+
+// Binary mesh produced offline by MeshBaker tool from imported model, so Assimp isn't needed at runtime.
+// Layout (little endian): header, material name, vertex streams, indices, bone streams and skeleton.
+// Arrays are stored as element count followed by raw elements aligned to BakedMeshAlignment from file start,
+// so they are copied without parsing (or can be used in place from mapped file).
+// Version is increased on every layout change, older files should be baked again.
+constexpr uint32_t BakedMeshVersion = 1;
+constexpr uint32_t BakedMeshAlignment = 16;
+
+bool isBakedMesh(const FileView& data);
+// Runtime settings (name, animation speed, vertex format) aren't stored and are taken from mesh file
+std::string bakeMesh(const MeshSettings& meshSettings);
+MeshSettings loadBakedMesh(const FileView& data);
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,64 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "BoundingBox.h"
+
+namespace SVE
+{
+
+BoundingBox BoundingBox::infinite()
+{
+    BoundingBox box;
+    box.isInfinite = true;
+    return box;
+}
+
+bool BoundingBox::isEmpty() const
+{
+    return !isInfinite && (min.x > max.x || min.y > max.y || min.z > max.z);
+}
+
+void BoundingBox::merge(glm::vec3 point)
+{
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void BoundingBox::merge(const BoundingBox& box)
+{
+    if (box.isInfinite)
+    {
+        isInfinite = true;
+    }
+    else if (!box.isEmpty())
+    {
+        min = glm::min(min, box.min);
+        max = glm::max(max, box.max);
+    }
+}
+
+BoundingBox BoundingBox::transform(const glm::mat4& matrix) const
+{
+    if (isInfinite || isEmpty())
+        return *this;
+
+    // Transform center and extents (Arvo's method), that's cheaper than transforming 8 corners
+    glm::vec3 center = (min + max) * 0.5f;
+    glm::vec3 extents = (max - min) * 0.5f;
+
+    glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+    glm::vec3 newExtents {};
+    for (auto i = 0; i < 3; ++i)
+    {
+        newExtents[i] = glm::abs(matrix[0][i]) * extents.x +
+                        glm::abs(matrix[1][i]) * extents.y +
+                        glm::abs(matrix[2][i]) * extents.z;
+    }
+
+    BoundingBox box;
+    box.min = newCenter - newExtents;
+    box.max = newCenter + newExtents;
+    return box;
+}
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,27 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "Libs.h"
+#include <limits>
+
+namespace SVE
+{
+
+// Axis aligned bounding box.
+// Infinite box is used for entities without known bounds, they are never culled.
+struct BoundingBox
+{
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+    bool isInfinite = false;
+
+    static BoundingBox infinite();
+
+    bool isEmpty() const;
+    void merge(glm::vec3 point);
+    void merge(const BoundingBox& box);
+    BoundingBox transform(const glm::mat4& matrix) const;
+};
+
+} // namespace SVE
\ No newline at end of file
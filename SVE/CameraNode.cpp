@@ -77,7 +77,7 @@ const glm::mat4& CameraNode::getViewMatrix()
     return _view;
 }
 
-void CameraNode::fillUniformData(UniformData& data)
+void CameraNode::fillUniformData(PassUniformData& data)
 {
     auto cameraPos = glm::yawPitchRoll(_yawPitchRoll.x, _yawPitchRoll.y, _yawPitchRoll.z);
     cameraPos = glm::translate(glm::mat4(1), _position) * cameraPos;
@@ -86,7 +86,6 @@ void CameraNode::fillUniformData(UniformData& data)
     data.projection = _projection;
     data.view = _view;
     data.viewProjectionList.push_back(_projection * _view);
-    data.model = glm::mat4(1);
     data.cameraPos = glm::vec4(_position, 1.0f);//getTotalTransformation()[3];
 }
 
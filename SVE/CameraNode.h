@@ -8,6 +8,7 @@
 
 namespace SVE
 {
+struct PassUniformData;
 
 class CameraNode : public SceneNode
 {
@@ -33,7 +34,7 @@ public:
     void setYawPitchRoll(glm::vec3 yawPitchRoll);
     glm::vec3 getYawPitchRoll();
 
-    void fillUniformData(UniformData& data);
+    void fillUniformData(PassUniformData& data);
 
     void setNodeTransformation(glm::mat4 transform) override;
 private:
@@ -0,0 +1,28 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <cstdint>
+
+namespace SVE
+{
+
+enum class CommandsType : uint8_t
+{
+    MainPass = 0,
+    ShadowPassDirectLight,
+    ShadowPassPointLights,
+    // ShadowPassSpotLight,
+    ReflectionPass,
+    RefractionPass,
+    ScreenQuadPass,
+    ScreenQuadMRTPass,  // for additional bloom output
+    ScreenQuadLatePass, // for particles or alike
+    ScreenQuadDepthPass,
+    ComputeParticlesPass,
+    PostEffectPasses,
+};
+
+static const uint8_t PassCount = 9;
+
+} // namespace SVE
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include "SceneManager.h"
 #include "ShaderManager.h"
 #include "MeshManager.h"
+#include "TextureManager.h"
 #include "LightManager.h"
 #include "ParticleSystemManager.h"
 #include "PostEffectManager.h"
@@ -26,6 +27,16 @@
 #include "Water.h"
 #include "Utils.h"
 #include "ComputeEntity.h"
+#include "Frustum.h"
+#include "RenderQueue.h"
+#include "RecordingContext.h"
+#include "VulkanBindCache.h"
+#include "VulkanUniformRing.h"
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanGeometryArena.h"
+#include "ThreadPool.h"
+#include "FrameUniforms.h"
+#include <algorithm>
 #include <chrono>
 #include <utility>
 
@@ -35,12 +46,64 @@ namespace SVE
 namespace
 {
 
-enum class PassStage : uint8_t
+using Clock = std::chrono::high_resolution_clock;
+
+uint32_t getPassMask(CommandsType passType)
+{
+    return 1u << toInt(passType);
+}
+
+float getMilliseconds(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+std::unique_ptr<ThreadPool> createRecordingThreadPool(const EngineSettings& settings)
+{
+    // Main thread records passes too, so one thread less is needed
+    auto threadCount = std::thread::hardware_concurrency();
+    if (!settings.parallelRecording || threadCount < 2)
+        return nullptr;
+
+    return std::make_unique<ThreadPool>(std::min(threadCount - 1, static_cast<unsigned>(PassCount)));
+}
+
+RecordingContext createRecordingContext(CommandsType passType, uint32_t bufferIndex, uint32_t imageIndex, VulkanBindCache& bindCache)
 {
-    Start,
-    Instanced,
-    Deferred
-};
+    bindCache.reset();
+    return { passType, bufferIndex, imageIndex,
+             Engine::getInstance()->getVulkanInstance()->getCommandBuffer(bufferIndex), &bindCache };
+}
+
+void createDrawCommands(const RenderQueue& renderQueue, const RecordingContext& context)
+{
+    // Queue is sorted by state, so consecutive items mostly share pipeline and geometry
+    auto itemContext = context;
+    for (const auto& item : renderQueue.getItems(context.passType))
+    {
+        itemContext.firstInstance = item.firstInstance;
+        itemContext.instanceCount = item.instanceCount;
+        item.entity->applyDrawingCommands(itemContext);
+    }
+}
+
+std::vector<FrustumList> createPassFrustums(const FrameUniforms& frameUniforms)
+{
+    std::vector<FrustumList> passFrustums(PassCount);
+    for (auto i = 0u; i < PassCount; i++)
+    {
+        const auto& data = frameUniforms.getPassData(static_cast<CommandsType>(i));
+        if (i == toInt(CommandsType::ShadowPassDirectLight) || i == toInt(CommandsType::ShadowPassPointLights))
+        {
+            // Shadow passes render all cascades (or cube faces) in one go
+            for (const auto& viewProjection : data.viewProjectionList)
+                passFrustums[i].emplace_back(viewProjection);
+        } else {
+            passFrustums[i].emplace_back(data.viewProjection);
+        }
+    }
+    return passFrustums;
+}
 
 } // anon namespace
 
@@ -102,12 +165,16 @@ Engine::Engine(SDL_Window* window, EngineSettings settings, std::shared_ptr<File
     , _shaderManager(std::make_unique<ShaderManager>())
     , _sceneManager(std::make_unique<SceneManager>())
     , _meshManager(std::make_unique<MeshManager>())
+    , _textureManager(std::make_unique<TextureManager>(_vulkanInstance.get()))
     , _resourceManager(std::make_unique<ResourceManager>(fileSystem))
     , _particleSystemManager(std::make_unique<ParticleSystemManager>())
     , _postEffectManager(std::make_unique<PostEffectManager>())
     , _fontManager(std::make_unique<FontManager>())
     , _overlayManager(std::make_unique<OverlayManager>())
     , _pipelineCacheManager(std::make_unique<PipelineCacheManager>())
+    , _renderQueue(std::make_unique<RenderQueue>())
+    , _threadPool(createRecordingThreadPool(_vulkanInstance->getEngineSettings()))
+    , _frameUniforms(std::make_unique<FrameUniforms>())
 {
     updateTime();
 }
@@ -118,8 +185,10 @@ Engine::~Engine()
     _resourceManager.reset();
     _meshManager.reset();
     _sceneManager.reset();
-    _shaderManager.reset();
+    // Materials use shaders descriptor set layouts, so they are destroyed first
     _materialManager.reset();
+    _textureManager.reset();
+    _shaderManager.reset();
     _vulkanInstance.reset();
     _postEffectManager.reset();
     _fontManager.reset();
@@ -151,6 +220,11 @@ MeshManager* Engine::getMeshManager()
     return _meshManager.get();
 }
 
+TextureManager* Engine::getTextureManager()
+{
+    return _textureManager.get();
+}
+
 ParticleSystemManager* Engine::getParticleSystemManager()
 {
     return _particleSystemManager.get();
@@ -207,100 +281,50 @@ void Engine::onResume()
 
 }
 
-void createNodeStageDrawCommands(const std::shared_ptr<SceneNode>& node, uint32_t bufferIndex, uint32_t imageIndex, PassStage stage)
+void createComputeCommands(const FlatScene& scene, uint32_t bufferIndex, uint32_t imageIndex)
 {
-    auto passType = Engine::getInstance()->getPassType();
-    for (auto& entity : node->getAttachedEntities())
-    {
-        bool isRenderLast = entity->isRenderLast();
-        bool isRenderDepth = entity->isRenderToDepth();
-        bool isInstanced = entity->isInstanceRendering();
-
-        if (!isRenderDepth && passType == CommandsType::ScreenQuadDepthPass)
-        {
-            continue;
-        }
-
-        switch (stage)
-        {
-            case PassStage::Start:
-                if (!isRenderLast && !isInstanced)
-                    entity->applyDrawingCommands(bufferIndex, imageIndex);
-                break;
-            case PassStage::Instanced:
-                if (!isRenderLast && isInstanced)
-                {
-                    entity->updateInstanceBuffers();
-                    entity->applyDrawingCommands(bufferIndex, imageIndex);
-                }
-                break;
-            case PassStage::Deferred:
-                if (isRenderLast)
-                    entity->applyDrawingCommands(bufferIndex, imageIndex);
-                break;
-        }
-    }
-
-    for (auto& child : node->getChildren())
-    {
-        createNodeStageDrawCommands(child, bufferIndex, imageIndex, stage);
-    }
-}
-
-void createNodeDrawCommands(const std::shared_ptr<SceneNode>& node, uint32_t bufferIndex, uint32_t imageIndex)
-{
-    createNodeStageDrawCommands(node, bufferIndex, imageIndex, PassStage::Start);
-    createNodeStageDrawCommands(node, bufferIndex, imageIndex, PassStage::Instanced);
-    createNodeStageDrawCommands(node, bufferIndex, imageIndex, PassStage::Deferred);
-}
-
-void createNodeComputeCommands(const std::shared_ptr<SceneNode>& node, uint32_t bufferIndex, uint32_t imageIndex)
-{
-
-    for (auto& entity : node->getAttachedEntities())
+    for (auto* entity : scene.getAllEntities())
     {
         if (entity->isComputeEntity())
         {
-            auto* computeEntity = static_cast<ComputeEntity*>(entity.get());
+            auto* computeEntity = static_cast<ComputeEntity*>(entity);
             computeEntity->applyComputeCommands(bufferIndex, imageIndex);
         }
     }
-
-    for (auto& child : node->getChildren())
-    {
-        createNodeComputeCommands(child, bufferIndex, imageIndex);
-    }
 }
 
-void setFrameNumber(const std::shared_ptr<SceneNode>& node, uint64_t frameId)
+void setFrameNumber(const FlatScene& scene, uint64_t frameId)
 {
-    node->setCurrentFrame(frameId);
-    for (auto& child : node->getChildren())
+    for (auto i = 0u; i < scene.getNodeCount(); i++)
     {
-        setFrameNumber(child, frameId);
+        scene.getNode(i)->setCurrentFrame(frameId);
     }
 }
 
-void updateNode(const std::shared_ptr<SceneNode>& node, UniformDataList& uniformDataList)
+void updateNodes(const FlatScene& scene, FrameUniforms& frameUniforms)
 {
-    auto oldModel = uniformDataList[0]->model;
-    uniformDataList[0]->model *= node->getNodeTransformation();
-    for (auto i = 1u; i < uniformDataList.size(); i++)
-        uniformDataList[i]->model = uniformDataList[0]->model;
-
-    // update uniforms
-    for (auto& entity : node->getAttachedEntities())
+    for (auto i = 0u; i < scene.getNodeCount();)
     {
-        entity->updateUniforms(uniformDataList);
-    }
+        // Subtree invisible in all passes doesn't need uniforms
+        if (!scene.isSubtreeVisible(i, ~0u))
+        {
+            i = scene.getSubtreeEnd(i);
+            continue;
+        }
 
-    for (auto& child : node->getChildren())
-    {
-        updateNode(child, uniformDataList);
-    }
+        // Requested after previous entities update, so attachment nodes pick up fresh bones
+        const auto& model = scene.getNode(i)->getWorldTransformation();
 
-    for (auto i = 0u; i < uniformDataList.size(); i++)
-        uniformDataList[i]->model = oldModel;
+        // update uniforms
+        if (scene.isEntitiesVisible(i, ~0u))
+        {
+            for (auto* entity : scene.getEntities(i))
+            {
+                entity->updateUniforms(frameUniforms, model);
+            }
+        }
+        ++i;
+    }
 }
 
 void Engine::renderFrame()
@@ -324,177 +348,105 @@ void Engine::renderFrame(float deltaTime)
 void Engine::renderFrameImpl()
 {
     ++_frameId;
+    auto frameStartTime = Clock::now();
     auto skybox = _sceneManager->getSkybox();
     auto currentFrame = _vulkanInstance->getCurrentFrameIndex();
     auto currentImage = _vulkanInstance->getCurrentImageIndex();
 
-    ////// update command buffers
-
     _vulkanInstance->reallocateCommandBuffers();
-    setFrameNumber(_sceneManager->getRootNode(), _frameId);
-
-    ComputeEntity::startComputeStep();
-    createNodeComputeCommands(_sceneManager->getRootNode(), BUFFER_INDEX_COMPUTE_PARTICLES, currentImage);
-    ComputeEntity::finishComputeStep();
-
-    _commandsType = CommandsType::ShadowPassDirectLight;
+    _vulkanInstance->getUniformRing()->startFrame(currentImage);
+    _vulkanInstance->getDescriptorAllocator()->startFrame(currentImage);
+    _vulkanInstance->getGeometryArena()->startFrame(currentImage);
+    auto& scene = _sceneManager->getFlatScene();
+    scene.update(_sceneManager->getRootNode());
+    setFrameNumber(scene, _frameId);
     _sceneManager->getLightManager()->setCurrentFrame(_frameId);
-    if (auto directLight = _sceneManager->getLightManager()->getDirectionLight())
-    {
-        if (auto sunLightShadowMap = _sceneManager->getLightManager()->getDirectLightShadowMap())
-        {
-            sunLightShadowMap->getVulkanShadowMap()->reallocateCommandBuffers();
-
-            auto bufferIndex =
-                    sunLightShadowMap->getVulkanShadowMap()->startRenderCommandBufferCreation(
-                            _vulkanInstance->getCurrentFrameIndex(),
-                            _vulkanInstance->getCurrentImageIndex());
-            createNodeDrawCommands(_sceneManager->getRootNode(), bufferIndex, currentImage);
-            sunLightShadowMap->getVulkanShadowMap()->endRenderCommandBufferCreation(
-                    _vulkanInstance->getCurrentFrameIndex());
-        }
-    }
-
-    _commandsType = CommandsType::ShadowPassPointLights;
-    if (auto pointLightShadowMap = _sceneManager->getLightManager()->getPointLightShadowMap())
-    {
-        pointLightShadowMap->getVulkanShadowMap()->reallocateCommandBuffers();
-
-        auto bufferIndex =
-                pointLightShadowMap->getVulkanShadowMap()->startRenderCommandBufferCreation(
-                        _vulkanInstance->getCurrentFrameIndex(),
-                        _vulkanInstance->getCurrentImageIndex());
-        createNodeDrawCommands(_sceneManager->getRootNode(), bufferIndex, currentImage);
-        pointLightShadowMap->getVulkanShadowMap()->endRenderCommandBufferCreation(
-                _vulkanInstance->getCurrentFrameIndex());
-    }
-
-    if (auto water = _sceneManager->getWater())
-    {
-        water->getVulkanWater()->reallocateCommandBuffers();
-        _commandsType = CommandsType::ReflectionPass;
-        water->getVulkanWater()->startRenderCommandBufferCreation(VulkanWater::PassType::Reflection);
-        if (skybox)
-            skybox->applyDrawingCommands(BUFFER_INDEX_WATER_REFLECTION, currentImage);
-        createNodeDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_WATER_REFLECTION, currentImage);
-        water->getVulkanWater()->endRenderCommandBufferCreation(VulkanWater::PassType::Reflection);
-
-        _commandsType = CommandsType::RefractionPass;
-        water->getVulkanWater()->startRenderCommandBufferCreation(VulkanWater::PassType::Refraction);
-        if (skybox)
-            skybox->applyDrawingCommands(BUFFER_INDEX_WATER_REFRACTION, currentImage);
-        createNodeDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_WATER_REFRACTION, currentImage);
-        water->getVulkanWater()->endRenderCommandBufferCreation(VulkanWater::PassType::Refraction);
-    }
-
-    if (auto* screenQuad = _vulkanInstance->getScreenQuad())
-    {
-        /*_commandsType = CommandsType::ScreenQuadDepthPass;
-        screenQuad->reallocateCommandBuffers(VulkanScreenQuad::Depth);
-        screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::Depth);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_DEPTH, currentImage, PassStage::Start);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_DEPTH, currentImage, PassStage::Instanced);
-        screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Depth);*/
-
-        _commandsType = CommandsType::ScreenQuadPass;
-        screenQuad->reallocateCommandBuffers(VulkanScreenQuad::Normal);
-        screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::Normal);
-        if (skybox)
-            skybox->applyDrawingCommands(BUFFER_INDEX_SCREEN_QUAD, currentImage);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD, currentImage, PassStage::Start);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD, currentImage, PassStage::Instanced);
-        screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Normal);
-
-        _commandsType = CommandsType::ScreenQuadMRTPass;
-        screenQuad->reallocateCommandBuffers(VulkanScreenQuad::MRT);
-        screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::MRT);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_MRT, currentImage, PassStage::Start);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_MRT, currentImage, PassStage::Instanced);
-        screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::MRT);
-
-        _commandsType = CommandsType::ScreenQuadLatePass;
-        screenQuad->reallocateCommandBuffers(VulkanScreenQuad::Late);
-        screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::Late);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_LATE, currentImage, PassStage::Deferred);
-        screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Late);
-
-        _commandsType = CommandsType::PostEffectPasses;
-        _engineInstance->getPostEffectManager()->createCommands(currentFrame, currentImage);
-    }
-
-    _commandsType = CommandsType::MainPass;
-    _vulkanInstance->startRenderCommandBufferCreation();
-    if (auto* screenQuad = _vulkanInstance->getScreenQuad())
-    {
-        auto index = _engineInstance->getMaterialManager()->getMaterial("ScreenQuad")->getVulkanMaterial()->getInstanceForEntity(nullptr);
-        _materialManager->getMaterial("ScreenQuad")->getVulkanMaterial()->applyDrawingCommands(currentFrame, currentImage, index);
-        auto commandBuffer = _vulkanInstance->getCommandBuffer(currentFrame);
-        vkCmdDraw(commandBuffer, 6, 1, 0, 0);
-
-        // Draw GUI
-        _overlayManager->applyDrawingCommands(currentFrame, currentImage);
-    } else
-    {
-        if (skybox)
-            skybox->applyDrawingCommands(currentFrame, currentImage);
-        createNodeDrawCommands(_sceneManager->getRootNode(), currentFrame, currentImage);
-    }
-    _vulkanInstance->endRenderCommandBufferCreation();
 
-
-    ////// Fill uniform data (from camera and lights)
+    ////// Fill uniform data (from camera and lights), it's needed for culling before commands creation
 
     auto mainCamera = _sceneManager->getMainCamera();
     if (!mainCamera)
         throw VulkanException("Camera not set");
 
-    // TODO: Init this once
-    UniformDataList uniformDataList(PassCount);
-
-    for (auto i = 0; i < PassCount; i++)
-    {
-        uniformDataList[i] = std::make_shared<UniformData>();
-    }
-    auto& mainUniform = uniformDataList[toInt(CommandsType::MainPass)];
+    // Pass blocks are kept between frames, copies below reuse lists capacity
+    _frameUniforms->reset();
+    auto& mainUniform = _frameUniforms->getPassData(CommandsType::MainPass);
 
-    mainUniform->clipPlane = glm::vec4(0.0, 1.0, 0.0, 100);
-    mainUniform->time = getTime();
-    mainUniform->deltaTime = getDeltaTime();
-    mainUniform->imageSize = glm::ivec4(getRenderWindowSize(), 0, 0);
-    _sceneManager->getMainCamera()->fillUniformData(*mainUniform);
+    mainUniform.clipPlane = glm::vec4(0.0, 1.0, 0.0, 100);
+    mainUniform.time = getTime();
+    mainUniform.deltaTime = getDeltaTime();
+    mainUniform.imageSize = glm::ivec4(getRenderWindowSize(), 0, 0);
+    _sceneManager->getMainCamera()->fillUniformData(mainUniform);
 
     for (auto i = 1; i < PassCount; i++)
     {
-        *uniformDataList[i] = *mainUniform;
+        _frameUniforms->getPassData(static_cast<CommandsType>(i)) = mainUniform;
     }
 
     _sceneManager->getLightManager()->getDirectionLight()->updateViewMatrix(_sceneManager->getMainCamera()->getPosition(),
                                                                             _sceneManager->getMainCamera()->getDirection());
-    _sceneManager->getLightManager()->fillUniformData(*uniformDataList[toInt(CommandsType::ShadowPassDirectLight)], LightType::SunLight);
-    _sceneManager->getLightManager()->fillUniformData(*uniformDataList[toInt(CommandsType::ShadowPassPointLights)], LightType::ShadowPointLight);
+    _sceneManager->getLightManager()->fillUniformData(_frameUniforms->getPassData(CommandsType::ShadowPassDirectLight), LightType::SunLight);
+    _sceneManager->getLightManager()->fillUniformData(_frameUniforms->getPassData(CommandsType::ShadowPassPointLights), LightType::ShadowPointLight);
     for (auto i = 0u; i < PassCount; i++)
     {
         if (i == toInt(CommandsType::ShadowPassDirectLight) || i == toInt(CommandsType::ShadowPassPointLights))
             continue;
-        _sceneManager->getLightManager()->fillUniformData(*uniformDataList[i]);
+        _sceneManager->getLightManager()->fillUniformData(_frameUniforms->getPassData(static_cast<CommandsType>(i)));
     }
 
     if (auto water = _sceneManager->getWater())
     {
-        water->getVulkanWater()->fillUniformData(*uniformDataList[toInt(CommandsType::ReflectionPass)],
+        water->getVulkanWater()->fillUniformData(_frameUniforms->getPassData(CommandsType::ReflectionPass),
                                                  VulkanWater::PassType::Reflection);
-        water->getVulkanWater()->fillUniformData(*uniformDataList[toInt(CommandsType::RefractionPass)],
+        water->getVulkanWater()->fillUniformData(_frameUniforms->getPassData(CommandsType::RefractionPass),
                                                  VulkanWater::PassType::Refraction);
     }
+    _frameUniforms->updateViewProjections();
+
+    ////// Frustum culling
 
-    /////// Update uniforms
+    uint32_t activePasses = 0;
+    if (_sceneManager->getLightManager()->getDirectionLight() && _sceneManager->getLightManager()->getDirectLightShadowMap())
+        activePasses |= getPassMask(CommandsType::ShadowPassDirectLight);
+    if (_sceneManager->getLightManager()->getPointLightShadowMap())
+        activePasses |= getPassMask(CommandsType::ShadowPassPointLights);
+    if (_sceneManager->getWater())
+        activePasses |= getPassMask(CommandsType::ReflectionPass) | getPassMask(CommandsType::RefractionPass);
+    if (_vulkanInstance->getScreenQuad())
+        activePasses |= getPassMask(CommandsType::ScreenQuadPass) | getPassMask(CommandsType::ScreenQuadMRTPass) |
+                        getPassMask(CommandsType::ScreenQuadLatePass);
+    else
+        activePasses |= getPassMask(CommandsType::MainPass);
 
+    auto cullingStartTime = Clock::now();
+    scene.updateBounds();
+    scene.cull(createPassFrustums(*_frameUniforms), activePasses);
+    _renderQueue->build(scene, _sceneManager->getMainCamera()->getPosition());
+    _frameStatistics.drawCalls = _renderQueue->getDrawCount();
+    _frameStatistics.mergedDrawCalls = _renderQueue->getMergedDrawCount();
+
+    /////// Update uniforms (before recording, commands bind them by dynamic offsets)
+
+    auto uniformsStartTime = Clock::now();
     if (skybox)
-        skybox->updateUniforms(uniformDataList);
-    updateNode(_sceneManager->getRootNode(), uniformDataList);
-    _overlayManager->updateUniforms(uniformDataList);
+        skybox->updateUniforms(*_frameUniforms, glm::mat4(1));
+    updateNodes(scene, *_frameUniforms);
+    _overlayManager->updateUniforms(*_frameUniforms);
+    if (_vulkanInstance->getScreenQuad())
+        _postEffectManager->updateUniforms(*_frameUniforms);
+
+    ////// update command buffers
+
+    auto recordingStartTime = Clock::now();
+    ComputeEntity::startComputeStep();
+    createComputeCommands(scene, BUFFER_INDEX_COMPUTE_PARTICLES, currentImage);
+    ComputeEntity::finishComputeStep();
+
+    recordPasses(currentFrame, currentImage);
 
     ///////  Submit command buffers to queue
+
+    auto submitStartTime = Clock::now();
     //if (particleSystemManager)
     {
         // TODO: Use special compute queue instead of graphics queue for compute shader (they can be different)
@@ -528,11 +480,176 @@ void Engine::renderFrameImpl()
         _vulkanInstance->submitCommands(CommandsType::ScreenQuadPass, BUFFER_INDEX_SCREEN_QUAD);
         _vulkanInstance->submitCommands(CommandsType::ScreenQuadMRTPass, BUFFER_INDEX_SCREEN_QUAD_MRT);
         _vulkanInstance->submitCommands(CommandsType::ScreenQuadLatePass, BUFFER_INDEX_SCREEN_QUAD_LATE);
-        _postEffectManager->submitCommands(uniformDataList);
+        _postEffectManager->submitCommands();
     }
     _vulkanInstance->submitCommands(CommandsType::MainPass, _vulkanInstance->getCurrentFrameIndex());
 
     _vulkanInstance->renderCommands();
+
+    auto frameEndTime = Clock::now();
+    _frameStatistics.sceneUpdateTime = getMilliseconds(frameStartTime, cullingStartTime);
+    _frameStatistics.cullingTime = getMilliseconds(cullingStartTime, uniformsStartTime);
+    _frameStatistics.uniformsUpdateTime = getMilliseconds(uniformsStartTime, recordingStartTime);
+    _frameStatistics.recordingTime = getMilliseconds(recordingStartTime, submitStartTime);
+    _frameStatistics.submitTime = getMilliseconds(submitStartTime, frameEndTime);
+}
+
+void Engine::recordPasses(uint32_t currentFrame, uint32_t currentImage)
+{
+    // Everything shared between passes (command buffers allocation, instance buffers, material instances)
+    // is prepared here on main thread. Recordings only read scene and write their own command buffers.
+    auto* lightManager = _sceneManager->getLightManager();
+    auto skybox = _sceneManager->getSkybox();
+    _recordings.clear();
+
+    // Instance buffers are shared between passes, so they are filled before recordings start
+    _renderQueue->updateInstanceData();
+
+    auto sunLightShadowMap = lightManager->getDirectionLight() ? lightManager->getDirectLightShadowMap() : nullptr;
+    if (sunLightShadowMap)
+    {
+        sunLightShadowMap->getVulkanShadowMap()->reallocateCommandBuffers();
+        _recordings.emplace_back([this, sunLightShadowMap, currentFrame, currentImage](VulkanBindCache& bindCache)
+        {
+            auto* vulkanShadowMap = sunLightShadowMap->getVulkanShadowMap();
+            auto bufferIndex = vulkanShadowMap->startRenderCommandBufferCreation(currentFrame, currentImage);
+            createDrawCommands(*_renderQueue, createRecordingContext(CommandsType::ShadowPassDirectLight, bufferIndex, currentImage, bindCache));
+            vulkanShadowMap->endRenderCommandBufferCreation(currentFrame);
+        });
+    }
+
+    if (auto pointLightShadowMap = lightManager->getPointLightShadowMap())
+    {
+        pointLightShadowMap->getVulkanShadowMap()->reallocateCommandBuffers();
+        _recordings.emplace_back([this, pointLightShadowMap, currentFrame, currentImage](VulkanBindCache& bindCache)
+        {
+            auto* vulkanShadowMap = pointLightShadowMap->getVulkanShadowMap();
+            auto bufferIndex = vulkanShadowMap->startRenderCommandBufferCreation(currentFrame, currentImage);
+            createDrawCommands(*_renderQueue, createRecordingContext(CommandsType::ShadowPassPointLights, bufferIndex, currentImage, bindCache));
+            vulkanShadowMap->endRenderCommandBufferCreation(currentFrame);
+        });
+    }
+
+    if (auto water = _sceneManager->getWater())
+    {
+        water->getVulkanWater()->reallocateCommandBuffers();
+        const auto addWaterRecording = [&](VulkanWater::PassType passType, CommandsType commandsType, uint32_t bufferIndex)
+        {
+            _recordings.emplace_back([this, water, skybox, passType, commandsType, bufferIndex, currentImage](VulkanBindCache& bindCache)
+            {
+                auto context = createRecordingContext(commandsType, bufferIndex, currentImage, bindCache);
+                water->getVulkanWater()->startRenderCommandBufferCreation(passType);
+                if (skybox)
+                    skybox->applyDrawingCommands(context);
+                createDrawCommands(*_renderQueue, context);
+                water->getVulkanWater()->endRenderCommandBufferCreation(passType);
+            });
+        };
+        addWaterRecording(VulkanWater::PassType::Reflection, CommandsType::ReflectionPass, BUFFER_INDEX_WATER_REFLECTION);
+        addWaterRecording(VulkanWater::PassType::Refraction, CommandsType::RefractionPass, BUFFER_INDEX_WATER_REFRACTION);
+    }
+
+    auto* screenQuad = _vulkanInstance->getScreenQuad();
+    if (screenQuad)
+    {
+        const auto addScreenQuadRecording = [&](VulkanScreenQuad::ScreenQuadPass quadPass, CommandsType commandsType,
+                                                uint32_t bufferIndex, bool drawSkybox)
+        {
+            screenQuad->reallocateCommandBuffers(quadPass);
+            _recordings.emplace_back([this, screenQuad, skybox, quadPass, commandsType, bufferIndex, drawSkybox, currentImage](VulkanBindCache& bindCache)
+            {
+                auto context = createRecordingContext(commandsType, bufferIndex, currentImage, bindCache);
+                screenQuad->startRenderCommandBufferCreation(quadPass);
+                if (skybox && drawSkybox)
+                    skybox->applyDrawingCommands(context);
+                createDrawCommands(*_renderQueue, context);
+                screenQuad->endRenderCommandBufferCreation(quadPass);
+            });
+        };
+        //addScreenQuadRecording(VulkanScreenQuad::Depth, CommandsType::ScreenQuadDepthPass, BUFFER_INDEX_SCREEN_QUAD_DEPTH, false);
+        addScreenQuadRecording(VulkanScreenQuad::Normal, CommandsType::ScreenQuadPass, BUFFER_INDEX_SCREEN_QUAD, true);
+        addScreenQuadRecording(VulkanScreenQuad::MRT, CommandsType::ScreenQuadMRTPass, BUFFER_INDEX_SCREEN_QUAD_MRT, false);
+        addScreenQuadRecording(VulkanScreenQuad::Late, CommandsType::ScreenQuadLatePass, BUFFER_INDEX_SCREEN_QUAD_LATE, false);
+
+        _postEffectManager->reallocateCommandBuffers();
+        _recordings.emplace_back([this, currentImage](VulkanBindCache& bindCache)
+        {
+            _postEffectManager->createCommands(currentImage, bindCache);
+        });
+    }
+
+    // Main pass buffers are allocated in VulkanInstance::reallocateCommandBuffers at frame start
+    auto* screenQuadMaterial = screenQuad ? _materialManager->getMaterial("ScreenQuad")->getVulkanMaterial() : nullptr;
+    if (screenQuadMaterial && !screenQuadMaterial->isInstanceValid(_screenQuadInstance))
+        _screenQuadInstance = screenQuadMaterial->createInstance();
+    auto screenQuadInstance = _screenQuadInstance;
+    _recordings.emplace_back([this, skybox, screenQuadMaterial, screenQuadInstance, currentFrame, currentImage](VulkanBindCache& bindCache)
+    {
+        auto context = createRecordingContext(CommandsType::MainPass, currentFrame, currentImage, bindCache);
+        _vulkanInstance->startRenderCommandBufferCreation();
+        if (screenQuadMaterial)
+        {
+            screenQuadMaterial->applyDrawingCommands(context, screenQuadInstance);
+            vkCmdDraw(context.commandBuffer, 6, 1, 0, 0);
+
+            // Draw GUI
+            _overlayManager->applyDrawingCommands(context);
+        } else
+        {
+            if (skybox)
+                skybox->applyDrawingCommands(context);
+            createDrawCommands(*_renderQueue, context);
+        }
+        _vulkanInstance->endRenderCommandBufferCreation();
+    });
+
+    runRecordings();
+}
+
+void Engine::runRecordings()
+{
+    // Every recording has own bind cache, command buffer and command pool, so they are independent
+    std::vector<VulkanBindCache> bindCaches(_recordings.size());
+    std::vector<std::future<void>> tasks;
+    if (_threadPool)
+    {
+        // Last recording (main pass) is done on main thread while workers record the rest
+        tasks.reserve(_recordings.size());
+        for (auto i = 0u; i + 1 < _recordings.size(); i++)
+        {
+            auto& recording = _recordings[i];
+            auto& bindCache = bindCaches[i];
+            tasks.push_back(_threadPool->addTask([&recording, &bindCache] { recording(bindCache); }));
+        }
+    }
+
+    // Workers must finish before exception is rethrown, they use recordings and caches from this frame
+    std::exception_ptr exception;
+    try
+    {
+        for (auto i = tasks.size(); i < _recordings.size(); i++)
+            _recordings[i](bindCaches[i]);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+    for (auto& task : tasks)
+        task.wait();
+    for (auto& task : tasks)
+        task.get();
+    if (exception)
+        std::rethrow_exception(exception);
+
+    VulkanBindCache::Statistics bindStatistics;
+    for (const auto& bindCache : bindCaches)
+        bindStatistics += bindCache.getStatistics();
+
+    _frameStatistics.recordingThreads = static_cast<uint32_t>(_threadPool ? std::min(_threadPool->getThreadCount() + 1, _recordings.size()) : 1);
+    _frameStatistics.pipelineBinds = bindStatistics.pipelineBinds;
+    _frameStatistics.pipelineBindsSkipped = bindStatistics.pipelineBindsSkipped;
+    _frameStatistics.geometryBinds = bindStatistics.geometryBinds;
+    _frameStatistics.geometryBindsSkipped = bindStatistics.geometryBindsSkipped;
 }
 
 float Engine::getTime()
@@ -553,9 +670,9 @@ void Engine::updateTime()
     _deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(_currentTime - _prevTime).count();
 }
 
-CommandsType Engine::getPassType() const
+const FrameStatistics& Engine::getFrameStatistics() const
 {
-    return _commandsType;
+    return _frameStatistics;
 }
 
 bool Engine::isShadowMappingEnabled() const
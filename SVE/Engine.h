@@ -6,10 +6,13 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <functional>
 #include <SDL2/SDL.h>
+#include "CommandsType.h"
 #include "EngineSettings.h"
 #include "SceneNode.h"
 #include "FileSystem.h"
+#include "MaterialInstance.h"
 
 namespace SVE
 {
@@ -18,31 +21,37 @@ class MaterialManager;
 class SceneManager;
 class ShaderManager;
 class MeshManager;
+class TextureManager;
 class ResourceManager;
 class ParticleSystemManager;
 class PostEffectManager;
 class FontManager;
 class OverlayManager;
 class PipelineCacheManager;
+class RenderQueue;
+class ThreadPool;
+class VulkanBindCache;
+class FrameUniforms;
 
-enum class CommandsType : uint8_t
+// CPU time of frame stages (milliseconds) and commands recording counters of the last frame
+struct FrameStatistics
 {
-    MainPass = 0,
-    ShadowPassDirectLight,
-    ShadowPassPointLights,
-    // ShadowPassSpotLight,
-    ReflectionPass,
-    RefractionPass,
-    ScreenQuadPass,
-    ScreenQuadMRTPass,  // for additional bloom output
-    ScreenQuadLatePass, // for particles or alike
-    ScreenQuadDepthPass,
-    ComputeParticlesPass,
-    PostEffectPasses,
+    float sceneUpdateTime = 0;
+    float cullingTime = 0;
+    float recordingTime = 0;
+    float uniformsUpdateTime = 0;
+    float submitTime = 0;
+
+    uint32_t recordingThreads = 0;
+    uint32_t pipelineBinds = 0;
+    uint32_t pipelineBindsSkipped = 0;
+    uint32_t geometryBinds = 0;
+    uint32_t geometryBindsSkipped = 0;
+    // Render queue draws, without instancing there would be drawCalls + mergedDrawCalls
+    uint32_t drawCalls = 0;
+    uint32_t mergedDrawCalls = 0;
 };
 
-static const uint8_t PassCount = 9;
-
 class Engine
 {
 public:
@@ -55,6 +64,7 @@ public:
     VulkanInstance* getVulkanInstance();
     MaterialManager* getMaterialManager();
     MeshManager* getMeshManager();
+    TextureManager* getTextureManager();
     ShaderManager* getShaderManager();
     SceneManager* getSceneManager();
     ResourceManager* getResourceManager();
@@ -78,7 +88,7 @@ public:
     bool isFirstRun() const;
     void setIsFirstRun(bool value);
 
-    CommandsType getPassType() const;
+    const FrameStatistics& getFrameStatistics() const;
     float getTime();
     float getDeltaTime();
 
@@ -91,13 +101,18 @@ private:
 
     void updateTime();
     void renderFrameImpl();
+    void recordPasses(uint32_t currentFrame, uint32_t currentImage);
+    void runRecordings();
+
 private:
+    using Recording = std::function<void(VulkanBindCache& bindCache)>;
+
     static Engine* _engineInstance;
     std::unique_ptr<VulkanInstance> _vulkanInstance;
-    CommandsType _commandsType = CommandsType::MainPass;
     std::unique_ptr<MaterialManager> _materialManager;
     std::unique_ptr<SceneManager> _sceneManager;
     std::unique_ptr<MeshManager> _meshManager;
+    std::unique_ptr<TextureManager> _textureManager;
     std::unique_ptr<ShaderManager> _shaderManager;
     std::unique_ptr<ResourceManager> _resourceManager;
     std::unique_ptr<ParticleSystemManager> _particleSystemManager;
@@ -105,6 +120,12 @@ private:
     std::unique_ptr<FontManager> _fontManager;
     std::unique_ptr<OverlayManager> _overlayManager;
     std::unique_ptr<PipelineCacheManager> _pipelineCacheManager;
+    std::unique_ptr<RenderQueue> _renderQueue;
+    std::unique_ptr<ThreadPool> _threadPool;
+    std::unique_ptr<FrameUniforms> _frameUniforms;
+    std::vector<Recording> _recordings;
+    FrameStatistics _frameStatistics;
+    MaterialInstance _screenQuadInstance;
 
     std::chrono::high_resolution_clock::time_point _startTime = std::chrono::high_resolution_clock::now();
     std::chrono::high_resolution_clock::time_point _currentTime = std::chrono::high_resolution_clock::now();
@@ -29,6 +29,8 @@ struct EngineSettings
     bool initWater = false;
     bool useCascadeShadowMap = false;
     bool particlesEnabled = true;
+    bool parallelRecording = true; // record passes command buffers on worker threads
+    uint32_t loadingThreads = 0; // threads reading and decoding resources, 0 - all cores, 1 - no worker threads
 
     static const int BEST_GPU_AVAILABLE;
     static const int BEST_MSAA_AVAILABLE;
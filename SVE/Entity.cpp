@@ -58,6 +58,26 @@ bool Entity::isInstanceRendering() const
     return false;
 }
 
+BoundingBox Entity::getBoundingBox() const
+{
+    return BoundingBox::infinite();
+}
+
+bool Entity::isDrawnInPass(CommandsType passType) const
+{
+    return true;
+}
+
+VulkanMaterial* Entity::getPassMaterial(CommandsType passType) const
+{
+    return nullptr;
+}
+
+VulkanMesh* Entity::getVulkanMesh() const
+{
+    return nullptr;
+}
+
 void Entity::setCustomData(glm::vec4 data)
 {
     _customVec4 = data;
@@ -88,11 +108,6 @@ MaterialInfo* Entity::getMaterialInfo()
     return nullptr;
 }
 
-void Entity::updateInstanceBuffers()
-{
-    // do nothing
-}
-
 bool Entity::isRenderToDepth() const
 {
     return _renderToDepth;
@@ -5,17 +5,18 @@
 #include <memory>
 #include <vector>
 #include <map>
-#include <glm/glm.hpp>
+#include "BoundingBox.h"
 
 namespace SVE
 {
-struct UniformData;
+class FrameUniforms;
 class SceneNode;
 struct MaterialInfo;
+class VulkanMaterial;
+class VulkanMesh;
+struct RecordingContext;
 enum class CommandsType : uint8_t;
 
-using UniformDataList = std::vector<std::shared_ptr<UniformData>>;
-
 // Base class for entities that can be attached to scene nodes
 class Entity : public std::enable_shared_from_this<Entity>
 {
@@ -44,14 +45,21 @@ public:
 
     virtual bool isComputeEntity() const;
     virtual bool isInstanceRendering() const;
+    // Bounds in scene node space used for culling, infinite if entity shouldn't be culled
+    virtual BoundingBox getBoundingBox() const;
+    // Render queue info: if entity draws anything in pass and which material it binds there (nullptr if unknown)
+    virtual bool isDrawnInPass(CommandsType passType) const;
+    virtual VulkanMaterial* getPassMaterial(CommandsType passType) const;
+    virtual VulkanMesh* getVulkanMesh() const;
 
     virtual void setMaterial(const std::string& materialName);
     virtual void setMaterialInfo(const MaterialInfo& materialInfo);
     virtual MaterialInfo* getMaterialInfo();
 
-    virtual void updateUniforms(UniformDataList uniformDataList) const = 0;
-    virtual void updateInstanceBuffers();
-    virtual void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const = 0;
+    // Fills object uniforms (allocated from frame uniforms) for materials of all passes
+    virtual void updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const = 0;
+    // Called from recording threads, shouldn't modify any shared state
+    virtual void applyDrawingCommands(const RecordingContext& context) const = 0;
 
     virtual void subscribeToAttachment(const std::string& name);
     virtual void unsubscribeFromAttachment(const std::string& name);
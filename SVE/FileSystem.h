@@ -10,6 +10,36 @@
 namespace SVE
 {
 
+// Read-only file content which keeps its memory alive.
+// Packed archive gives out views of mapped memory, other file systems wrap a copy.
+class FileView
+{
+public:
+    FileView() = default;
+    explicit FileView(std::string content)
+    {
+        auto holder = std::make_shared<std::string>(std::move(content));
+        _size = holder->size();
+        _data = std::shared_ptr<const char>(holder, holder->data());
+    }
+    FileView(std::shared_ptr<const char> data, size_t size)
+        : _data(std::move(data))
+        , _size(size)
+    {
+    }
+
+    const char* data() const { return _data.get(); }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    // Pointer to view data, can be used to keep it alive with aliasing pointers to its parts
+    const std::shared_ptr<const char>& getDataPtr() const { return _data; }
+    std::string toString() const { return std::string(data(), size()); }
+
+private:
+    std::shared_ptr<const char> _data;
+    size_t _size = 0;
+};
+
 class FileSystemEntity
 {
 public:
@@ -33,6 +63,11 @@ public:
     virtual FSEntityPtr getContainingDirectory(FSEntityPtr file) const = 0;
     virtual FSEntityList getFileList(FSEntityPtr dir) const = 0;
     virtual std::string getFileContent(FSEntityPtr file) const = 0;
+    // Content without copying if file system can map it
+    virtual FileView getFileView(FSEntityPtr file) const
+    {
+        return FileView(getFileContent(file));
+    }
     virtual std::string getSavePath() const = 0;
 
     virtual FSEntityPtr getEntity(const std::string& localPath, bool isDirectory = false) const = 0;
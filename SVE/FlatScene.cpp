@@ -0,0 +1,189 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "FlatScene.h"
+#include <algorithm>
+
+namespace SVE
+{
+
+namespace
+{
+
+uint32_t getVisiblePasses(const BoundingBox& box, const std::vector<FrustumList>& passFrustums, uint32_t passMask)
+{
+    if (box.isInfinite)
+        return passMask;
+    if (box.isEmpty())
+        return 0;
+
+    for (auto i = 0u; i < passFrustums.size(); i++)
+    {
+        if (!(passMask & (1u << i)) || passFrustums[i].empty())
+            continue;
+
+        bool isVisible = false;
+        for (const auto& frustum : passFrustums[i])
+        {
+            if (frustum.isVisible(box))
+            {
+                isVisible = true;
+                break;
+            }
+        }
+        if (!isVisible)
+            passMask &= ~(1u << i);
+    }
+    return passMask;
+}
+
+} // anon namespace
+
+constexpr int32_t FlatScene::NoParent;
+
+void FlatScene::update(const std::shared_ptr<SceneNode>& root)
+{
+    if (root == _root && SceneNode::getStructureVersion() == _structureVersion)
+        return;
+
+    _root = root;
+    _structureVersion = SceneNode::getStructureVersion();
+
+    _nodes.clear();
+    _parents.clear();
+    _subtreeEnds.clear();
+    _entityOffsets.clear();
+    _entities.clear();
+
+    if (_root)
+        addNode(_root.get(), NoParent);
+    _entityOffsets.push_back(static_cast<uint32_t>(_entities.size()));
+
+    auto nodeCount = _nodes.size();
+    _worldTransformations.resize(nodeCount);
+    _entitiesBounds.resize(nodeCount);
+    _subtreeBounds.resize(nodeCount);
+    // Everything is visible until first culling
+    _entitiesPassMasks.assign(nodeCount, ~0u);
+    _subtreePassMasks.assign(nodeCount, ~0u);
+}
+
+void FlatScene::addNode(SceneNode* node, int32_t parent)
+{
+    auto index = _nodes.size();
+    _nodes.push_back(node);
+    _parents.push_back(parent);
+    _subtreeEnds.push_back(0);
+    _entityOffsets.push_back(static_cast<uint32_t>(_entities.size()));
+    for (auto& entity : node->getAttachedEntities())
+    {
+        _entities.push_back(entity.get());
+    }
+
+    for (auto& child : node->getChildren())
+    {
+        addNode(child.get(), static_cast<int32_t>(index));
+    }
+    _subtreeEnds[index] = static_cast<uint32_t>(_nodes.size());
+}
+
+size_t FlatScene::getNodeCount() const
+{
+    return _nodes.size();
+}
+
+SceneNode* FlatScene::getNode(size_t index) const
+{
+    return _nodes[index];
+}
+
+int32_t FlatScene::getParent(size_t index) const
+{
+    return _parents[index];
+}
+
+size_t FlatScene::getSubtreeEnd(size_t index) const
+{
+    return _subtreeEnds[index];
+}
+
+FlatScene::EntityRange FlatScene::getEntities(size_t index) const
+{
+    return { _entities.data() + _entityOffsets[index], _entities.data() + _entityOffsets[index + 1] };
+}
+
+FlatScene::EntityRange FlatScene::getAllEntities() const
+{
+    return { _entities.data(), _entities.data() + _entities.size() };
+}
+
+void FlatScene::updateBounds()
+{
+    // Parents go before children, so world transformations are refreshed top-down
+    for (auto i = 0u; i < _nodes.size(); i++)
+    {
+        _worldTransformations[i] = _nodes[i]->getWorldTransformation();
+
+        BoundingBox entitiesBounds;
+        for (auto* entity : getEntities(i))
+        {
+            entitiesBounds.merge(entity->getBoundingBox().transform(_worldTransformations[i]));
+        }
+        _entitiesBounds[i] = entitiesBounds;
+        _subtreeBounds[i] = entitiesBounds;
+    }
+
+    // Children go after parents, so backward scan merges complete subtrees
+    for (auto i = _nodes.size(); i-- > 0;)
+    {
+        if (_parents[i] != NoParent)
+            _subtreeBounds[_parents[i]].merge(_subtreeBounds[i]);
+    }
+}
+
+void FlatScene::cull(const std::vector<FrustumList>& passFrustums, uint32_t activePassMask)
+{
+    for (auto i = 0u; i < _nodes.size();)
+    {
+        // Node can be visible only in passes where parent subtree is visible
+        auto passMask = _parents[i] == NoParent ? activePassMask : _subtreePassMasks[_parents[i]];
+        _subtreePassMasks[i] = getVisiblePasses(_subtreeBounds[i], passFrustums, passMask);
+        _entitiesPassMasks[i] = getVisiblePasses(_entitiesBounds[i], passFrustums, _subtreePassMasks[i]);
+
+        if (_subtreePassMasks[i])
+        {
+            ++i;
+        } else {
+            std::fill(_entitiesPassMasks.begin() + i, _entitiesPassMasks.begin() + _subtreeEnds[i], 0);
+            std::fill(_subtreePassMasks.begin() + i, _subtreePassMasks.begin() + _subtreeEnds[i], 0);
+            i = _subtreeEnds[i];
+        }
+    }
+}
+
+bool FlatScene::isEntitiesVisible(size_t index, uint32_t passMask) const
+{
+    return (_entitiesPassMasks[index] & passMask) != 0;
+}
+
+bool FlatScene::isSubtreeVisible(size_t index, uint32_t passMask) const
+{
+    return (_subtreePassMasks[index] & passMask) != 0;
+}
+
+uint32_t FlatScene::getEntitiesPassMask(size_t index) const
+{
+    return _entitiesPassMasks[index];
+}
+
+const BoundingBox& FlatScene::getEntitiesBounds(size_t index) const
+{
+    return _entitiesBounds[index];
+}
+
+uint32_t FlatScene::getSubtreePassMask(size_t index) const
+{
+    return _subtreePassMasks[index];
+}
+
+} // namespace SVE
\ No newline at end of file
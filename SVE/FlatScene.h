@@ -0,0 +1,72 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "SceneNode.h"
+#include "Frustum.h"
+#include <memory>
+#include <vector>
+
+namespace SVE
+{
+
+// Scene graph flattened to arrays in depth-first order, so per frame traversals are linear scans.
+// It's rebuilt only when scene structure changes, SceneNode stays the interface for scene editing.
+// Node subtree occupies index range [index, subtreeEnd), so whole subtree can be skipped with one jump.
+class FlatScene
+{
+public:
+    static constexpr int32_t NoParent = -1;
+
+    struct EntityRange
+    {
+        Entity* const* first;
+        Entity* const* last;
+
+        Entity* const* begin() const { return first; }
+        Entity* const* end() const { return last; }
+    };
+
+    // Rebuild arrays if scene structure changed since last call
+    void update(const std::shared_ptr<SceneNode>& root);
+
+    size_t getNodeCount() const;
+    SceneNode* getNode(size_t index) const;
+    int32_t getParent(size_t index) const;
+    size_t getSubtreeEnd(size_t index) const;
+    EntityRange getEntities(size_t index) const;
+    // All entities of the scene in depth-first order
+    EntityRange getAllEntities() const;
+
+    // Update world transformations and bounds of all nodes
+    void updateBounds();
+    // Calculate visibility masks (bit per CommandsType), passFrustums are indexed by CommandsType
+    void cull(const std::vector<FrustumList>& passFrustums, uint32_t activePassMask);
+    bool isEntitiesVisible(size_t index, uint32_t passMask) const;
+    bool isSubtreeVisible(size_t index, uint32_t passMask) const;
+    uint32_t getEntitiesPassMask(size_t index) const;
+    const BoundingBox& getEntitiesBounds(size_t index) const;
+    uint32_t getSubtreePassMask(size_t index) const;
+
+private:
+    void addNode(SceneNode* node, int32_t parent);
+
+private:
+    std::shared_ptr<SceneNode> _root;
+    uint64_t _structureVersion = 0;
+
+    std::vector<SceneNode*> _nodes;
+    std::vector<int32_t> _parents;
+    std::vector<uint32_t> _subtreeEnds;
+    // Entities of node i are in range [_entityOffsets[i], _entityOffsets[i + 1])
+    std::vector<uint32_t> _entityOffsets;
+    std::vector<Entity*> _entities;
+
+    std::vector<glm::mat4> _worldTransformations;
+    std::vector<BoundingBox> _entitiesBounds;
+    std::vector<BoundingBox> _subtreeBounds;
+    std::vector<uint32_t> _entitiesPassMasks;
+    std::vector<uint32_t> _subtreePassMasks;
+};
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,95 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "FrameUniforms.h"
+#include "CommandsType.h"
+#include "Utils.h"
+#include <algorithm>
+
+namespace SVE
+{
+
+namespace
+{
+
+constexpr size_t ArenaPageSize = 64 * 1024;
+
+size_t alignOffset(size_t offset, size_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // anon namespace
+
+FrameUniforms::FrameUniforms()
+    : _passDataList(PassCount)
+{
+}
+
+void FrameUniforms::reset()
+{
+    for (auto& passData : _passDataList)
+    {
+        passData.viewProjectionList.clear();
+        passData.lightDirectViewProjectionList.clear();
+        passData.lightPointViewProjectionList.clear();
+        passData.shadowPointLightList.clear();
+        passData.pointLightList.clear();
+        passData.lineLightList.clear();
+        passData.dirLight = {};
+        passData.spotLight = {};
+        passData.lightInfo = {};
+    }
+
+    _currentPage = 0;
+    _pageOffset = 0;
+}
+
+void FrameUniforms::updateViewProjections()
+{
+    for (auto& passData : _passDataList)
+        passData.viewProjection = passData.projection * passData.view;
+}
+
+PassUniformData& FrameUniforms::getPassData(CommandsType passType)
+{
+    return _passDataList[toInt(passType)];
+}
+
+const PassUniformData& FrameUniforms::getPassData(CommandsType passType) const
+{
+    return _passDataList[toInt(passType)];
+}
+
+ObjectUniformData& FrameUniforms::createObjectData(const glm::mat4& model)
+{
+    const auto& mainData = getPassData(CommandsType::MainPass);
+    auto* objectData = allocateArray<ObjectUniformData>(1);
+    objectData->model = model;
+    objectData->time = mainData.time;
+    objectData->deltaTime = mainData.deltaTime;
+    return *objectData;
+}
+
+void* FrameUniforms::allocate(size_t size, size_t alignment)
+{
+    while (_currentPage < _arenaPages.size())
+    {
+        auto& page = _arenaPages[_currentPage];
+        auto offset = alignOffset(_pageOffset, alignment);
+        if (offset + size <= page.size())
+        {
+            _pageOffset = offset + size;
+            return page.data() + offset;
+        }
+        ++_currentPage;
+        _pageOffset = 0;
+    }
+
+    // Only during warm-up: new page is kept for next frames. Page start is aligned by operator new.
+    _arenaPages.emplace_back(std::max(size, ArenaPageSize));
+    _pageOffset = size;
+    return _arenaPages.back().data();
+}
+
+} // namespace SVE
\ No newline at end of file
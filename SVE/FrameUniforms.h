@@ -0,0 +1,55 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "ShaderSettings.h"
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace SVE
+{
+enum class CommandsType : uint8_t;
+
+// Uniforms of current frame: pass blocks filled once per frame (camera, lights)
+// and linear arena for object blocks and their arrays (bones, text symbols).
+// Created once and reused every frame, arena pages are kept on reset,
+// so after first frames uniforms update doesn't allocate memory.
+class FrameUniforms
+{
+public:
+    FrameUniforms();
+
+    // Clears pass lists keeping their capacity and rewinds arena
+    void reset();
+
+    // Derived pass data, called once pass blocks are filled by camera, lights and water
+    void updateViewProjections();
+
+    PassUniformData& getPassData(CommandsType passType);
+    const PassUniformData& getPassData(CommandsType passType) const;
+
+    // Object block lives until next reset, time is taken from main pass
+    ObjectUniformData& createObjectData(const glm::mat4& model);
+
+    template <typename T>
+    T* allocateArray(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena doesn't call destructors");
+        auto* data = reinterpret_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        for (auto i = 0u; i < count; i++)
+            new (data + i) T();
+        return data;
+    }
+
+private:
+    void* allocate(size_t size, size_t alignment);
+
+private:
+    std::vector<PassUniformData> _passDataList;
+    std::vector<std::vector<char>> _arenaPages;
+    size_t _currentPage = 0;
+    size_t _pageOffset = 0;
+};
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,42 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "Frustum.h"
+
+namespace SVE
+{
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+    // Gribb-Hartmann extraction, rows of matrix are combined to get clip planes
+    auto m = glm::transpose(viewProjection);
+    _planes[0] = m[3] + m[0]; // left
+    _planes[1] = m[3] - m[0]; // right
+    _planes[2] = m[3] + m[1]; // bottom
+    _planes[3] = m[3] - m[1]; // top
+    // Depth is in [0, 1] range, but [-1, 1] near plane is used as it's more conservative
+    _planes[4] = m[3] + m[2]; // near
+    _planes[5] = m[3] - m[2]; // far
+}
+
+bool Frustum::isVisible(const BoundingBox& box) const
+{
+    if (box.isInfinite)
+        return true;
+    if (box.isEmpty())
+        return false;
+
+    for (const auto& plane : _planes)
+    {
+        // Check the box corner which is farthest along plane normal
+        glm::vec3 corner(plane.x >= 0 ? box.max.x : box.min.x,
+                         plane.y >= 0 ? box.max.y : box.min.y,
+                         plane.z >= 0 ? box.max.z : box.min.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,26 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "BoundingBox.h"
+#include <vector>
+
+namespace SVE
+{
+
+// View frustum planes extracted from view-projection matrix
+class Frustum
+{
+public:
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    bool isVisible(const BoundingBox& box) const;
+
+private:
+    // (Nx, Ny, Nz, D), normals point inside
+    glm::vec4 _planes[6];
+};
+
+using FrustumList = std::vector<Frustum>;
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,206 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "KtxTexture.h"
+#include "VulkanException.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SVE
+{
+namespace
+{
+
+const uint8_t KtxIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+struct KtxHeader
+{
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+
+struct KtxLevelIndex
+{
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+
+static_assert(sizeof(KtxHeader) == 80, "KTX2 header should be packed");
+static_assert(sizeof(KtxLevelIndex) == 24, "KTX2 level index should be packed");
+
+const TextureFormatInfo textureFormats[] {
+        { VK_FORMAT_R8G8B8A8_UNORM,                 1, 1, 4 },
+        { VK_FORMAT_BC7_UNORM_BLOCK,                4, 4, 16 },
+        { VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,      4, 4, 16 },
+        { VK_FORMAT_ASTC_4x4_UNORM_BLOCK,           4, 4, 16 },
+};
+
+// Basic data format descriptor of RGBA8 (linear, straight alpha), required by KTX2 for every file
+void appendRGBA8Descriptor(std::string& data)
+{
+    const auto append = [&data](const auto& value)
+    {
+        data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    const uint16_t blockSize = 24 + 4 * 16;
+    append(static_cast<uint32_t>(4 + blockSize));   // total descriptor size
+    append(static_cast<uint32_t>(0));               // vendor (Khronos) and descriptor type (basic)
+    append(static_cast<uint16_t>(2));               // version
+    append(blockSize);
+    const uint8_t model[4] = {1, 1, 1, 0};          // RGBSDA model, BT709 primaries, linear transfer, straight alpha
+    append(model);
+    const uint8_t texelBlockDimensions[4] = {0, 0, 0, 0};
+    append(texelBlockDimensions);
+    const uint8_t bytesPlane[8] = {4, 0, 0, 0, 0, 0, 0, 0};
+    append(bytesPlane);
+
+    const uint8_t channels[4] = {0, 1, 2, 15};      // R, G, B, A
+    for (auto i = 0u; i < 4; i++)
+    {
+        append(static_cast<uint16_t>(i * 8));       // bit offset
+        append(static_cast<uint8_t>(7));            // bit length - 1
+        append(channels[i]);
+        append(static_cast<uint32_t>(0));           // sample position
+        append(static_cast<uint32_t>(0));           // lower
+        append(static_cast<uint32_t>(255));         // upper
+    }
+}
+
+} // anon namespace
+
+const TextureFormatInfo* getTextureFormatInfo(VkFormat format)
+{
+    for (const auto& formatInfo : textureFormats)
+    {
+        if (formatInfo.format == format)
+            return &formatInfo;
+    }
+    return nullptr;
+}
+
+VkDeviceSize getTextureLevelSize(const TextureFormatInfo& formatInfo, uint32_t width, uint32_t height)
+{
+    VkDeviceSize blocksX = (width + formatInfo.blockWidth - 1) / formatInfo.blockWidth;
+    VkDeviceSize blocksY = (height + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
+    return blocksX * blocksY * formatInfo.blockSize;
+}
+
+bool isKtxTexture(const FileView& data)
+{
+    return data.size() >= sizeof(KtxHeader) && memcmp(data.data(), KtxIdentifier, sizeof(KtxIdentifier)) == 0;
+}
+
+KtxTextureInfo readKtxTexture(const FileView& data)
+{
+    if (!isKtxTexture(data))
+        throw VulkanException("Data isn't a KTX2 texture");
+
+    KtxHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+
+    if (header.supercompressionScheme != 0)
+        throw VulkanException("Supercompressed KTX2 textures aren't supported");
+    if (header.pixelDepth != 0 || header.layerCount != 0 || header.faceCount != 1)
+        throw VulkanException("Only 2D KTX2 textures are supported");
+    if (header.pixelWidth == 0 || header.pixelHeight == 0)
+        throw VulkanException("Incorrect KTX2 texture size");
+
+    const auto* formatInfo = getTextureFormatInfo(static_cast<VkFormat>(header.vkFormat));
+    if (!formatInfo)
+        throw VulkanException("Unsupported KTX2 texture format " + std::to_string(header.vkFormat));
+
+    // Zero level count means mips should be generated on load, it's the same as single level here
+    auto levelCount = std::max(header.levelCount, 1u);
+    auto maxLevelCount = static_cast<uint32_t>(std::floor(std::log2(std::max(header.pixelWidth, header.pixelHeight)))) + 1;
+    if (levelCount > maxLevelCount)
+        throw VulkanException("Incorrect KTX2 texture mip levels count");
+    if (sizeof(KtxHeader) + levelCount * sizeof(KtxLevelIndex) > data.size())
+        throw VulkanException("KTX2 texture data is corrupted");
+
+    KtxTextureInfo textureInfo {};
+    textureInfo.format = formatInfo->format;
+    textureInfo.width = header.pixelWidth;
+    textureInfo.height = header.pixelHeight;
+    textureInfo.levels.resize(levelCount);
+    for (auto i = 0u; i < levelCount; i++)
+    {
+        KtxLevelIndex levelIndex;
+        memcpy(&levelIndex, data.data() + sizeof(KtxHeader) + i * sizeof(KtxLevelIndex), sizeof(levelIndex));
+
+        auto& level = textureInfo.levels[i];
+        level.width = std::max(header.pixelWidth >> i, 1u);
+        level.height = std::max(header.pixelHeight >> i, 1u);
+        level.offset = levelIndex.byteOffset;
+        level.size = levelIndex.byteLength;
+        if (level.size != getTextureLevelSize(*formatInfo, level.width, level.height))
+            throw VulkanException("Incorrect KTX2 texture level " + std::to_string(i) + " size");
+        if (level.offset > data.size() || level.size > data.size() - level.offset)
+            throw VulkanException("KTX2 texture data is corrupted");
+    }
+
+    return textureInfo;
+}
+
+std::string writeKtxTexture(uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels)
+{
+    const auto& formatInfo = *getTextureFormatInfo(VK_FORMAT_R8G8B8A8_UNORM);
+    auto levelCount = static_cast<uint32_t>(levels.size());
+
+    KtxHeader header {};
+    memcpy(header.identifier, KtxIdentifier, sizeof(KtxIdentifier));
+    header.vkFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    header.typeSize = 1;
+    header.pixelWidth = width;
+    header.pixelHeight = height;
+    header.faceCount = 1;
+    header.levelCount = levelCount;
+
+    std::string descriptor;
+    appendRGBA8Descriptor(descriptor);
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(KtxHeader) + levelCount * sizeof(KtxLevelIndex));
+    header.dfdByteLength = static_cast<uint32_t>(descriptor.size());
+
+    // Levels are stored from the smallest one, RGBA8 level sizes keep 4 byte alignment
+    std::vector<KtxLevelIndex> levelIndexes(levelCount);
+    uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+    for (auto i = levelCount; i > 0; i--)
+    {
+        auto level = i - 1;
+        auto levelSize = getTextureLevelSize(formatInfo, std::max(width >> level, 1u), std::max(height >> level, 1u));
+        if (levels[level].size() != levelSize)
+            throw VulkanException("Incorrect texture level " + std::to_string(level) + " size");
+
+        levelIndexes[level] = { offset, levelSize, levelSize };
+        offset += levelSize;
+    }
+
+    std::string data;
+    data.reserve(offset);
+    data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    data.append(reinterpret_cast<const char*>(levelIndexes.data()), levelIndexes.size() * sizeof(KtxLevelIndex));
+    data.append(descriptor);
+    for (auto i = levelCount; i > 0; i--)
+        data.append(reinterpret_cast<const char*>(levels[i - 1].data()), levels[i - 1].size());
+
+    return data;
+}
+
+} // namespace SVE
\ No newline at end of file
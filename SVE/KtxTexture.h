@@ -0,0 +1,51 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "FileSystem.h"
+#include "VulkanHeaders.h"
+#include <string>
+#include <vector>
+
+namespace SVE
+{
+
+// KTX2 container with full mip chain baked offline (2D, no supercompression).
+// Reading and validation doesn't use Vulkan device, so files can be checked without GPU.
+
+struct TextureFormatInfo
+{
+    VkFormat format;
+    uint32_t blockWidth;
+    uint32_t blockHeight;
+    uint32_t blockSize;
+};
+
+struct TextureLevel
+{
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    uint32_t width;
+    uint32_t height;
+};
+
+struct KtxTextureInfo
+{
+    VkFormat format;
+    uint32_t width;
+    uint32_t height;
+    // Level 0 is the largest, offsets are from file start
+    std::vector<TextureLevel> levels;
+};
+
+// Null if format can't be loaded from KTX file (only RGBA8, BC7, ETC2 RGBA and ASTC 4x4 are supported)
+const TextureFormatInfo* getTextureFormatInfo(VkFormat format);
+VkDeviceSize getTextureLevelSize(const TextureFormatInfo& formatInfo, uint32_t width, uint32_t height);
+
+bool isKtxTexture(const FileView& data);
+// Throws if header, format or level sizes are invalid
+KtxTextureInfo readKtxTexture(const FileView& data);
+// Only uncompressed RGBA8 can be written, compressed files are produced by external encoders
+std::string writeKtxTexture(uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels);
+
+} // namespace SVE
\ No newline at end of file
@@ -93,7 +93,7 @@ std::pair<glm::vec4, glm::vec2> LightManager::getDirectShadowOrtho() const
     return { _shadowCameraFrame, _shadowCameraNearFar };
 }
 
-void LightManager::fillUniformData(UniformData& data, LightType viewSourceLightType)
+void LightManager::fillUniformData(PassUniformData& data, LightType viewSourceLightType)
 {
     data.lightPointViewProjectionList.resize(MAX_LIGHTS);
     auto activeLights = 0;
@@ -34,7 +34,7 @@ public:
     std::pair<glm::vec4, glm::vec2> getDirectShadowOrtho() const;
 
     void setCurrentFrame(uint64_t frame);
-    void fillUniformData(UniformData& data, LightType viewSourceLightType = LightType::None);
+    void fillUniformData(PassUniformData& data, LightType viewSourceLightType = LightType::None);
 
 private:
     std::set<LightNode*> _lightList;
@@ -56,7 +56,7 @@ void LightNode::updateViewMatrix(glm::vec3 cameraPos, glm::vec3 cameraDir)
     }
 }
 
-void LightNode::fillUniformData(UniformData& data, uint32_t lightNum, bool asViewSource)
+void LightNode::fillUniformData(PassUniformData& data, uint32_t lightNum, bool asViewSource)
 {
     //updateViewMatrix(data.cameraPos);
 
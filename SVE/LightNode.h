@@ -8,6 +8,7 @@
 namespace SVE
 {
 class ShadowMap;
+struct PassUniformData;
 
 class LightNode : public SceneNode
 {
@@ -20,7 +21,7 @@ public:
 
     LightSettings& getLightSettings();
     void updateViewMatrix(glm::vec3 cameraPos, glm::vec3 cameraDir);
-    void fillUniformData(UniformData& data, uint32_t lightNum, bool asViewSource);
+    void fillUniformData(PassUniformData& data, uint32_t lightNum, bool asViewSource);
     bool castShadows() const;
 
     void setNodeTransformation(glm::mat4 transform) override;
@@ -0,0 +1,19 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <cstdint>
+
+namespace SVE
+{
+
+// Handle of material instance (uniform data of one entity in one pass).
+// Slots of deleted instances are reused, so generation is checked to catch handles of deleted instances.
+// Valid instances never have zero generation, default handle is always invalid.
+struct MaterialInstance
+{
+    uint32_t index = 0;
+    uint32_t generation = 0;
+};
+
+} // namespace SVE
\ No newline at end of file
@@ -91,9 +91,9 @@ struct MaterialSettings
     bool useMultisampling = true;
     bool useAlphaBlending = false;
     bool useMRT = false;
-    bool useInstancing = false;
+    bool useInstancing = false; // set by material if vertex shader reads model matrix list
     bool ignoreShadow = true;
-    uint32_t instanceMaxCount = 0;
+    uint32_t instanceMaxCount = 0; // instances of all passes in one frame, default is used if 0
     BlendFactor srcBlendFactor = BlendFactor::SrcAlpha;
     BlendFactor dstBlendFactor = BlendFactor::OneMinusSrcAlpha;
     MaterialCullFace cullFace = MaterialCullFace::FrontFace;
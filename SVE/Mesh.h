@@ -3,12 +3,14 @@
 // Licensed under the MIT License
 #pragma once
 #include "MeshSettings.h"
+#include "BoundingBox.h"
 #include <memory>
 
 namespace SVE
 {
 class VulkanMesh;
-class UniformData;
+class FrameUniforms;
+struct ObjectUniformData;
 
 class Mesh
 {
@@ -17,22 +19,38 @@ public:
     explicit Mesh(MeshLoadSettings meshLoadSettings);
     ~Mesh();
 
+    // Reads and converts mesh file, doesn't create GPU objects so it can be called from any thread
+    static MeshSettings importMeshSettings(const MeshLoadSettings& meshLoadSettings);
+
     const std::string& getName() const;
     const std::string& getDefaultMaterialName() const;
     VulkanMesh* getVulkanMesh();
+    // Bounds in mesh space, infinite for animated meshes
+    const BoundingBox& getBoundingBox() const;
+    // Source data is kept only for dynamic meshes, null otherwise
+    const MeshSettings* getSourceData() const;
 
     void updateMesh(MeshSettings meshSettings);
 
     // TODO: this should be moved to something like Animation class
-    void updateUniformDataBones(UniformData& data, float time, BonesAttachments& bonesAttachments);
+    // Bones are allocated from frame uniforms arena
+    void updateUniformDataBones(FrameUniforms& frameUniforms, ObjectUniformData& data, float time, BonesAttachments& bonesAttachments);
+
+private:
+    void init(MeshSettings meshSettings);
 
 private:
     std::string _name;
     std::string _materialName;
 
-    bool _isAnimated;
+    bool _isAnimated = false;
+    BoundingBox _boundingBox;
+    std::shared_ptr<AnimationSettings> _animation;
+    uint32_t _boneNum = 0;
+    float _animationSpeed = 1.0f;
 
     std::unique_ptr<VulkanMesh> _vulkanMesh;
+    std::unique_ptr<MeshSettings> _sourceData;
 };
 
 } // namespace SVE
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "VulkanMesh.h"
 #include "VulkanMaterial.h"
 #include "ShaderSettings.h"
+#include "FrameUniforms.h"
+#include "RecordingContext.h"
 #include "Utils.h"
 
 namespace SVE
@@ -35,22 +37,12 @@ MeshEntity::MeshEntity(Mesh* mesh)
 
 MeshEntity::~MeshEntity()
 {
-    if (_material)
-    {
-        _material->getVulkanMaterial()->deleteInstancesForEntity(this);
-    }
-    if (_shadowMaterial)
-    {
-        _shadowMaterial->getVulkanMaterial()->deleteInstancesForEntity(this);
-    }
-    if (_pointLightShadowMaterial)
-    {
-        _pointLightShadowMaterial->getVulkanMaterial()->deleteInstancesForEntity(this);
-    }
+    deleteMaterialInstances();
 }
 
 void MeshEntity::setMaterial(const std::string& materialName)
 {
+    deleteMaterialInstances();
     _material = Engine::getInstance()->getMaterialManager()->getMaterial(materialName);
     _materialInfo.ignoreShadow = static_cast<uint32_t>(_material->getVulkanMaterial()->getSettings().ignoreShadow);
     setupMaterial();
@@ -66,137 +58,94 @@ void MeshEntity::setIsReflected(bool isReflected)
     _isReflected = isReflected;
 }
 
-void MeshEntity::updateUniforms(UniformDataList uniformDataList) const
+void MeshEntity::updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const
 {
-    for (auto& uniformData : uniformDataList)
-    {
-        // TODO: Load material info data from resources
-        uniformData->materialInfo = _materialInfo;
-    }
-
-    UniformData newData = *uniformDataList[toInt(CommandsType::MainPass)];
+    // Updates are skipped while entity is culled, so advance by time passed since last update
+    auto currentTime = Engine::getInstance()->getTime();
+    auto deltaTime = _lastUpdateTime < 0 ? Engine::getInstance()->getDeltaTime() : currentTime - _lastUpdateTime;
+    _lastUpdateTime = currentTime;
 
     if (!_isTimePaused)
-        _time += Engine::getInstance()->getDeltaTime();
-    newData.time = _time;
-    newData.customFloat = _customFloat;
-    newData.customVec4 = _customVec4;
-    newData.customMat4 = _customMat4;
+        _time += deltaTime;
+
+    auto& objectData = frameUniforms.createObjectData(model);
+    // TODO: Load material info data from resources
+    objectData.materialInfo = _materialInfo;
+    objectData.time = _time;
+    objectData.customFloat = _customFloat;
+    objectData.customVec4 = _customVec4;
+    objectData.customMat4 = _customMat4;
 
     if (_animationState == AnimationState::Play && !_isTimePaused)
-        _animationTime += Engine::getInstance()->getDeltaTime();
-    _mesh->updateUniformDataBones(newData, _animationTime, _attachments);
-    _material->getVulkanMaterial()->setUniformData(_materialIndex, newData);
+        _animationTime += deltaTime;
+    _mesh->updateUniformDataBones(frameUniforms, objectData, _animationTime, _attachments);
 
-    if (_shadowMaterial)
+    // Object block (with bones) is shared by all passes, only pass block differs
+    const auto setPassUniforms = [&frameUniforms, &objectData](Material* material, MaterialInstance instance, CommandsType passType)
     {
-        UniformData newShadowData = *uniformDataList[toInt(CommandsType::ShadowPassDirectLight)];
-        newShadowData.bones = newData.bones;
-        _shadowMaterial->getVulkanMaterial()->setUniformData(
-                _shadowIndex,
-                newShadowData);
+        material->getVulkanMaterial()->setUniformData(instance, { frameUniforms.getPassData(passType), objectData });
+    };
 
+    setPassUniforms(_material, _materialInstance, CommandsType::MainPass);
+    if (_shadowMaterial)
+    {
+        setPassUniforms(_shadowMaterial, _shadowInstance, CommandsType::ShadowPassDirectLight);
         if (_renderToDepth)
-        {
-            UniformData depthData = *uniformDataList[toInt(CommandsType::ScreenQuadDepthPass)];
-            depthData.bones = newData.bones;
-            _shadowMaterial->getVulkanMaterial()->setUniformData(
-                    _depthIndex,
-                    depthData);
-        }
+            setPassUniforms(_shadowMaterial, _depthInstance, CommandsType::ScreenQuadDepthPass);
     }
     if (_pointLightShadowMaterial)
     {
-        UniformData newShadowData = *uniformDataList[toInt(CommandsType::ShadowPassPointLights)];
-        newShadowData.bones = newData.bones;
-        _pointLightShadowMaterial->getVulkanMaterial()->setUniformData(
-                _pointLightShadowMaterial->getVulkanMaterial()->getInstanceForEntity(this),
-                newShadowData);
+        setPassUniforms(_pointLightShadowMaterial, _pointLightShadowInstance, CommandsType::ShadowPassPointLights);
     }
     if (Engine::getInstance()->isWaterEnabled())
     {
-        UniformData newReflectionData = *uniformDataList[toInt(CommandsType::ReflectionPass)];
-        newReflectionData.bones = newData.bones;
-        _material->getVulkanMaterial()->setUniformData(_reflectionMaterialIndex, newReflectionData);
-
-        UniformData newRefractionData = *uniformDataList[toInt(CommandsType::RefractionPass)];
-        newRefractionData.bones = newData.bones;
-        _material->getVulkanMaterial()->setUniformData(_refractionMaterialIndex, newRefractionData);
+        setPassUniforms(_material, _reflectionMaterialInstance, CommandsType::ReflectionPass);
+        setPassUniforms(_material, _refractionMaterialInstance, CommandsType::RefractionPass);
     }
 }
 
-void MeshEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
+void MeshEntity::applyDrawingCommands(const RecordingContext& context) const
 {
-    if (Engine::getInstance()->getPassType() == CommandsType::ReflectionPass)
-    {
-        if (!_isReflected)
-            return;
-        _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _reflectionMaterialIndex);
-
-    } else if (Engine::getInstance()->getPassType() == CommandsType::RefractionPass)
-    {
-        if (!_isReflected)
-            return;
+    if (!isDrawnInPass(context.passType))
+        return;
 
-        _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _refractionMaterialIndex);
-    }
-    else if (Engine::getInstance()->getPassType() == CommandsType::ShadowPassDirectLight)
-    {
-        if (!_castShadows || !_shadowMaterial)
-            return;
-
-        _shadowMaterial->getVulkanMaterial()->applyDrawingCommands(
-                bufferIndex,
-                imageIndex,
-                _shadowIndex);
-    }
-    else if (Engine::getInstance()->getPassType() == CommandsType::ShadowPassPointLights)
-    {
-        if (!_castShadows || !_pointLightShadowMaterial)
-            return;
-        _pointLightShadowMaterial->getVulkanMaterial()->applyDrawingCommands(
-                bufferIndex,
-                imageIndex,
-                _pointLightShadowMaterial->getVulkanMaterial()->getInstanceForEntity(this));
-    }
-    else if (Engine::getInstance()->getPassType() == CommandsType::ScreenQuadDepthPass)
-    {
-        if (!_renderToDepth)
-            return;
-
-        if (_shadowMaterial)
-            _shadowMaterial->getVulkanMaterial()->applyDrawingCommands(
-                    bufferIndex,
-                    imageIndex,
-                    _depthIndex);
-    }
-    else
+    const auto vertexFormat = _mesh->getVulkanMesh()->getVertexFormat();
+    switch (context.passType)
     {
-        bool isMRTPass = Engine::getInstance()->getPassType() == CommandsType::ScreenQuadMRTPass;
-        if (isMRTPass != _material->isMRT())
-            return;
-        _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _materialIndex);
+        case CommandsType::ReflectionPass:
+            _material->getVulkanMaterial()->applyDrawingCommands(context, _reflectionMaterialInstance, vertexFormat);
+            break;
+        case CommandsType::RefractionPass:
+            _material->getVulkanMaterial()->applyDrawingCommands(context, _refractionMaterialInstance, vertexFormat);
+            break;
+        case CommandsType::ShadowPassDirectLight:
+            _shadowMaterial->getVulkanMaterial()->applyDrawingCommands(context, _shadowInstance, vertexFormat);
+            break;
+        case CommandsType::ShadowPassPointLights:
+            _pointLightShadowMaterial->getVulkanMaterial()->applyDrawingCommands(context, _pointLightShadowInstance, vertexFormat);
+            break;
+        case CommandsType::ScreenQuadDepthPass:
+            _shadowMaterial->getVulkanMaterial()->applyDrawingCommands(context, _depthInstance, vertexFormat);
+            break;
+        default:
+            _material->getVulkanMaterial()->applyDrawingCommands(context, _materialInstance, vertexFormat);
     }
 
-    if (!isInstanceRendering() ||
-        !_material->getVulkanMaterial()->isInstancesRendered() || _material->getVulkanMaterial()->isMainInstance(_materialIndex))
-    {
-        _mesh->getVulkanMesh()->applyDrawingCommands(bufferIndex, _material->getVulkanMaterial()->getInstanceCount());
-        _material->getVulkanMaterial()->setInstancedRendered();
-        _material->getVulkanMaterial()->setMainInstance(_materialIndex);
-        if (_shadowMaterial)
-            _shadowMaterial->getVulkanMaterial()->setMainInstance(_materialIndex);
-    }
+    // Batched item draws instances of all entities from its run, range is in context
+    _mesh->getVulkanMesh()->applyDrawingCommands(context);
 }
 
 void MeshEntity::setupMaterial()
 {
-    _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
+    // Pipelines are created here, recording can't create them
+    const auto vertexFormat = _mesh->getVulkanMesh()->getVertexFormat();
+    _material->getVulkanMaterial()->preparePipeline(vertexFormat);
+    _materialInstance = _material->getVulkanMaterial()->createInstance();
 
     if (Engine::getInstance()->isWaterEnabled())
     {
-        _reflectionMaterialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this, 1);
-        _refractionMaterialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this, 2);
+        _reflectionMaterialInstance = _material->getVulkanMaterial()->createInstance();
+        _refractionMaterialInstance = _material->getVulkanMaterial()->createInstance();
     }
 
     if (Engine::getInstance()->isShadowMappingEnabled())
@@ -215,8 +164,34 @@ void MeshEntity::setupMaterial()
             //_pointLightShadowMaterial = Engine::getInstance()->getMaterialManager()->getMaterial("FullDepth");
         }
 
-        _shadowIndex = _shadowMaterial->getVulkanMaterial()->getInstanceForEntity(this, 0);
-        _depthIndex = _shadowMaterial->getVulkanMaterial()->getInstanceForEntity(this, 1);
+        _shadowMaterial->getVulkanMaterial()->preparePipeline(vertexFormat);
+        _shadowInstance = _shadowMaterial->getVulkanMaterial()->createInstance();
+        _depthInstance = _shadowMaterial->getVulkanMaterial()->createInstance();
+        if (_pointLightShadowMaterial)
+        {
+            _pointLightShadowMaterial->getVulkanMaterial()->preparePipeline(vertexFormat);
+            _pointLightShadowInstance = _pointLightShadowMaterial->getVulkanMaterial()->createInstance();
+        }
+    }
+}
+
+void MeshEntity::deleteMaterialInstances()
+{
+    // Deleting invalid (never created) instance is no-op
+    if (_material)
+    {
+        _material->getVulkanMaterial()->deleteInstance(_materialInstance);
+        _material->getVulkanMaterial()->deleteInstance(_reflectionMaterialInstance);
+        _material->getVulkanMaterial()->deleteInstance(_refractionMaterialInstance);
+    }
+    if (_shadowMaterial)
+    {
+        _shadowMaterial->getVulkanMaterial()->deleteInstance(_shadowInstance);
+        _shadowMaterial->getVulkanMaterial()->deleteInstance(_depthInstance);
+    }
+    if (_pointLightShadowMaterial)
+    {
+        _pointLightShadowMaterial->getVulkanMaterial()->deleteInstance(_pointLightShadowInstance);
     }
 }
 
@@ -235,15 +210,50 @@ bool MeshEntity::isInstanceRendering() const
     return _material->getVulkanMaterial()->getSettings().useInstancing;
 }
 
-void MeshEntity::updateInstanceBuffers()
+BoundingBox MeshEntity::getBoundingBox() const
 {
-    _material->getVulkanMaterial()->updateInstancedData();
-    if (_shadowMaterial)
+    return _mesh->getBoundingBox();
+}
+
+bool MeshEntity::isDrawnInPass(CommandsType passType) const
+{
+    switch (passType)
+    {
+        case CommandsType::ReflectionPass:
+        case CommandsType::RefractionPass:
+            return _isReflected;
+        case CommandsType::ShadowPassDirectLight:
+            return _castShadows && _shadowMaterial;
+        case CommandsType::ShadowPassPointLights:
+            return _castShadows && _pointLightShadowMaterial;
+        case CommandsType::ScreenQuadDepthPass:
+            return _renderToDepth && _shadowMaterial;
+        case CommandsType::ScreenQuadMRTPass:
+            return _material->isMRT();
+        default:
+            return !_material->isMRT();
+    }
+}
+
+VulkanMaterial* MeshEntity::getPassMaterial(CommandsType passType) const
+{
+    switch (passType)
     {
-        _shadowMaterial->getVulkanMaterial()->updateInstancedData();
+        case CommandsType::ShadowPassDirectLight:
+        case CommandsType::ScreenQuadDepthPass:
+            return _shadowMaterial ? _shadowMaterial->getVulkanMaterial() : nullptr;
+        case CommandsType::ShadowPassPointLights:
+            return _pointLightShadowMaterial ? _pointLightShadowMaterial->getVulkanMaterial() : nullptr;
+        default:
+            return _material->getVulkanMaterial();
     }
 }
 
+VulkanMesh* MeshEntity::getVulkanMesh() const
+{
+    return _mesh->getVulkanMesh();
+}
+
 void MeshEntity::setAnimationState(AnimationState animationState)
 {
     _animationState = animationState;
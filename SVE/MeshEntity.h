@@ -5,6 +5,7 @@
 #include "Entity.h"
 #include "ShaderSettings.h"
 #include "MeshDefs.h"
+#include "MaterialInstance.h"
 #include <memory>
 
 namespace SVE
@@ -33,11 +34,14 @@ public:
     // TODO: add IsRefracted method
     void setIsReflected(bool isReflected);
 
-    void updateUniforms(UniformDataList uniformDataList) const override;
-    void updateInstanceBuffers() override;
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
+    void updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const override;
+    void applyDrawingCommands(const RecordingContext& context) const override;
 
     bool isInstanceRendering() const override;
+    BoundingBox getBoundingBox() const override;
+    bool isDrawnInPass(CommandsType passType) const override;
+    VulkanMaterial* getPassMaterial(CommandsType passType) const override;
+    VulkanMesh* getVulkanMesh() const override;
 
     void setAnimationState(AnimationState animationState);
     void resetTime(float time = 0.0f, bool resetAnimation = false);
@@ -48,6 +52,7 @@ public:
 
 private:
     void setupMaterial();
+    void deleteMaterialInstances();
 
 private:
     Mesh* _mesh = nullptr;
@@ -56,14 +61,15 @@ private:
     bool _isReflected = true;
     bool _castShadows = true;
 
-    uint32_t _materialIndex = 0;
-    uint32_t _reflectionMaterialIndex = 0;
-    uint32_t _refractionMaterialIndex = 0;
+    MaterialInstance _materialInstance;
+    MaterialInstance _reflectionMaterialInstance;
+    MaterialInstance _refractionMaterialInstance;
 
     Material* _shadowMaterial = nullptr;
-    uint32_t _shadowIndex = 0;
-    uint32_t _depthIndex = 0;
+    MaterialInstance _shadowInstance;
+    MaterialInstance _depthInstance;
     Material* _pointLightShadowMaterial = nullptr;
+    MaterialInstance _pointLightShadowInstance;
     //std::unique_ptr<Material> _bloomMaterial;
     //std::vector<uint32_t> _shadowMaterialIndexes;
 
@@ -71,6 +77,7 @@ private:
     AnimationState _animationState = AnimationState::Play;
     mutable float _animationTime = 0.0f;
     mutable float _time = 0.0f;
+    mutable float _lastUpdateTime = -1.0f;
 
     mutable BonesAttachments _attachments;
 };
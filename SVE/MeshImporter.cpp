@@ -0,0 +1,240 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "MeshImporter.h"
+#include "VulkanException.h"
+
+#ifndef SVE_NO_ASSIMP_IMPORT
+#include <stack>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#endif
+
+namespace SVE
+{
+
+#ifndef SVE_NO_ASSIMP_IMPORT
+
+namespace
+{
+
+std::string fixAssimpBoneName(std::string nodeName)
+{
+    auto fbxTagPos = nodeName.find("_$AssimpFbx$");
+    if (fbxTagPos != std::string::npos)
+    {
+        nodeName = nodeName.substr(0, fbxTagPos);
+    }
+    return nodeName;
+}
+
+void createSkeletonNodes(const aiScene* scene, const std::map<std::string, uint32_t>& boneMap, AnimationSettings& animationSettings)
+{
+    auto& nodes = animationSettings.nodes;
+
+    // Depth first order, so parent is added before its children
+    std::stack<std::pair<const aiNode*, int32_t>> nodeStack;
+    nodeStack.emplace(scene->mRootNode, -1);
+    while (!nodeStack.empty())
+    {
+        auto* sceneNode = nodeStack.top().first;
+        auto parent = nodeStack.top().second;
+        nodeStack.pop();
+
+        SkeletonNode node;
+        node.name = sceneNode->mName.C_Str();
+        node.transformation = sceneNode->mTransformation;
+        node.parent = parent;
+        auto bone = boneMap.find(node.name);
+        if (bone != boneMap.end())
+            node.boneIndex = bone->second;
+
+        auto index = static_cast<int32_t>(nodes.size());
+        nodes.push_back(std::move(node));
+        for (auto i = sceneNode->mNumChildren; i > 0; i--)
+            nodeStack.emplace(sceneNode->mChildren[i - 1], index);
+    }
+
+    // Attachment uses bone of node itself or first bone found starting from grandparent
+    for (auto& node : nodes)
+    {
+        auto current = node.parent;
+        auto named = node.boneIndex >= 0 ? static_cast<int32_t>(&node - nodes.data()) : (current >= 0 ? nodes[current].parent : -1);
+        while (named >= 0 && nodes[named].boneIndex < 0)
+        {
+            current = nodes[current].parent;
+            named = current >= 0 ? nodes[current].parent : -1;
+        }
+        if (named < 0)
+            continue;
+
+        node.attachmentBoneIndex = nodes[named].boneIndex;
+        aiVector3D scale, rotation, position;
+        animationSettings.boneOffset[node.attachmentBoneIndex].Decompose(scale, rotation, position);
+        aiMatrix4x4::Scaling(scale, node.attachmentScale);
+    }
+}
+
+void createSkeletonAnimations(const aiScene* scene, AnimationSettings& animationSettings)
+{
+    const auto& nodes = animationSettings.nodes;
+    animationSettings.animations.resize(scene->mNumAnimations);
+    for (auto a = 0u; a < scene->mNumAnimations; a++)
+    {
+        const auto* sceneAnimation = scene->mAnimations[a];
+        auto& animation = animationSettings.animations[a];
+        animation.duration = sceneAnimation->mDuration;
+        animation.channels.resize(sceneAnimation->mNumChannels);
+
+        // First channel of node is used if there are duplicates
+        std::map<std::string, int32_t> channelMap;
+        for (auto c = 0u; c < sceneAnimation->mNumChannels; c++)
+        {
+            const auto* nodeAnim = sceneAnimation->mChannels[c];
+            auto& channel = animation.channels[c];
+            channel.positionKeys.assign(nodeAnim->mPositionKeys, nodeAnim->mPositionKeys + nodeAnim->mNumPositionKeys);
+            channel.rotationKeys.assign(nodeAnim->mRotationKeys, nodeAnim->mRotationKeys + nodeAnim->mNumRotationKeys);
+            channel.scalingKeys.assign(nodeAnim->mScalingKeys, nodeAnim->mScalingKeys + nodeAnim->mNumScalingKeys);
+            channelMap.emplace(nodeAnim->mNodeName.C_Str(), static_cast<int32_t>(c));
+        }
+
+        animation.nodeChannels.resize(nodes.size(), -1);
+        for (auto i = 0u; i < nodes.size(); i++)
+        {
+            auto channel = channelMap.find(nodes[i].name);
+            if (channel != channelMap.end())
+                animation.nodeChannels[i] = channel->second;
+        }
+    }
+}
+
+} // anon namespace
+
+MeshSettings importMesh(const MeshLoadSettings& meshLoadSettings, const FileView& fileContent)
+{
+    MeshSettings meshSettings {};
+
+    // Importer and scene are freed after loading, animation data is copied from scene
+    Assimp::Importer importer;
+    meshSettings.animation = std::make_shared<AnimationSettings>();
+
+    std::map<std::string, uint32_t> boneMap;
+
+    const aiScene* scene = importer.ReadFileFromMemory(
+            fileContent.data(), fileContent.size(),
+            aiProcess_CalcTangentSpace       |
+            aiProcess_Triangulate            |
+            aiProcess_JoinIdenticalVertices  |
+            aiProcess_TransformUVCoords      |
+            aiProcess_LimitBoneWeights       |
+            aiProcess_OptimizeMeshes         |
+            aiProcess_SortByPType            |
+            aiProcess_OptimizeGraph);
+
+    // If the import failed, report it
+    if(!scene)
+    {
+        throw VulkanException( importer.GetErrorString());
+    }
+
+    meshSettings.name = meshLoadSettings.name;
+    aiString materialName;
+    scene->mMaterials[0]->Get(AI_MATKEY_NAME, materialName);
+
+    meshSettings.materialName = materialName.C_Str();
+
+    // TODO: Support multiple meshes (only 1 currently will work)
+    for (auto i = 0u; i < scene->mNumMeshes; i++)
+    {
+        const auto* mesh = scene->mMeshes[i];
+        meshSettings.vertexPosData.reserve(mesh->mNumVertices);
+        meshSettings.vertexColorData.reserve(mesh->mNumVertices);
+        meshSettings.vertexTexData.reserve(mesh->mNumVertices);
+        meshSettings.vertexNormalData.reserve(mesh->mNumVertices);
+        meshSettings.vertexBinormalData.reserve(mesh->mNumVertices);
+        meshSettings.vertexTangentData.reserve(mesh->mNumVertices);
+        for (auto v = 0u; v < mesh->mNumVertices; v++)
+        {
+            if (meshLoadSettings.switchYZ)
+            {
+                meshSettings.vertexPosData.emplace_back(mesh->mVertices[v].x, mesh->mVertices[v].z, mesh->mVertices[v].y);
+                meshSettings.vertexPosData.back() *= meshLoadSettings.scale;
+                meshSettings.vertexColorData.emplace_back(1.0f, 1.0f, 1.0f);
+                meshSettings.vertexTexData.emplace_back(mesh->mTextureCoords[0][v].x, 1.0f - mesh->mTextureCoords[0][v].y);
+                meshSettings.vertexNormalData.emplace_back(mesh->mNormals[v].x, mesh->mNormals[v].z, mesh->mNormals[v].y);
+                meshSettings.vertexBinormalData.emplace_back(mesh->mBitangents[v].x, mesh->mBitangents[v].z, mesh->mBitangents[v].y);
+                meshSettings.vertexTangentData.emplace_back(mesh->mTangents[v].x, mesh->mTangents[v].z, mesh->mTangents[v].y);
+            } else {
+                meshSettings.vertexPosData.emplace_back(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
+                meshSettings.vertexPosData.back() *= meshLoadSettings.scale;
+                meshSettings.vertexColorData.emplace_back(1.0f, 1.0f, 1.0f);
+                meshSettings.vertexTexData.emplace_back(mesh->mTextureCoords[0][v].x, 1.0f - mesh->mTextureCoords[0][v].y);
+                meshSettings.vertexNormalData.emplace_back(mesh->mNormals[v].x, mesh->mNormals[v].y, mesh->mNormals[v].z);
+                meshSettings.vertexBinormalData.emplace_back(mesh->mBitangents[v].x, mesh->mBitangents[v].y, mesh->mBitangents[v].z);
+                meshSettings.vertexTangentData.emplace_back(mesh->mTangents[v].x, mesh->mTangents[v].y, mesh->mTangents[v].z);
+            }
+        }
+        meshSettings.indexData.reserve(meshSettings.indexData.size() + mesh->mNumFaces * 3);
+        for (auto f = 0u; f < mesh->mNumFaces; f++)
+        {
+            for (auto index = 0u; index < mesh->mFaces[f].mNumIndices; index++)
+            {
+                meshSettings.indexData.push_back(mesh->mFaces[f].mIndices[index]);
+            }
+        }
+
+        if (mesh->mNumBones > 0)
+        {
+            meshSettings.boneNum = mesh->mNumBones;
+            meshSettings.vertexBoneIndexData.resize(mesh->mNumVertices);
+            meshSettings.vertexBoneWeightData.resize(mesh->mNumVertices);
+            meshSettings.animation->boneOffset.resize(mesh->mNumBones);
+
+            for (auto r = 0u; r < mesh->mNumBones; r++)
+            {
+                auto* boneInfo = mesh->mBones[r];
+                boneMap[boneInfo->mName.C_Str()] = r;
+                meshSettings.animation->boneOffset[r] = boneInfo->mOffsetMatrix;
+                for (auto w = 0u; w < boneInfo->mNumWeights; w++)
+                {
+                    auto weight = boneInfo->mWeights[w];
+
+                    auto vID = weight.mVertexId;
+                    for (auto bi = 0u; bi < 4; bi++)
+                    {
+                        if (meshSettings.vertexBoneWeightData[vID][bi] < 0.01f)
+                        {
+                            meshSettings.vertexBoneIndexData[vID][bi] = r;
+                            meshSettings.vertexBoneWeightData[vID][bi] = weight.mWeight;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (scene->mNumAnimations > 0)
+    {
+        meshSettings.animation->globalInverse = scene->mRootNode->mTransformation;
+        meshSettings.animation->globalInverse.Inverse();
+        createSkeletonNodes(scene, boneMap, *meshSettings.animation);
+        createSkeletonAnimations(scene, *meshSettings.animation);
+    } else {
+        meshSettings.animation = nullptr;
+    }
+
+    return meshSettings;
+}
+
+#else
+
+MeshSettings importMesh(const MeshLoadSettings& meshLoadSettings, const FileView& /*fileContent*/)
+{
+    throw VulkanException("Can't load " + meshLoadSettings.filename + ": Assimp import is disabled, mesh should be baked");
+}
+
+#endif
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,17 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "FileSystem.h"
+#include "MeshSettings.h"
+#include <string>
+
+namespace SVE
+{
+
+// Converts model file (COLLADA or other format supported by Assimp) to mesh data.
+// Only geometry and skeleton are filled, runtime settings (animation speed, vertex format) are left default.
+// Import is unavailable if engine is built with SVE_NO_ASSIMP_IMPORT, only baked meshes can be loaded then.
+MeshSettings importMesh(const MeshLoadSettings& meshLoadSettings, const FileView& fileContent);
+
+} // namespace SVE
\ No newline at end of file
@@ -13,42 +13,29 @@ namespace SVE
 namespace
 {
 
-const aiNodeAnim* findAnimNode(const aiAnimation* animation, const std::string& nodeName)
-{
-    for (uint32_t i = 0; i < animation->mNumChannels; i++)
-    {
-        const aiNodeAnim* nodeAnim = animation->mChannels[i];
-        if (std::string(nodeAnim->mNodeName.data) == nodeName)
-        {
-            return nodeAnim;
-        }
-    }
-    return nullptr;
-}
-
 // Returns a 4x4 matrix with interpolated translation between current and next frame
-aiMatrix4x4 interpolateTranslation(float time, const aiNodeAnim* animNode)
+aiMatrix4x4 interpolateTranslation(float time, const NodeAnimation& animNode)
 {
     aiVector3D translation;
 
-    if (animNode->mNumPositionKeys == 1)
+    if (animNode.positionKeys.size() == 1)
     {
-        translation = animNode->mPositionKeys[0].mValue;
+        translation = animNode.positionKeys[0].mValue;
     }
     else
     {
         uint32_t frameIndex = 0;
-        for (uint32_t i = 0; i < animNode->mNumPositionKeys - 1; i++)
+        for (uint32_t i = 0; i < animNode.positionKeys.size() - 1; i++)
         {
-            if (time < (float)animNode->mPositionKeys[i + 1].mTime)
+            if (time < (float)animNode.positionKeys[i + 1].mTime)
             {
                 frameIndex = i;
                 break;
             }
         }
 
-        aiVectorKey currentFrame = animNode->mPositionKeys[frameIndex];
-        aiVectorKey nextFrame = animNode->mPositionKeys[(frameIndex + 1) % animNode->mNumPositionKeys];
+        aiVectorKey currentFrame = animNode.positionKeys[frameIndex];
+        aiVectorKey nextFrame = animNode.positionKeys[(frameIndex + 1) % animNode.positionKeys.size()];
 
         float delta = (time - (float)currentFrame.mTime) / (float)(nextFrame.mTime - currentFrame.mTime);
 
@@ -64,28 +51,28 @@ aiMatrix4x4 interpolateTranslation(float time, const aiNodeAnim* animNode)
 }
 
 // Returns a 4x4 matrix with interpolated rotation between current and next frame
-aiMatrix4x4 interpolateRotation(float time, const aiNodeAnim* animNode)
+aiMatrix4x4 interpolateRotation(float time, const NodeAnimation& animNode)
 {
     aiQuaternion rotation;
 
-    if (animNode->mNumRotationKeys == 1)
+    if (animNode.rotationKeys.size() == 1)
     {
-        rotation = animNode->mRotationKeys[0].mValue;
+        rotation = animNode.rotationKeys[0].mValue;
     }
     else
     {
         uint32_t frameIndex = 0;
-        for (uint32_t i = 0; i < animNode->mNumRotationKeys - 1; i++)
+        for (uint32_t i = 0; i < animNode.rotationKeys.size() - 1; i++)
         {
-            if (time < (float)animNode->mRotationKeys[i + 1].mTime)
+            if (time < (float)animNode.rotationKeys[i + 1].mTime)
             {
                 frameIndex = i;
                 break;
             }
         }
 
-        aiQuatKey currentFrame = animNode->mRotationKeys[frameIndex];
-        aiQuatKey nextFrame = animNode->mRotationKeys[(frameIndex + 1) % animNode->mNumRotationKeys];
+        aiQuatKey currentFrame = animNode.rotationKeys[frameIndex];
+        aiQuatKey nextFrame = animNode.rotationKeys[(frameIndex + 1) % animNode.rotationKeys.size()];
 
         float delta = (time - (float)currentFrame.mTime) / (float)(nextFrame.mTime - currentFrame.mTime);
 
@@ -102,28 +89,28 @@ aiMatrix4x4 interpolateRotation(float time, const aiNodeAnim* animNode)
 
 
 // Returns a 4x4 matrix with interpolated scaling between current and next frame
-aiMatrix4x4 interpolateScale(float time, const aiNodeAnim* animNode)
+aiMatrix4x4 interpolateScale(float time, const NodeAnimation& animNode)
 {
     aiVector3D scale;
 
-    if (animNode->mNumScalingKeys == 1)
+    if (animNode.scalingKeys.size() == 1)
     {
-        scale = animNode->mScalingKeys[0].mValue;
+        scale = animNode.scalingKeys[0].mValue;
     }
     else
     {
         uint32_t frameIndex = 0;
-        for (uint32_t i = 0; i < animNode->mNumScalingKeys - 1; i++)
+        for (uint32_t i = 0; i < animNode.scalingKeys.size() - 1; i++)
         {
-            if (time < (float)animNode->mScalingKeys[i + 1].mTime)
+            if (time < (float)animNode.scalingKeys[i + 1].mTime)
             {
                 frameIndex = i;
                 break;
             }
         }
 
-        aiVectorKey currentFrame = animNode->mScalingKeys[frameIndex];
-        aiVectorKey nextFrame = animNode->mScalingKeys[(frameIndex + 1) % animNode->mNumScalingKeys];
+        aiVectorKey currentFrame = animNode.scalingKeys[frameIndex];
+        aiVectorKey nextFrame = animNode.scalingKeys[(frameIndex + 1) % animNode.scalingKeys.size()];
 
         float delta = (time - (float)currentFrame.mTime) / (float)(nextFrame.mTime - currentFrame.mTime);
 
@@ -138,91 +125,65 @@ aiMatrix4x4 interpolateScale(float time, const aiNodeAnim* animNode)
     return mat;
 }
 
-void iterateBones(
-        std::vector<glm::mat4>& boneData,
-        float time,
-        const std::shared_ptr<AnimationSettings>& animationSettings,
-        const uint32_t animationId,
-        const aiNode* node,
-        const aiMatrix4x4& parentTransform,
-        BonesAttachments& bonesAttachments)
-{
-    std::string nodeName(node->mName.data);
-
-    aiMatrix4x4 nodeTransformation(node->mTransformation);
-
-    const auto* animNode = findAnimNode(animationSettings->animations[animationId], nodeName);
-
-    if (animNode)
-    {
-        // Get interpolated matrices between current and next frame
-        aiMatrix4x4 matScale = interpolateScale(time, animNode);
-        aiMatrix4x4 matRotation = interpolateRotation(time, animNode);
-        aiMatrix4x4 matTranslation = interpolateTranslation(time, animNode);
+} // anon namespace
 
-        nodeTransformation = matTranslation * matRotation * matScale;
-    }
 
-    aiMatrix4x4 globalTransformation = parentTransform * nodeTransformation;
+void getAnimationTransforms(const AnimationSettings& animationSettings, uint32_t boneNum, uint32_t animationId, float time,
+                            BonesAttachments& bonesAttachments, glm::mat4* boneData, aiMatrix4x4* globalTransformations)
+{
+    const auto& animation = animationSettings.animations[animationId];
+    const auto& nodes = animationSettings.nodes;
 
-    if (animationSettings->boneMap.find(nodeName) != animationSettings->boneMap.end())
+    // TODO: Only for looped anims
+    auto duration = animation.duration;
+    if (duration > 0)
     {
-        uint32_t boneIndex = animationSettings->boneMap.at(nodeName);
-        if (boneIndex < boneData.size())
+        while (time > duration)
         {
-            auto finalTransform =
-                    animationSettings->globalInverse * globalTransformation * animationSettings->boneOffset[boneIndex];
-            auto resultMat = glm::transpose(glm::make_mat4(&finalTransform.a1));
-            boneData[boneIndex] = resultMat;
+            time -= duration;
         }
     }
-    auto attachment = bonesAttachments.find(nodeName);
-    if (attachment != bonesAttachments.end())
+
+    std::fill(boneData, boneData + boneNum, glm::mat4(1));
+
+    // Parents go first, so their global transformation is ready when child is processed
+    for (auto i = 0u; i < nodes.size(); i++)
     {
-        std::string name = nodeName;
-        auto* curNode = node;
-        while (animationSettings->boneMap.find(name) == animationSettings->boneMap.end())
+        const auto& node = nodes[i];
+        aiMatrix4x4 nodeTransformation(node.transformation);
+
+        auto channel = animation.nodeChannels[i];
+        if (channel >= 0)
         {
-            curNode = curNode->mParent;
-            name = curNode->mParent->mName.C_Str();
-        }
-        uint32_t boneIndex = animationSettings->boneMap.at(name);
-        auto toBoneSpace = animationSettings->boneOffset[boneIndex];
-        aiVector3D scale, rot, pos;
-        toBoneSpace.Decompose(scale, rot, pos);
-        aiMatrix4x4 scaleMatrix;
-        aiMatrix4x4::Scaling(scale, scaleMatrix);
-        auto finalTransform =
-                animationSettings->globalInverse  * globalTransformation * scaleMatrix;
-
-        attachment->second = glm::transpose(glm::make_mat4(&finalTransform.a1));
-    }
+            // Get interpolated matrices between current and next frame
+            const auto& animNode = animation.channels[channel];
+            aiMatrix4x4 matScale = interpolateScale(time, animNode);
+            aiMatrix4x4 matRotation = interpolateRotation(time, animNode);
+            aiMatrix4x4 matTranslation = interpolateTranslation(time, animNode);
 
-    for (uint32_t i = 0; i < node->mNumChildren; i++)
-    {
-        iterateBones(boneData, time, animationSettings, animationId, node->mChildren[i], globalTransformation, bonesAttachments);
-    }
-}
+            nodeTransformation = matTranslation * matRotation * matScale;
+        }
 
-} // anon namespace
+        auto& globalTransformation = globalTransformations[i];
+        globalTransformation = node.parent >= 0 ? globalTransformations[node.parent] * nodeTransformation : nodeTransformation;
 
+        if (node.boneIndex >= 0 && static_cast<uint32_t>(node.boneIndex) < boneNum)
+        {
+            auto finalTransform =
+                    animationSettings.globalInverse * globalTransformation * animationSettings.boneOffset[node.boneIndex];
+            boneData[node.boneIndex] = glm::transpose(glm::make_mat4(&finalTransform.a1));
+        }
 
-std::vector<glm::mat4> getAnimationTransforms(const MeshSettings& meshSettings, uint32_t animationId, float time, BonesAttachments& bonesAttachments)
-{
-    // TODO: Only for looped anims
-    time *= meshSettings.animationSpeed;
-    auto duration = meshSettings.animation->animations[animationId]->mDuration;
-    if (duration > 0)
-    {
-        while (time > duration)
+        if (node.attachmentBoneIndex >= 0 && !bonesAttachments.empty())
         {
-            time -= duration;
+            auto attachment = bonesAttachments.find(node.name);
+            if (attachment != bonesAttachments.end())
+            {
+                auto finalTransform = animationSettings.globalInverse * globalTransformation * node.attachmentScale;
+                attachment->second = glm::transpose(glm::make_mat4(&finalTransform.a1));
+            }
         }
     }
-
-    std::vector<glm::mat4> result(meshSettings.boneNum, glm::mat4(1));
-    iterateBones(result, time, meshSettings.animation, animationId, meshSettings.animation->rootNode, aiMatrix4x4(), bonesAttachments);
-
-    return result;
 }
+
 } // namespace SVE
\ No newline at end of file
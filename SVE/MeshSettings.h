@@ -4,6 +4,7 @@
 #pragma once
 #include "Libs.h"
 #include "MeshDefs.h"
+#include "ShaderSettings.h"
 #include <string>
 #include <vector>
 #include <glm/gtc/quaternion.hpp>
@@ -11,20 +12,48 @@
 #include <unordered_map>
 #include <memory>
 
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
+#include <assimp/anim.h>
+#include <assimp/matrix4x4.h>
 
 namespace SVE
 {
 
+// Skeleton and animations are copied from imported scene, so importer is freed after loading
+
+// Node of skeleton hierarchy, parent always goes before its children
+struct SkeletonNode
+{
+    std::string name;
+    aiMatrix4x4 transformation;
+    int32_t parent = -1;
+    // -1 if node is not a bone
+    int32_t boneIndex = -1;
+    // Bone used to place attachments of this node and its scale, -1 if node has no bone above it
+    int32_t attachmentBoneIndex = -1;
+    aiMatrix4x4 attachmentScale;
+};
+
+struct NodeAnimation
+{
+    std::vector<aiVectorKey> positionKeys;
+    std::vector<aiQuatKey> rotationKeys;
+    std::vector<aiVectorKey> scalingKeys;
+};
+
+struct SkeletonAnimation
+{
+    double duration = 0.0;
+    // Channel of every skeleton node, -1 if node is not animated
+    std::vector<int32_t> nodeChannels;
+    std::vector<NodeAnimation> channels;
+};
+
 struct AnimationSettings
 {
-    Assimp::Importer importer;
-    aiAnimation** animations;
-    aiNode* rootNode;
+    std::vector<SkeletonNode> nodes;
+    std::vector<SkeletonAnimation> animations;
     std::vector<aiMatrix4x4> boneOffset;
     aiMatrix4x4 globalInverse;
-    std::map<std::string, uint32_t> boneMap;
 };
 
 struct MeshLoadSettings
@@ -34,6 +63,7 @@ struct MeshLoadSettings
     bool switchYZ = false;
     glm::vec3 scale = {1.0f, 1.0f, 1.0f};
     float animationSpeed = 1.0f;
+    VertexFormat vertexFormat = VertexFormat::Full;
 };
 
 struct MeshSettings
@@ -47,15 +77,22 @@ struct MeshSettings
     std::vector<glm::vec3> vertexTangentData;
     std::vector<uint32_t> indexData;
 
-    uint32_t boneNum;
+    uint32_t boneNum = 0;
     std::vector<glm::ivec4> vertexBoneIndexData;
     std::vector<glm::vec4> vertexBoneWeightData;
     std::shared_ptr<AnimationSettings> animation;
     float animationSpeed = 1.0f;
+    // Compact format is used only if quantization error is acceptable, otherwise mesh stays in full format
+    VertexFormat vertexFormat = VertexFormat::Full;
+    // Mesh keeps these settings after upload only if it's dynamic, otherwise only draw data and bounds are kept
+    bool isDynamic = false;
 
     std::string materialName;
 };
 
-std::vector<glm::mat4> getAnimationTransforms(const MeshSettings& meshSettings, uint32_t animationId, float time, BonesAttachments& bonesAttachments);
+// Writes boneNum matrices to boneData, time is in animation ticks.
+// globalTransformations is scratch space for nodes.size() matrices, so nothing is allocated per frame.
+void getAnimationTransforms(const AnimationSettings& animationSettings, uint32_t boneNum, uint32_t animationId, float time,
+                            BonesAttachments& bonesAttachments, glm::mat4* boneData, aiMatrix4x4* globalTransformations);
 
 } // namespace SVE
\ No newline at end of file
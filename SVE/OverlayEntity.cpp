@@ -6,7 +6,10 @@
 #include "VulkanMaterial.h"
 #include "MaterialManager.h"
 #include "FontManager.h"
+#include "RecordingContext.h"
+#include "FrameUniforms.h"
 #include "Utils.h"
+#include <algorithm>
 
 namespace SVE
 {
@@ -17,8 +20,8 @@ OverlayEntity::OverlayEntity(OverlayInfo overlayInfo)
 {
     if (_material)
     {
-        _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
-        _materialList.insert(_material);
+        _materialInstance = _material->getVulkanMaterial()->createInstance();
+        _materialInstances[_material] = _materialInstance;
     }
     _renderLast = true;
     initText();
@@ -26,10 +29,10 @@ OverlayEntity::OverlayEntity(OverlayInfo overlayInfo)
 
 OverlayEntity::~OverlayEntity()
 {
-    for (auto& material : _materialList)
-        material->getVulkanMaterial()->deleteInstancesForEntity(this);
+    for (auto& materialInstance : _materialInstances)
+        materialInstance.first->getVulkanMaterial()->deleteInstance(materialInstance.second);
     if (_textMaterial)
-        _textMaterial->getVulkanMaterial()->deleteInstancesForEntity(this);
+        _textMaterial->getVulkanMaterial()->deleteInstance(_textMaterialInstance);
 }
 
 OverlayInfo& OverlayEntity::getInfo()
@@ -43,72 +46,66 @@ void OverlayEntity::setText(TextInfo textInfo)
     initText();
 }
 
-void OverlayEntity::updateUniforms(UniformDataList uniformDataList) const
+void OverlayEntity::updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const
 {
-    auto& uniformData = *uniformDataList[toInt(CommandsType::MainPass)];
-
-    uniformData.overlayInfo.x = _overlayInfo.x;
-    uniformData.overlayInfo.y = _overlayInfo.y;
-    uniformData.overlayInfo.width = _overlayInfo.width;
-    uniformData.overlayInfo.height = _overlayInfo.height;
-    uniformData.overlayInfo.texCoord = _overlayInfo.texCoord;
-    uniformData.customFloat = _customFloat;
-    uniformData.customVec4 = _customVec4;
+    const auto& passData = frameUniforms.getPassData(CommandsType::MainPass);
+    auto& objectData = frameUniforms.createObjectData(model);
+
+    objectData.overlayInfo.x = _overlayInfo.x;
+    objectData.overlayInfo.y = _overlayInfo.y;
+    objectData.overlayInfo.width = _overlayInfo.width;
+    objectData.overlayInfo.height = _overlayInfo.height;
+    objectData.overlayInfo.texCoord = _overlayInfo.texCoord;
+    objectData.customFloat = _customFloat;
+    objectData.customVec4 = _customVec4;
     if (_material)
-        _material->getVulkanMaterial()->setUniformData(_materialIndex, uniformData);
+        _material->getVulkanMaterial()->setUniformData(_materialInstance, { passData, objectData });
 
     if (_overlayInfo.textInfo.symbolCount)
     {
-        uniformData.textInfo.symbolCount = _overlayInfo.textInfo.symbolCount;
-        uniformData.textInfo.fontImageSize = glm::vec2(_overlayInfo.textInfo.font->width, _overlayInfo.textInfo.font->height);
-        uniformData.textInfo.imageSize = Engine::getInstance()->getRenderWindowSize();
-        uniformData.textInfo.maxHeight = _overlayInfo.textInfo.font->maxHeight;
-        uniformData.textInfo.maxGlyphHeight = _overlayInfo.textInfo.font->maxGlyphHeight;
-        uniformData.textInfo.scale = _overlayInfo.textInfo.scale;
-        uniformData.textInfo.color = _overlayInfo.textInfo.color;
-        uniformData.glyphList.clear();
-        uniformData.glyphList.reserve(300);
-        std::copy(_overlayInfo.textInfo.font->symbols, _overlayInfo.textInfo.font->symbols + 300, std::back_inserter(uniformData.glyphList));
-        uniformData.glyphList.resize(300);
-        uniformData.textSymbolList = _overlayInfo.textInfo.symbols;
-        uniformData.textSymbolList.resize(100);
-
-        _textMaterial->getVulkanMaterial()->setUniformData(_textMaterialIndex, uniformData);
+        const auto& textInfo = _overlayInfo.textInfo;
+        objectData.textInfo.symbolCount = textInfo.symbolCount;
+        objectData.textInfo.fontImageSize = glm::vec2(textInfo.font->width, textInfo.font->height);
+        objectData.textInfo.imageSize = Engine::getInstance()->getRenderWindowSize();
+        objectData.textInfo.maxHeight = textInfo.font->maxHeight;
+        objectData.textInfo.maxGlyphHeight = textInfo.font->maxGlyphHeight;
+        objectData.textInfo.scale = textInfo.scale;
+        objectData.textInfo.color = textInfo.color;
+        objectData.glyphList = { textInfo.font->symbols, 300 };
+
+        // Shader expects fixed size symbol list, so symbols are padded in arena
+        auto* textSymbols = frameUniforms.allocateArray<TextSymbolInfo>(100);
+        std::copy_n(textInfo.symbols.begin(), std::min<size_t>(textInfo.symbols.size(), 100), textSymbols);
+        objectData.textSymbolList = { textSymbols, 100 };
+
+        _textMaterial->getVulkanMaterial()->setUniformData(_textMaterialInstance, { passData, objectData });
     }
 }
 
-void OverlayEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
+void OverlayEntity::applyDrawingCommands(const RecordingContext& context) const
 {
     if (!_isVisible)
         return;
 
-    if (Engine::getInstance()->getPassType() == CommandsType::MainPass
-        || Engine::getInstance()->getPassType() == CommandsType::ScreenQuadPass
-        || Engine::getInstance()->getPassType() == CommandsType::ScreenQuadLatePass)
+    if (context.passType == CommandsType::MainPass
+        || context.passType == CommandsType::ScreenQuadPass
+        || context.passType == CommandsType::ScreenQuadLatePass)
     {
-        auto commandBuffer = Engine::getInstance()->getVulkanInstance()->getCommandBuffer(bufferIndex);
-
         if (_material)
         {
-            _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _materialIndex);
-            vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+            _material->getVulkanMaterial()->applyDrawingCommands(context, _materialInstance);
+            vkCmdDraw(context.commandBuffer, 6, 1, 0, 0);
         }
         if (_textMaterial)
         {
-            _textMaterial->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _textMaterialIndex);
-            vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+            _textMaterial->getVulkanMaterial()->applyDrawingCommands(context, _textMaterialInstance);
+            vkCmdDraw(context.commandBuffer, 6, 1, 0, 0);
         }
     }
 }
 
 void OverlayEntity::initText()
 {
-    if (_textMaterial)
-    {
-        auto newMaterial = _textMaterial = Engine::getInstance()->getMaterialManager()->getMaterial(_overlayInfo.textInfo.font->materialName);
-        if (newMaterial != _textMaterial)
-            _textMaterial->getVulkanMaterial()->deleteInstancesForEntity(this);
-    }
     if (_overlayInfo.textInfo.symbolCount)
     {
         auto& textInfo = _overlayInfo.textInfo;
@@ -144,8 +141,15 @@ void OverlayEntity::initText()
         _overlayInfo.textInfo = Engine::getInstance()->getFontManager()->generateText(
                 textInfo.text, textInfo.font->fontName, textInfo.scale, glm::ivec2(textX, textY) + textInfo.shift, textInfo.color);
 
-        _textMaterial = Engine::getInstance()->getMaterialManager()->getMaterial(_overlayInfo.textInfo.font->materialName);
-        _textMaterialIndex = _textMaterial->getVulkanMaterial()->getInstanceForEntity(this);
+        // Instance is recreated only when font (and so text material) changes
+        auto* textMaterial = Engine::getInstance()->getMaterialManager()->getMaterial(_overlayInfo.textInfo.font->materialName);
+        if (textMaterial != _textMaterial)
+        {
+            if (_textMaterial)
+                _textMaterial->getVulkanMaterial()->deleteInstance(_textMaterialInstance);
+            _textMaterial = textMaterial;
+            _textMaterialInstance = _textMaterial->getVulkanMaterial()->createInstance();
+        }
     }
 }
 
@@ -162,8 +166,10 @@ void OverlayEntity::setMaterial(const std::string& materialName)
     {
         _overlayInfo.materialName = materialName;
         _material = material;
-        _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
-        _materialList.insert(_material);
+        auto instanceIter = _materialInstances.find(_material);
+        if (instanceIter == _materialInstances.end())
+            instanceIter = _materialInstances.emplace(_material, _material->getVulkanMaterial()->createInstance()).first;
+        _materialInstance = instanceIter->second;
     }
 }
 
@@ -5,8 +5,9 @@
 #include "OverlaySettings.h"
 #include "Material.h"
 #include "Mesh.h"
+#include "MaterialInstance.h"
 
-#include <set>
+#include <map>
 
 namespace SVE
 {
@@ -25,8 +26,8 @@ public:
     void setVisible(bool visible);
     bool isVisible() const;
 
-    void updateUniforms(UniformDataList uniformDataList) const override;
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
+    void updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const override;
+    void applyDrawingCommands(const RecordingContext& context) const override;
 
 private:
     void initText();
@@ -34,11 +35,12 @@ private:
 private:
     OverlayInfo _overlayInfo;
     Material* _material = nullptr;
-    std::set<Material*> _materialList;
-    uint32_t _materialIndex = 0;
+    // Instances are kept for every used material, so switching materials back and forth doesn't create new ones
+    std::map<Material*, MaterialInstance> _materialInstances;
+    MaterialInstance _materialInstance;
 
     Material* _textMaterial = nullptr;
-    uint32_t _textMaterialIndex = 0;
+    MaterialInstance _textMaterialInstance;
 
     bool _isVisible = true;
 };
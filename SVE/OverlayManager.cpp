@@ -44,22 +44,22 @@ void OverlayManager::changeOverlayOrder(const std::string& name, uint32_t newOrd
     _overlayZMap[newOrder].push_back(overlay);
 }
 
-void OverlayManager::updateUniforms(UniformDataList uniformDataList) const
+void OverlayManager::updateUniforms(FrameUniforms& frameUniforms) const
 {
     for (auto& overlay : _overlayList)
     {
         if (overlay.second->isVisible())
-            overlay.second->updateUniforms(uniformDataList);
+            overlay.second->updateUniforms(frameUniforms, glm::mat4(1));
     }
 }
 
-void OverlayManager::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
+void OverlayManager::applyDrawingCommands(const RecordingContext& context) const
 {
     for (auto& zList : _overlayZMap)
     {
         for (auto& overlay : zList.second)
         {
-            overlay->applyDrawingCommands(bufferIndex, imageIndex);
+            overlay->applyDrawingCommands(context);
         }
     }
 }
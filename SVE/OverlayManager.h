@@ -16,8 +16,8 @@ public:
     void removeOverlay(const std::string& name);
     void changeOverlayOrder(const std::string& name, uint32_t newOrder);
 
-    void updateUniforms(UniformDataList uniformDataList) const;
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const;
+    void updateUniforms(FrameUniforms& frameUniforms) const;
+    void applyDrawingCommands(const RecordingContext& context) const;
 
 private:
     std::unordered_map<std::string, std::shared_ptr<OverlayEntity>> _overlayList;
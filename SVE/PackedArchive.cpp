@@ -0,0 +1,321 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "PackedArchive.h"
+#include "VulkanException.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef SVE_PACK_LZ4
+#include <lz4.h>
+#endif
+
+namespace SVE
+{
+namespace
+{
+
+const char PackedArchiveMagic[4] = {'S', 'V', 'E', 'P'};
+
+struct PackedHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t entriesOffset;
+    uint64_t pathsOffset;
+    uint64_t pathsSize;
+};
+
+uint64_t alignOffset(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// LZ4 block is limited by LZ4_MAX_INPUT_SIZE and it can't be compressed better than 255:1
+constexpr uint64_t MaxCompressedFileSize = 0x7E000000;
+constexpr uint64_t MaxCompressionRatio = 255;
+
+bool isRangeValid(uint64_t offset, uint64_t size, uint64_t dataSize)
+{
+    return offset <= dataSize && size <= dataSize - offset;
+}
+
+#ifdef SVE_PACK_LZ4
+std::string compressData(const std::string& data, PackedCompression compression)
+{
+    if (compression != PackedCompression::LZ4)
+        throw VulkanException("Packed file compression isn't supported");
+
+    std::string result(static_cast<size_t>(LZ4_compressBound(static_cast<int>(data.size()))), '\0');
+    auto size = LZ4_compress_default(data.data(), &result[0], static_cast<int>(data.size()), static_cast<int>(result.size()));
+    if (size <= 0)
+        throw VulkanException("Can't compress packed file");
+    result.resize(static_cast<size_t>(size));
+    return result;
+}
+
+// Entry sizes are validated by archive, so original size is bounded by compression ratio
+std::string decompressData(const char* data, const PackedEntry& entry)
+{
+    if (entry.compression != PackedCompression::LZ4)
+        throw VulkanException("Packed file compression isn't supported");
+
+    std::string result(static_cast<size_t>(entry.originalSize), '\0');
+    auto size = LZ4_decompress_safe(data, &result[0], static_cast<int>(entry.size), static_cast<int>(entry.originalSize));
+    if (size < 0 || static_cast<uint64_t>(size) != entry.originalSize)
+        throw VulkanException("Packed file data is corrupted");
+    return result;
+}
+#else
+std::string compressData(const std::string&, PackedCompression)
+{
+    throw VulkanException("Packed file compression isn't supported");
+}
+
+std::string decompressData(const char*, const PackedEntry&)
+{
+    throw VulkanException("Packed file compression isn't supported");
+}
+#endif
+
+// Compressed entries with bigger original size are rejected before anything is allocated for them
+bool isEntrySizeValid(const PackedEntry& entry)
+{
+    switch (entry.compression)
+    {
+        case PackedCompression::None:
+            return entry.size == entry.originalSize;
+        case PackedCompression::LZ4:
+            return entry.originalSize <= MaxCompressedFileSize &&
+                   entry.originalSize / MaxCompressionRatio <= entry.size;
+    }
+    // Unknown compression
+    return false;
+}
+
+} // anon namespace
+
+std::string writePackedArchive(std::vector<PackedFile> files)
+{
+    for (auto& file : files)
+        file.path = normalizePackedPath(file.path);
+    std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) { return a.path < b.path; });
+
+    std::string data(sizeof(PackedHeader), '\0');
+    std::string paths;
+    std::vector<PackedEntry> entries;
+    entries.reserve(files.size());
+    for (auto i = 0u; i < files.size(); i++)
+    {
+        auto& file = files[i];
+        if (file.path.empty() || (i > 0 && file.path == files[i - 1].path))
+            throw VulkanException("Invalid or duplicated packed file path \"" + file.path + "\"");
+
+        PackedEntry entry {};
+        entry.originalSize = file.data.size();
+        if (file.compression != PackedCompression::None)
+        {
+            auto compressedData = compressData(file.data, file.compression);
+            if (compressedData.size() < file.data.size())
+            {
+                file.data = std::move(compressedData);
+                entry.compression = file.compression;
+            }
+        }
+
+        data.resize(static_cast<size_t>(alignOffset(data.size(), std::max(file.alignment, PackedArchiveAlignment))), '\0');
+        entry.offset = data.size();
+        entry.size = file.data.size();
+        entry.pathOffset = static_cast<uint32_t>(paths.size());
+        entry.pathSize = static_cast<uint32_t>(file.path.size());
+        data.append(file.data);
+        paths.append(file.path);
+        entries.push_back(entry);
+
+        // Free data of written files, archive can be big
+        std::string().swap(file.data);
+    }
+
+    PackedHeader header {};
+    memcpy(header.magic, PackedArchiveMagic, sizeof(PackedArchiveMagic));
+    header.version = PackedArchiveVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+
+    data.resize(static_cast<size_t>(alignOffset(data.size(), PackedArchiveAlignment)), '\0');
+    header.entriesOffset = data.size();
+    data.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackedEntry));
+    header.pathsOffset = data.size();
+    header.pathsSize = paths.size();
+    data.append(paths);
+
+    memcpy(&data[0], &header, sizeof(header));
+    return data;
+}
+
+bool isCompressionSupported(PackedCompression compression)
+{
+    switch (compression)
+    {
+        case PackedCompression::None:
+            return true;
+        case PackedCompression::LZ4:
+#ifdef SVE_PACK_LZ4
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+std::string normalizePackedPath(const std::string& path)
+{
+    std::vector<std::string> parts;
+    size_t partStart = 0;
+    while (partStart <= path.size())
+    {
+        auto partEnd = path.find_first_of("/\\", partStart);
+        if (partEnd == std::string::npos)
+            partEnd = path.size();
+
+        auto part = path.substr(partStart, partEnd - partStart);
+        if (part == "..")
+        {
+            if (!parts.empty() && parts.back() != "..")
+                parts.pop_back();
+            else
+                parts.push_back(part);
+        }
+        else if (!part.empty() && part != ".")
+        {
+            parts.push_back(part);
+        }
+        partStart = partEnd + 1;
+    }
+
+    std::string result;
+    for (auto& part : parts)
+    {
+        if (!result.empty())
+            result += '/';
+        result += part;
+    }
+    return result;
+}
+
+PackedArchive::PackedArchive(FileView data)
+    : _data(std::move(data))
+{
+    PackedHeader header;
+    if (_data.size() < sizeof(header))
+        throw VulkanException("Data isn't a packed archive");
+    memcpy(&header, _data.data(), sizeof(header));
+    if (memcmp(header.magic, PackedArchiveMagic, sizeof(PackedArchiveMagic)) != 0)
+        throw VulkanException("Data isn't a packed archive");
+    if (header.version != PackedArchiveVersion)
+        throw VulkanException("Packed archive version " + std::to_string(header.version) + " isn't supported, archive should be packed again");
+    if (!isRangeValid(header.entriesOffset, static_cast<uint64_t>(header.entryCount) * sizeof(PackedEntry), _data.size()) ||
+        !isRangeValid(header.pathsOffset, header.pathsSize, _data.size()))
+        throw VulkanException("Packed archive data is corrupted");
+
+    _paths = _data.data() + header.pathsOffset;
+    _entries.resize(header.entryCount);
+    memcpy(_entries.data(), _data.data() + header.entriesOffset, _entries.size() * sizeof(PackedEntry));
+
+    // Lookups use binary search, so entries must be sorted and unique
+    for (auto i = 0u; i < _entries.size(); i++)
+    {
+        const auto& entry = _entries[i];
+        if (!isRangeValid(entry.pathOffset, entry.pathSize, header.pathsSize) ||
+            !isRangeValid(entry.offset, entry.size, _data.size()) ||
+            !isEntrySizeValid(entry))
+            throw VulkanException("Packed archive data is corrupted");
+        if (i > 0 && comparePath(_entries[i - 1], getPath(entry)) >= 0)
+            throw VulkanException("Packed archive entries aren't sorted");
+    }
+}
+
+bool PackedArchive::isFile(const std::string& path) const
+{
+    return findEntry(normalizePackedPath(path)) != nullptr;
+}
+
+bool PackedArchive::isDirectory(const std::string& path) const
+{
+    auto normalizedPath = normalizePackedPath(path);
+    auto prefix = normalizedPath.empty() ? normalizedPath : normalizedPath + '/';
+    auto entryIter = findFirstEntry(prefix);
+    return entryIter != _entries.end() && isPathPrefix(*entryIter, prefix);
+}
+
+std::vector<std::string> PackedArchive::getDirectoryList(const std::string& path) const
+{
+    auto normalizedPath = normalizePackedPath(path);
+    auto prefix = normalizedPath.empty() ? normalizedPath : normalizedPath + '/';
+
+    // Entries of one subdirectory have common prefix, so they follow each other
+    std::vector<std::string> list;
+    for (auto entryIter = findFirstEntry(prefix); entryIter != _entries.end() && isPathPrefix(*entryIter, prefix); ++entryIter)
+    {
+        auto entryPath = getPath(*entryIter);
+        auto separatorPos = entryPath.find('/', prefix.size());
+        auto childPath = separatorPos == std::string::npos ? entryPath : entryPath.substr(0, separatorPos);
+        if (list.empty() || list.back() != childPath)
+            list.push_back(std::move(childPath));
+    }
+
+    return list;
+}
+
+FileView PackedArchive::getFileView(const std::string& path) const
+{
+    const auto* entry = findEntry(normalizePackedPath(path));
+    if (!entry)
+        throw VulkanException("File " + path + " isn't found in packed archive");
+
+    const auto* entryData = _data.data() + entry->offset;
+    if (entry->compression != PackedCompression::None)
+        return FileView(decompressData(entryData, *entry));
+
+    return FileView(std::shared_ptr<const char>(_data.getDataPtr(), entryData), static_cast<size_t>(entry->size));
+}
+
+size_t PackedArchive::getFileCount() const
+{
+    return _entries.size();
+}
+
+const PackedEntry* PackedArchive::findEntry(const std::string& path) const
+{
+    auto entryIter = findFirstEntry(path);
+    if (entryIter == _entries.end() || comparePath(*entryIter, path) != 0)
+        return nullptr;
+    return &*entryIter;
+}
+
+std::vector<PackedEntry>::const_iterator PackedArchive::findFirstEntry(const std::string& prefix) const
+{
+    return std::lower_bound(_entries.begin(), _entries.end(), prefix, [this](const PackedEntry& entry, const std::string& path)
+    {
+        return comparePath(entry, path) < 0;
+    });
+}
+
+bool PackedArchive::isPathPrefix(const PackedEntry& entry, const std::string& prefix) const
+{
+    return entry.pathSize >= prefix.size() && memcmp(_paths + entry.pathOffset, prefix.data(), prefix.size()) == 0;
+}
+
+std::string PackedArchive::getPath(const PackedEntry& entry) const
+{
+    return std::string(_paths + entry.pathOffset, entry.pathSize);
+}
+
+int PackedArchive::comparePath(const PackedEntry& entry, const std::string& path) const
+{
+    return -path.compare(0, std::string::npos, _paths + entry.pathOffset, entry.pathSize);
+}
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,84 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "FileSystem.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SVE
+{
+
+// Single file with all resources, packed by tools/AssetPacker.cpp.
+// Header is followed by entry data, table of contents sorted by path and path strings.
+// Stored entries are aligned, so views of mapped archive can be used directly (e.g. for SPIR-V or KTX levels).
+// Compressed entries are decompressed on every read.
+
+constexpr uint32_t PackedArchiveVersion = 1;
+constexpr uint32_t PackedArchiveAlignment = 16;
+
+enum class PackedCompression : uint32_t
+{
+    None = 0,
+    LZ4 = 1     // Can be read only if engine is built with SVE_PACK_LZ4
+};
+
+struct PackedFile
+{
+    std::string path;
+    std::string data;
+    // Offset of entry data in archive is multiple of alignment (not less than PackedArchiveAlignment)
+    uint32_t alignment = PackedArchiveAlignment;
+    PackedCompression compression = PackedCompression::None;
+};
+
+// Table of contents entry, offsets are from archive start
+struct PackedEntry
+{
+    uint64_t offset;
+    uint64_t size;
+    uint64_t originalSize;
+    uint32_t pathOffset;
+    uint32_t pathSize;
+    PackedCompression compression;
+    uint32_t reserved;
+};
+
+// Compression is applied only if it makes entry smaller
+std::string writePackedArchive(std::vector<PackedFile> files);
+bool isCompressionSupported(PackedCompression compression);
+
+// Lexically normalized path: "/" separators, no "." and ".." parts, no leading or trailing separators
+std::string normalizePackedPath(const std::string& path);
+
+class PackedArchive
+{
+public:
+    // Throws if header or table of contents is invalid
+    explicit PackedArchive(FileView data);
+
+    bool isFile(const std::string& path) const;
+    bool isDirectory(const std::string& path) const;
+    // Paths of files and directories directly inside the directory
+    std::vector<std::string> getDirectoryList(const std::string& path) const;
+    // View of stored entry shares archive data, compressed entry is decompressed to new buffer
+    FileView getFileView(const std::string& path) const;
+
+    size_t getFileCount() const;
+
+private:
+    const PackedEntry* findEntry(const std::string& path) const;
+    // First entry with path not less than prefix
+    std::vector<PackedEntry>::const_iterator findFirstEntry(const std::string& prefix) const;
+    bool isPathPrefix(const PackedEntry& entry, const std::string& prefix) const;
+    std::string getPath(const PackedEntry& entry) const;
+    int comparePath(const PackedEntry& entry, const std::string& path) const;
+
+private:
+    FileView _data;
+    const char* _paths = nullptr;
+    std::vector<PackedEntry> _entries;
+};
+
+} // namespace SVE
\ No newline at end of file
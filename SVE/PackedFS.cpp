@@ -0,0 +1,127 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "PackedFS.h"
+#include "VulkanException.h"
+
+namespace SVE
+{
+
+PackedFSEntity::PackedFSEntity(std::string path, bool isDirectory, bool exist)
+    : _path(std::move(path))
+    , _isDirectory(isDirectory)
+    , _exist(exist)
+{
+}
+
+bool PackedFSEntity::isDirectory() const
+{
+    return _isDirectory;
+}
+
+bool PackedFSEntity::exist() const
+{
+    return _exist;
+}
+
+std::string PackedFSEntity::getPath() const
+{
+    return _path;
+}
+
+std::string PackedFSEntity::resolveFilePath(const std::string& file) const
+{
+    return normalizePackedPath(_path + "/" + file);
+}
+
+PackedFS::PackedFS(FileView archiveData, std::shared_ptr<FileSystem> fallbackFS)
+    : _archive(std::move(archiveData))
+    , _fallbackFS(std::move(fallbackFS))
+{
+}
+
+std::string PackedFS::getExtension(FSEntityPtr file) const
+{
+    if (!isPacked(file))
+        return _fallbackFS->getExtension(file);
+
+    auto path = file->getPath();
+    auto dotPos = path.find_last_of('.');
+    auto separatorPos = path.find_last_of('/');
+    if (dotPos == std::string::npos || (separatorPos != std::string::npos && dotPos < separatorPos))
+        return std::string();
+    return path.substr(dotPos);
+}
+
+FSEntityPtr PackedFS::getContainingDirectory(FSEntityPtr file) const
+{
+    if (!isPacked(file))
+        return _fallbackFS->getContainingDirectory(file);
+
+    auto path = file->getPath();
+    auto separatorPos = path.find_last_of('/');
+    return getEntity(separatorPos == std::string::npos ? std::string() : path.substr(0, separatorPos), true);
+}
+
+FSEntityList PackedFS::getFileList(FSEntityPtr dir) const
+{
+    if (!isPacked(dir))
+        return _fallbackFS->getFileList(dir);
+
+    FSEntityList fileList;
+    if (!dir->isDirectory())
+        return fileList;
+
+    for (auto& path : _archive.getDirectoryList(dir->getPath()))
+    {
+        auto isFile = _archive.isFile(path);
+        fileList.push_back(std::make_shared<PackedFSEntity>(path, !isFile, true));
+    }
+
+    return fileList;
+}
+
+std::string PackedFS::getFileContent(FSEntityPtr file) const
+{
+    if (!isPacked(file))
+        return _fallbackFS->getFileContent(file);
+
+    return _archive.getFileView(file->getPath()).toString();
+}
+
+FileView PackedFS::getFileView(FSEntityPtr file) const
+{
+    if (!isPacked(file))
+        return _fallbackFS->getFileView(file);
+
+    return _archive.getFileView(file->getPath());
+}
+
+std::string PackedFS::getSavePath() const
+{
+    if (!_fallbackFS)
+    {
+        throw VulkanException("Packed file system has no folder for saving data");
+    }
+    return _fallbackFS->getSavePath();
+}
+
+FSEntityPtr PackedFS::getEntity(const std::string& localPath, bool isDirectory) const
+{
+    auto path = normalizePackedPath(localPath);
+    if (_archive.isFile(path))
+        return std::make_shared<PackedFSEntity>(path, false, true);
+    if (_archive.isDirectory(path))
+        return std::make_shared<PackedFSEntity>(path, true, true);
+
+    if (_fallbackFS)
+        return _fallbackFS->getEntity(localPath, isDirectory);
+    return std::make_shared<PackedFSEntity>(path, false, false);
+}
+
+bool PackedFS::isPacked(const FSEntityPtr& file) const
+{
+    return !_fallbackFS || std::dynamic_pointer_cast<PackedFSEntity>(file) != nullptr;
+}
+
+} // namespace SVE
\ No newline at end of file
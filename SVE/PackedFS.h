@@ -0,0 +1,52 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "FileSystem.h"
+#include "PackedArchive.h"
+
+namespace SVE
+{
+
+class PackedFSEntity : public FileSystemEntity
+{
+public:
+    PackedFSEntity(std::string path, bool isDirectory, bool exist);
+
+    bool isDirectory() const override;
+    bool exist() const override;
+    std::string getPath() const override;
+    std::string resolveFilePath(const std::string& file) const override;
+
+private:
+    std::string _path;
+    bool _isDirectory;
+    bool _exist;
+};
+
+// Resources from packed archive, file content is given out as views of archive data without copying.
+// Files missing in archive (saved settings, scores) are taken from fallback file system if it's set.
+class PackedFS : public FileSystem
+{
+public:
+    // Archive data is usually mapped file (see DesktopFS::mapFile and AndroidFS::mapAsset)
+    PackedFS(FileView archiveData, std::shared_ptr<FileSystem> fallbackFS);
+
+    std::string getExtension(FSEntityPtr file) const override;
+    FSEntityPtr getContainingDirectory(FSEntityPtr file) const override;
+    FSEntityList getFileList(FSEntityPtr dir) const override;
+    std::string getFileContent(FSEntityPtr file) const override;
+    FileView getFileView(FSEntityPtr file) const override;
+    std::string getSavePath() const override;
+
+    FSEntityPtr getEntity(const std::string& localPath, bool isDirectory = false) const override;
+
+private:
+    bool isPacked(const FSEntityPtr& file) const;
+
+private:
+    PackedArchive _archive;
+    std::shared_ptr<FileSystem> _fallbackFS;
+};
+
+} // namespace SVE
\ No newline at end of file
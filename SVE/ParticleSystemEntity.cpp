@@ -8,6 +8,8 @@
 #include "MaterialManager.h"
 #include "VulkanMaterial.h"
 #include "Engine.h"
+#include "RecordingContext.h"
+#include "FrameUniforms.h"
 #include "Utils.h"
 
 namespace SVE
@@ -19,7 +21,7 @@ ParticleSystemEntity::ParticleSystemEntity(ParticleSystemSettings settings)
     , _materialInfo { glm::vec4(0), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 16 }
 {
     _renderLast = true;
-    _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
+    _materialInstance = _material->getVulkanMaterial()->createInstance();
     generateParticles();
 }
 
@@ -29,44 +31,58 @@ ParticleSystemEntity::ParticleSystemEntity(const std::string &name)
 
 }
 
-ParticleSystemEntity::~ParticleSystemEntity() = default;
+ParticleSystemEntity::~ParticleSystemEntity()
+{
+    _material->getVulkanMaterial()->deleteInstance(_materialInstance);
+}
 
 void ParticleSystemEntity::applyComputeCommands(uint32_t bufferIndex, uint32_t imageIndex) const
 {
     // TODO: Change it to VulkanCommandsManager interface
     _vulkanComputeEntity->reallocateCommandBuffers();
-    //_material->getVulkanMaterial()->applyComputeCommands(bufferIndex, imageIndex, _materialIndex);
+    //_material->getVulkanMaterial()->applyComputeCommands(bufferIndex, imageIndex, _materialInstance);
     _vulkanComputeEntity->applyComputeCommands();
 }
 
-void ParticleSystemEntity::updateUniforms(UniformDataList uniformDataList) const
+void ParticleSystemEntity::updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const
 {
-    auto& data = *uniformDataList[toInt(CommandsType::MainPass)];
-    data.materialInfo = _materialInfo;
-    data.particleEmitter = _settings.particleEmitter;
-    data.particleAffector = _settings.particleAffector;
-    data.particleCount = _settings.quota;
-    data.spritesheetSize = _material->getVulkanMaterial()->getSpritesheetSize();
+    auto& objectData = frameUniforms.createObjectData(model);
+    objectData.materialInfo = _materialInfo;
+    objectData.particleEmitter = _settings.particleEmitter;
+    objectData.particleAffector = _settings.particleAffector;
+    objectData.particleCount = _settings.quota;
+    objectData.spritesheetSize = _material->getVulkanMaterial()->getSpritesheetSize();
     if (_isTimePaused)
     {
-        data.time = _pauseTime;
-        data.deltaTime = 0;
+        objectData.time = _pauseTime;
+        objectData.deltaTime = 0;
     }
 
-    _material->getVulkanMaterial()->setUniformData(_materialIndex, data);
+    UniformData data { frameUniforms.getPassData(CommandsType::MainPass), objectData };
+    _material->getVulkanMaterial()->setUniformData(_materialInstance, data);
     _vulkanComputeEntity->setUniformData(data);
 }
 
-void ParticleSystemEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
+void ParticleSystemEntity::applyDrawingCommands(const RecordingContext& context) const
 {
-    if (Engine::getInstance()->getPassType() == CommandsType::MainPass || Engine::getInstance()->getPassType() == CommandsType::ScreenQuadPass
-        || Engine::getInstance()->getPassType() == CommandsType::ScreenQuadLatePass)
+    if (isDrawnInPass(context.passType))
     {
-        _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _materialIndex);
-        _vulkanParticleSystem->applyDrawingCommands(bufferIndex);
+        _material->getVulkanMaterial()->applyDrawingCommands(context, _materialInstance);
+        _vulkanParticleSystem->applyDrawingCommands(context);
     }
 }
 
+bool ParticleSystemEntity::isDrawnInPass(CommandsType passType) const
+{
+    return passType == CommandsType::MainPass || passType == CommandsType::ScreenQuadPass
+           || passType == CommandsType::ScreenQuadLatePass;
+}
+
+VulkanMaterial* ParticleSystemEntity::getPassMaterial(CommandsType passType) const
+{
+    return _material->getVulkanMaterial();
+}
+
 ParticleSystemSettings& ParticleSystemEntity::getSettings()
 {
     return _settings;
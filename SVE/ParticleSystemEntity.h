@@ -5,6 +5,7 @@
 #include "ComputeEntity.h"
 #include "ParticleSystemSettings.h"
 #include "ShaderSettings.h"
+#include "MaterialInstance.h"
 
 namespace SVE
 {
@@ -20,8 +21,10 @@ public:
     ~ParticleSystemEntity() override;
 
     void applyComputeCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
-    void updateUniforms(UniformDataList uniformDataList) const override;
+    void applyDrawingCommands(const RecordingContext& context) const override;
+    bool isDrawnInPass(CommandsType passType) const override;
+    VulkanMaterial* getPassMaterial(CommandsType passType) const override;
+    void updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const override;
 
     void setMaterialInfo(const MaterialInfo& materialInfo) override;
     MaterialInfo* getMaterialInfo() override;
@@ -37,7 +40,7 @@ private:
     std::unique_ptr<VulkanParticleSystem> _vulkanParticleSystem;
 
     Material* _material;
-    uint32_t _materialIndex;
+    MaterialInstance _materialInstance;
     MaterialInfo _materialInfo;
 };
 
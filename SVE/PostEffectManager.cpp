@@ -12,6 +12,9 @@
 #include "MaterialManager.h"
 #include "VulkanInstance.h"
 #include "VulkanMaterial.h"
+#include "VulkanBindCache.h"
+#include "RecordingContext.h"
+#include "FrameUniforms.h"
 #include "Utils.h"
 
 namespace SVE
@@ -31,7 +34,7 @@ void PostEffectManager::addPostEffect(const std::string& materialName, std::stri
     postEffect.height = height < 0 ? engine->getRenderWindowSize().y : height;
     postEffect.material = Engine::getInstance()->getMaterialManager()->getMaterial(materialName);
     postEffect.material->getVulkanMaterial()->updateDescriptorSets();
-    postEffect.materialIndex = postEffect.material->getVulkanMaterial()->getInstanceForEntity(nullptr);
+    postEffect.materialInstance = postEffect.material->getVulkanMaterial()->createInstance();
     postEffect.vulkanPostEffect = std::make_unique<VulkanPostEffect>(postEffect.index, width, height);
 
     _effectMap[postEffect.name] = postEffect.index;
@@ -46,30 +49,50 @@ uint32_t PostEffectManager::getEffectIndex(const std::string& name)
     return iter == _effectMap.end() ? 0 : iter->second;
 }
 
-void PostEffectManager::createCommands(uint32_t currentFrame, uint32_t currentImage)
+void PostEffectManager::reallocateCommandBuffers()
 {
+    for (auto& postEffect : _effectList)
+    {
+        postEffect.vulkanPostEffect->reallocateCommandBuffers();
+    }
+}
+
+void PostEffectManager::createCommands(uint32_t currentImage, VulkanBindCache& bindCache)
+{
+    auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
     for (auto& postEffect : _effectList)
     {
         auto bufferIndex = BUFFER_INDEX_SCREEN_QUAD + postEffect.index;
-        auto commandBuffer =  postEffect.vulkanPostEffect->reallocateCommandBuffers();
+        RecordingContext context { CommandsType::PostEffectPasses, bufferIndex, currentImage,
+                                   vulkanInstance->getCommandBuffer(bufferIndex), &bindCache };
+        bindCache.reset();
 
         postEffect.vulkanPostEffect->startRenderCommandBufferCreation();
-        postEffect.material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, currentImage, postEffect.materialIndex);
+        postEffect.material->getVulkanMaterial()->applyDrawingCommands(context, postEffect.materialInstance);
 
-        vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+        vkCmdDraw(context.commandBuffer, 6, 1, 0, 0);
         postEffect.vulkanPostEffect->endRenderCommandBufferCreation();
     }
 }
 
-void PostEffectManager::submitCommands(UniformDataList uniformDataList)
+void PostEffectManager::updateUniforms(FrameUniforms& frameUniforms)
+{
+    // Every effect gets size of previous effect output
+    auto& passData = frameUniforms.getPassData(CommandsType::ScreenQuadPass);
+    const auto& objectData = frameUniforms.createObjectData(glm::mat4(1));
+    for (auto& postEffect : _effectList)
+    {
+        postEffect.material->getVulkanMaterial()->setUniformData(postEffect.materialInstance, { passData, objectData });
+        passData.imageSize = glm::ivec4(postEffect.width, postEffect.height, 0, 0);
+    }
+}
+
+void PostEffectManager::submitCommands()
 {
     auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
-    auto* uniformData = uniformDataList[toInt(CommandsType::ScreenQuadPass)].get();
     for (auto& postEffect : _effectList)
     {
-        postEffect.material->getVulkanMaterial()->setUniformData(postEffect.materialIndex, *uniformData);
         vulkanInstance->submitCommands(CommandsType::ScreenQuadPass, BUFFER_INDEX_SCREEN_QUAD + postEffect.index);
-        uniformData->imageSize = glm::ivec4(postEffect.width, postEffect.height, 0, 0);
     }
 }
 
@@ -4,12 +4,14 @@
 #pragma once
 
 #include "Entity.h"
+#include "MaterialInstance.h"
 
 namespace SVE
 {
 
 class Material;
 class VulkanPostEffect;
+class VulkanBindCache;
 
 struct PostEffect
 {
@@ -19,7 +21,7 @@ struct PostEffect
     uint32_t index;
     std::string name;
     Material* material;
-    uint32_t materialIndex;
+    MaterialInstance materialInstance;
     int width;
     int height;
     std::unique_ptr<VulkanPostEffect> vulkanPostEffect;
@@ -33,8 +35,12 @@ public:
     void addPostEffect(const std::string& materialName, std::string effectName, int width = -1, int height = -1);
     uint32_t getEffectIndex(const std::string& name);
 
-    void createCommands(uint32_t currentFrame, uint32_t currentImage);
-    void submitCommands(UniformDataList uniformDataList);
+    // Command buffers are allocated on main thread, commands can be created on worker thread
+    void reallocateCommandBuffers();
+    // Uniforms should be set before commands creation, they are bound by dynamic offsets
+    void updateUniforms(FrameUniforms& frameUniforms);
+    void createCommands(uint32_t currentImage, VulkanBindCache& bindCache);
+    void submitCommands();
 
 private:
     std::vector<PostEffect> _effectList;
@@ -0,0 +1,27 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <cstdint>
+
+namespace SVE
+{
+class VulkanBindCache;
+enum class CommandsType : uint8_t;
+
+// State of a single pass recording. Every pass gets its own context (command buffer,
+// bind cache), so passes can be recorded on different threads without shared state.
+struct RecordingContext
+{
+    CommandsType passType;
+    uint32_t bufferIndex;
+    uint32_t imageIndex;
+    VkCommandBuffer commandBuffer;
+    VulkanBindCache* bindCache;
+    // Instances range of current draw, set by render queue for batched items
+    uint32_t firstInstance = 0;
+    uint32_t instanceCount = 1;
+};
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,211 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "RenderQueue.h"
+#include "Engine.h"
+#include "VulkanMaterial.h"
+#include "VulkanMesh.h"
+#include "Utils.h"
+#include <algorithm>
+#include <iostream>
+
+namespace SVE
+{
+namespace
+{
+
+bool isStageInPass(CommandsType passType, RenderQueue::Stage stage)
+{
+    switch (passType)
+    {
+        case CommandsType::ScreenQuadPass:
+        case CommandsType::ScreenQuadMRTPass:
+        case CommandsType::ScreenQuadDepthPass:
+            return stage != RenderQueue::Stage::RenderLast;
+        case CommandsType::ScreenQuadLatePass:
+            return stage == RenderQueue::Stage::RenderLast;
+        default:
+            return true;
+    }
+}
+
+float getViewDistance(const BoundingBox& box, glm::vec3 viewPosition)
+{
+    if (box.isInfinite || box.isEmpty())
+        return 0.0f;
+    return glm::length((box.min + box.max) * 0.5f - viewPosition);
+}
+
+bool isInstancedItem(const RenderQueue::Item& item)
+{
+    return item.stage == RenderQueue::Stage::Instanced && item.material && item.material->getSettings().useInstancing;
+}
+
+// Fragment shaders read material info from uniforms of the first entity, so it should match for whole run
+bool isSameMaterialInfo(const MaterialInfo* left, const MaterialInfo* right)
+{
+    if (!left || !right)
+        return left == right;
+    return left->ambient == right->ambient && left->diffuse == right->diffuse &&
+           left->specular == right->specular && left->shininess == right->shininess &&
+           left->ignoreShadow == right->ignoreShadow;
+}
+
+bool canMergeItems(const RenderQueue::Item& first, const RenderQueue::Item& item)
+{
+    return isInstancedItem(item) && item.material == first.material &&
+           item.entity->getVulkanMesh() == first.entity->getVulkanMesh() &&
+           isSameMaterialInfo(item.entity->getMaterialInfo(), first.entity->getMaterialInfo());
+}
+
+} // anon namespace
+
+void RenderQueue::build(const FlatScene& scene, glm::vec3 viewPosition)
+{
+    _passItems.resize(PassCount);
+    _passNodes.resize(PassCount);
+    for (auto pass = 0u; pass < PassCount; pass++)
+    {
+        _passItems[pass].clear();
+        _passNodes[pass].clear();
+    }
+
+    uint32_t sceneOrder = 0;
+    for (auto i = 0u; i < scene.getNodeCount();)
+    {
+        if (!scene.getSubtreePassMask(i))
+        {
+            i = scene.getSubtreeEnd(i);
+            continue;
+        }
+
+        auto passMask = scene.getEntitiesPassMask(i);
+        auto depth = passMask ? getViewDistance(scene.getEntitiesBounds(i), viewPosition) : 0.0f;
+        for (auto* entity : scene.getEntities(i))
+        {
+            if (!passMask)
+                break;
+
+            auto stage = entity->isRenderLast()
+                    ? Stage::RenderLast
+                    : (entity->isInstanceRendering() ? Stage::Instanced : Stage::Regular);
+            auto* mesh = entity->getVulkanMesh();
+            auto order = sceneOrder++;
+
+            for (auto pass = 0u; pass < PassCount; pass++)
+            {
+                auto passType = static_cast<CommandsType>(pass);
+                if (!(passMask & (1u << pass)) || !isStageInPass(passType, stage))
+                    continue;
+                if (passType == CommandsType::ScreenQuadDepthPass && !entity->isRenderToDepth())
+                    continue;
+                if (!entity->isDrawnInPass(passType))
+                    continue;
+
+                auto* material = entity->getPassMaterial(passType);
+                auto sortKey = stage == Stage::RenderLast || !material || material->getSettings().useAlphaBlending
+                        ? createSortKey(stage, order)
+                        : createStateSortKey(stage, material->getId(), mesh ? mesh->getId() : 0, depth, order);
+                auto nodeIndex = static_cast<uint32_t>(_passNodes[pass].size());
+                _passNodes[pass].push_back(scene.getNode(i));
+                _passItems[pass].push_back({ sortKey, entity, material, stage, nodeIndex, 0, 1 });
+            }
+        }
+        ++i;
+    }
+
+    _mergedDrawCount = 0;
+    for (auto pass = 0u; pass < PassCount; pass++)
+    {
+        auto& items = _passItems[pass];
+        std::sort(items.begin(), items.end(), [](const Item& left, const Item& right)
+        {
+            return left.sortKey < right.sortKey;
+        });
+        mergeInstancedItems(items, _passNodes[pass]);
+    }
+}
+
+void RenderQueue::mergeInstancedItems(std::vector<Item>& items, std::vector<SceneNode*>& nodes)
+{
+    // Sorting puts items with the same material and mesh next to each other, every run
+    // becomes one item. Nodes are reordered to run order, so item keeps just a range of them.
+    _mergedNodes.clear();
+    auto last = items.begin();
+    for (auto it = items.begin(); it != items.end();)
+    {
+        auto item = *it;
+        item.firstNode = static_cast<uint32_t>(_mergedNodes.size());
+        _mergedNodes.push_back(nodes[it->firstNode]);
+
+        auto runEnd = it + 1;
+        if (isInstancedItem(item))
+        {
+            for (; runEnd != items.end() && canMergeItems(item, *runEnd); ++runEnd)
+                _mergedNodes.push_back(nodes[runEnd->firstNode]);
+        }
+        item.instanceCount = static_cast<uint32_t>(runEnd - it);
+        _mergedDrawCount += item.instanceCount - 1;
+
+        *last++ = item;
+        it = runEnd;
+    }
+    items.erase(last, items.end());
+    nodes.swap(_mergedNodes);
+}
+
+void RenderQueue::updateInstanceData()
+{
+    // Material buffers are filled from scratch every frame
+    for (const auto& items : _passItems)
+    {
+        for (const auto& item : items)
+        {
+            if (isInstancedItem(item))
+                item.material->resetInstanceData();
+        }
+    }
+
+    for (auto pass = 0u; pass < _passItems.size(); pass++)
+    {
+        const auto& nodes = _passNodes[pass];
+        for (auto& item : _passItems[pass])
+        {
+            if (!isInstancedItem(item))
+                continue;
+
+            // Instances over material capacity are dropped, instanceMaxCount of material should be increased then
+            auto freeCount = item.material->getFreeInstanceDataCount();
+            if (item.instanceCount > freeCount && _overflowMaterials.insert(item.material->getId()).second)
+            {
+                std::cout << "Material " << item.material->getSettings().name
+                          << " is out of instance capacity, extra instances are not drawn" << std::endl;
+            }
+            item.instanceCount = std::min(item.instanceCount, freeCount);
+            _instanceModels.clear();
+            for (auto i = 0u; i < item.instanceCount; i++)
+                _instanceModels.push_back(nodes[item.firstNode + i]->getWorldTransformation());
+            item.firstInstance = item.material->addInstanceData(_instanceModels.data(), item.instanceCount);
+        }
+    }
+}
+
+const std::vector<RenderQueue::Item>& RenderQueue::getItems(CommandsType passType) const
+{
+    return _passItems[toInt(passType)];
+}
+
+uint32_t RenderQueue::getDrawCount() const
+{
+    uint32_t drawCount = 0;
+    for (const auto& items : _passItems)
+        drawCount += static_cast<uint32_t>(items.size());
+    return drawCount;
+}
+
+uint32_t RenderQueue::getMergedDrawCount() const
+{
+    return _mergedDrawCount;
+}
+
+} // namespace SVE
\ No newline at end of file
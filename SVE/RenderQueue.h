@@ -0,0 +1,65 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "FlatScene.h"
+#include "RenderSortKey.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_set>
+
+namespace SVE
+{
+class VulkanMaterial;
+enum class CommandsType : uint8_t;
+
+// Draw lists for all passes built with single scene walk per frame.
+// Items are sorted by key, so commands recording is a plain loop over pass queue.
+// Opaque items are grouped by material and mesh to minimise state changes,
+// blended and render-last items keep scene order.
+// Runs of instanced items with the same material and mesh are merged to single instanced draw.
+// Only materials with vertex shader reading ModelMatrixList are instanced (coins, gems and their depth
+// material), entities of all other materials are drawn one by one with their regular shaders.
+class RenderQueue
+{
+public:
+    using Stage = RenderStage;
+
+    struct Item
+    {
+        // Stage is most significant, then state (material, mesh, depth) or scene order
+        uint64_t sortKey;
+        Entity* entity;
+        VulkanMaterial* material;
+        Stage stage;
+        // Nodes of merged entities are [firstNode, firstNode + instanceCount) in pass node list
+        uint32_t firstNode;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+    };
+
+    // Scene should be culled already, only visible entities are queued
+    void build(const FlatScene& scene, glm::vec3 viewPosition);
+    // Write model matrices of instanced items to material buffers, should be called
+    // after scene nodes are updated for this frame and before recording
+    void updateInstanceData();
+    const std::vector<Item>& getItems(CommandsType passType) const;
+    // Draws of all passes and entities merged into instanced draws (beyond the first one)
+    uint32_t getDrawCount() const;
+    uint32_t getMergedDrawCount() const;
+
+private:
+    void mergeInstancedItems(std::vector<Item>& items, std::vector<SceneNode*>& nodes);
+
+private:
+    std::vector<std::vector<Item>> _passItems;
+    // Scene node of every queued entity, indexed by Item::firstNode
+    std::vector<std::vector<SceneNode*>> _passNodes;
+    std::vector<SceneNode*> _mergedNodes;
+    std::vector<glm::mat4> _instanceModels;
+    // Materials which already reported dropped instances
+    std::unordered_set<uint32_t> _overflowMaterials;
+    uint32_t _mergedDrawCount = 0;
+};
+
+} // namespace SVE
\ No newline at end of file
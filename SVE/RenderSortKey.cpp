@@ -0,0 +1,38 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "RenderSortKey.h"
+#include <cstring>
+
+namespace SVE
+{
+namespace
+{
+
+// Positive floats keep their order when compared as integers, so top bits are enough for coarse depth
+uint32_t getDepthBits(float depth)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return bits >> 16u;
+}
+
+} // anon namespace
+
+uint64_t createSortKey(RenderStage stage, uint32_t sceneOrder)
+{
+    // Ordered items go after state sorted ones of the same stage, so blending happens over opaque geometry
+    return (static_cast<uint64_t>(stage) << 62u) | (1ull << 61u) | sceneOrder;
+}
+
+uint64_t createStateSortKey(RenderStage stage, uint32_t materialId, uint32_t meshId, float depth, uint32_t sceneOrder)
+{
+    // stage:2 | ordered:1 (zero) | material:16 | mesh:16 | depth:16 | scene order:13
+    return (static_cast<uint64_t>(stage) << 62u) |
+           (static_cast<uint64_t>(materialId & 0xFFFFu) << 45u) |
+           (static_cast<uint64_t>(meshId & 0xFFFFu) << 29u) |
+           (static_cast<uint64_t>(getDepthBits(depth)) << 13u) |
+           (sceneOrder & 0x1FFFu);
+}
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,23 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <cstdint>
+
+namespace SVE
+{
+
+// Render queue items of pass are drawn by stages, stage is the most significant part of sort key
+enum class RenderStage : uint8_t
+{
+    Regular,
+    Instanced,
+    RenderLast
+};
+
+// Key for items that must be drawn in scene order
+uint64_t createSortKey(RenderStage stage, uint32_t sceneOrder);
+// Key for items that can be reordered: grouped by material, then mesh, front to back inside the same state
+uint64_t createStateSortKey(RenderStage stage, uint32_t materialId, uint32_t meshId, float depth, uint32_t sceneOrder);
+
+} // namespace SVE
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "MaterialSettings.h"
 #include "EngineSettings.h"
 #include "ShaderSettings.h"
+#include "ShaderLoader.h"
 #include "MeshSettings.h"
 #include "LightSettings.h"
 #include "ParticleSystemManager.h"
@@ -16,19 +17,24 @@
 #include "SceneManager.h"
 #include "MaterialManager.h"
 #include "MeshManager.h"
+#include "TextureManager.h"
+#include "VulkanInstance.h"
+#include "VulkanUploadBatcher.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
 #include "Libs.h"
 
 #include <utf8.h>
 #include <map>
+#include <chrono>
+#include <atomic>
+#include <future>
+#include <iterator>
 #include <rapidjson/document.h>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 
-#define setOptional(expr)                \
-    try { expr; }                        \
-    catch (const RapidJsonException&) { }
-
 namespace SVE
 {
 namespace
@@ -82,156 +88,16 @@ EngineSettings loadEngine(const std::string& data)
     setOptional(engineSettings.useScreenQuad = document["useScreenQuad"].GetBool());
     setOptional(engineSettings.useCascadeShadowMap = document["useCascadeShadowMap"].GetBool());
     setOptional(engineSettings.particlesEnabled = document["particlesEnabled"].GetBool());
+    setOptional(engineSettings.parallelRecording = document["parallelRecording"].GetBool());
+    setOptional(engineSettings.loadingThreads = document["loadingThreads"].GetUint());
 
     return engineSettings;
 }
 
-std::vector<UniformInfo> getUniformInfoList(rj::Document& document)
-{
-    static const std::map<std::string, UniformType> uniformMap{
-            {"ModelMatrix",                     UniformType::ModelMatrix},
-            {"ViewMatrix",                      UniformType::ViewMatrix},
-            {"ProjectionMatrix",                UniformType::ProjectionMatrix},
-            {"InverseModelMatrix",              UniformType::InverseModelMatrix},
-            {"ModelViewProjectionMatrix",       UniformType::ModelViewProjectionMatrix},
-            {"ViewProjectionMatrix",            UniformType::ViewProjectionMatrix},
-            {"ViewProjectionMatrixList",        UniformType::ViewProjectionMatrixList},
-            {"ViewProjectionMatrixSize",        UniformType::ViewProjectionMatrixSize},
-            {"CameraPosition",                  UniformType::CameraPosition},
-            {"MaterialInfo",                    UniformType::MaterialInfo},
-            {"LightInfo",                       UniformType::LightInfo},
-            {"LightDirectional",                UniformType::LightDirectional},
-            {"LightPoint",                      UniformType::LightPoint},
-            {"LightPointSimple",                UniformType::LightPointSimple},
-            {"LightLine",                       UniformType::LightLine},
-            {"LightSpot",                       UniformType::LightSpot},
-            {"LightPointViewProjectionList",    UniformType::LightPointViewProjectionList},
-            {"LightDirectViewProjectionList",   UniformType::LightDirectViewProjectionList},
-            {"LightDirectViewProjection",       UniformType::LightDirectViewProjection},
-            {"BoneMatrices",                    UniformType::BoneMatrices},
-            {"ClipPlane",                       UniformType::ClipPlane},
-            {"ParticleEmitter",                 UniformType::ParticleEmitter},
-            {"ParticleAffector",                UniformType::ParticleAffector},
-            {"ParticleCount",                   UniformType::ParticleCount},
-            {"SpritesheetSize",                 UniformType::SpritesheetSize},
-            {"ImageSize",                       UniformType::ImageSize},
-            {"TextInfo",                        UniformType::TextInfo},
-            {"GlyphInfoList",                   UniformType::GlyphInfoList},
-            {"TextSymbolList",                  UniformType::TextSymbolList},
-            {"OverlayInfo",                     UniformType::OverlayInfo},
-            {"CustomFloat",                     UniformType::CustomFloat},
-            {"CustomVec4",                      UniformType::CustomVec4},
-            {"CustomMat4",                      UniformType::CustomMat4},
-            {"Time",                            UniformType::Time},
-            {"DeltaTime",                       UniformType::DeltaTime},
-    };
-
-    std::vector<UniformInfo> uniformList;
-    auto list = document["uniformList"].GetArray();
-    for (auto& item : list)
-    {
-        UniformInfo uniformInfo {};
-        uniformInfo.uniformType = uniformMap.at(item["uniformType"].GetString());
-        setOptional(uniformInfo.uniformIndex = item["uniformIndex"].GetInt());
-        uniformList.push_back(std::move(uniformInfo));
-    }
-
-    return uniformList;
-}
-
-std::vector<BufferType> getBufferTypeList(rj::Document& document)
-{
-    static const std::map<std::string, BufferType> bufferMap{
-            {"AtomicCounter",     BufferType::AtomicCounter },
-            {"ModelMatrixList",   BufferType::ModelMatrixList },
-            {"TextSymbolList",    BufferType::TextSymbolList },
-    };
-
-    std::vector<BufferType> bufferList;
-    auto list = document["bufferList"].GetArray();
-    for (auto& item : list)
-    {
-        auto bufferType = bufferMap.at(item.GetString());
-        bufferList.push_back(bufferType);
-    }
-
-    return bufferList;
-}
-
-VertexInfo getVertexInfo(rj::Document& document)
-{
-    static const std::map<std::string, VertexInfo::VertexDataType> vertexDataTypeMap{
-            {"Position",    VertexInfo::VertexDataType::Position},
-            {"Color",       VertexInfo::VertexDataType::Color},
-            {"TexCoord",    VertexInfo::VertexDataType::TexCoord},
-            {"Normal",      VertexInfo::VertexDataType::Normal},
-            {"Binormal",    VertexInfo::VertexDataType::Binormal},
-            {"Tangent",     VertexInfo::VertexDataType::Tangent},
-            {"BoneWeights", VertexInfo::VertexDataType::BoneWeights},
-            {"BoneIds",     VertexInfo::VertexDataType::BoneIds},
-            {"Custom",      VertexInfo::VertexDataType::Custom},
-    };
-
-    VertexInfo info {};
-
-    auto vertexInfo = document["vertexInfo"].GetObject();
-    auto vertexDataFlags = vertexInfo["vertexDataFlags"].GetArray();
-
-    info.vertexDataFlags = 0;
-    for (auto& item : vertexDataFlags)
-    {
-        info.vertexDataFlags |= vertexDataTypeMap.at(item.GetString());
-    }
-    setOptional(info.positionSize = static_cast<uint8_t>(vertexInfo["positionSize"].GetUint()));
-    setOptional(info.colorSize = static_cast<uint8_t>(vertexInfo["colorSize"].GetUint()));
-    setOptional(info.customCount = static_cast<uint8_t>(vertexInfo["customCount"].GetUint()));
-    setOptional(info.separateBinding = static_cast<uint8_t>(vertexInfo["separateBinding"].GetBool()));
-
-    return info;
-}
-
-std::vector<std::string> getStringList(rj::Document& document, const std::string& listName)
-{
-    auto list = document[listName.c_str()].GetArray();
-
-    std::vector<std::string> stringList;
-    for (auto& item : list)
-    {
-        stringList.emplace_back(item.GetString());
-    }
-
-    return stringList;
-}
-
 ShaderSettings loadShader(FSEntityPtr directory, const std::string& data)
 {
-    static const std::map<std::string, ShaderType> shaderTypeMap{
-            {"VertexShader",   ShaderType::VertexShader},
-            {"FragmentShader", ShaderType::FragmentShader},
-            {"GeometryShader", ShaderType::GeometryShader},
-            {"ComputeShader",  ShaderType::ComputeShader},
-    };
-
-    rj::Document document;
-    document.Parse(data.c_str());
-
-    ShaderSettings shaderSettings {};
-    shaderSettings.name = document["name"].GetString();
-    setOptional(shaderSettings.maxBonesSize = document["maxBonesSize"].GetUint());
-    setOptional(shaderSettings.maxLightSize = document["maxLightSize"].GetUint());
-    setOptional(shaderSettings.maxCascadeLightSize = document["maxCascadeLightSize"].GetUint());
-    setOptional(shaderSettings.maxShadowPointLightSize = document["maxShadowPointLightSize"].GetUint());
-    setOptional(shaderSettings.maxLineLightSize = document["maxLineLightSize"].GetUint());
-    setOptional(shaderSettings.maxViewProjectionMatrices = document["maxViewProjectionMatrices"].GetUint());
-    setOptional(shaderSettings.uniformList = getUniformInfoList(document));
-    setOptional(shaderSettings.bufferList = getBufferTypeList(document));
-    setOptional(shaderSettings.vertexInfo = getVertexInfo(document));
-    setOptional(shaderSettings.maxGlyphCount = document["maxGlyphCount"].GetUint());
-    setOptional(shaderSettings.samplerNamesList = getStringList(document, "samplerNamesList"));
-    shaderSettings.filename = directory->resolveFilePath(document["filename"].GetString());
-    shaderSettings.shaderType = shaderTypeMap.at(document["shaderType"].GetString());
-    setOptional(shaderSettings.entryPoint = document["entryPoint"].GetString());
-
+    auto shaderSettings = loadShaderSettings(data);
+    shaderSettings.filename = directory->resolveFilePath(shaderSettings.filename);
     return shaderSettings;
 }
 
@@ -426,7 +292,6 @@ MaterialSettings loadMaterial(FSEntityPtr directory, const std::string& data)
     setOptional(materialSettings.useMultisampling = document["useMultisampling"].GetBool());
     setOptional(materialSettings.useAlphaBlending = document["useAlphaBlending"].GetBool());
     setOptional(materialSettings.useMRT = document["useMRT"].GetBool());
-    setOptional(materialSettings.useInstancing = document["useInstancing"].GetBool());
     setOptional(materialSettings.ignoreShadow = document["ignoreShadow"].GetBool());
     setOptional(materialSettings.instanceMaxCount = document["instanceMaxCount"].GetUint());
     setOptional(materialSettings.srcBlendFactor = blendFactor.at(document["srcBlendFactor"].GetString()));
@@ -444,6 +309,11 @@ MaterialSettings loadMaterial(FSEntityPtr directory, const std::string& data)
 
 MeshLoadSettings loadMesh(FSEntityPtr directory, const std::string& data)
 {
+    static const std::map<std::string, VertexFormat> vertexFormatMap {
+            {"Full",    VertexFormat::Full},
+            {"Compact", VertexFormat::Compact},
+    };
+
     rj::Document document;
     document.Parse(data.c_str());
 
@@ -454,6 +324,7 @@ MeshLoadSettings loadMesh(FSEntityPtr directory, const std::string& data)
     setOptional(meshLoadSettings.switchYZ = document["switchYZ"].GetBool());
     setOptional(meshLoadSettings.scale = loadVector<3>(document, "scale"));
     setOptional(meshLoadSettings.animationSpeed = document["animationSpeed"].GetFloat());
+    setOptional(meshLoadSettings.vertexFormat = vertexFormatMap.at(document["vertexFormat"].GetString()));
 
     return meshLoadSettings;
 }
@@ -490,6 +361,39 @@ LightSettings loadLight(const std::string& data)
     return lightSettings;
 }
 
+template <typename T>
+void appendList(std::vector<T>& list, std::vector<T>& source)
+{
+    list.insert(list.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+}
+
+void appendLoadData(ResourceManager::LoadData& loadData, ResourceManager::LoadData& source)
+{
+    appendList(loadData.materialsList, source.materialsList);
+    appendList(loadData.engine, source.engine);
+    appendList(loadData.shaderList, source.shaderList);
+    appendList(loadData.meshList, source.meshList);
+    appendList(loadData.lightList, source.lightList);
+    appendList(loadData.particleSystemList, source.particleSystemList);
+    appendList(loadData.fontList, source.fontList);
+}
+
+// Futures of started loading tasks. Unfinished tasks are waited on destruction
+// (when loading throws), so they never outlive data they write to.
+struct LoadingTasks
+{
+    std::vector<std::future<void>> futures;
+
+    ~LoadingTasks()
+    {
+        for (auto& future : futures)
+        {
+            if (future.valid() && future.wait_for(std::chrono::seconds(0)) != std::future_status::deferred)
+                future.wait();
+        }
+    }
+};
+
 } // anon namespace
 
 ResourceManager::ResourceManager(std::shared_ptr<FileSystem> fileSystem)
@@ -497,6 +401,8 @@ ResourceManager::ResourceManager(std::shared_ptr<FileSystem> fileSystem)
 {
 }
 
+ResourceManager::~ResourceManager() = default;
+
 void ResourceManager::loadResources()
 {
     LoadData data {};
@@ -506,7 +412,7 @@ void ResourceManager::loadResources()
 
         if (fh->isDirectory())
         {
-            loadDirectory(folder, data, _fileSystem);
+            loadDirectory(folder, data, _fileSystem, getLoadingPool());
         }
         else
         {
@@ -520,23 +426,107 @@ void ResourceManager::loadResources()
 void ResourceManager::initializeResources(LoadData& data, CallbackFunc callback)
 {
     auto* engine = Engine::getInstance();
+    auto* textureManager = engine->getTextureManager();
+    auto* loadingPool = getLoadingPool();
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Image files of materials which will be created, every file is decoded once
+    std::vector<std::string> textureFiles;
+    std::vector<std::vector<size_t>> materialTextures(data.materialsList.size());
+    std::map<std::string, size_t> textureFileIndexes;
+    for (auto i = 0u; i < data.materialsList.size(); i++)
+    {
+        const auto& materialSettings = data.materialsList[i];
+        if (static_cast<uint8_t>(materialSettings.loadQuality) > static_cast<uint8_t>(_maxLoadQuality) || materialSettings.isCubemap)
+            continue;
 
+        for (const auto& textureInfo : materialSettings.textures)
+        {
+            if (textureInfo.textureType != TextureType::ImageFile || textureManager->isTextureLoaded(textureInfo.filename))
+                continue;
+
+            auto fileIndex = textureFileIndexes.emplace(textureInfo.filename, textureFiles.size());
+            if (fileIndex.second)
+                textureFiles.push_back(textureInfo.filename);
+            materialTextures[i].push_back(fileIndex.first->second);
+        }
+    }
+
+    // Decoding and mesh import are started first, GPU objects are created below in dependency order
+    // (shaders, materials, meshes) and each of them waits only for data it uses.
+    // Without loading threads tasks are deferred and run when their result is needed.
+    std::vector<TextureManager::DecodedImage> decodedImages(textureFiles.size());
+    std::vector<MeshSettings> meshSettingsList(data.meshList.size());
+    std::atomic<uint32_t> finishedTaskCount { 0 };
+    LoadingTasks textureTasks;
+    LoadingTasks meshTasks;
+
+    auto startTask = [loadingPool, &finishedTaskCount](std::function<void()> task)
+    {
+        auto countedTask = [task, &finishedTaskCount]
+        {
+            task();
+            ++finishedTaskCount;
+        };
+        return loadingPool ? loadingPool->addTask(countedTask) : std::async(std::launch::deferred, countedTask);
+    };
+    for (auto i = 0u; i < textureFiles.size(); i++)
+    {
+        textureTasks.futures.push_back(startTask([textureManager, &textureFiles, &decodedImages, i]
+        {
+            decodedImages[i] = textureManager->decodeImage(textureFiles[i]);
+        }));
+    }
+    for (auto i = 0u; i < data.meshList.size(); i++)
+    {
+        meshTasks.futures.push_back(startTask([&data, &meshSettingsList, i]
+        {
+            meshSettingsList[i] = Mesh::importMeshSettings(data.meshList[i]);
+        }));
+    }
+
+    // Uploads of all resources are collected in one batch, it's submitted only when staging ring is full
+    auto* uploadBatcher = engine->getVulkanInstance()->getUploadBatcher();
+    auto startSubmitCount = uploadBatcher->getSubmitCount();
+    auto startTextureStatistics = textureManager->getStatistics();
+    uploadBatcher->beginBatch();
+
+    // Progress counts finished loading tasks and created resources.
+    // Callback usually renders a frame, so it's called not more often than frames are shown.
     uint32_t totalCount = 0;
     uint32_t currCount = 0;
+    auto lastReportTime = std::chrono::high_resolution_clock::now();
     if (callback)
     {
         totalCount = data.materialsList.size() + data.engine.size() + data.shaderList.size() + data.meshList.size()
-                     + data.lightList.size() + data.particleSystemList.size() + data.fontList.size();
+                     + data.lightList.size() + data.particleSystemList.size() + data.fontList.size()
+                     + textureTasks.futures.size() + meshTasks.futures.size();
         callback(0);
     }
-    auto provideCallback = [&]()
+    auto reportProgress = [&]()
     {
-        if (callback)
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        if (callback && currentTime - lastReportTime >= std::chrono::milliseconds(16))
         {
-            ++currCount;
-            callback((float)currCount / totalCount);
+            lastReportTime = currentTime;
+            callback((float)(currCount + finishedTaskCount) / totalCount);
         }
     };
+    auto provideCallback = [&]()
+    {
+        ++currCount;
+        reportProgress();
+    };
+    // Callback is called while waiting, so loading screen keeps updating. Returns false if task was already finished.
+    auto finishTask = [&](std::future<void>& future)
+    {
+        if (!future.valid())
+            return false;
+        while (future.wait_for(std::chrono::milliseconds(16)) == std::future_status::timeout)
+            reportProgress();
+        future.get();
+        return true;
+    };
 
     for (auto& shaderSettings : data.shaderList)
     {
@@ -549,20 +539,27 @@ void ResourceManager::initializeResources(LoadData& data, CallbackFunc callback)
         engine->getSceneManager()->createLight(lightSettings);
         provideCallback();
     }
-    for (auto& materialSettings : data.materialsList)
+    for (auto i = 0u; i < data.materialsList.size(); i++)
     {
+        auto& materialSettings = data.materialsList[i];
         if (static_cast<uint8_t>(materialSettings.loadQuality) > static_cast<uint8_t>(_maxLoadQuality))
         {
             provideCallback();
             continue;
         }
+        for (auto fileIndex : materialTextures[i])
+        {
+            if (finishTask(textureTasks.futures[fileIndex]))
+                textureManager->addDecodedImage(textureFiles[fileIndex], std::move(decodedImages[fileIndex]));
+        }
         std::shared_ptr<SVE::Material> material = std::make_shared<SVE::Material>(materialSettings);
         engine->getMaterialManager()->registerMaterial(material);
         provideCallback();
     }
-    for (auto& meshLoadSettings : data.meshList)
+    for (auto i = 0u; i < data.meshList.size(); i++)
     {
-        std::shared_ptr<SVE::Mesh> mesh = std::make_shared<SVE::Mesh>(meshLoadSettings);
+        finishTask(meshTasks.futures[i]);
+        std::shared_ptr<SVE::Mesh> mesh = std::make_shared<SVE::Mesh>(std::move(meshSettingsList[i]));
         engine->getMeshManager()->registerMesh(mesh);
         provideCallback();
     }
@@ -576,6 +573,38 @@ void ResourceManager::initializeResources(LoadData& data, CallbackFunc callback)
         engine->getFontManager()->addFont(font);
         provideCallback();
     }
+
+    uploadBatcher->endBatch();
+    if (callback)
+        callback(1.0f);
+
+    auto duration = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    std::cout << "Resources initialized in " << duration << " ms (loading threads: "
+              << (loadingPool ? loadingPool->getThreadCount() : 0) << "), upload submits: "
+              << uploadBatcher->getSubmitCount() - startSubmitCount << std::endl;
+
+    const auto& textureStatistics = textureManager->getStatistics();
+    std::cout << "Textures decoded: " << textureStatistics.decodeCount - startTextureStatistics.decodeCount
+              << ", baked: " << textureStatistics.bakedCount - startTextureStatistics.bakedCount
+              << " (" << (textureStatistics.uploadedBytes - startTextureStatistics.uploadedBytes) / (1024 * 1024) << " MB), reused: "
+              << textureStatistics.reuseCount - startTextureStatistics.reuseCount
+              << " (" << (textureStatistics.reusedBytes - startTextureStatistics.reusedBytes) / (1024 * 1024) << " MB saved)" << std::endl;
+}
+
+ThreadPool* ResourceManager::getLoadingPool()
+{
+    if (!_loadingPool)
+    {
+        auto threadCount = Engine::getInstance()->getEngineSettings().loadingThreads;
+        if (threadCount == 0)
+            threadCount = std::thread::hardware_concurrency();
+        if (threadCount < 2)
+            return nullptr;
+
+        _loadingPool = std::make_unique<ThreadPool>(threadCount);
+    }
+
+    return _loadingPool.get();
 }
 
 void ResourceManager::loadFolder(const std::string& folder, CallbackFunc callback)
@@ -583,7 +612,7 @@ void ResourceManager::loadFolder(const std::string& folder, CallbackFunc callbac
     _folderList.push_back(folder);
 
     LoadData loadData {};
-    loadDirectory(folder, loadData, _fileSystem);
+    loadDirectory(folder, loadData, _fileSystem, getLoadingPool());
     initializeResources(loadData, callback);
 }
 
@@ -618,13 +647,43 @@ std::string ResourceManager::loadFileContent(const std::string& file) const
     return _fileSystem->getFileContent(_fileSystem->getEntity(file));
 }
 
-void ResourceManager::loadDirectory(const std::string& directory, LoadData& loadData, const std::shared_ptr<FileSystem>& fileSystem)
+FileView ResourceManager::loadFileView(const std::string& file) const
+{
+    return _fileSystem->getFileView(_fileSystem->getEntity(file));
+}
+
+void ResourceManager::loadDirectory(const std::string& directory, LoadData& loadData, const std::shared_ptr<FileSystem>& fileSystem,
+                                    ThreadPool* threadPool)
 {
     auto dir = fileSystem->getEntity(directory, true);
     auto fileList = fileSystem->getFileList(dir);
-    for (auto& file : fileList)
+    if (!threadPool)
+    {
+        for (auto& file : fileList)
+        {
+            loadFile(file, loadData, fileSystem);
+        }
+        return;
+    }
+
+    // Every file is read and parsed into its own data, lists are merged in directory order
+    std::vector<LoadData> fileDataList(fileList.size());
+    std::vector<std::future<void>> futures;
+    futures.reserve(fileList.size());
+    for (auto i = 0u; i < fileList.size(); i++)
+    {
+        futures.push_back(threadPool->addTask([&fileList, &fileDataList, &fileSystem, i]
+        {
+            loadFile(fileList[i], fileDataList[i], fileSystem);
+        }));
+    }
+    // All tasks finish before the first exception is rethrown, so none of them outlives the data
+    for (auto& future : futures)
+        future.wait();
+    for (auto i = 0u; i < fileList.size(); i++)
     {
-        loadFile(file, loadData, fileSystem);
+        futures[i].get();
+        appendLoadData(loadData, fileDataList[i]);
     }
 }
 
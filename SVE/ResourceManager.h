@@ -19,6 +19,7 @@ struct MeshLoadSettings;
 struct LightSettings;
 struct ParticleSystemSettings;
 struct Font;
+class ThreadPool;
 
 class ResourceManager
 {
@@ -37,12 +38,14 @@ public:
     };
 
     explicit ResourceManager(std::shared_ptr<FileSystem> fileSystem);
+    ~ResourceManager();
 
     void setMaxMaterialLoadQuality(MaterialQuality quality);
     void loadFolder(const std::string& folder, CallbackFunc callback = nullptr);
     static LoadData getLoadDataFromFolder(const std::string& folder, bool isFolder, const std::shared_ptr<FileSystem>& fileSystem);
     const std::vector<std::string> getFolderList() const;
     std::string loadFileContent(const std::string& file) const;
+    FileView loadFileView(const std::string& file) const;
     std::string getSavePath() const;
     std::shared_ptr<FileSystem> getFileSystem() const;
 
@@ -60,15 +63,19 @@ private:
 
 private:
     void loadResources();
+    // CPU loading work runs on loading threads, GPU objects are created on calling thread
     void initializeResources(LoadData& loadData, CallbackFunc callback = nullptr);
+    ThreadPool* getLoadingPool();
 
-    static void loadDirectory(const std::string& directory, LoadData& loadData, const std::shared_ptr<FileSystem>& fileSystem);
+    static void loadDirectory(const std::string& directory, LoadData& loadData, const std::shared_ptr<FileSystem>& fileSystem,
+                              ThreadPool* threadPool = nullptr);
     static void loadFile(FSEntityPtr file, LoadData& loadData, const std::shared_ptr<FileSystem>& fileSystem);
 
 private:
     std::vector<std::string> _folderList;
     std::shared_ptr<FileSystem> _fileSystem;
     MaterialQuality _maxLoadQuality = MaterialQuality::High;
+    std::unique_ptr<ThreadPool> _loadingPool;
 };
 
 } // namespace SVE
\ No newline at end of file
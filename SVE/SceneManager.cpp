@@ -89,4 +89,9 @@ std::shared_ptr<Water> SceneManager::getWater()
     return _water;
 }
 
+FlatScene& SceneManager::getFlatScene()
+{
+    return _flatScene;
+}
+
 } // namespace SVE
\ No newline at end of file
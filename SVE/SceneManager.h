@@ -4,6 +4,7 @@
 #pragma once
 #include "SceneNode.h"
 #include "CameraNode.h"
+#include "FlatScene.h"
 #include <memory>
 
 namespace SVE
@@ -43,12 +44,16 @@ public:
     std::shared_ptr<Water> createWater(float height);
     std::shared_ptr<Water> getWater();
 
+    // Flattened scene graph for per frame traversals
+    FlatScene& getFlatScene();
+
 private:
     bool _recreateCommandBuffers = true;
     std::shared_ptr<SceneNode> _root;
     std::shared_ptr<CameraNode> _mainCamera;
     std::shared_ptr<Skybox> _skybox;
     std::shared_ptr<Water> _water;
+    FlatScene _flatScene;
 
     std::unique_ptr<LightManager> _lightManager;
 
@@ -2,13 +2,13 @@
 // Copyright (c) 2018-2019, Igor Barinov
 // Licensed under the MIT License
 #include "SceneNode.h"
-#include "SceneManager.h"
-#include "Engine.h"
 #include <algorithm>
 
 namespace SVE
 {
 
+uint64_t SceneNode::_structureVersion = 0;
+
 SceneNode::SceneNode(std::string name)
     : _name(std::move(name))
 {
@@ -36,6 +36,7 @@ void SceneNode::setParent(std::shared_ptr<SceneNode> parent)
         }
     }
     _parent = std::move(parent);
+    setWorldDirty();
 }
 
 std::shared_ptr<SceneNode> SceneNode::getParent() const
@@ -47,6 +48,7 @@ void SceneNode::attachEntity(std::shared_ptr<Entity> entity)
 {
     entity->setParent(shared_from_this());
     _entityList.push_back(std::move(entity));
+    ++_structureVersion;
 }
 
 void SceneNode::detachEntity(std::shared_ptr<Entity> entity)
@@ -55,6 +57,7 @@ void SceneNode::detachEntity(std::shared_ptr<Entity> entity)
     {
         _entityList.remove(entity);
         entity->clearParent();
+        ++_structureVersion;
     }
 }
 
@@ -71,6 +74,8 @@ const std::list<std::shared_ptr<Entity>>& SceneNode::getAttachedEntities() const
 
 void SceneNode::setHideEntities(bool value)
 {
+    if (_entitiesHidden != value)
+        ++_structureVersion;
     _entitiesHidden = value;
 }
 
@@ -79,6 +84,7 @@ void SceneNode::attachSceneNode(std::shared_ptr<SceneNode> sceneNode)
 {
     sceneNode->setParent(shared_from_this());
     _sceneNodeList.push_back(sceneNode);
+    ++_structureVersion;
 }
 
 void SceneNode::detachSceneNode(std::shared_ptr<SceneNode> sceneNode)
@@ -87,6 +93,8 @@ void SceneNode::detachSceneNode(std::shared_ptr<SceneNode> sceneNode)
     {
         _sceneNodeList.remove(sceneNode);
         sceneNode->_parent.reset();
+        sceneNode->setWorldDirty();
+        ++_structureVersion;
     }
 }
 
@@ -106,19 +114,54 @@ glm::mat4 SceneNode::getNodeTransformation() const
 void SceneNode::setNodeTransformation(glm::mat4 transform)
 {
     _transformation = std::move(transform);
+    setWorldDirty();
+}
+
+uint64_t SceneNode::getStructureVersion()
+{
+    return _structureVersion;
 }
 
 glm::mat4 SceneNode::getTotalTransformation() const
 {
-    glm::mat4 totalTransform = glm::mat4(1);
-    auto node = shared_from_this();
-    while (node)
+    return getWorldTransformation();
+}
+
+const glm::mat4& SceneNode::getWorldTransformation() const
+{
+    // Bone can move without any notification, so attachment is checked on every call
+    if (_attachment)
     {
-        totalTransform *= node->getNodeTransformation();
-        node = node->getParent();
+        auto attachmentTransformation = _attachment->getAttachment(_attachmentName);
+        if (attachmentTransformation != _attachmentTransformation)
+        {
+            _attachmentTransformation = attachmentTransformation;
+            setWorldDirty();
+        }
     }
 
-    return totalTransform;
+    if (_isWorldDirty)
+    {
+        auto localTransformation = _attachment ? _attachmentTransformation * _transformation : _transformation;
+        auto parent = _parent.lock();
+        _worldTransformation = parent ? parent->getWorldTransformation() * localTransformation : localTransformation;
+        _isWorldDirty = false;
+    }
+
+    return _worldTransformation;
+}
+
+void SceneNode::setWorldDirty() const
+{
+    // Descendants of dirty node are always dirty, so propagation can stop here
+    if (_isWorldDirty)
+        return;
+
+    _isWorldDirty = true;
+    for (auto& child : _sceneNodeList)
+    {
+        child->setWorldDirty();
+    }
 }
 
 void SceneNode::setCurrentFrame(uint64_t frame)
@@ -141,6 +184,8 @@ void SceneNode::setEntityAttachment(std::shared_ptr<Entity> entity, const std::s
     _attachment = std::move(entity);
     _attachment->subscribeToAttachment(attachmentName);
     _attachmentName = attachmentName;
+    _attachmentTransformation = _attachment->getAttachment(_attachmentName);
+    setWorldDirty();
 }
 
 } // namespace SVE
\ No newline at end of file
@@ -41,6 +41,15 @@ public:
     virtual void setNodeTransformation(glm::mat4 transform);
 
     glm::mat4 getTotalTransformation() const;
+    // World transformation is cached and recalculated only after node, its parent or attachment bone changes.
+    // Ancestors attachments are not checked here, engine refreshes them every frame during traversal.
+    const glm::mat4& getWorldTransformation() const;
+
+    // Changed every time any node gets or loses children or entities
+    static uint64_t getStructureVersion();
+
+private:
+    void setWorldDirty() const;
 
 private:
     std::string _name;
@@ -55,6 +64,11 @@ private:
     bool _entitiesHidden = false;
 
     glm::mat4 _transformation = glm::mat4(1);
+    mutable glm::mat4 _attachmentTransformation = glm::mat4(1);
+    mutable glm::mat4 _worldTransformation = glm::mat4(1);
+    mutable bool _isWorldDirty = true;
+
+    static uint64_t _structureVersion;
 };
 
 } // namespace SVE
\ No newline at end of file
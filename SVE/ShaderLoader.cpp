@@ -0,0 +1,167 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "ShaderLoader.h"
+#include "VulkanException.h"
+#include <map>
+#include <rapidjson/document.h>
+
+namespace SVE
+{
+
+namespace
+{
+namespace rj = rapidjson;
+
+std::vector<UniformInfo> getUniformInfoList(rj::Document& document)
+{
+    static const std::map<std::string, UniformType> uniformMap{
+            {"ModelMatrix",                     UniformType::ModelMatrix},
+            {"ViewMatrix",                      UniformType::ViewMatrix},
+            {"ProjectionMatrix",                UniformType::ProjectionMatrix},
+            {"InverseModelMatrix",              UniformType::InverseModelMatrix},
+            {"ModelViewProjectionMatrix",       UniformType::ModelViewProjectionMatrix},
+            {"ViewProjectionMatrix",            UniformType::ViewProjectionMatrix},
+            {"ViewProjectionMatrixList",        UniformType::ViewProjectionMatrixList},
+            {"ViewProjectionMatrixSize",        UniformType::ViewProjectionMatrixSize},
+            {"CameraPosition",                  UniformType::CameraPosition},
+            {"MaterialInfo",                    UniformType::MaterialInfo},
+            {"LightInfo",                       UniformType::LightInfo},
+            {"LightDirectional",                UniformType::LightDirectional},
+            {"LightPoint",                      UniformType::LightPoint},
+            {"LightPointSimple",                UniformType::LightPointSimple},
+            {"LightLine",                       UniformType::LightLine},
+            {"LightSpot",                       UniformType::LightSpot},
+            {"LightPointViewProjectionList",    UniformType::LightPointViewProjectionList},
+            {"LightDirectViewProjectionList",   UniformType::LightDirectViewProjectionList},
+            {"LightDirectViewProjection",       UniformType::LightDirectViewProjection},
+            {"BoneMatrices",                    UniformType::BoneMatrices},
+            {"ClipPlane",                       UniformType::ClipPlane},
+            {"ParticleEmitter",                 UniformType::ParticleEmitter},
+            {"ParticleAffector",                UniformType::ParticleAffector},
+            {"ParticleCount",                   UniformType::ParticleCount},
+            {"SpritesheetSize",                 UniformType::SpritesheetSize},
+            {"ImageSize",                       UniformType::ImageSize},
+            {"TextInfo",                        UniformType::TextInfo},
+            {"GlyphInfoList",                   UniformType::GlyphInfoList},
+            {"TextSymbolList",                  UniformType::TextSymbolList},
+            {"OverlayInfo",                     UniformType::OverlayInfo},
+            {"CustomFloat",                     UniformType::CustomFloat},
+            {"CustomVec4",                      UniformType::CustomVec4},
+            {"CustomMat4",                      UniformType::CustomMat4},
+            {"Time",                            UniformType::Time},
+            {"DeltaTime",                       UniformType::DeltaTime},
+    };
+
+    std::vector<UniformInfo> uniformList;
+    auto list = document["uniformList"].GetArray();
+    for (auto& item : list)
+    {
+        UniformInfo uniformInfo {};
+        uniformInfo.uniformType = uniformMap.at(item["uniformType"].GetString());
+        setOptional(uniformInfo.uniformIndex = item["uniformIndex"].GetInt());
+        uniformList.push_back(std::move(uniformInfo));
+    }
+
+    return uniformList;
+}
+
+std::vector<BufferType> getBufferTypeList(rj::Document& document)
+{
+    static const std::map<std::string, BufferType> bufferMap{
+            {"AtomicCounter",     BufferType::AtomicCounter },
+            {"ModelMatrixList",   BufferType::ModelMatrixList },
+            {"TextSymbolList",    BufferType::TextSymbolList },
+    };
+
+    std::vector<BufferType> bufferList;
+    auto list = document["bufferList"].GetArray();
+    for (auto& item : list)
+    {
+        auto bufferType = bufferMap.at(item.GetString());
+        bufferList.push_back(bufferType);
+    }
+
+    return bufferList;
+}
+
+VertexInfo getVertexInfo(rj::Document& document)
+{
+    static const std::map<std::string, VertexInfo::VertexDataType> vertexDataTypeMap{
+            {"Position",    VertexInfo::VertexDataType::Position},
+            {"Color",       VertexInfo::VertexDataType::Color},
+            {"TexCoord",    VertexInfo::VertexDataType::TexCoord},
+            {"Normal",      VertexInfo::VertexDataType::Normal},
+            {"Binormal",    VertexInfo::VertexDataType::Binormal},
+            {"Tangent",     VertexInfo::VertexDataType::Tangent},
+            {"BoneWeights", VertexInfo::VertexDataType::BoneWeights},
+            {"BoneIds",     VertexInfo::VertexDataType::BoneIds},
+            {"Custom",      VertexInfo::VertexDataType::Custom},
+    };
+
+    VertexInfo info {};
+
+    auto vertexInfo = document["vertexInfo"].GetObject();
+    auto vertexDataFlags = vertexInfo["vertexDataFlags"].GetArray();
+
+    info.vertexDataFlags = 0;
+    for (auto& item : vertexDataFlags)
+    {
+        info.vertexDataFlags |= vertexDataTypeMap.at(item.GetString());
+    }
+    setOptional(info.positionSize = static_cast<uint8_t>(vertexInfo["positionSize"].GetUint()));
+    setOptional(info.colorSize = static_cast<uint8_t>(vertexInfo["colorSize"].GetUint()));
+    setOptional(info.customCount = static_cast<uint8_t>(vertexInfo["customCount"].GetUint()));
+    setOptional(info.separateBinding = static_cast<uint8_t>(vertexInfo["separateBinding"].GetBool()));
+
+    return info;
+}
+
+std::vector<std::string> getStringList(rj::Document& document, const std::string& listName)
+{
+    auto list = document[listName.c_str()].GetArray();
+
+    std::vector<std::string> stringList;
+    for (auto& item : list)
+    {
+        stringList.emplace_back(item.GetString());
+    }
+
+    return stringList;
+}
+
+} // anon namespace
+
+ShaderSettings loadShaderSettings(const std::string& data)
+{
+    static const std::map<std::string, ShaderType> shaderTypeMap{
+            {"VertexShader",   ShaderType::VertexShader},
+            {"FragmentShader", ShaderType::FragmentShader},
+            {"GeometryShader", ShaderType::GeometryShader},
+            {"ComputeShader",  ShaderType::ComputeShader},
+    };
+
+    rj::Document document;
+    document.Parse(data.c_str());
+
+    ShaderSettings shaderSettings {};
+    shaderSettings.name = document["name"].GetString();
+    setOptional(shaderSettings.maxBonesSize = document["maxBonesSize"].GetUint());
+    setOptional(shaderSettings.maxLightSize = document["maxLightSize"].GetUint());
+    setOptional(shaderSettings.maxCascadeLightSize = document["maxCascadeLightSize"].GetUint());
+    setOptional(shaderSettings.maxShadowPointLightSize = document["maxShadowPointLightSize"].GetUint());
+    setOptional(shaderSettings.maxLineLightSize = document["maxLineLightSize"].GetUint());
+    setOptional(shaderSettings.maxViewProjectionMatrices = document["maxViewProjectionMatrices"].GetUint());
+    setOptional(shaderSettings.uniformList = getUniformInfoList(document));
+    setOptional(shaderSettings.bufferList = getBufferTypeList(document));
+    setOptional(shaderSettings.vertexInfo = getVertexInfo(document));
+    setOptional(shaderSettings.maxGlyphCount = document["maxGlyphCount"].GetUint());
+    setOptional(shaderSettings.samplerNamesList = getStringList(document, "samplerNamesList"));
+    shaderSettings.filename = document["filename"].GetString();
+    shaderSettings.shaderType = shaderTypeMap.at(document["shaderType"].GetString());
+    setOptional(shaderSettings.entryPoint = document["entryPoint"].GetString());
+
+    return shaderSettings;
+}
+
+} // namespace SVE
\ No newline at end of file
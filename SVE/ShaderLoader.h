@@ -0,0 +1,14 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "ShaderSettings.h"
+#include <string>
+
+namespace SVE
+{
+
+// Parses shader JSON, filename is left as written in resource and should be resolved by caller
+ShaderSettings loadShaderSettings(const std::string& data);
+
+} // namespace SVE
\ No newline at end of file
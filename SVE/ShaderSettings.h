@@ -78,16 +78,21 @@ struct MaterialInfo
     float _padding[2];
 };
 
-struct StorageData
+// Non-owning view of uniform array, memory is kept by entity or frame uniforms arena
+template <typename T>
+struct UniformArray
 {
-    std::vector<glm::mat4> modelList;
+    const T* data = nullptr;
+    size_t size = 0;
 };
 
-struct UniformData
+// Uniforms shared by all objects of pass (camera, lights), filled once per frame.
+// Kept between frames, so lists don't reallocate after first frames.
+struct PassUniformData
 {
-    glm::mat4 model;
     glm::mat4 view;
     glm::mat4 projection;
+    glm::mat4 viewProjection;  // projection * view, calculated after pass data is filled
     std::vector<glm::mat4> viewProjectionList;
     std::vector<glm::mat4> lightDirectViewProjectionList;
     std::vector<glm::mat4> lightPointViewProjectionList;
@@ -95,31 +100,49 @@ struct UniformData
     glm::vec4 clipPlane;  // (Nx, Ny, Nz, DistanceFromOrigin)
     float time = 0;
     float deltaTime = 0;
-    MaterialInfo materialInfo {};
     DirLight dirLight {};
     std::vector<PointLight> shadowPointLightList;
     std::vector<PointLight> pointLightList;
     std::vector<LineLight> lineLightList;
     SpotLight spotLight {};
     LightInfo lightInfo {};
-    std::vector<glm::mat4> bones;
+    glm::ivec4 imageSize;
+};
+
+// Uniforms of single drawn object. Allocated from frame arena and shared by all passes of object.
+struct ObjectUniformData
+{
+    glm::mat4 model;
+    // Calculated by first material which needs it
+    mutable glm::mat4 inverseModel;
+    mutable bool isInverseModelReady = false;
+    float time = 0;
+    float deltaTime = 0;
+    MaterialInfo materialInfo {};
+    UniformArray<glm::mat4> bones;
 
     ParticleEmitter particleEmitter {};
     ParticleAffector particleAffector {};
     uint32_t particleCount = 0;
     glm::ivec2 spritesheetSize;
-    glm::ivec4 imageSize;
 
     UniformTextInfo textInfo {};
     UniformOverlayInfo overlayInfo {};
-    std::vector<GlyphInfo> glyphList;
-    std::vector<TextSymbolInfo> textSymbolList;
+    UniformArray<GlyphInfo> glyphList;
+    UniformArray<TextSymbolInfo> textSymbolList;
 
     float customFloat;
     glm::vec4 customVec4;
     glm::mat4 customMat4;
 };
 
+// Everything material can read from: pass block and object block
+struct UniformData
+{
+    const PassUniformData& pass;
+    const ObjectUniformData& object;
+};
+
 struct UniformInfo
 {
     UniformType uniformType;
@@ -147,6 +170,58 @@ struct VertexInfo
     bool separateBinding = true;
 };
 
+// Vertex buffer bindings of meshes (used by shaders with separate binding).
+// Positions have own stream, so depth and shadow passes fetch only them,
+// other attributes are interleaved in surface stream, skinned meshes have bones stream.
+enum class VertexStream : uint32_t
+{
+    Position = 0,
+    Surface,
+    Skin,
+    Count
+};
+
+struct SurfaceVertex
+{
+    glm::vec3 color;
+    glm::vec2 texCoord;
+    glm::vec3 normal;
+    glm::vec3 binormal;
+    glm::vec3 tangent;
+};
+
+struct SkinVertex
+{
+    glm::vec4 boneWeights;
+    glm::ivec4 boneIds;
+};
+
+// Storage format of mesh position and surface streams.
+// Compact format is decoded by vertex fetch, so shaders are the same for both formats,
+// but pipelines differ in attribute formats.
+enum class VertexFormat : uint8_t
+{
+    Full = 0,
+    Compact,
+    Count
+};
+
+// Half float xyz, w is unused
+struct CompactPositionVertex
+{
+    uint64_t position;
+};
+
+// Unorm8 color, half float texture coordinates and snorm8 directions
+struct CompactSurfaceVertex
+{
+    uint32_t color;
+    uint32_t texCoord;
+    uint32_t normal;
+    uint32_t binormal;
+    uint32_t tangent;
+};
+
 struct ShaderSettings
 {
     std::string name;
@@ -171,8 +246,5 @@ struct ShaderSettings
 
 const std::map<UniformType, size_t>& getUniformSizeMap();
 const std::map<BufferType, size_t>& getStorageBufferSizeMap();
-std::vector<char> getUniformDataByType(const UniformData& data, UniformType type);
-std::vector<char> getStorageDataByType(const StorageData& data, BufferType type);
-void updateStorageDataByUniforms(const UniformData& data, StorageData& storageData, BufferType type);
 
 } // namespace SVE
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include "Material.h"
 #include "VulkanMaterial.h"
 #include "VulkanMesh.h"
+#include "RecordingContext.h"
+#include "FrameUniforms.h"
 #include "Utils.h"
 
 namespace SVE
@@ -80,49 +82,61 @@ Skybox::Skybox(const std::string& materialName)
         setupMaterial();
 }
 
-Skybox::~Skybox() = default;
+Skybox::~Skybox()
+{
+    if (_material)
+    {
+        _material->getVulkanMaterial()->deleteInstance(_materialInstance);
+        _material->getVulkanMaterial()->deleteInstance(_reflectionMaterialInstance);
+        _material->getVulkanMaterial()->deleteInstance(_refractionMaterialInstance);
+    }
+}
 
-void Skybox::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
+void Skybox::applyDrawingCommands(const RecordingContext& context) const
 {
     // TODO: Probably should not be rendered on shadow pass (and possibly refraction)
-    uint32_t materialIndex;
-    switch (Engine::getInstance()->getPassType())
+    MaterialInstance materialInstance;
+    switch (context.passType)
     {
         case CommandsType::MainPass:
-            materialIndex = _materialIndex;
+            materialInstance = _materialInstance;
             break;
         case CommandsType::ReflectionPass:
-            materialIndex = _reflectionMaterialIndex;
+            materialInstance = _reflectionMaterialInstance;
             break;
         case CommandsType::RefractionPass:
-            materialIndex = _refractionMaterialIndex;
+            materialInstance = _refractionMaterialInstance;
             break;
         default:
-            materialIndex = _materialIndex;
+            materialInstance = _materialInstance;
     }
-    _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, materialIndex);
-    _mesh->getVulkanMesh()->applyDrawingCommands(bufferIndex);
+    _material->getVulkanMaterial()->applyDrawingCommands(context, materialInstance);
+    _mesh->getVulkanMesh()->applyDrawingCommands(context);
 }
 
-void Skybox::updateUniforms(UniformDataList uniformDataList) const
+void Skybox::updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const
 {
-    _material->getVulkanMaterial()->setUniformData(_materialIndex, *uniformDataList[toInt(CommandsType::MainPass)]);
+    const auto& objectData = frameUniforms.createObjectData(model);
+    _material->getVulkanMaterial()->setUniformData(
+            _materialInstance, { frameUniforms.getPassData(CommandsType::MainPass), objectData });
 
     if (Engine::getInstance()->isWaterEnabled())
     {
-        _material->getVulkanMaterial()->setUniformData(_reflectionMaterialIndex, *uniformDataList[toInt(CommandsType::ReflectionPass)]);
-        _material->getVulkanMaterial()->setUniformData(_refractionMaterialIndex, *uniformDataList[toInt(CommandsType::RefractionPass)]);
+        _material->getVulkanMaterial()->setUniformData(
+                _reflectionMaterialInstance, { frameUniforms.getPassData(CommandsType::ReflectionPass), objectData });
+        _material->getVulkanMaterial()->setUniformData(
+                _refractionMaterialInstance, { frameUniforms.getPassData(CommandsType::RefractionPass), objectData });
     }
 }
 
 void Skybox::setupMaterial()
 {
-    _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
+    _materialInstance = _material->getVulkanMaterial()->createInstance();
 
     if (Engine::getInstance()->isWaterEnabled())
     {
-        _reflectionMaterialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this, 1);
-        _refractionMaterialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this, 2);
+        _reflectionMaterialInstance = _material->getVulkanMaterial()->createInstance();
+        _refractionMaterialInstance = _material->getVulkanMaterial()->createInstance();
     }
 }
 
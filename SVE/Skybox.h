@@ -3,6 +3,7 @@
 // Licensed under the MIT License
 #pragma once
 #include "Entity.h"
+#include "MaterialInstance.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -18,8 +19,8 @@ public:
     explicit Skybox(const std::string& materialName);
     ~Skybox() override;
 
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
-    void updateUniforms(UniformDataList uniformDataList) const override;
+    void applyDrawingCommands(const RecordingContext& context) const override;
+    void updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const override;
 
 private:
     void setupMaterial();
@@ -28,9 +29,9 @@ private:
     std::shared_ptr<Mesh> _mesh;
     Material* _material = nullptr;
 
-    uint32_t _materialIndex = 0;
-    uint32_t _reflectionMaterialIndex = 0;
-    uint32_t _refractionMaterialIndex = 0;
+    MaterialInstance _materialInstance;
+    MaterialInstance _reflectionMaterialInstance;
+    MaterialInstance _refractionMaterialInstance;
 };
 
 } // namespace SVE
\ No newline at end of file
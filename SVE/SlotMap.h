@@ -0,0 +1,99 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SVE
+{
+
+// Items addressed by generational handles (Handle has index and generation fields).
+// Slots of removed items go to free list and are reused without clearing item, so its memory is kept.
+// Generation of slot is increased on remove, so old handles don't match reused slot.
+// Zero generation is never used by items, so default handle is always invalid.
+template <typename Handle, typename T>
+class SlotMap
+{
+public:
+    Handle create()
+    {
+        uint32_t index;
+        if (!_freeSlots.empty())
+        {
+            index = _freeSlots.back();
+            _freeSlots.pop_back();
+        } else {
+            index = static_cast<uint32_t>(_slots.size());
+            _slots.emplace_back();
+        }
+
+        auto& slot = _slots[index];
+        slot.isUsed = true;
+        Handle handle {};
+        handle.index = index;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    // Removing invalid handle does nothing
+    void remove(Handle handle)
+    {
+        if (!isValid(handle))
+            return;
+
+        auto& slot = _slots[handle.index];
+        slot.isUsed = false;
+        // Skip zero on overflow, it's reserved for invalid handles
+        if (++slot.generation == 0)
+            slot.generation = 1;
+        _freeSlots.push_back(handle.index);
+    }
+
+    bool isValid(Handle handle) const
+    {
+        return handle.index < _slots.size()
+               && _slots[handle.index].isUsed
+               && _slots[handle.index].generation == handle.generation;
+    }
+
+    T& get(Handle handle)
+    {
+        assert(isValid(handle));
+        return _slots[handle.index].item;
+    }
+
+    const T& get(Handle handle) const
+    {
+        assert(isValid(handle));
+        return _slots[handle.index].item;
+    }
+
+    // Number of slots ever created, live items and free slots
+    size_t getSlotCount() const
+    {
+        return _slots.size();
+    }
+
+    size_t getSize() const
+    {
+        return _slots.size() - _freeSlots.size();
+    }
+
+private:
+    using Generation = decltype(Handle::generation);
+
+    struct Slot
+    {
+        T item {};
+        Generation generation = 1;
+        bool isUsed = false;
+    };
+
+    std::vector<Slot> _slots;
+    std::vector<uint32_t> _freeSlots;
+};
+
+} // namespace SVE
\ No newline at end of file
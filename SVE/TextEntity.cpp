@@ -5,6 +5,8 @@
 #include "VulkanInstance.h"
 #include "VulkanMaterial.h"
 #include "MaterialManager.h"
+#include "RecordingContext.h"
+#include "FrameUniforms.h"
 #include "Utils.h"
 
 namespace SVE
@@ -14,13 +16,13 @@ TextEntity::TextEntity(TextInfo textInfo)
     : _textInfo(std::move(textInfo))
     , _material(Engine::getInstance()->getMaterialManager()->getMaterial(_textInfo.font->materialName))
 {
-    _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
+    _materialInstance = _material->getVulkanMaterial()->createInstance();
     _renderLast = true;
 }
 
 TextEntity::~TextEntity()
 {
-    _material->getVulkanMaterial()->deleteInstancesForEntity(this);
+    _material->getVulkanMaterial()->deleteInstance(_materialInstance);
 }
 
 TextInfo& TextEntity::getText()
@@ -34,36 +36,43 @@ void TextEntity::setText(TextInfo textInfo)
     _textInfo = std::move(textInfo);
 }
 
-void TextEntity::updateUniforms(UniformDataList uniformDataList) const
+void TextEntity::updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const
 {
-    auto& uniformData = *uniformDataList[toInt(CommandsType::MainPass)];
-    uniformData.textInfo.symbolCount = _textInfo.symbolCount;
-    uniformData.textInfo.fontImageSize = glm::vec2(_textInfo.font->width, _textInfo.font->height);
-    uniformData.textInfo.imageSize = Engine::getInstance()->getRenderWindowSize();
-    uniformData.textInfo.maxHeight = _textInfo.font->maxHeight;
-    uniformData.textInfo.maxGlyphHeight = _textInfo.font->maxGlyphHeight;
-    uniformData.textInfo.scale = _textInfo.scale;
-    uniformData.textInfo.color = _textInfo.color;
-    uniformData.glyphList.reserve(300);
-    std::copy(_textInfo.font->symbols, _textInfo.font->symbols + 300, std::back_inserter(uniformData.glyphList));
-    uniformData.glyphList.resize(300);
-    uniformData.textSymbolList.reserve(_textInfo.symbolCount);
-    uniformData.textSymbolList = _textInfo.symbols;
+    auto& objectData = frameUniforms.createObjectData(model);
+    objectData.textInfo.symbolCount = _textInfo.symbolCount;
+    objectData.textInfo.fontImageSize = glm::vec2(_textInfo.font->width, _textInfo.font->height);
+    objectData.textInfo.imageSize = Engine::getInstance()->getRenderWindowSize();
+    objectData.textInfo.maxHeight = _textInfo.font->maxHeight;
+    objectData.textInfo.maxGlyphHeight = _textInfo.font->maxGlyphHeight;
+    objectData.textInfo.scale = _textInfo.scale;
+    objectData.textInfo.color = _textInfo.color;
+    // Glyphs and symbols are read directly from font and text info, no copies are needed
+    objectData.glyphList = { _textInfo.font->symbols, 300 };
+    objectData.textSymbolList = { _textInfo.symbols.data(), _textInfo.symbols.size() };
 
-    _material->getVulkanMaterial()->setUniformData(_materialIndex, *uniformDataList[toInt(CommandsType::MainPass)]);
+    _material->getVulkanMaterial()->setUniformData(
+            _materialInstance, { frameUniforms.getPassData(CommandsType::MainPass), objectData });
 }
 
-void TextEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
+void TextEntity::applyDrawingCommands(const RecordingContext& context) const
 {
-    if (Engine::getInstance()->getPassType() == CommandsType::MainPass
-        || Engine::getInstance()->getPassType() == CommandsType::ScreenQuadPass
-        || Engine::getInstance()->getPassType() == CommandsType::ScreenQuadLatePass)
+    if (isDrawnInPass(context.passType))
     {
-        auto commandBuffer = Engine::getInstance()->getVulkanInstance()->getCommandBuffer(bufferIndex);
-
-        _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _materialIndex);
-        vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+        _material->getVulkanMaterial()->applyDrawingCommands(context, _materialInstance);
+        vkCmdDraw(context.commandBuffer, 6, 1, 0, 0);
     }
 }
 
+bool TextEntity::isDrawnInPass(CommandsType passType) const
+{
+    return passType == CommandsType::MainPass
+           || passType == CommandsType::ScreenQuadPass
+           || passType == CommandsType::ScreenQuadLatePass;
+}
+
+VulkanMaterial* TextEntity::getPassMaterial(CommandsType passType) const
+{
+    return _material->getVulkanMaterial();
+}
+
 } // namespace SVE
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "TextSettings.h"
 #include "Material.h"
 #include "Mesh.h"
+#include "MaterialInstance.h"
 
 namespace SVE
 {
@@ -19,13 +20,15 @@ public:
     TextInfo& getText();
     void setText(TextInfo textInfo);
 
-    void updateUniforms(UniformDataList uniformDataList) const override;
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
+    void updateUniforms(FrameUniforms& frameUniforms, const glm::mat4& model) const override;
+    void applyDrawingCommands(const RecordingContext& context) const override;
+    bool isDrawnInPass(CommandsType passType) const override;
+    VulkanMaterial* getPassMaterial(CommandsType passType) const override;
 
 private:
     TextInfo _textInfo;
     Material* _material;
-    uint32_t _materialIndex;
+    MaterialInstance _materialInstance;
 };
 
 } // namespace SVE
\ No newline at end of file
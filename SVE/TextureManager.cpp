@@ -0,0 +1,386 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "TextureManager.h"
+#include "Engine.h"
+#include "ResourceManager.h"
+#include "VulkanInstance.h"
+#include "VulkanUploadBatcher.h"
+#include "VulkanException.h"
+
+#include <stb/stb_image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SVE
+{
+namespace
+{
+
+VkSamplerAddressMode getAddressMode(TextureAddressMode mode)
+{
+    static const std::map<TextureAddressMode, VkSamplerAddressMode> addressModeMap {
+            { TextureAddressMode::Repeat,               VK_SAMPLER_ADDRESS_MODE_REPEAT },
+            { TextureAddressMode::MirroredRepeat,       VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT },
+            { TextureAddressMode::ClampToEdge,          VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE },
+            { TextureAddressMode::ClampToBorder,        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER },
+            { TextureAddressMode::MirrorClampToEdge,    VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE },
+    };
+
+    return addressModeMap.at(mode);
+}
+
+// Baked variants in order of preference, compressed ones are used only if GPU supports their format
+const std::vector<std::pair<std::string, VkFormat>> BakedTextureSuffixes {
+        { ".astc.ktx2", VK_FORMAT_ASTC_4x4_UNORM_BLOCK },
+        { ".bc7.ktx2",  VK_FORMAT_BC7_UNORM_BLOCK },
+        { ".etc2.ktx2", VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK },
+        { ".ktx2",      VK_FORMAT_R8G8B8A8_UNORM },
+};
+
+// Staging offsets of copied levels must be multiple of texel block size
+constexpr VkDeviceSize StagingLevelAlignment = 16;
+
+VkBorderColor getBorderColor(TextureBorderColor color)
+{
+    switch (color)
+    {
+        case TextureBorderColor::TransparentBlack:
+            return VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+        case TextureBorderColor::SolidBlack:
+            return VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+        case TextureBorderColor::SolidWhite:
+            return VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    }
+
+    throw VulkanException("Unsupported texture border color");
+}
+
+} // anon namespace
+
+VulkanTexture::VulkanTexture(VkImage image, VkDeviceMemory memory, VkImageView imageView, uint32_t mipLevels, VkDeviceSize size)
+    : _device(Engine::getInstance()->getVulkanInstance()->getLogicalDevice())
+    , _image(image)
+    , _memory(memory)
+    , _imageView(imageView)
+    , _mipLevels(mipLevels)
+    , _size(size)
+{
+}
+
+VulkanTexture::~VulkanTexture()
+{
+    vkDestroyImageView(_device, _imageView, nullptr);
+    vkDestroyImage(_device, _image, nullptr);
+    vkFreeMemory(_device, _memory, nullptr);
+}
+
+VkImageView VulkanTexture::getImageView() const
+{
+    return _imageView;
+}
+
+uint32_t VulkanTexture::getMipLevels() const
+{
+    return _mipLevels;
+}
+
+VkDeviceSize VulkanTexture::getSize() const
+{
+    return _size;
+}
+
+TextureManager::TextureManager(const VulkanInstance* vulkanInstance)
+    : _gpu(vulkanInstance->getGPU())
+    , _device(vulkanInstance->getLogicalDevice())
+{
+    for (auto& suffix : BakedTextureSuffixes)
+    {
+        if (isFormatSupported(suffix.second))
+            _bakedSuffixes.push_back(suffix.first);
+    }
+}
+
+TextureManager::~TextureManager()
+{
+    for (auto& sampler : _samplerMap)
+        vkDestroySampler(_device, sampler.second, nullptr);
+}
+
+std::shared_ptr<VulkanTexture> TextureManager::getTexture(const std::string& filename)
+{
+    auto textureIter = _textureMap.find(filename);
+    if (textureIter != _textureMap.end())
+    {
+        if (auto texture = textureIter->second.lock())
+        {
+            ++_statistics.reuseCount;
+            _statistics.reusedBytes += texture->getSize();
+            return texture;
+        }
+    }
+
+    auto texture = loadTexture(filename);
+    _textureMap[filename] = texture;
+    return texture;
+}
+
+bool TextureManager::isTextureLoaded(const std::string& filename) const
+{
+    auto textureIter = _textureMap.find(filename);
+    return textureIter != _textureMap.end() && !textureIter->second.expired();
+}
+
+TextureManager::DecodedImage TextureManager::decodeImage(const std::string& filename) const
+{
+    DecodedImage image;
+    auto* resourceManager = Engine::getInstance()->getResourceManager();
+
+    // Baked texture already has all levels in GPU format, only the file content is kept
+    auto bakedFilename = findBakedTexture(filename);
+    if (!bakedFilename.empty())
+    {
+        auto fileContent = resourceManager->loadFileView(bakedFilename);
+        auto textureInfo = readKtxTexture(fileContent);
+        if (!isFormatSupported(textureInfo.format))
+        {
+            throw VulkanException("Texture format of " + bakedFilename + " isn't supported by GPU");
+        }
+
+        image.data = std::shared_ptr<const uint8_t>(fileContent.getDataPtr(), reinterpret_cast<const uint8_t*>(fileContent.data()));
+        image.format = textureInfo.format;
+        image.width = textureInfo.width;
+        image.height = textureInfo.height;
+        image.levels = std::move(textureInfo.levels);
+        image.isBaked = true;
+        return image;
+    }
+
+    int texWidth, texHeight, texChannels;
+    auto fileContent = resourceManager->loadFileView(filename);
+    stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(fileContent.data()), fileContent.size(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+    if (!pixels)
+    {
+        throw VulkanException("Can't load texture " + filename);
+    }
+
+    image.data = std::shared_ptr<const uint8_t>(pixels, stbi_image_free);
+    image.width = static_cast<uint32_t>(texWidth);
+    image.height = static_cast<uint32_t>(texHeight);
+    image.levels.push_back({0, static_cast<VkDeviceSize>(image.width) * image.height * 4, image.width, image.height});
+    return image;
+}
+
+void TextureManager::addDecodedImage(const std::string& filename, DecodedImage image)
+{
+    _decodedImages[filename] = std::move(image);
+}
+
+VkSampler TextureManager::getSampler(TextureAddressMode addressMode, TextureBorderColor borderColor, uint32_t mipLevels)
+{
+    auto key = std::make_tuple(addressMode, borderColor, mipLevels);
+    auto samplerIter = _samplerMap.find(key);
+    if (samplerIter != _samplerMap.end())
+        return samplerIter->second;
+
+    VkSamplerCreateInfo samplerCreateInfo{};
+    samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+    samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+
+    auto vkAddressMode = getAddressMode(addressMode);
+    samplerCreateInfo.addressModeU = vkAddressMode;
+    samplerCreateInfo.addressModeV = vkAddressMode;
+    samplerCreateInfo.addressModeW = vkAddressMode;
+    samplerCreateInfo.borderColor = getBorderColor(borderColor);
+    samplerCreateInfo.anisotropyEnable = VK_TRUE;
+    samplerCreateInfo.maxAnisotropy = 16;
+    samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerCreateInfo.compareEnable = VK_FALSE;
+    samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerCreateInfo.minLod = 0;
+    samplerCreateInfo.maxLod = mipLevels;
+    samplerCreateInfo.mipLodBias = 0;
+
+    VkSampler sampler;
+    auto result = vkCreateSampler(_device, &samplerCreateInfo, nullptr, &sampler);
+    if (result != VK_SUCCESS)
+    {
+        throw SVE::VulkanException("Can't create Vulkan texture sampler", result);
+    }
+
+    _samplerMap[key] = sampler;
+    return sampler;
+}
+
+const TextureManager::Statistics& TextureManager::getStatistics() const
+{
+    return _statistics;
+}
+
+std::string TextureManager::findBakedTexture(const std::string& filename) const
+{
+    // Texture can be referenced by its baked file directly
+    static const std::string ktxExtension = ".ktx2";
+    if (filename.size() > ktxExtension.size() &&
+        filename.compare(filename.size() - ktxExtension.size(), ktxExtension.size(), ktxExtension) == 0)
+        return filename;
+
+    auto fileSystem = Engine::getInstance()->getResourceManager()->getFileSystem();
+    auto extensionPos = filename.find_last_of('.');
+    auto slashPos = filename.find_last_of('/');
+    auto basename = extensionPos != std::string::npos && (slashPos == std::string::npos || extensionPos > slashPos)
+            ? filename.substr(0, extensionPos)
+            : filename;
+
+    for (auto& suffix : _bakedSuffixes)
+    {
+        auto bakedFilename = basename + suffix;
+        if (fileSystem->getEntity(bakedFilename)->exist())
+            return bakedFilename;
+    }
+
+    return std::string();
+}
+
+bool TextureManager::isFormatSupported(VkFormat format) const
+{
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(_gpu, format, &formatProperties);
+    return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+}
+
+std::shared_ptr<VulkanTexture> TextureManager::loadTexture(const std::string& filename)
+{
+    auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
+    const auto& vulkanUtils = vulkanInstance->getVulkanUtils();
+
+    // Use pixel data decoded on loading threads if it's available
+    DecodedImage decodedImage;
+    auto decodedIter = _decodedImages.find(filename);
+    if (decodedIter != _decodedImages.end())
+    {
+        decodedImage = std::move(decodedIter->second);
+        _decodedImages.erase(decodedIter);
+    } else {
+        decodedImage = decodeImage(filename);
+    }
+    auto texWidth = decodedImage.width;
+    auto texHeight = decodedImage.height;
+    auto format = decodedImage.format;
+
+    // Baked texture is copied level by level as is, decoded image gets mips generated by blits
+    auto generateMips = !decodedImage.isBaked;
+    auto mipLevels = generateMips
+            ? static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1
+            : static_cast<uint32_t>(decodedImage.levels.size());
+
+    VkDeviceSize stagingSize = 0;
+    VkDeviceSize levelsSize = 0;
+    for (auto& level : decodedImage.levels)
+    {
+        stagingSize = (stagingSize + StagingLevelAlignment - 1) / StagingLevelAlignment * StagingLevelAlignment + level.size;
+        levelsSize += level.size;
+    }
+
+    // Copy pixel data into staging memory, commands below go to the same batch
+    auto* uploadBatcher = vulkanInstance->getUploadBatcher();
+    uploadBatcher->beginBatch();
+    auto staging = uploadBatcher->allocateStaging(stagingSize);
+
+    std::vector<VkBufferImageCopy> bufferCopyRegions;
+    VkDeviceSize stagingOffset = 0;
+    for (auto i = 0u; i < decodedImage.levels.size(); ++i)
+    {
+        const auto& level = decodedImage.levels[i];
+        stagingOffset = (stagingOffset + StagingLevelAlignment - 1) / StagingLevelAlignment * StagingLevelAlignment;
+        memcpy(staging.data + stagingOffset, decodedImage.data.get() + level.offset, static_cast<size_t>(level.size));
+
+        VkBufferImageCopy bufferCopyRegion = {};
+        bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        bufferCopyRegion.imageSubresource.mipLevel = i;
+        bufferCopyRegion.imageSubresource.baseArrayLayer = 0;
+        bufferCopyRegion.imageSubresource.layerCount = 1;
+        bufferCopyRegion.imageExtent.width = level.width;
+        bufferCopyRegion.imageExtent.height = level.height;
+        bufferCopyRegion.imageExtent.depth = 1;
+        bufferCopyRegion.bufferOffset = staging.offset + stagingOffset;
+        bufferCopyRegions.push_back(bufferCopyRegion);
+
+        stagingOffset += level.size;
+    }
+
+    // Free pixel data
+    decodedImage.data.reset();
+
+    // Create texture image which will be used in shaders
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (generateMips)
+        usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+    VkImage image;
+    VkDeviceMemory imageMemory;
+    vulkanUtils.createImage(texWidth,
+                            texHeight,
+                            mipLevels,
+                            VK_SAMPLE_COUNT_1_BIT,
+                            format,
+                            VK_IMAGE_TILING_OPTIMAL,
+                            usage,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            image,
+                            imageMemory);
+
+    // Transition layout of the image to be optimal as a transfer destination
+    vulkanUtils.transitionImageLayout(
+            image,
+            format,
+            {VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT},
+            {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT},
+            mipLevels);
+
+    // Copy image data from buffer to image
+    auto commandBuffer = vulkanUtils.beginRecordingCommands();
+    vkCmdCopyBufferToImage(commandBuffer,
+                           staging.buffer,
+                           image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           bufferCopyRegions.size(),
+                           bufferCopyRegions.data());
+    vulkanUtils.endRecordingAndSubmitCommands(commandBuffer);
+
+    if (generateMips)
+    {
+        vulkanUtils.generateMipmaps(image, format, static_cast<int32_t>(texWidth), static_cast<int32_t>(texHeight), mipLevels);
+    } else {
+        vulkanUtils.transitionImageLayout(
+                image,
+                format,
+                {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT},
+                {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT},
+                mipLevels);
+    }
+    uploadBatcher->endBatch();
+
+    auto imageView = vulkanUtils.createImageView(
+            image,
+            format,
+            mipLevels,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_IMAGE_VIEW_TYPE_2D,
+            1);
+
+    // Full mip chain takes about one third more than base level
+    auto gpuSize = generateMips ? levelsSize * 4 / 3 : levelsSize;
+    if (decodedImage.isBaked)
+        ++_statistics.bakedCount;
+    else
+        ++_statistics.decodeCount;
+    _statistics.uploadedBytes += gpuSize;
+
+    return std::make_shared<VulkanTexture>(image, imageMemory, imageView, mipLevels, gpuSize);
+}
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,99 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "MaterialSettings.h"
+#include "KtxTexture.h"
+#include "VulkanHeaders.h"
+#include <memory>
+#include <string>
+#include <tuple>
+#include <map>
+#include <unordered_map>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Image loaded from file and uploaded with full mip chain.
+// Owned by materials which sample it, GPU resources are freed with the last owner.
+class VulkanTexture
+{
+public:
+    VulkanTexture(VkImage image, VkDeviceMemory memory, VkImageView imageView, uint32_t mipLevels, VkDeviceSize size);
+    ~VulkanTexture();
+
+    VkImageView getImageView() const;
+    uint32_t getMipLevels() const;
+    VkDeviceSize getSize() const;
+
+private:
+    VkDevice _device;
+    VkImage _image;
+    VkDeviceMemory _memory;
+    VkImageView _imageView;
+    uint32_t _mipLevels;
+    VkDeviceSize _size;
+};
+
+// Loads every image file once, materials referencing the same file share the image.
+// Samplers are shared between textures with the same addressing and mip count.
+// If baked KTX2 variant of image exists (see tools/TextureBaker.cpp), it's loaded instead of decoding
+// the image: "name.astc.ktx2", "name.bc7.ktx2" or "name.etc2.ktx2" if GPU can sample the format, then "name.ktx2".
+class TextureManager
+{
+public:
+    struct Statistics
+    {
+        uint32_t decodeCount = 0;
+        uint32_t bakedCount = 0;
+        uint32_t reuseCount = 0;
+        // Memory of uploaded images and memory which would be used by duplicates without cache
+        VkDeviceSize uploadedBytes = 0;
+        VkDeviceSize reusedBytes = 0;
+    };
+
+    // Data ready for upload: RGBA pixels of decoded image or mip levels of baked texture.
+    // Mips of decoded image are generated on GPU.
+    struct DecodedImage
+    {
+        std::shared_ptr<const uint8_t> data;
+        VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<TextureLevel> levels;
+        bool isBaked = false;
+    };
+
+    explicit TextureManager(const VulkanInstance* vulkanInstance);
+    ~TextureManager();
+
+    std::shared_ptr<VulkanTexture> getTexture(const std::string& filename);
+    bool isTextureLoaded(const std::string& filename) const;
+
+    // Decoding doesn't change manager state, so it can run on loading threads.
+    // Added image is used by the next getTexture call for this file instead of decoding it again.
+    DecodedImage decodeImage(const std::string& filename) const;
+    void addDecodedImage(const std::string& filename, DecodedImage image);
+    VkSampler getSampler(TextureAddressMode addressMode, TextureBorderColor borderColor, uint32_t mipLevels);
+
+    const Statistics& getStatistics() const;
+
+private:
+    std::shared_ptr<VulkanTexture> loadTexture(const std::string& filename);
+    std::string findBakedTexture(const std::string& filename) const;
+    bool isFormatSupported(VkFormat format) const;
+
+private:
+    using SamplerKey = std::tuple<TextureAddressMode, TextureBorderColor, uint32_t>;
+
+    VkPhysicalDevice _gpu;
+    VkDevice _device;
+    std::vector<std::string> _bakedSuffixes;
+    std::unordered_map<std::string, std::weak_ptr<VulkanTexture>> _textureMap;
+    std::unordered_map<std::string, DecodedImage> _decodedImages;
+    std::map<SamplerKey, VkSampler> _samplerMap;
+    Statistics _statistics;
+};
+
+} // namespace SVE
\ No newline at end of file
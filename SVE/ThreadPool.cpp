@@ -0,0 +1,70 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "ThreadPool.h"
+
+namespace SVE
+{
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    _threads.reserve(threadCount);
+    for (auto i = 0u; i < threadCount; i++)
+    {
+        _threads.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _condition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::getThreadCount() const
+{
+    return _threads.size();
+}
+
+std::future<void> ThreadPool::addTask(std::function<void()> task)
+{
+    std::packaged_task<void()> packagedTask(std::move(task));
+    auto future = packagedTask.get_future();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(packagedTask));
+    }
+    _condition.notify_one();
+
+    return future;
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] { return _isStopping || !_tasks.empty(); });
+            if (_tasks.empty())
+                return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        // Exceptions are stored in task future
+        task();
+    }
+}
+
+} // namespace SVE
\ No newline at end of file
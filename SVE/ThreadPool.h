@@ -0,0 +1,38 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SVE
+{
+
+// Fixed set of worker threads executing tasks in FIFO order.
+// Threads live as long as pool, so per frame tasks don't pay thread creation cost.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+    size_t getThreadCount() const;
+    std::future<void> addTask(std::function<void()> task);
+
+private:
+    void workerLoop();
+
+private:
+    std::vector<std::thread> _threads;
+    std::deque<std::packaged_task<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _isStopping = false;
+};
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,197 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "UniformLayout.h"
+#include "VulkanException.h"
+#include <algorithm>
+#include <cstring>
+
+namespace SVE
+{
+
+namespace
+{
+
+template <typename T>
+void writeValue(const T& value, char* destination)
+{
+    memcpy(destination, &value, sizeof(T));
+}
+
+// Arrays longer than reserved space are cut, shorter ones leave the rest untouched
+template <typename T>
+void writeArray(const T* values, size_t count, char* destination, uint32_t size)
+{
+    memcpy(destination, values, std::min(sizeof(T) * count, static_cast<size_t>(size)));
+}
+
+template <typename T>
+void writeArray(const std::vector<T>& values, char* destination, uint32_t size)
+{
+    writeArray(values.data(), values.size(), destination, size);
+}
+
+template <typename T>
+void writeArray(const UniformArray<T>& values, char* destination, uint32_t size)
+{
+    writeArray(values.data, values.size, destination, size);
+}
+
+uint32_t getArrayCapacity(const ShaderSettings& shaderSettings, UniformType uniformType)
+{
+    switch (uniformType)
+    {
+        case UniformType::BoneMatrices:
+            return shaderSettings.maxBonesSize;
+        case UniformType::LightPoint:
+            return shaderSettings.maxShadowPointLightSize;
+        case UniformType::LightPointSimple:
+            return shaderSettings.maxPointLightSize;
+        case UniformType::LightLine:
+            return shaderSettings.maxLineLightSize;
+        case UniformType::LightPointViewProjectionList:
+            return shaderSettings.maxLightSize;
+        case UniformType::LightDirectViewProjectionList:
+            return shaderSettings.maxCascadeLightSize;
+        case UniformType::ViewProjectionMatrixList:
+            return shaderSettings.maxViewProjectionMatrices;
+        case UniformType::GlyphInfoList:
+            return shaderSettings.maxGlyphCount;
+        case UniformType::TextSymbolList:
+            return shaderSettings.maxTextSize;
+        default:
+            return 1;
+    }
+}
+
+UniformWriter getUniformWriter(UniformType uniformType)
+{
+    switch (uniformType)
+    {
+        case UniformType::ModelMatrix:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.model, destination); };
+        case UniformType::ViewMatrix:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.view, destination); };
+        case UniformType::ProjectionMatrix:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.projection, destination); };
+        case UniformType::InverseModelMatrix:
+            return [](const UniformData& data, char* destination, uint32_t)
+            {
+                // Object block is shared between passes, so inverse is calculated once per object
+                if (!data.object.isInverseModelReady)
+                {
+                    data.object.inverseModel = glm::inverse(data.object.model);
+                    data.object.isInverseModelReady = true;
+                }
+                writeValue(data.object.inverseModel, destination);
+            };
+        case UniformType::ModelViewProjectionMatrix:
+            return [](const UniformData& data, char* destination, uint32_t)
+            {
+                writeValue(data.pass.viewProjection * data.object.model, destination);
+            };
+        case UniformType::ViewProjectionMatrix:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.viewProjection, destination); };
+        case UniformType::ViewProjectionMatrixList:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.pass.viewProjectionList, destination, size); };
+        case UniformType::ViewProjectionMatrixSize:
+            return [](const UniformData& data, char* destination, uint32_t)
+            {
+                // uint[3] padding
+                writeValue(glm::uvec4(data.pass.viewProjectionList.size(), 0, 0, 0), destination);
+            };
+        case UniformType::CameraPosition:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.cameraPos, destination); };
+        case UniformType::MaterialInfo:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.materialInfo, destination); };
+        case UniformType::LightInfo:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.lightInfo, destination); };
+        case UniformType::LightDirectional:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.dirLight, destination); };
+        case UniformType::LightPoint:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.pass.shadowPointLightList, destination, size); };
+        case UniformType::LightPointSimple:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.pass.pointLightList, destination, size); };
+        case UniformType::LightSpot:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.spotLight, destination); };
+        case UniformType::LightLine:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.pass.lineLightList, destination, size); };
+        case UniformType::LightPointViewProjectionList:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.pass.lightPointViewProjectionList, destination, size); };
+        case UniformType::LightDirectViewProjectionList:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.pass.lightDirectViewProjectionList, destination, size); };
+        case UniformType::LightDirectViewProjection:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.pass.lightDirectViewProjectionList, destination, size); };
+        case UniformType::BoneMatrices:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.object.bones, destination, size); };
+        case UniformType::ClipPlane:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.clipPlane, destination); };
+        case UniformType::ParticleEmitter:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.particleEmitter, destination); };
+        case UniformType::ParticleAffector:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.particleAffector, destination); };
+        case UniformType::ParticleCount:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.particleCount, destination); };
+        case UniformType::SpritesheetSize:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.spritesheetSize, destination); };
+        case UniformType::ImageSize:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.pass.imageSize, destination); };
+        case UniformType::TextInfo:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.textInfo, destination); };
+        case UniformType::GlyphInfoList:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.object.glyphList, destination, size); };
+        case UniformType::TextSymbolList:
+            return [](const UniformData& data, char* destination, uint32_t size) { writeArray(data.object.textSymbolList, destination, size); };
+        case UniformType::OverlayInfo:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.overlayInfo, destination); };
+        case UniformType::CustomFloat:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.customFloat, destination); };
+        case UniformType::CustomVec4:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.customVec4, destination); };
+        case UniformType::CustomMat4:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.customMat4, destination); };
+        case UniformType::Time:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.time, destination); };
+        case UniformType::DeltaTime:
+            return [](const UniformData& data, char* destination, uint32_t) { writeValue(data.object.deltaTime, destination); };
+    }
+
+    throw VulkanException("Unsupported uniform type");
+}
+
+} // anon namespace
+
+UniformLayout::UniformLayout(const ShaderSettings& shaderSettings)
+{
+    const auto& sizeMap = getUniformSizeMap();
+    _entries.reserve(shaderSettings.uniformList.size());
+    for (const auto& info : shaderSettings.uniformList)
+    {
+        auto size = sizeMap.at(info.uniformType) * getArrayCapacity(shaderSettings, info.uniformType);
+        _entries.push_back({ info.uniformType,
+                             static_cast<uint32_t>(_size),
+                             static_cast<uint32_t>(size),
+                             getUniformWriter(info.uniformType) });
+        _size += size;
+    }
+}
+
+size_t UniformLayout::getSize() const
+{
+    return _size;
+}
+
+const std::vector<UniformLayoutEntry>& UniformLayout::getEntries() const
+{
+    return _entries;
+}
+
+void UniformLayout::write(const UniformData& data, char* mappedData) const
+{
+    for (const auto& entry : _entries)
+    {
+        entry.writer(data, mappedData + entry.offset, entry.size);
+    }
+}
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,39 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "ShaderSettings.h"
+#include <vector>
+
+namespace SVE
+{
+
+// Writes uniform of single type straight to mapped memory, size is reserved space in bytes
+using UniformWriter = void (*)(const UniformData& data, char* destination, uint32_t size);
+
+struct UniformLayoutEntry
+{
+    UniformType uniformType;
+    uint32_t offset;
+    uint32_t size;
+    UniformWriter writer;
+};
+
+// Shader uniform list compiled to offset/size/writer table, built once when shader is loaded.
+// Arrays take their maximum size from shader settings, so offsets don't depend on current data.
+class UniformLayout
+{
+public:
+    explicit UniformLayout(const ShaderSettings& shaderSettings);
+
+    size_t getSize() const;
+    const std::vector<UniformLayoutEntry>& getEntries() const;
+
+    void write(const UniformData& data, char* mappedData) const;
+
+private:
+    std::vector<UniformLayoutEntry> _entries;
+    size_t _size = 0;
+};
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,116 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VertexQuantization.h"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+
+namespace SVE
+{
+namespace
+{
+
+// Below 1 mm for 1 m object
+constexpr float PositionTolerance = 1.0f / 1024;
+// Quarter of texel for 512 texture, half floats keep it for coordinates in [-2, 2] range
+constexpr float TexCoordTolerance = 1.0f / 2048;
+// One 8-bit step, colors outside [0, 1] are clamped and don't pass
+constexpr float ColorTolerance = 1.0f / 255;
+// One snorm8 step, unit vectors keep direction within half degree
+constexpr float DirectionTolerance = 1.0f / 127;
+
+float getMaxDifference(const glm::vec4& a, const glm::vec4& b)
+{
+    auto difference = glm::abs(a - b);
+    return std::max(std::max(difference.x, difference.y), std::max(difference.z, difference.w));
+}
+
+template <typename T>
+glm::vec4 getAttribute(const std::vector<T>& data, size_t index)
+{
+    glm::vec4 result(0.0f);
+    if (index < data.size())
+    {
+        for (auto i = 0; i < T::length(); i++)
+            result[i] = data[index][i];
+    }
+    return result;
+}
+
+uint32_t packDirection(const std::vector<glm::vec3>& data, size_t index, float& error)
+{
+    auto direction = getAttribute(data, index);
+    auto packed = glm::packSnorm4x8(direction);
+    error = std::max(error, getMaxDifference(direction, glm::unpackSnorm4x8(packed)));
+    return packed;
+}
+
+} // anon namespace
+
+void packCompactPositions(const MeshSettings& meshSettings, CompactPositionVertex* vertices, VertexQuantizationError& error)
+{
+    const auto& positions = meshSettings.vertexPosData;
+    if (positions.empty())
+        return;
+
+    auto minPosition = positions.front();
+    auto maxPosition = positions.front();
+    for (const auto& position : positions)
+    {
+        minPosition = glm::min(minPosition, position);
+        maxPosition = glm::max(maxPosition, position);
+    }
+    auto extent = maxPosition - minPosition;
+    auto size = std::max(std::max(extent.x, extent.y), extent.z);
+
+    float maxDifference = 0.0f;
+    for (auto i = 0u; i < positions.size(); i++)
+    {
+        auto position = glm::vec4(positions[i], 0.0f);
+        vertices[i].position = glm::packHalf4x16(position);
+        maxDifference = std::max(maxDifference, getMaxDifference(position, glm::unpackHalf4x16(vertices[i].position)));
+    }
+
+    error.position = std::max(error.position, size > 0.0f ? maxDifference / size : maxDifference);
+}
+
+void packCompactSurface(const MeshSettings& meshSettings, CompactSurfaceVertex* vertices, VertexQuantizationError& error)
+{
+    for (auto i = 0u; i < meshSettings.vertexPosData.size(); i++)
+    {
+        auto& vertex = vertices[i];
+
+        auto color = getAttribute(meshSettings.vertexColorData, i);
+        vertex.color = glm::packUnorm4x8(color);
+        error.color = std::max(error.color, getMaxDifference(color, glm::unpackUnorm4x8(vertex.color)));
+
+        auto texCoord = glm::vec2(getAttribute(meshSettings.vertexTexData, i));
+        vertex.texCoord = glm::packHalf2x16(texCoord);
+        auto texCoordDifference = glm::abs(texCoord - glm::unpackHalf2x16(vertex.texCoord));
+        error.texCoord = std::max(error.texCoord, std::max(texCoordDifference.x, texCoordDifference.y));
+
+        vertex.normal = packDirection(meshSettings.vertexNormalData, i, error.direction);
+        vertex.binormal = packDirection(meshSettings.vertexBinormalData, i, error.direction);
+        vertex.tangent = packDirection(meshSettings.vertexTangentData, i, error.direction);
+    }
+}
+
+VertexQuantizationError getCompactFormatError(const MeshSettings& meshSettings)
+{
+    VertexQuantizationError error;
+    std::vector<CompactPositionVertex> positions(meshSettings.vertexPosData.size());
+    std::vector<CompactSurfaceVertex> surface(meshSettings.vertexPosData.size());
+    packCompactPositions(meshSettings, positions.data(), error);
+    packCompactSurface(meshSettings, surface.data(), error);
+    return error;
+}
+
+bool isQuantizationErrorAcceptable(const VertexQuantizationError& error)
+{
+    return error.position <= PositionTolerance &&
+           error.texCoord <= TexCoordTolerance &&
+           error.color <= ColorTolerance &&
+           error.direction <= DirectionTolerance;
+}
+
+} // namespace SVE
\ No newline at end of file
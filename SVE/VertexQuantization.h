@@ -0,0 +1,31 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "MeshSettings.h"
+#include "ShaderSettings.h"
+
+namespace SVE
+{
+
+// Max difference between source and decoded compact data.
+// Position error is relative to mesh bounding box size, other errors are absolute per component.
+struct VertexQuantizationError
+{
+    float position = 0.0f;
+    float texCoord = 0.0f;
+    float color = 0.0f;
+    float direction = 0.0f;
+};
+
+// Pack vertex streams of mesh to compact format, missing attributes are packed as zero
+void packCompactPositions(const MeshSettings& meshSettings, CompactPositionVertex* vertices, VertexQuantizationError& error);
+void packCompactSurface(const MeshSettings& meshSettings, CompactSurfaceVertex* vertices, VertexQuantizationError& error);
+
+// Packs all streams to temporary buffers, used by offline tools to select vertex format
+VertexQuantizationError getCompactFormatError(const MeshSettings& meshSettings);
+
+// Compact format is visually the same as full one if error is inside tolerance
+bool isQuantizationErrorAcceptable(const VertexQuantizationError& error);
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,65 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanBindCache.h"
+
+namespace SVE
+{
+
+VulkanBindCache::Statistics& VulkanBindCache::Statistics::operator+=(const Statistics& other)
+{
+    pipelineBinds += other.pipelineBinds;
+    pipelineBindsSkipped += other.pipelineBindsSkipped;
+    geometryBinds += other.geometryBinds;
+    geometryBindsSkipped += other.geometryBindsSkipped;
+    return *this;
+}
+
+void VulkanBindCache::reset()
+{
+    _pipeline = VK_NULL_HANDLE;
+    _geometry = nullptr;
+}
+
+bool VulkanBindCache::isPipelineBindNeeded(VkPipeline pipeline)
+{
+    if (pipeline == _pipeline)
+    {
+        ++_statistics.pipelineBindsSkipped;
+        return false;
+    }
+
+    _pipeline = pipeline;
+    ++_statistics.pipelineBinds;
+    return true;
+}
+
+bool VulkanBindCache::isGeometryBindNeeded(const void* geometry)
+{
+    if (geometry == _geometry)
+    {
+        ++_statistics.geometryBindsSkipped;
+        return false;
+    }
+
+    _geometry = geometry;
+    ++_statistics.geometryBinds;
+    return true;
+}
+
+void VulkanBindCache::resetGeometry()
+{
+    _geometry = nullptr;
+}
+
+const VulkanBindCache::Statistics& VulkanBindCache::getStatistics() const
+{
+    return _statistics;
+}
+
+void VulkanBindCache::resetStatistics()
+{
+    _statistics = {};
+}
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,45 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <cstdint>
+
+namespace SVE
+{
+
+// Tracks pipeline and geometry bound to command buffer of one pass recording,
+// so redundant binds can be skipped. Every recording context owns separate cache.
+class VulkanBindCache
+{
+public:
+    struct Statistics
+    {
+        uint32_t pipelineBinds = 0;
+        uint32_t pipelineBindsSkipped = 0;
+        uint32_t geometryBinds = 0;
+        uint32_t geometryBindsSkipped = 0;
+
+        Statistics& operator+=(const Statistics& other);
+    };
+
+    // Forget bound state, should be called when command buffer recording starts
+    void reset();
+
+    // Return true if bind command should be recorded and remember new state
+    bool isPipelineBindNeeded(VkPipeline pipeline);
+    bool isGeometryBindNeeded(const void* geometry);
+    // Should be called after geometry buffers are bound bypassing cache
+    void resetGeometry();
+
+    const Statistics& getStatistics() const;
+    void resetStatistics();
+
+private:
+    VkPipeline _pipeline = VK_NULL_HANDLE;
+    const void* _geometry = nullptr;
+
+    Statistics _statistics;
+};
+
+} // namespace SVE
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "VulkanUtils.h"
 #include "VulkanException.h"
 #include "ShaderManager.h"
+#include "VulkanDescriptorAllocator.h"
 
 namespace SVE
 {
@@ -26,14 +27,12 @@ VulkanComputeEntity::VulkanComputeEntity(ComputeSettings computeSettings)
     createBufferResources();
 
     createUniformAndStorageBuffers();
-    createDescriptorPool();
     createDescriptorSets();
 }
 
 VulkanComputeEntity::~VulkanComputeEntity()
 {
     deleteDescriptorSets();
-    deleteDescriptorPool();
     deleteUniformAndStorageBuffers();
 
     deleteBufferResources();
@@ -51,19 +50,13 @@ void VulkanComputeEntity::setUniformData(const UniformData &uniformData) const
 {
     auto imageIndex = _vulkanInstance->getCurrentImageIndex();
 
-    size_t uniformSize = _computeShader->getShaderUniformsSize();
-    if (uniformSize == 0)
+    const auto& uniformLayout = _computeShader->getUniformLayout();
+    if (uniformLayout.getSize() == 0)
         return;
 
-    const auto& shaderSettings = _computeShader->getShaderSettings();
     char* data = nullptr;
     vmaMapMemory(_vulkanInstance->getAllocator(),  _uniformBuffersMemory[imageIndex], (void**)&data);
-    for (const auto& r : shaderSettings.uniformList)
-    {
-        auto uniformBytes = getUniformDataByType(uniformData, r.uniformType);
-        memcpy(data, uniformBytes.data(), uniformBytes.size());
-        data += uniformBytes.size();
-    }
+    uniformLayout.write(uniformData, data);
     vmaUnmapMemory(_vulkanInstance->getAllocator(), _uniformBuffersMemory[imageIndex]);
 }
 
@@ -222,38 +215,6 @@ void VulkanComputeEntity::deleteUniformAndStorageBuffers()
     }
 }
 
-void VulkanComputeEntity::createDescriptorPool()
-{
-    auto swapchainSize = _vulkanInstance->getSwapchainSize();
-
-    std::vector<VkDescriptorPoolSize> poolSizes(3);
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = _uniformBuffers.size();
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSizes[1].descriptorCount = _storageBuffers.size();
-    poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
-    poolSizes[2].descriptorCount = swapchainSize;
-    for (auto& poolSize : poolSizes)
-        if (poolSize.descriptorCount == 0)
-            poolSize.descriptorCount = 1;
-
-    VkDescriptorPoolCreateInfo poolInfo = {};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = poolSizes.size();
-    poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = swapchainSize;
-
-    if (vkCreateDescriptorPool(_device, &poolInfo, nullptr, &_descriptorPool) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Can't create Vulkan descriptor pool");
-    }
-}
-
-void VulkanComputeEntity::deleteDescriptorPool()
-{
-    vkDestroyDescriptorPool(_device, _descriptorPool, nullptr);
-}
-
 void VulkanComputeEntity::createDescriptorSets()
 {
     auto swapchainSize = _vulkanInstance->getSwapchainSize();
@@ -261,20 +222,12 @@ void VulkanComputeEntity::createDescriptorSets()
     if (_computeShader->getShaderSettings().samplerNamesList.empty() && _uniformBuffers.empty())
         return;
 
-    std::vector<VkDescriptorSetLayout> layouts(swapchainSize, _computeShader->getDescriptorSetLayout());
-
-    VkDescriptorSetAllocateInfo allocInfo {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = _descriptorPool;
-    allocInfo.descriptorSetCount = swapchainSize;
-    allocInfo.pSetLayouts = layouts.data();
-
+    // Particle systems are created and destroyed with effects, so sets come from shared allocator
     _descriptorSets.resize(swapchainSize);
-    auto result = vkAllocateDescriptorSets(_device, &allocInfo, _descriptorSets.data());
-    if (result != VK_SUCCESS)
-    {
-        throw VulkanException("Can't allocate Vulkan descriptor sets");
-    }
+    _vulkanInstance->getDescriptorAllocator()->allocate(_computeShader->getDescriptorSetLayout(),
+                                                        _computeShader->getDescriptorPoolSizes(),
+                                                        swapchainSize,
+                                                        _descriptorSets.data());
 
     auto uniformSize = _computeShader->getShaderUniformsSize();
     auto storageSize = _computeShader->getShaderStorageBuffersSize();
@@ -346,7 +299,10 @@ void VulkanComputeEntity::createDescriptorSets()
 
 void VulkanComputeEntity::deleteDescriptorSets()
 {
-
+    _vulkanInstance->getDescriptorAllocator()->free(_computeShader->getDescriptorSetLayout(),
+                                                    _descriptorSets.size(),
+                                                    _descriptorSets.data());
+    _descriptorSets.clear();
 }
 
 void VulkanComputeEntity::finishComputeStep()
@@ -44,8 +44,6 @@ private:
     void createUniformAndStorageBuffers();
     void deleteUniformAndStorageBuffers();
 
-    void createDescriptorPool();
-    void deleteDescriptorPool();
     void createDescriptorSets();
     void deleteDescriptorSets();
 
@@ -72,7 +70,6 @@ private:
     std::vector<VkBuffer> _storageBuffers;
 
     std::vector<VkDescriptorSet> _descriptorSets;
-    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
 
     VkCommandBuffer _commandBuffer = VK_NULL_HANDLE;
     bool _computeShaderNotSupported = false;
@@ -0,0 +1,144 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanException.h"
+#include <algorithm>
+
+namespace SVE
+{
+namespace
+{
+
+constexpr uint32_t FirstPoolSetCount = 16;
+constexpr uint32_t MaxPoolSetCount = 512;
+
+} // anon namespace
+
+VulkanDescriptorAllocator::VulkanDescriptorAllocator(VkDevice device, uint32_t swapchainSize)
+    : _device(device)
+    , _retiredSets(swapchainSize)
+{
+}
+
+VulkanDescriptorAllocator::~VulkanDescriptorAllocator()
+{
+    for (auto& layoutPools : _layoutPools)
+    {
+        for (auto pool : layoutPools.second.pools)
+            vkDestroyDescriptorPool(_device, pool, nullptr);
+    }
+}
+
+void VulkanDescriptorAllocator::allocate(VkDescriptorSetLayout layout,
+                                         const std::vector<VkDescriptorPoolSize>& setSizes,
+                                         uint32_t count,
+                                         VkDescriptorSet* descriptorSets)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto& layoutPools = _layoutPools[layout];
+    if (layoutPools.setSizes.empty())
+        layoutPools.setSizes = setSizes;
+
+    for (auto i = 0u; i < count; i++)
+    {
+        if (!layoutPools.freeSets.empty())
+        {
+            descriptorSets[i] = layoutPools.freeSets.back();
+            layoutPools.freeSets.pop_back();
+            continue;
+        }
+
+        if (layoutPools.poolAllocated == layoutPools.poolCapacity)
+            createPool(layoutPools);
+
+        VkDescriptorSetAllocateInfo allocInfo {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = layoutPools.pools.back();
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+
+        auto result = vkAllocateDescriptorSets(_device, &allocInfo, &descriptorSets[i]);
+        if (result != VK_SUCCESS)
+        {
+            throw VulkanException("Can't allocate Vulkan descriptor sets", result);
+        }
+        ++layoutPools.poolAllocated;
+    }
+}
+
+void VulkanDescriptorAllocator::free(VkDescriptorSetLayout layout, uint32_t count, const VkDescriptorSet* descriptorSets)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Layout can be already released on shutdown, its pools are destroyed with all sets
+    if (_layoutPools.find(layout) == _layoutPools.end())
+        return;
+
+    auto& retiredSets = _retiredSets[_imageIndex];
+    for (auto i = 0u; i < count; i++)
+        retiredSets.push_back({ layout, descriptorSets[i] });
+}
+
+void VulkanDescriptorAllocator::releaseLayout(VkDescriptorSetLayout layout)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto layoutIter = _layoutPools.find(layout);
+    if (layoutIter == _layoutPools.end())
+        return;
+
+    for (auto pool : layoutIter->second.pools)
+        vkDestroyDescriptorPool(_device, pool, nullptr);
+    _layoutPools.erase(layoutIter);
+
+    for (auto& retiredSets : _retiredSets)
+    {
+        retiredSets.erase(std::remove_if(retiredSets.begin(), retiredSets.end(), [layout](const RetiredSet& retiredSet)
+        {
+            return retiredSet.layout == layout;
+        }), retiredSets.end());
+    }
+}
+
+void VulkanDescriptorAllocator::startFrame(uint32_t imageIndex)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _imageIndex = imageIndex;
+    for (const auto& retiredSet : _retiredSets[imageIndex])
+        _layoutPools.at(retiredSet.layout).freeSets.push_back(retiredSet.descriptorSet);
+    _retiredSets[imageIndex].clear();
+}
+
+void VulkanDescriptorAllocator::createPool(LayoutPools& layoutPools) const
+{
+    // Every next pool is twice bigger, so layouts with many instances don't create lots of pools
+    auto setCount = layoutPools.pools.empty()
+                    ? FirstPoolSetCount
+                    : std::min(layoutPools.poolCapacity * 2, MaxPoolSetCount);
+
+    std::vector<VkDescriptorPoolSize> poolSizes = layoutPools.setSizes;
+    for (auto& poolSize : poolSizes)
+        poolSize.descriptorCount *= setCount;
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = poolSizes.size();
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = setCount;
+
+    VkDescriptorPool descriptorPool;
+    auto result = vkCreateDescriptorPool(_device, &poolInfo, nullptr, &descriptorPool);
+    if (result != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan descriptor pool", result);
+    }
+
+    layoutPools.pools.push_back(descriptorPool);
+    layoutPools.poolCapacity = setCount;
+    layoutPools.poolAllocated = 0;
+}
+
+} // namespace SVE
\ No newline at end of file
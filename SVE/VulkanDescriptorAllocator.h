@@ -0,0 +1,63 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace SVE
+{
+
+// Descriptor sets allocator shared by materials and compute entities.
+// Pools are created per set layout and grow when full. Freed sets go to layout free list
+// when their swapchain image is rendered again (so frames in flight don't see them rewritten)
+// and are reused by next allocations.
+class VulkanDescriptorAllocator
+{
+public:
+    VulkanDescriptorAllocator(VkDevice device, uint32_t swapchainSize);
+    ~VulkanDescriptorAllocator();
+
+    // setSizes - descriptors count by type needed for one set of layout
+    void allocate(VkDescriptorSetLayout layout,
+                  const std::vector<VkDescriptorPoolSize>& setSizes,
+                  uint32_t count,
+                  VkDescriptorSet* descriptorSets);
+    void free(VkDescriptorSetLayout layout, uint32_t count, const VkDescriptorSet* descriptorSets);
+    // Destroy pools of layout before layout itself is destroyed
+    void releaseLayout(VkDescriptorSetLayout layout);
+
+    // Recycle sets freed when image was rendered last time, should be called at frame start
+    void startFrame(uint32_t imageIndex);
+
+private:
+    struct LayoutPools
+    {
+        std::vector<VkDescriptorPoolSize> setSizes;
+        std::vector<VkDescriptorPool> pools;
+        uint32_t poolCapacity = 0;
+        uint32_t poolAllocated = 0;
+        std::vector<VkDescriptorSet> freeSets;
+    };
+
+    struct RetiredSet
+    {
+        VkDescriptorSetLayout layout;
+        VkDescriptorSet descriptorSet;
+    };
+
+    void createPool(LayoutPools& layoutPools) const;
+
+private:
+    VkDevice _device;
+
+    std::mutex _mutex;
+    std::map<VkDescriptorSetLayout, LayoutPools> _layoutPools;
+    // [image]
+    std::vector<std::vector<RetiredSet>> _retiredSets;
+    uint32_t _imageIndex = 0;
+};
+
+} // namespace SVE
\ No newline at end of file
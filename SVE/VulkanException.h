@@ -32,4 +32,9 @@ public:
     #define RAPIDJSON_ASSERT(x) if(!(x)) throw SVE::RapidJsonException();
 #endif
 
+// Missing optional JSON fields keep their default values
+#define setOptional(expr)                \
+    try { expr; }                        \
+    catch (const RapidJsonException&) { }
+
 } // namespace SVE
\ No newline at end of file
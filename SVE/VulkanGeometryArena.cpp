@@ -0,0 +1,151 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanGeometryArena.h"
+#include "VulkanInstance.h"
+#include "VulkanUtils.h"
+#include "VulkanUploadBatcher.h"
+#include <algorithm>
+
+namespace SVE
+{
+namespace
+{
+
+constexpr VkDeviceSize GeometryBlockSize = 16 * 1024 * 1024;
+// Covers vertex attribute formats and uint32 indices
+constexpr VkDeviceSize GeometryAlignment = 16;
+
+VkDeviceSize alignSize(VkDeviceSize size)
+{
+    return (size + GeometryAlignment - 1) / GeometryAlignment * GeometryAlignment;
+}
+
+} // anon namespace
+
+VulkanGeometryArena::VulkanGeometryArena(const VulkanInstance* instance)
+    : _vulkanInstance(instance)
+    , _retiredAllocations(instance->getSwapchainSize())
+{
+}
+
+VulkanGeometryArena::~VulkanGeometryArena()
+{
+    for (auto& block : _blocks)
+        vmaDestroyBuffer(_vulkanInstance->getAllocator(), block.buffer, block.allocation);
+}
+
+VulkanGeometryArena::Allocation VulkanGeometryArena::allocate(const void* data, VkDeviceSize size)
+{
+    // Empty geometry still gets valid range, so it can be bound
+    auto alignedSize = alignSize(std::max<VkDeviceSize>(size, 1));
+    Allocation allocation;
+    auto allocated = false;
+    for (auto i = 0u; i < _blocks.size() && !allocated; i++)
+        allocated = allocateFromBlock(i, alignedSize, allocation);
+
+    if (!allocated)
+    {
+        // Geometry bigger than block gets dedicated block
+        addBlock(std::max(GeometryBlockSize, alignedSize));
+        allocateFromBlock(static_cast<uint32_t>(_blocks.size() - 1), alignedSize, allocation);
+    }
+
+    if (size > 0)
+        upload(allocation, data, size);
+    ++_allocationCount;
+    return allocation;
+}
+
+void VulkanGeometryArena::free(const Allocation& allocation)
+{
+    if (allocation.buffer == VK_NULL_HANDLE)
+        return;
+
+    auto& freeRanges = _blocks[allocation.blockIndex].freeRanges;
+    auto next = std::lower_bound(freeRanges.begin(), freeRanges.end(), allocation.offset, [](const Range& range, VkDeviceSize offset)
+    {
+        return range.offset < offset;
+    });
+    auto current = freeRanges.insert(next, { allocation.offset, allocation.size });
+
+    auto nextRange = current + 1;
+    if (nextRange != freeRanges.end() && current->offset + current->size == nextRange->offset)
+    {
+        current->size += nextRange->size;
+        current = freeRanges.erase(nextRange) - 1;
+    }
+    if (current != freeRanges.begin())
+    {
+        auto previous = current - 1;
+        if (previous->offset + previous->size == current->offset)
+        {
+            previous->size += current->size;
+            freeRanges.erase(current);
+        }
+    }
+    --_allocationCount;
+}
+
+void VulkanGeometryArena::retire(const Allocation& allocation)
+{
+    if (allocation.buffer != VK_NULL_HANDLE)
+        _retiredAllocations[_imageIndex].push_back(allocation);
+}
+
+void VulkanGeometryArena::startFrame(uint32_t imageIndex)
+{
+    _imageIndex = imageIndex;
+    for (const auto& allocation : _retiredAllocations[imageIndex])
+        free(allocation);
+    _retiredAllocations[imageIndex].clear();
+}
+
+uint32_t VulkanGeometryArena::getBlockCount() const
+{
+    return static_cast<uint32_t>(_blocks.size());
+}
+
+uint32_t VulkanGeometryArena::getAllocationCount() const
+{
+    return _allocationCount;
+}
+
+bool VulkanGeometryArena::allocateFromBlock(uint32_t blockIndex, VkDeviceSize size, Allocation& allocation)
+{
+    // First fit, meshes are mostly loaded once, so fragmentation is low
+    auto& block = _blocks[blockIndex];
+    for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it)
+    {
+        if (it->size < size)
+            continue;
+
+        allocation = { block.buffer, it->offset, size, blockIndex };
+        it->offset += size;
+        it->size -= size;
+        if (it->size == 0)
+            block.freeRanges.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void VulkanGeometryArena::addBlock(VkDeviceSize size)
+{
+    Block block;
+    _vulkanInstance->getVulkanUtils().createBuffer(
+            size,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY,
+            block.buffer,
+            block.allocation);
+    block.freeRanges.push_back({ 0, size });
+    _blocks.push_back(std::move(block));
+}
+
+void VulkanGeometryArena::upload(const Allocation& allocation, const void* data, VkDeviceSize size)
+{
+    _vulkanInstance->getUploadBatcher()->uploadBuffer(data, size, allocation.buffer, allocation.offset);
+}
+
+} // namespace SVE
\ No newline at end of file
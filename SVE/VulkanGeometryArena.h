@@ -0,0 +1,72 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <vulkan/vk_mem_alloc.h>
+#include <vector>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Device local buffers shared by all meshes. Mesh gets one range for all its vertex streams
+// and indices, so there is no separate buffer and memory allocation per attribute.
+// Freed ranges are merged with neighbours and reused, blocks are kept until arena is destroyed.
+// Ranges replaced while frames are in flight are retired and freed when their swapchain image is rendered again.
+class VulkanGeometryArena
+{
+public:
+    struct Allocation
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        uint32_t blockIndex = 0;
+    };
+
+    explicit VulkanGeometryArena(const VulkanInstance* instance);
+    ~VulkanGeometryArena();
+
+    // Data is uploaded through upload batcher, copy is finished when current upload batch ends
+    Allocation allocate(const void* data, VkDeviceSize size);
+    // Range shouldn't be used by commands in flight
+    void free(const Allocation& allocation);
+    // Range can be used by commands in flight, it's freed on next frame of current image
+    void retire(const Allocation& allocation);
+
+    // Free ranges retired when image was rendered last time, should be called at frame start
+    void startFrame(uint32_t imageIndex);
+
+    uint32_t getBlockCount() const;
+    uint32_t getAllocationCount() const;
+
+private:
+    struct Range
+    {
+        VkDeviceSize offset;
+        VkDeviceSize size;
+    };
+
+    struct Block
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        // Sorted by offset, adjacent ranges are always merged
+        std::vector<Range> freeRanges;
+    };
+
+    bool allocateFromBlock(uint32_t blockIndex, VkDeviceSize size, Allocation& allocation);
+    void addBlock(VkDeviceSize size);
+    void upload(const Allocation& allocation, const void* data, VkDeviceSize size);
+
+private:
+    const VulkanInstance* _vulkanInstance;
+    std::vector<Block> _blocks;
+    uint32_t _allocationCount = 0;
+    // [image]
+    std::vector<std::vector<Allocation>> _retiredAllocations;
+    uint32_t _imageIndex = 0;
+};
+
+} // namespace SVE
\ No newline at end of file
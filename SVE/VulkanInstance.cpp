@@ -12,6 +12,10 @@
 #include "VulkanScreenQuad.h"
 #include "VulkanSamplerHolder.h"
 #include "VulkanPassInfo.h"
+#include "VulkanUniformRing.h"
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanGeometryArena.h"
+#include "VulkanUploadBatcher.h"
 
 namespace SVE
 {
@@ -144,11 +148,21 @@ VulkanInstance::VulkanInstance(SDL_Window* window, EngineSettings settings)
     createDepthBuffer();
     createFramebuffers();
     createSyncPrimitives();
+
+    _uniformRing = std::make_unique<VulkanUniformRing>(this);
+    _descriptorAllocator = std::make_unique<VulkanDescriptorAllocator>(getLogicalDevice(),
+                                                                       static_cast<uint32_t>(getSwapchainSize()));
+    _geometryArena = std::make_unique<VulkanGeometryArena>(this);
+    _uploadBatcher = std::make_unique<VulkanUploadBatcher>(this);
 }
 
 VulkanInstance::~VulkanInstance()
 {
     _screenQuad.reset();
+    _uniformRing.reset();
+    _descriptorAllocator.reset();
+    _geometryArena.reset();
+    _uploadBatcher.reset();
 
     deleteSyncPrimitives();
     deleteFramebuffers();
@@ -312,9 +326,23 @@ VkCommandBuffer VulkanInstance::createCommandBuffer(BufferIndex bufferIndex)
         return existingBufferIter->second;
     }
 
+    auto& commandPool = _recordingPools[{_currentPool, bufferIndex}];
+    if (commandPool == VK_NULL_HANDLE)
+    {
+        VkCommandPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolCreateInfo.queueFamilyIndex = _queueIndex;
+
+        if (vkCreateCommandPool(_device, &poolCreateInfo, nullptr, &commandPool) != VK_SUCCESS)
+        {
+            throw VulkanException("Can't create Vulkan Command Pool");
+        }
+    }
+
     VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
     commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    commandBufferAllocateInfo.commandPool = _commandPools[_currentPool];
+    commandBufferAllocateInfo.commandPool = commandPool;
     commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     commandBufferAllocateInfo.commandBufferCount = 1;
 
@@ -454,9 +482,14 @@ void VulkanInstance::reallocateCommandBuffers()
 {
     _currentPool = (_currentPool + 1) % _commandPools.size();
 
-    if (vkResetCommandPool(_device, _commandPools[_currentPool], VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT) != VK_SUCCESS)
+    for (auto& recordingPool : _recordingPools)
     {
-        throw VulkanException("Can't reset Vulkan Command Pool");
+        if (recordingPool.first.first != _currentPool)
+            continue;
+        if (vkResetCommandPool(_device, recordingPool.second, VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT) != VK_SUCCESS)
+        {
+            throw VulkanException("Can't reset Vulkan Command Pool");
+        }
     }
     _externalBufferMap.clear();
 
@@ -542,6 +575,26 @@ VulkanPassInfo* VulkanInstance::getPassInfo()
     return _passInfo.get();
 }
 
+VulkanUniformRing* VulkanInstance::getUniformRing()
+{
+    return _uniformRing.get();
+}
+
+VulkanDescriptorAllocator* VulkanInstance::getDescriptorAllocator()
+{
+    return _descriptorAllocator.get();
+}
+
+VulkanGeometryArena* VulkanInstance::getGeometryArena()
+{
+    return _geometryArena.get();
+}
+
+VulkanUploadBatcher* VulkanInstance::getUploadBatcher() const
+{
+    return _uploadBatcher.get();
+}
+
 void VulkanInstance::createInstance()
 {
     VkApplicationInfo appInfo{};
@@ -655,6 +708,13 @@ void VulkanInstance::createDevice()
     deviceFeatures.geometryShader = VK_TRUE;
     deviceFeatures.imageCubeArray = VK_TRUE;
 
+    // Block compressed formats of baked textures, loader checks which of them are available
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(_gpu, &supportedFeatures);
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    deviceFeatures.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+    deviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
@@ -1016,6 +1076,11 @@ void VulkanInstance::deleteCommandPool()
     {
         vkDestroyCommandPool(_device, commandPool, nullptr);
     }
+    for (auto& recordingPool : _recordingPools)
+    {
+        vkDestroyCommandPool(_device, recordingPool.second, nullptr);
+    }
+    _recordingPools.clear();
     _poolBufferMap.clear();
 }
 
@@ -17,6 +17,10 @@ class VulkanMesh;
 class VulkanScreenQuad;
 class VulkanSamplerHolder;
 class VulkanPassInfo;
+class VulkanUniformRing;
+class VulkanDescriptorAllocator;
+class VulkanGeometryArena;
+class VulkanUploadBatcher;
 
 // TODO: Create some mapping to external indexes instead of hardcoding
 enum
@@ -84,6 +88,11 @@ public:
     VulkanScreenQuad* getScreenQuad();
     VulkanSamplerHolder* getSamplerHolder();
     VulkanPassInfo* getPassInfo();
+    VulkanUniformRing* getUniformRing();
+    VulkanDescriptorAllocator* getDescriptorAllocator();
+    VulkanGeometryArena* getGeometryArena();
+    // Null while instance is created, one time commands are submitted immediately then
+    VulkanUploadBatcher* getUploadBatcher() const;
     void initScreenQuad(glm::ivec2 resolution);
 
 private:
@@ -162,6 +171,8 @@ private:
 
     PoolID _currentPool = 0;
     std::vector<VkCommandPool> _commandPools;
+    // Every command buffer has own pool per pool slot, so buffers can be recorded in parallel
+    std::map<std::pair<PoolID, BufferIndex>, VkCommandPool> _recordingPools;
     std::vector<VkCommandBuffer> _commandBuffers;
     std::map<uint32_t, VkCommandBuffer> _externalBufferMap;
     std::map<std::pair<PoolID, BufferIndex>, VkCommandBuffer> _poolBufferMap;
@@ -198,6 +209,10 @@ private:
     std::unique_ptr<VulkanScreenQuad> _screenQuad;
     std::unique_ptr<VulkanSamplerHolder> _samplerHolder;
     std::unique_ptr<VulkanPassInfo> _passInfo;
+    std::unique_ptr<VulkanUniformRing> _uniformRing;
+    std::unique_ptr<VulkanDescriptorAllocator> _descriptorAllocator;
+    std::unique_ptr<VulkanGeometryArena> _geometryArena;
+    std::unique_ptr<VulkanUploadBatcher> _uploadBatcher;
 };
 
 } // namespace SVE
\ No newline at end of file
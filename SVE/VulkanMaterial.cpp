@@ -4,6 +4,7 @@
 #include "VulkanMaterial.h"
 #include "VulkanException.h"
 #include "VulkanInstance.h"
+#include "VulkanBindCache.h"
 #include "VulkanScreenQuad.h"
 #include "VulkanDirectShadowMap.h"
 #include "VulkanSamplerHolder.h"
@@ -20,9 +21,16 @@
 #include "VulkanWater.h"
 #include "Entity.h"
 #include "Engine.h"
+#include "RecordingContext.h"
+#include "VulkanUniformRing.h"
+#include "VulkanDescriptorAllocator.h"
+#include "VulkanUploadBatcher.h"
+#include "TextureManager.h"
+#include "Utils.h"
 
 #include <fstream>
 #include <algorithm>
+#include <atomic>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 #define GLM_ENABLE_EXPERIMENTAL
@@ -34,38 +42,17 @@ namespace SVE
 namespace
 {
 
-VkSamplerAddressMode getAddressMode(TextureAddressMode mode)
-{
-    static const std::map<TextureAddressMode, VkSamplerAddressMode> addressModeMap {
-            { TextureAddressMode::Repeat,               VK_SAMPLER_ADDRESS_MODE_REPEAT },
-            { TextureAddressMode::MirroredRepeat,       VK_SAMPLER_ADDRESS_MODE_MIRRORED_REPEAT },
-            { TextureAddressMode::ClampToEdge,          VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE },
-            { TextureAddressMode::ClampToBorder,        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER },
-            { TextureAddressMode::MirrorClampToEdge,    VK_SAMPLER_ADDRESS_MODE_MIRROR_CLAMP_TO_EDGE },
-    };
-
-    return addressModeMap.at(mode);
-}
-
-VkBorderColor getBorderColor(TextureBorderColor color)
-{
-    switch (color)
-    {
-        case TextureBorderColor::TransparentBlack:
-            return VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
-        case TextureBorderColor::SolidBlack:
-            return VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
-        case TextureBorderColor::SolidWhite:
-            return VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
-    }
-
-    throw VulkanException("Unsupported texture border color");
-}
+std::atomic<uint32_t> materialCounter { 0 };
+// vertex, geometry and fragment
+constexpr uint32_t MaxShaderCount = 3;
+// Used when instanced material doesn't set instanceMaxCount
+constexpr uint32_t DefaultInstanceCapacity = 1024;
 
 } // anon namespace
 
 SVE::VulkanMaterial::VulkanMaterial(MaterialSettings materialSettings)
-    : _materialSettings(std::move(materialSettings))
+    : _id(++materialCounter)
+    , _materialSettings(std::move(materialSettings))
     , _vulkanInstance(Engine::getInstance()->getVulkanInstance())
     , _device(_vulkanInstance->getLogicalDevice())
     , _allocator(_vulkanInstance->getAllocator())
@@ -87,6 +74,11 @@ SVE::VulkanMaterial::VulkanMaterial(MaterialSettings materialSettings)
         throw VulkanException("Vertex shader is mandatory");
     }
 
+    // Instancing is defined by vertex shader, material can't draw instances without model list
+    const auto& bufferList = _vertexShader->getShaderSettings().bufferList;
+    _materialSettings.useInstancing =
+            std::find(bufferList.begin(), bufferList.end(), BufferType::ModelMatrixList) != bufferList.end();
+
     if (!_materialSettings.geometryShaderName.empty())
     {
         _geometryShader = shaderManager->getShader(_materialSettings.geometryShaderName)->getVulkanShaderInfo();
@@ -99,40 +91,36 @@ SVE::VulkanMaterial::VulkanMaterial(MaterialSettings materialSettings)
     }
 
     createPipelineLayout();
-    createPipeline();
+    createPipeline(VertexFormat::Full);
 
     if (_materialSettings.isCubemap)
         createCubemapTextureImages();
     else
         createTextureImages();
-    createTextureImageView();
     createTextureSampler();
 
-    createUniformBuffers();
     createStorageBuffers();
-    createDescriptorPool();
-    createDescriptorSets();
+    createBlockDescriptorSets(_vulkanInstance->getUniformRing()->getBlockCount() - 1);
 }
 
 VulkanMaterial::~VulkanMaterial()
 {
     deleteDescriptorSets();
-    deleteDescriptorPool();
-    deleteUniformBuffers();
     deleteStorageBuffers();
 
-    deleteTextureSampler();
-    deleteTextureImageView();
-    deleteTextureImages();
-
     deletePipelineCache();
-    deletePipeline();
+    deletePipelines();
     deletePipelineLayout();
 }
 
-VkPipeline VulkanMaterial::getPipeline() const
+uint32_t VulkanMaterial::getId() const
+{
+    return _id;
+}
+
+VkPipeline VulkanMaterial::getPipeline(VertexFormat vertexFormat) const
 {
-    return _pipeline;
+    return _pipelines[toInt(vertexFormat)];
 }
 
 VkPipelineLayout VulkanMaterial::getPipelineLayout() const
@@ -140,22 +128,49 @@ VkPipelineLayout VulkanMaterial::getPipelineLayout() const
     return _pipelineLayout;
 }
 
-void VulkanMaterial::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex, uint32_t materialIndex)
+void VulkanMaterial::preparePipeline(VertexFormat vertexFormat)
 {
-    if (_materialSettings.useInstancing && isInstancesRendered() && !isMainInstance(materialIndex))
-        return;
+    if (_pipelines[toInt(vertexFormat)] == VK_NULL_HANDLE)
+        createPipeline(vertexFormat);
+}
+
+void VulkanMaterial::applyDrawingCommands(const RecordingContext& context, MaterialInstance instanceHandle,
+                                          VertexFormat vertexFormat) const
+{
+    assert(isInstanceValid(instanceHandle));
+
+    auto pipeline = _pipelines[toInt(vertexFormat)];
+    assert(pipeline != VK_NULL_HANDLE && "Pipeline for vertex format is not prepared");
+    if (context.bindCache->isPipelineBindNeeded(pipeline))
+        vkCmdBindPipeline(context.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+    // Sets go in pipeline layout order, every set with uniforms takes dynamic offset of instance data
+    VkDescriptorSet descriptorSets[MaxShaderCount];
+    uint32_t dynamicOffsets[MaxShaderCount];
+    uint32_t setCount = 0;
+    uint32_t offsetCount = 0;
+    auto swapchainSize = _vulkanInstance->getSwapchainSize();
+    const auto& instance = _instanceData.get(instanceHandle);
+    for (auto i = 0u; i < _shaderList.size(); i++)
+    {
+        if (_descriptorSets[i].empty())
+            continue;
 
-    auto commandBuffer = _vulkanInstance->getCommandBuffer(bufferIndex);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline);
+        const auto& location = instance.uniformLocations[i];
+        descriptorSets[setCount++] = _descriptorSets[i][location.blockIndex * swapchainSize + context.imageIndex];
+        if (_shaderList[i]->getShaderUniformsSize() > 0)
+            dynamicOffsets[offsetCount++] = location.offset;
+    }
 
-    auto descriptorSets = getDescriptorSets(materialIndex, imageIndex);
     vkCmdBindDescriptorSets(
-            commandBuffer,
+            context.commandBuffer,
             VK_PIPELINE_BIND_POINT_GRAPHICS,
             _pipelineLayout,
             0,
-            descriptorSets.size(),
-            descriptorSets.data(), 0, nullptr);
+            setCount,
+            descriptorSets,
+            offsetCount,
+            dynamicOffsets);
 }
 
 void VulkanMaterial::resetDescriptorSets()
@@ -166,66 +181,41 @@ void VulkanMaterial::resetDescriptorSets()
 
 void VulkanMaterial::resetPipeline()
 {
-    deletePipeline();
-
-    createPipeline();
-}
-
-std::vector<VkDescriptorSet> VulkanMaterial::getDescriptorSets(uint32_t materialIndex, size_t index) const
-{
-    std::vector<VkDescriptorSet> sets;
-    sets.reserve(_shaderList.size());
-    if (!_instanceData[materialIndex].vertexDescriptorSets.empty())
-        sets.push_back(_instanceData[materialIndex].vertexDescriptorSets[index]);
-    if (!_instanceData[materialIndex].geometryDescriptorSets.empty())
-        sets.push_back(_instanceData[materialIndex].geometryDescriptorSets[index]);
-    if (!_instanceData[materialIndex].fragmentDescriptorSets.empty())
-        sets.push_back(_instanceData[materialIndex].fragmentDescriptorSets[index]);
-
+    bool usedFormats[VertexFormatCount];
+    for (auto format = 0u; format < VertexFormatCount; format++)
+        usedFormats[format] = _pipelines[format] != VK_NULL_HANDLE;
 
-    return sets;
-}
+    deletePipelines();
 
-uint32_t VulkanMaterial::getInstanceForEntity(const Entity* entity, uint32_t index)
-{
-    auto instanceIter = _entityInstanceMap.find(entity);
-    if (instanceIter != _entityInstanceMap.end())
+    for (auto format = 0u; format < VertexFormatCount; format++)
     {
-        if (instanceIter->second.size() > index)
-            return instanceIter->second[index];
-
-        if (index > instanceIter->second.size())
-            throw VulkanException("Incorrect entity material index");
-        instanceIter->second.push_back(0);
-    } else {
-        _entityInstanceMap[entity] = std::vector<uint32_t>(1);
+        if (usedFormats[format])
+            createPipeline(static_cast<VertexFormat>(format));
     }
+}
 
-    createUniformBuffers();
-    //createStorageBuffers();
-    createDescriptorPool();
-    createDescriptorSets();
-    _entityInstanceMap[entity][index] = _instanceData.size() - 1;
-    return _instanceData.size() - 1;
+MaterialInstance VulkanMaterial::createInstance()
+{
+    // Instance only keeps offsets of its data, buffers and descriptor sets are shared
+    auto instanceHandle = _instanceData.create();
+    // Reused slots already have locations, they are reset on delete
+    _instanceData.get(instanceHandle).uniformLocations.resize(_shaderList.size());
+    return instanceHandle;
 }
 
-void VulkanMaterial::deleteInstancesForEntity(const Entity* entity)
+void VulkanMaterial::deleteInstance(MaterialInstance instanceHandle)
 {
-    auto instanceIter = _entityInstanceMap.find(entity);
-    if (instanceIter == _entityInstanceMap.end())
-    {
+    if (!isInstanceValid(instanceHandle))
         return;
-    }
 
-    for (auto& index : instanceIter->second)
-    {
-        deleteDescriptorSets(_instanceData[index]);
-        deleteDescriptorPool(_instanceData[index]);
-        deleteUniformBuffers(_instanceData[index]);
-        _instanceData[index] = {};
-    }
+    auto& instance = _instanceData.get(instanceHandle);
+    std::fill(instance.uniformLocations.begin(), instance.uniformLocations.end(), UniformLocation());
+    _instanceData.remove(instanceHandle);
+}
 
-    _entityInstanceMap.erase(instanceIter);
+bool VulkanMaterial::isInstanceValid(MaterialInstance instanceHandle) const
+{
+    return _instanceData.isValid(instanceHandle);
 }
 
 bool VulkanMaterial::isSkeletal() const
@@ -236,70 +226,46 @@ bool VulkanMaterial::isSkeletal() const
     return _vertexShader->getShaderSettings().maxBonesSize > 0;
 }
 
-void VulkanMaterial::setUniformData(uint32_t materialIndex, const UniformData& uniformData)
+void VulkanMaterial::setUniformData(MaterialInstance instanceHandle, const UniformData& uniformData)
 {
-    auto swapchainSize = _vulkanInstance->getSwapchainSize();
-    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+    assert(isInstanceValid(instanceHandle));
+    auto* uniformRing = _vulkanInstance->getUniformRing();
+    auto& instance = _instanceData.get(instanceHandle);
     for (auto i = 0u; i < _shaderList.size(); i++)
     {
-        size_t uniformSize = _shaderList[i]->getShaderUniformsSize();
-        if (uniformSize == 0)
+        const auto& uniformLayout = _shaderList[i]->getUniformLayout();
+        if (uniformLayout.getSize() == 0)
             continue;
-        const auto& shaderSettings = _shaderList[i]->getShaderSettings();
-        void* data = nullptr;
-        vmaMapMemory(_allocator, _instanceData[materialIndex].uniformBuffersMemory[swapchainSize * i + imageIndex], &data);
-        char* mappedUniformData = reinterpret_cast<char*>(data);
-        for (const auto& r : shaderSettings.uniformList)
-        {
-            auto uniformBytes = getUniformDataByType(uniformData, r.uniformType);
-            memcpy(mappedUniformData, uniformBytes.data(), uniformBytes.size());
-            mappedUniformData += uniformBytes.size();
-        }
-        vmaUnmapMemory(_allocator, _instanceData[materialIndex].uniformBuffersMemory[swapchainSize * i + imageIndex]);
+        auto allocation = uniformRing->allocate(uniformLayout.getSize());
+        createBlockDescriptorSets(allocation.blockIndex);
+        uniformLayout.write(uniformData, allocation.data);
+        instance.uniformLocations[i] = { allocation.blockIndex, allocation.offset };
     }
-
-    for (const auto& b : _vertexShader->getShaderSettings().bufferList)
-    {
-        updateStorageDataByUniforms(uniformData, _storageData, b);
-    }
-
-    if (_storageUpdated || !_materialSettings.useInstancing)
-        _currentInstanceCount = 0;
-
-    ++_currentInstanceCount;
-    _storageUpdated = false;
-    _mainInstance = materialIndex;
-    _instancesRendered = false;
 }
 
-void VulkanMaterial::updateInstancedData()
+void VulkanMaterial::resetInstanceData()
 {
-    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+    _instanceDataCount = 0;
+}
 
-    if (_storageBufferSize == 0 || _mainInstance == 0 || _storageUpdated)
-        return;
+uint32_t VulkanMaterial::addInstanceData(const glm::mat4* modelList, uint32_t count)
+{
+    assert(_materialSettings.useInstancing);
+    assert(_instanceDataCount + count <= _instanceCapacity);
 
-    if (!_materialSettings.useInstancing)
-        return;
+    auto firstInstance = _instanceDataCount;
+    auto* mappedBufferData = _storageBuffersData[_vulkanInstance->getCurrentImageIndex()];
+    memcpy(mappedBufferData + firstInstance * sizeof(glm::mat4), modelList, count * sizeof(glm::mat4));
+    _instanceDataCount += count;
+    return firstInstance;
+}
 
-    void* data = nullptr;
-    vmaMapMemory(_allocator, _storageBuffersMemory[imageIndex], &data);
-    char* mappedBufferData = reinterpret_cast<char*>(data);
-    for (const auto& b : _vertexShader->getShaderSettings().bufferList)
-    {
-        auto storageBytes = getStorageDataByType(_storageData, b);
-        if (!storageBytes.empty())
-        {
-            memcpy(mappedBufferData, storageBytes.data(), storageBytes.size());
-            mappedBufferData += storageBytes.size();
-        }
-    }
-    vmaUnmapMemory(_allocator, _storageBuffersMemory[imageIndex]);
-    _storageData = {};
-    _storageUpdated = true;
+uint32_t VulkanMaterial::getFreeInstanceDataCount() const
+{
+    return _instanceCapacity - _instanceDataCount;
 }
 
-void VulkanMaterial::createPipeline()
+void VulkanMaterial::createPipeline(VertexFormat vertexFormat)
 {
     std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
     for (auto * shader : _shaderList)
@@ -308,8 +274,8 @@ void VulkanMaterial::createPipeline()
     }
 
     // Triangle data setup
-    auto bindingDescriptions = _vertexShader->getBindingDescription();
-    auto attributeDescriptions = _vertexShader->getAttributeDescriptions();
+    auto bindingDescriptions = _vertexShader->getBindingDescription(vertexFormat);
+    auto attributeDescriptions = _vertexShader->getAttributeDescriptions(vertexFormat);
     VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{};
     vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInputStateCreateInfo.vertexBindingDescriptionCount = bindingDescriptions.size();
@@ -469,12 +435,13 @@ void VulkanMaterial::createPipeline()
     pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE; // no deriving from other pipeline
     pipelineCreateInfo.basePipelineIndex = -1;
 
-    if (_useCache && !Engine::getInstance()->getPipelineCacheManager()->isNew())
+    // Cache is shared by pipelines of all vertex formats and by recreated pipelines
+    if (_useCache && _pipelineCache == VK_NULL_HANDLE && !Engine::getInstance()->getPipelineCacheManager()->isNew())
     {
         loadPipelineCache();
     }
 
-    auto result = vkCreateGraphicsPipelines(_device, _pipelineCache, 1, &pipelineCreateInfo, nullptr, &_pipeline);
+    auto result = vkCreateGraphicsPipelines(_device, _pipelineCache, 1, &pipelineCreateInfo, nullptr, &_pipelines[toInt(vertexFormat)]);
     if (result != VK_SUCCESS)
     {
         throw VulkanException("Can't create Vulkan Graphics Pipeline");
@@ -492,9 +459,14 @@ void VulkanMaterial::createPipeline()
 
 }
 
-void VulkanMaterial::deletePipeline()
+void VulkanMaterial::deletePipelines()
 {
-    vkDestroyPipeline(_device, _pipeline, nullptr);
+    for (auto& pipeline : _pipelines)
+    {
+        if (pipeline != VK_NULL_HANDLE)
+            vkDestroyPipeline(_device, pipeline, nullptr);
+        pipeline = VK_NULL_HANDLE;
+    }
 }
 
 void VulkanMaterial::createAndStorePipelineCache()
@@ -585,12 +557,9 @@ void VulkanMaterial::deletePipelineLayout()
 void VulkanMaterial::createTextureImages()
 {
     size_t imageCount = _materialSettings.textures.size();
-    _mipLevels.resize(imageCount);
     _texturesData.resize(imageCount);
-    _textureImages.resize(imageCount);
-    _textureImageMemoryList.resize(imageCount);
+    _textures.resize(imageCount);
     _textureNames.resize(imageCount);
-    _textureImageViews.resize(imageCount);
     _textureSamplers.resize(imageCount);
     for (auto i = 0u; i < imageCount; i++)
     {
@@ -610,68 +579,7 @@ void VulkanMaterial::createTextureImages()
             _texturesData[i].external = false;
         }
 
-        // Load image pixel data
-        int texWidth, texHeight, texChannels;
-        //stbi_set_flip_vertically_on_load(true);
-        auto fileContent = Engine::getInstance()->getResourceManager()->loadFileContent(_materialSettings.textures[i].filename);
-        stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(fileContent.data()), fileContent.size(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-        VkDeviceSize imageSize = static_cast<VkDeviceSize>(texWidth * texHeight * 4);
-
-        _mipLevels[i] = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
-
-        if (!pixels)
-        {
-            throw VulkanException("Can't load texture " + _materialSettings.textures[i].filename);
-        }
-
-        // Create temporary buffer to hold pixel data
-        VkBuffer stagingBuffer;
-        VmaAllocation stagingBufferMemory;
-        _vulkanUtils.createBuffer(imageSize,
-                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                  VMA_MEMORY_USAGE_CPU_TO_GPU,
-                                  stagingBuffer,
-                                  stagingBufferMemory);
-
-        // Copy pixel data into temporary buffer
-        void* data;
-        vmaMapMemory(_allocator, stagingBufferMemory, &data);
-        memcpy(data, pixels, static_cast<size_t>(imageSize));
-        vmaUnmapMemory(_allocator, stagingBufferMemory);
-
-        // Free pixel data
-        stbi_image_free(pixels);
-
-        // Create texture image which will be used in shaders
-        _vulkanUtils.createImage(static_cast<uint32_t>(texWidth),
-                                 static_cast<uint32_t>(texHeight),
-                                 _mipLevels[i],
-                                 VK_SAMPLE_COUNT_1_BIT,
-                                 VK_FORMAT_R8G8B8A8_UNORM,
-                                 VK_IMAGE_TILING_OPTIMAL,
-                                 VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-                                 VK_IMAGE_USAGE_SAMPLED_BIT,
-                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                 _textureImages[i],
-                                 _textureImageMemoryList[i]);
-
-        // Transition layout of the image to be optimal as a transfer destination
-        _vulkanUtils.transitionImageLayout(
-                _textureImages[i],
-                VK_FORMAT_R8G8B8A8_UNORM,
-                {VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT},
-                {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT},
-                _mipLevels[i]);
-        // Copy image data from buffer to image
-        _vulkanUtils.copyBufferToImage(stagingBuffer,
-                                       _textureImages[i],
-                                       static_cast<uint32_t>(texWidth),
-                                       static_cast<uint32_t>(texHeight));
-
-        _vulkanUtils.generateMipmaps(_textureImages[i], VK_FORMAT_R8G8B8A8_UNORM, texWidth, texHeight, _mipLevels[i]);
-
-        // Free temporary buffer
-        vmaDestroyBuffer(_allocator, stagingBuffer, stagingBufferMemory);
+        _textures[i] = Engine::getInstance()->getTextureManager()->getTexture(_materialSettings.textures[i].filename);
     }
 }
 
@@ -681,11 +589,9 @@ void VulkanMaterial::createCubemapTextureImages()
     if (imageCount != 6)
         throw VulkanException("Incorrect cube map configuration (need 6 images)");
 
-    _textureImages.resize(1);
-    _textureImageMemoryList.resize(1);
+    _textures.resize(1);
     _textureNames.resize(1);
     _texturesData.resize(1);
-    _textureImageViews.resize(1);
     _textureSamplers.resize(1);
     std::vector<stbi_uc*> pixelsData;
     VkDeviceSize imageSize = 0;
@@ -695,7 +601,7 @@ void VulkanMaterial::createCubemapTextureImages()
         // Load image pixel data
         //stbi_set_flip_vertically_on_load(true);
 
-        auto fileContent = Engine::getInstance()->getResourceManager()->loadFileContent(_materialSettings.textures[i].filename);
+        auto fileContent = Engine::getInstance()->getResourceManager()->loadFileView(_materialSettings.textures[i].filename);
         stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const uint8_t*>(fileContent.data()), fileContent.size(), &texWidth, &texHeight, &texChannels,
                                     STBI_rgb_alpha);
         stbi_set_flip_vertically_on_load(false);
@@ -709,55 +615,48 @@ void VulkanMaterial::createCubemapTextureImages()
     }
     auto singleImageSize = static_cast<VkDeviceSize>(texWidth * texHeight * 4);
 
-    //_mipLevels.push_back(static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1);
-    _mipLevels.push_back(1);
-
-    // Create temporary buffer to hold pixel data
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingBufferMemory;
-    _vulkanUtils.createBuffer(imageSize,
-                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                              VMA_MEMORY_USAGE_CPU_TO_GPU,
-                              stagingBuffer,
-                              stagingBufferMemory);
-
-    // Copy pixel data into temporary buffer
-    void* data;
-    vmaMapMemory(_allocator, stagingBufferMemory, &data);
-    char* mappedData = reinterpret_cast<char*>(data);
+    //auto mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+    uint32_t mipLevels = 1;
+
+    // Copy pixel data into staging memory, commands below go to the same batch
+    auto* uploadBatcher = _vulkanInstance->getUploadBatcher();
+    uploadBatcher->beginBatch();
+    auto staging = uploadBatcher->allocateStaging(imageSize);
+    char* mappedData = staging.data;
     for (auto i = 0u; i < pixelsData.size(); i++)
     {
         memcpy(mappedData, pixelsData[i], singleImageSize);
         mappedData += singleImageSize;
     }
-    vmaUnmapMemory(_allocator, stagingBufferMemory);
 
     // Free pixel data
     for (auto i = 0u; i < imageCount; i++)
         stbi_image_free(pixelsData[i]);
 
     // Create texture image which will be used in shaders
+    VkImage image;
+    VkDeviceMemory imageMemory;
     _vulkanUtils.createImage(static_cast<uint32_t>(texWidth),
                              static_cast<uint32_t>(texHeight),
-                             _mipLevels[0],
+                             mipLevels,
                              VK_SAMPLE_COUNT_1_BIT,
                              VK_FORMAT_R8G8B8A8_UNORM,
                              VK_IMAGE_TILING_OPTIMAL,
                              VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
                              VK_IMAGE_USAGE_SAMPLED_BIT,
                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                             _textureImages[0],
-                             _textureImageMemoryList[0],
+                             image,
+                             imageMemory,
                              VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
                              6);
 
     // Transition layout of the image to be optimal as a transfer destination
     _vulkanUtils.transitionImageLayout(
-            _textureImages[0],
+            image,
             VK_FORMAT_R8G8B8A8_UNORM,
             {VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT},
             {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT},
-            _mipLevels[0],
+            mipLevels,
             VK_IMAGE_ASPECT_COLOR_BIT,
             6);
 
@@ -765,7 +664,7 @@ void VulkanMaterial::createCubemapTextureImages()
     // Copy image data from buffer to image
     auto commandBuffer = _vulkanUtils.beginRecordingCommands();
     std::vector<VkBufferImageCopy> bufferCopyRegions;
-    uint32_t offset = 0;
+    auto offset = staging.offset;
     for (auto i = 0u; i < 6; i++)
     {
         VkBufferImageCopy bufferCopyRegion = {};
@@ -785,8 +684,8 @@ void VulkanMaterial::createCubemapTextureImages()
     }
 
     vkCmdCopyBufferToImage(commandBuffer,
-                           stagingBuffer,
-                           _textureImages[0],
+                           staging.buffer,
+                           image,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                            bufferCopyRegions.size(),
                            bufferCopyRegions.data());
@@ -794,173 +693,43 @@ void VulkanMaterial::createCubemapTextureImages()
     _vulkanUtils.endRecordingAndSubmitCommands(commandBuffer);
 
     _vulkanUtils.transitionImageLayout(
-         _textureImages[0],
+         image,
          VK_FORMAT_R8G8B8A8_UNORM,
          {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT},
          {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT},
-         _mipLevels[0],
+         mipLevels,
          VK_IMAGE_ASPECT_COLOR_BIT,
          6);
 
-    //_vulkanUtils.generateMipmaps(_textureImages[i], VK_FORMAT_R8G8B8A8_UNORM, texWidth, texHeight, _mipLevels[i]);
+    //_vulkanUtils.generateMipmaps(image, VK_FORMAT_R8G8B8A8_UNORM, texWidth, texHeight, mipLevels);
+    uploadBatcher->endBatch();
 
-    // Free temporary buffer
-    vmaDestroyBuffer(_allocator, stagingBuffer, stagingBufferMemory);
+    // Cubemap is used only by its material, so it isn't cached in texture manager
+    auto imageView = _vulkanUtils.createImageView(
+            image,
+            VK_FORMAT_R8G8B8A8_UNORM,
+            mipLevels,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_IMAGE_VIEW_TYPE_CUBE,
+            6);
+    _textures[0] = std::make_shared<VulkanTexture>(image, imageMemory, imageView, mipLevels, imageSize);
 
     _textureNames[0] = _materialSettings.textures[0].samplerName;
     _texturesData[0].external = false;
 
 }
 
-void VulkanMaterial::deleteTextureImages()
-{
-    for (auto i = 0u; i < _textureImages.size(); i++)
-    {
-        if (_texturesData[i].external)
-            continue;
-
-        vkDestroyImage(_device, _textureImages[i], nullptr);
-        vkFreeMemory(_device, _textureImageMemoryList[i], nullptr);
-    }
-}
-
-void VulkanMaterial::createTextureImageView()
-{
-    for (auto i = 0; i < _textureImages.size(); i++)
-    {
-        if (_texturesData[i].external)
-            continue;
-
-        _textureImageViews[i] = _vulkanUtils.createImageView(
-                _textureImages[i],
-                VK_FORMAT_R8G8B8A8_UNORM,
-                _mipLevels[i],
-                VK_IMAGE_ASPECT_COLOR_BIT,
-                _materialSettings.isCubemap ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D,
-                _materialSettings.isCubemap ? 6 : 1);
-    }
-}
-
-void VulkanMaterial::deleteTextureImageView()
-{
-    for (auto i = 0; i < _textureImageViews.size(); i++)
-    {
-        if (_texturesData[i].external)
-            continue;
-        vkDestroyImageView(_device, _textureImageViews[i], nullptr);
-    }
-}
-
 void VulkanMaterial::createTextureSampler()
 {
-    for (auto i = 0; i < _textureImages.size(); i++)
+    auto* textureManager = Engine::getInstance()->getTextureManager();
+    for (auto i = 0u; i < _textures.size(); i++)
     {
         if (_texturesData[i].external)
             continue;
 
-        VkSamplerCreateInfo samplerCreateInfo{};
-        samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-        samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
-        samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
-
-        auto addressMode = getAddressMode(_materialSettings.textures[i].textureAddressMode);
-        samplerCreateInfo.addressModeU = addressMode;
-        samplerCreateInfo.addressModeV = addressMode;
-        samplerCreateInfo.addressModeW = addressMode;
-        samplerCreateInfo.borderColor = getBorderColor(_materialSettings.textures[i].textureBorderColor);
-        samplerCreateInfo.anisotropyEnable = VK_TRUE;
-        samplerCreateInfo.maxAnisotropy = 16;
-        //samplerCreateInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-        samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
-        samplerCreateInfo.compareEnable = VK_FALSE;
-        samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-        samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
-        samplerCreateInfo.minLod = 0;
-        samplerCreateInfo.maxLod = _mipLevels[i];
-        samplerCreateInfo.mipLodBias = 0;
-
-        auto result = vkCreateSampler(_device, &samplerCreateInfo, nullptr, &_textureSamplers[i]);
-        if (result != VK_SUCCESS)
-        {
-            throw SVE::VulkanException("Can't create Vulkan texture sampler", result);
-        }
-    }
-}
-
-void VulkanMaterial::deleteTextureSampler()
-{
-    for (auto i = 0; i < _textureSamplers.size(); i++)
-    {
-        if (_texturesData[i].external)
-            continue;
-
-        vkDestroySampler(_device, _textureSamplers[i], nullptr);
-    }
-}
-
-void VulkanMaterial::createUniformBuffers()
-{
-    auto swapchainSize = _vulkanInstance->getSwapchainSize();
-    size_t memoryBufferOffset = 0;
-    PerInstanceData data {};
-
-    auto createUniformBuffers = [this, &data, &swapchainSize, &memoryBufferOffset](std::vector<VkBuffer>& buffers,
-                                                                                   const VulkanShaderInfo* shaderInfo)
-    {
-        if (!shaderInfo)
-            return;
-
-        VkDeviceSize bufferSize = shaderInfo->getShaderUniformsSize();
-        data.uniformBuffersMemory.resize(data.uniformBuffersMemory.size() + swapchainSize);
-        if (bufferSize == 0)
-        {
-            memoryBufferOffset += swapchainSize;
-            return;
-        }
-
-        buffers.resize(swapchainSize);
-
-        for (auto i = 0u; i < swapchainSize; i++)
-        {
-            _vulkanUtils.createBuffer(
-                    bufferSize,
-                    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                    VMA_MEMORY_USAGE_CPU_TO_GPU,
-                    buffers[i],
-                    data.uniformBuffersMemory[memoryBufferOffset + i]);
-        }
-        memoryBufferOffset += swapchainSize;
-    };
-
-    createUniformBuffers(data.vertexUniformBuffers, _vertexShader);
-    createUniformBuffers(data.geometryUniformBuffer, _geometryShader);
-    createUniformBuffers(data.fragmentUniformBuffer, _fragmentShader);
-
-    _instanceData.push_back(data);
-}
-
-void VulkanMaterial::deleteUniformBuffers()
-{
-    for (auto& instance : _instanceData)
-    {
-        deleteUniformBuffers(instance);
-    }
-}
-
-void VulkanMaterial::deleteUniformBuffers(PerInstanceData& instance)
-{
-    auto memIndex = 0;
-    for (auto buffer : instance.vertexUniformBuffers)
-    {
-        vmaDestroyBuffer(_allocator, buffer, instance.uniformBuffersMemory[memIndex++]);
-    }
-    for (auto buffer : instance.geometryUniformBuffer)
-    {
-        vmaDestroyBuffer(_allocator, buffer, instance.uniformBuffersMemory[memIndex++]);
-    }
-    for (auto buffer : instance.fragmentUniformBuffer)
-    {
-        vmaDestroyBuffer(_allocator, buffer, instance.uniformBuffersMemory[memIndex++]);
+        _textureSamplers[i] = textureManager->getSampler(_materialSettings.textures[i].textureAddressMode,
+                                                         _materialSettings.textures[i].textureBorderColor,
+                                                         _textures[i]->getMipLevels());
     }
 }
 
@@ -972,22 +741,31 @@ void VulkanMaterial::createStorageBuffers()
     auto swapchainSize = _vulkanInstance->getSwapchainSize();
 
     _storageBufferSize = _vertexShader->getShaderStorageBuffersSize();
-    if (_storageBufferSize == 0)
-        _storageBufferSize = _materialSettings.instanceMaxCount;
+    if (_materialSettings.useInstancing)
+    {
+        _instanceCapacity = _materialSettings.instanceMaxCount > 0
+                ? _materialSettings.instanceMaxCount
+                : DefaultInstanceCapacity;
+        _storageBufferSize = _instanceCapacity * sizeof(glm::mat4);
+    }
 
     if (_storageBufferSize == 0)
         return;
     _storageBuffersMemory.resize(swapchainSize);
     _vertexStorageBuffers.resize(swapchainSize);
+    _storageBuffersData.resize(swapchainSize);
 
     for (auto i = 0u; i < swapchainSize; i++)
     {
+        void* data = nullptr;
         _vulkanUtils.createBuffer(
                 _storageBufferSize,
                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                 VMA_MEMORY_USAGE_CPU_TO_GPU,
                 _vertexStorageBuffers[i],
-                _storageBuffersMemory[i]);
+                _storageBuffersMemory[i],
+                &data);
+        _storageBuffersData[i] = reinterpret_cast<char*>(data);
     }
 }
 
@@ -999,231 +777,95 @@ void VulkanMaterial::deleteStorageBuffers()
     }
 }
 
-
-void VulkanMaterial::createDescriptorPool()
+void VulkanMaterial::createBlockDescriptorSets(uint32_t blockIndex)
 {
-    auto swapchainSize = _vulkanInstance->getSwapchainSize();
-
-    auto& instance = _instanceData.back();
-
-    std::vector<VkDescriptorPoolSize> poolSizes(3);
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = instance.vertexUniformBuffers.size() + instance.fragmentUniformBuffer.size() + instance.geometryUniformBuffer.size();
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = swapchainSize * _materialSettings.textures.size() * 2;
-    poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSizes[2].descriptorCount = _vertexStorageBuffers.size();
-    for (auto& poolSize : poolSizes)
-        if (poolSize.descriptorCount == 0)
-            poolSize.descriptorCount = 1;
-
-    VkDescriptorPoolCreateInfo poolInfo = {};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = poolSizes.size();
-    poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = _shaderList.size() * swapchainSize;
-
-    auto result = vkCreateDescriptorPool(_device, &poolInfo, nullptr, &instance.descriptorPool);
-    if (result != VK_SUCCESS)
+    while (_descriptorBlockCount <= blockIndex)
     {
-        throw SVE::VulkanException("Can't create Vulkan descriptor pool", result);
+        createDescriptorSets();
     }
 }
 
-void VulkanMaterial::deleteDescriptorPool()
-{
-    for (auto &instance : _instanceData)
-    {
-        deleteDescriptorPool(instance);
-    }
-}
-
-void VulkanMaterial::deleteDescriptorPool(PerInstanceData& instance)
-{
-    vkDestroyDescriptorPool(_device, instance.descriptorPool, nullptr);
-}
-
 void VulkanMaterial::createDescriptorSets()
 {
     auto swapchainSize = _vulkanInstance->getSwapchainSize();
-    auto makeDescriptorSet = [this, swapchainSize](const std::vector<VkBuffer>& shaderBuffers,
-                                                   const std::vector<VkBuffer>* storageBuffers,
-                                                   const VulkanShaderInfo* shaderInfo,
-                                                   std::vector<VkDescriptorSet>& descriptorSets)
-    {
-        if (!shaderInfo)
-            return;
-        if (shaderInfo->getShaderSettings().samplerNamesList.empty() && shaderBuffers.empty())
-            return;
-
-        std::vector<VkDescriptorSetLayout> layouts(swapchainSize, shaderInfo->getDescriptorSetLayout());
-
-        VkDescriptorSetAllocateInfo allocInfo {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = _instanceData.back().descriptorPool;
-        allocInfo.descriptorSetCount = swapchainSize;
-        allocInfo.pSetLayouts = layouts.data();
-
-        descriptorSets.resize(swapchainSize);
-        auto result = vkAllocateDescriptorSets(_device, &allocInfo, descriptorSets.data());
-        if (result != VK_SUCCESS)
-        {
-            throw VulkanException("Can't allocate Vulkan descriptor sets");
-        }
+    auto blockIndex = _descriptorBlockCount++;
+    auto* uniformRing = _vulkanInstance->getUniformRing();
+    auto* descriptorAllocator = _vulkanInstance->getDescriptorAllocator();
+    _descriptorSets.resize(_shaderList.size());
 
+    for (auto shaderIndex = 0u; shaderIndex < _shaderList.size(); shaderIndex++)
+    {
+        const auto* shaderInfo = _shaderList[shaderIndex];
         auto uniformSize = shaderInfo->getShaderUniformsSize();
+        if (shaderInfo->getShaderSettings().samplerNamesList.empty() && uniformSize == 0)
+            continue;
 
+        auto& descriptorSets = _descriptorSets[shaderIndex];
+        descriptorSets.resize(descriptorSets.size() + swapchainSize);
+        descriptorAllocator->allocate(shaderInfo->getDescriptorSetLayout(),
+                                      shaderInfo->getDescriptorPoolSizes(),
+                                      swapchainSize,
+                                      &descriptorSets[blockIndex * swapchainSize]);
+
+        auto* storageBuffers = shaderInfo == _vertexShader && _storageBufferSize > 0 ? &_vertexStorageBuffers : nullptr;
         for (auto i = 0u; i < swapchainSize; i++)
         {
-            VkDescriptorBufferInfo bufferInfo {};
-            VkDescriptorBufferInfo storageBufferInfo {};
-            if (!shaderBuffers.empty())
-            {
-                bufferInfo.buffer = shaderBuffers[i];
-                bufferInfo.offset = 0;
-                bufferInfo.range = uniformSize;
-            }
-
-            std::vector<VkDescriptorImageInfo> imageInfoList;
-            for (const auto& samplerName : shaderInfo->getShaderSettings().samplerNamesList)
-            {
-                auto iter = std::find(_textureNames.cbegin(),
-                                      _textureNames.cend(),
-                                      samplerName);
-                if (iter == _textureNames.end())
-                {
-                    throw VulkanException("Incorrect sampler name in material configuration");
-                }
-                auto index = std::distance(_textureNames.cbegin(), iter);
-
-                if (!_texturesData[index].external)
-                {
-                    VkDescriptorImageInfo imageInfo{};
-                    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    imageInfo.imageView = _textureImageViews[index];
-                    imageInfo.sampler = _textureSamplers[index];
-
-                    imageInfoList.push_back(imageInfo);
-                } else {
-
-                    const auto& samplerInfoList =
-                            _texturesData[index].type == TextureType::ScreenQuad && _texturesData[index].subtype > 0
-                            ? _vulkanInstance->getSamplerHolder()->getPostEffectSamplerInfo(_texturesData[index].subtype)
-                            : _vulkanInstance->getSamplerHolder()->getSamplerInfo(_texturesData[index].type);
-                    if (!samplerInfoList.empty())
-                    {
-                        VkDescriptorImageInfo imageInfo{};
-                        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                        imageInfo.imageView = samplerInfoList[i].imageView;
-                        imageInfo.sampler = samplerInfoList[i].sampler;
-
-                        imageInfoList.push_back(imageInfo);
-                    }
-                }
-            }
-
-
-            std::vector<VkWriteDescriptorSet> descriptorWrites;
-            auto bindingIndex = 0u;
-            // Add texture samplers
-            if (!imageInfoList.empty())
-            {
-                for (auto& imageInfo : imageInfoList)
-                {
-                    VkWriteDescriptorSet imagesBuffer{};
-                    imagesBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    imagesBuffer.dstSet = descriptorSets[i];
-                    imagesBuffer.dstBinding = bindingIndex;
-                    imagesBuffer.dstArrayElement = 0;
-                    imagesBuffer.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                    imagesBuffer.descriptorCount = 1;
-                    imagesBuffer.pImageInfo = &imageInfo;
-                    descriptorWrites.push_back(imagesBuffer);
-                    bindingIndex ++;
-                }
-            }
-            // Add uniforms
-            if (!shaderBuffers.empty())
-            {
-                VkWriteDescriptorSet uniformsBuffer {};
-                uniformsBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                uniformsBuffer.dstSet = descriptorSets[i];
-                uniformsBuffer.dstBinding = bindingIndex;
-                uniformsBuffer.dstArrayElement = 0;
-                uniformsBuffer.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                uniformsBuffer.descriptorCount = 1;
-                uniformsBuffer.pBufferInfo = &bufferInfo;
-                descriptorWrites.push_back(uniformsBuffer);
-                bindingIndex++;
-            }
-
-            if (storageBuffers && !storageBuffers->empty() && _storageBufferSize > 0)
-            {
-                storageBufferInfo.buffer = storageBuffers->at(i);
-                storageBufferInfo.offset = 0;
-                storageBufferInfo.range = _storageBufferSize;
-
-                VkWriteDescriptorSet storageBuffer {};
-                storageBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                storageBuffer.dstSet = descriptorSets[i];
-                storageBuffer.dstBinding = bindingIndex;
-                storageBuffer.dstArrayElement = 0;
-                storageBuffer.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                storageBuffer.descriptorCount = 1;
-                storageBuffer.pBufferInfo = &storageBufferInfo;
-                descriptorWrites.push_back(storageBuffer);
-            }
-
-            vkUpdateDescriptorSets(_device, descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+            VkBuffer uniformBuffer = uniformSize > 0 ? uniformRing->getBuffer(blockIndex, i) : VK_NULL_HANDLE;
+            updateDescriptorSet(
+                    i,
+                    uniformSize > 0 ? &uniformBuffer : nullptr,
+                    storageBuffers ? &storageBuffers->at(i) : nullptr,
+                    uniformSize,
+                    _storageBufferSize,
+                    shaderInfo,
+                    descriptorSets[blockIndex * swapchainSize + i]);
         }
-    };
-
-    makeDescriptorSet(_instanceData.back().vertexUniformBuffers, &_vertexStorageBuffers,  _vertexShader, _instanceData.back().vertexDescriptorSets);
-    makeDescriptorSet(_instanceData.back().geometryUniformBuffer, nullptr, _geometryShader, _instanceData.back().geometryDescriptorSets);
-    makeDescriptorSet(_instanceData.back().fragmentUniformBuffer, nullptr, _fragmentShader, _instanceData.back().fragmentDescriptorSets);
+    }
 }
 
 void VulkanMaterial::deleteDescriptorSets()
 {
-
-}
-
-void VulkanMaterial::deleteDescriptorSets(VulkanMaterial::PerInstanceData& instance)
-{
-
+    auto* descriptorAllocator = _vulkanInstance->getDescriptorAllocator();
+    for (auto shaderIndex = 0u; shaderIndex < _descriptorSets.size(); shaderIndex++)
+    {
+        const auto& descriptorSets = _descriptorSets[shaderIndex];
+        descriptorAllocator->free(_shaderList[shaderIndex]->getDescriptorSetLayout(),
+                                  descriptorSets.size(),
+                                  descriptorSets.data());
+    }
+    _descriptorSets.clear();
+    _descriptorBlockCount = 0;
 }
 
 void VulkanMaterial::updateDescriptorSets()
 {
     auto swapchainSize = _vulkanInstance->getSwapchainSize();
-    auto makeDescriptorSet = [this, swapchainSize](const std::vector<VkBuffer>& shaderBuffers,
-                                                   const std::vector<VkBuffer>* storageBuffers,
-                                                   const VulkanShaderInfo* shaderInfo,
-                                                   std::vector<VkDescriptorSet>& descriptorSets)
+    auto* uniformRing = _vulkanInstance->getUniformRing();
+
+    for (auto shaderIndex = 0u; shaderIndex < _shaderList.size(); shaderIndex++)
     {
-        if (!shaderInfo)
-            return;
-        if (shaderInfo->getShaderSettings().samplerNamesList.empty() && shaderBuffers.empty())
-            return;
+        if (_descriptorSets[shaderIndex].empty())
+            continue;
 
+        const auto* shaderInfo = _shaderList[shaderIndex];
         auto uniformSize = shaderInfo->getShaderUniformsSize();
-
-        for (auto i = 0u; i < swapchainSize; i++)
+        auto* storageBuffers = shaderInfo == _vertexShader && _storageBufferSize > 0 ? &_vertexStorageBuffers : nullptr;
+        for (auto blockIndex = 0u; blockIndex < _descriptorBlockCount; blockIndex++)
         {
-            updateDescriptorSet(
-                    i,
-                    shaderBuffers.empty() ? nullptr : &shaderBuffers[i],
-                    storageBuffers && !storageBuffers->empty() ? &storageBuffers->at(i) : nullptr,
-                    uniformSize,
-                    storageBuffers ? _storageBufferSize : 0,
-                    shaderInfo,
-                    descriptorSets[i]);
+            for (auto i = 0u; i < swapchainSize; i++)
+            {
+                VkBuffer uniformBuffer = uniformSize > 0 ? uniformRing->getBuffer(blockIndex, i) : VK_NULL_HANDLE;
+                updateDescriptorSet(
+                        i,
+                        uniformSize > 0 ? &uniformBuffer : nullptr,
+                        storageBuffers ? &storageBuffers->at(i) : nullptr,
+                        uniformSize,
+                        _storageBufferSize,
+                        shaderInfo,
+                        _descriptorSets[shaderIndex][blockIndex * swapchainSize + i]);
+            }
         }
-    };
-
-    makeDescriptorSet(_instanceData.back().vertexUniformBuffers, &_vertexStorageBuffers, _vertexShader, _instanceData.back().vertexDescriptorSets);
-    makeDescriptorSet(_instanceData.back().geometryUniformBuffer, nullptr, _geometryShader, _instanceData.back().geometryDescriptorSets);
-    makeDescriptorSet(_instanceData.back().fragmentUniformBuffer, nullptr, _fragmentShader, _instanceData.back().fragmentDescriptorSets);
+    }
 }
 
 void VulkanMaterial::updateDescriptorSet(
@@ -1239,6 +881,7 @@ void VulkanMaterial::updateDescriptorSet(
     VkDescriptorBufferInfo storageBufferInfo {};
     if (shaderBuffer)
     {
+        // Instance data position is passed as dynamic offset on bind
         bufferInfo.buffer = *shaderBuffer;
         bufferInfo.offset = 0;
         bufferInfo.range = uniformSize;
@@ -1250,61 +893,50 @@ void VulkanMaterial::updateDescriptorSet(
         storageBufferInfo.range = storageSize;
     }
 
-    std::vector<VkDescriptorImageInfo> imageInfoList;
-    for (const auto& samplerName : shaderInfo->getShaderSettings().samplerNamesList)
+    const auto& samplerNamesList = shaderInfo->getShaderSettings().samplerNamesList;
+    std::vector<VkDescriptorImageInfo> imageInfoList(samplerNamesList.size());
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+    descriptorWrites.reserve(samplerNamesList.size() + 2);
+    auto bindingIndex = 0u;
+    // Add texture samplers, external images that aren't created yet are written on descriptor sets reset
+    for (auto samplerIndex = 0u; samplerIndex < samplerNamesList.size(); samplerIndex++, bindingIndex++)
     {
         auto iter = std::find(_textureNames.cbegin(),
                               _textureNames.cend(),
-                              samplerName);
+                              samplerNamesList[samplerIndex]);
         if (iter == _textureNames.end())
         {
             throw VulkanException("Incorrect sampler name in material configuration");
         }
         auto index = std::distance(_textureNames.cbegin(), iter);
 
+        auto& imageInfo = imageInfoList[samplerIndex];
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         if (!_texturesData[index].external)
         {
-            VkDescriptorImageInfo imageInfo{};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = _textureImageViews[index];
+            imageInfo.imageView = _textures[index]->getImageView();
             imageInfo.sampler = _textureSamplers[index];
-
-            imageInfoList.push_back(imageInfo);
         } else {
             const auto& samplerInfoList =
                     _texturesData[index].type == TextureType::ScreenQuad && _texturesData[index].subtype > 0
                     ? _vulkanInstance->getSamplerHolder()->getPostEffectSamplerInfo(_texturesData[index].subtype)
                     : _vulkanInstance->getSamplerHolder()->getSamplerInfo(_texturesData[index].type);
-            if (!samplerInfoList.empty() && samplerInfoList[imageIndex].imageView != VK_NULL_HANDLE)
-            {
-                VkDescriptorImageInfo imageInfo{};
-                imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                imageInfo.imageView = samplerInfoList[imageIndex].imageView;
-                imageInfo.sampler = samplerInfoList[imageIndex].sampler;
+            if (samplerInfoList.empty() || samplerInfoList[imageIndex].imageView == VK_NULL_HANDLE)
+                continue;
 
-                imageInfoList.push_back(imageInfo);
-            }
+            imageInfo.imageView = samplerInfoList[imageIndex].imageView;
+            imageInfo.sampler = samplerInfoList[imageIndex].sampler;
         }
-    }
 
-    std::vector<VkWriteDescriptorSet> descriptorWrites;
-    auto bindingIndex = 0u;
-    // Add texture samplers
-    if (!imageInfoList.empty())
-    {
-        for (auto& imageInfo : imageInfoList)
-        {
-            VkWriteDescriptorSet imagesBuffer{};
-            imagesBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            imagesBuffer.dstSet = descriptorSet;
-            imagesBuffer.dstBinding = bindingIndex;
-            imagesBuffer.dstArrayElement = 0;
-            imagesBuffer.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            imagesBuffer.descriptorCount = 1;
-            imagesBuffer.pImageInfo = &imageInfo;
-            descriptorWrites.push_back(imagesBuffer);
-            bindingIndex ++;
-        }
+        VkWriteDescriptorSet imagesBuffer{};
+        imagesBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        imagesBuffer.dstSet = descriptorSet;
+        imagesBuffer.dstBinding = bindingIndex;
+        imagesBuffer.dstArrayElement = 0;
+        imagesBuffer.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        imagesBuffer.descriptorCount = 1;
+        imagesBuffer.pImageInfo = &imageInfo;
+        descriptorWrites.push_back(imagesBuffer);
     }
     // Add uniforms
     if (shaderBuffer)
@@ -1314,7 +946,7 @@ void VulkanMaterial::updateDescriptorSet(
         uniformsBuffer.dstSet = descriptorSet;
         uniformsBuffer.dstBinding = bindingIndex;
         uniformsBuffer.dstArrayElement = 0;
-        uniformsBuffer.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        uniformsBuffer.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         uniformsBuffer.descriptorCount = 1;
         uniformsBuffer.pBufferInfo = &bufferInfo;
         descriptorWrites.push_back(uniformsBuffer);
@@ -1353,29 +985,4 @@ const MaterialSettings &VulkanMaterial::getSettings() const
     return _materialSettings;
 }
 
-bool VulkanMaterial::isMainInstance(uint32_t materialIndex) const
-{
-    return _materialSettings.useInstancing && materialIndex == _mainInstance;
-}
-
-void VulkanMaterial::setMainInstance(uint32_t materialIndex)
-{
-    _mainInstance = materialIndex;
-}
-
-bool VulkanMaterial::isInstancesRendered() const
-{
-    return _instancesRendered;
-}
-
-void VulkanMaterial::setInstancedRendered()
-{
-    _instancesRendered = true;
-}
-
-uint32_t VulkanMaterial::getInstanceCount() const
-{
-    return _currentInstanceCount;//_instanceData.size() - 1;
-}
-
 } // namespace SVE
\ No newline at end of file
@@ -7,15 +7,19 @@
 #include "Libs.h"
 #include "MaterialSettings.h"
 #include "ShaderSettings.h"
+#include "MaterialInstance.h"
+#include "SlotMap.h"
 #include <vector>
+#include <memory>
 #include <vulkan/vk_mem_alloc.h>
 
 namespace SVE
 {
 class VulkanUtils;
+class VulkanTexture;
 class VulkanShaderInfo;
 class VulkanInstance;
-class Entity;
+struct RecordingContext;
 
 enum class TextureType : uint8_t;
 
@@ -25,40 +29,43 @@ public:
     explicit VulkanMaterial(MaterialSettings materialSettings);
     ~VulkanMaterial();
 
-    VkPipeline getPipeline() const;
+    // Unique material id, used for draw sorting
+    uint32_t getId() const;
+    VkPipeline getPipeline(VertexFormat vertexFormat = VertexFormat::Full) const;
     VkPipelineLayout getPipelineLayout() const;
+    // Pipeline for full vertex format is created with material, others should be prepared before drawing
+    void preparePipeline(VertexFormat vertexFormat);
 
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex, uint32_t materialIndex);
+    void applyDrawingCommands(const RecordingContext& context, MaterialInstance instance,
+                              VertexFormat vertexFormat = VertexFormat::Full) const;
 
     void resetDescriptorSets();
     void updateDescriptorSets();
     void resetPipeline();
 
-    std::vector<VkDescriptorSet> getDescriptorSets(uint32_t materialIndex, size_t index) const;
-
-    uint32_t getInstanceForEntity(const Entity* entity, uint32_t index = 0);
-    void deleteInstancesForEntity(const Entity* entity);
+    // Owner should delete instance, handle is invalid after that
+    MaterialInstance createInstance();
+    void deleteInstance(MaterialInstance instance);
+    bool isInstanceValid(MaterialInstance instance) const;
     bool isSkeletal() const;
-    bool isMainInstance(uint32_t materialIndex) const;
-    void setMainInstance(uint32_t materialIndex);
-    bool isInstancesRendered() const;
-    void setInstancedRendered();
-    uint32_t getInstanceCount() const;
     glm::ivec2 getSpritesheetSize() const;
 
     const MaterialSettings& getSettings() const;
 
-    void setUniformData(uint32_t materialIndex, const UniformData& data);
-    void updateInstancedData();
+    void setUniformData(MaterialInstance instance, const UniformData& data);
 
-private:
-    struct PerInstanceData;
+    // Model matrices of instanced draws, written for every frame before recording.
+    // Ranges of all passes go to the same buffer, draw uses returned index as first instance.
+    void resetInstanceData();
+    uint32_t addInstanceData(const glm::mat4* modelList, uint32_t count);
+    uint32_t getFreeInstanceDataCount() const;
 
+private:
     void createPipelineLayout();
     void deletePipelineLayout();
 
-    void createPipeline();
-    void deletePipeline();
+    void createPipeline(VertexFormat vertexFormat);
+    void deletePipelines();
 
     void createAndStorePipelineCache();
     void loadPipelineCache();
@@ -66,25 +73,15 @@ private:
 
     void createTextureImages();
     void createCubemapTextureImages();
-    void deleteTextureImages();
-    void createTextureImageView();
-    void deleteTextureImageView();
     void createTextureSampler();
-    void deleteTextureSampler();
-
-    void createUniformBuffers();
-    void deleteUniformBuffers();
-    void deleteUniformBuffers(PerInstanceData& instance);
 
     void createStorageBuffers();
     void deleteStorageBuffers();
 
-    void createDescriptorPool();
-    void deleteDescriptorPool();
-    void deleteDescriptorPool(PerInstanceData& instance);
+    // Descriptor sets are created for every uniform ring block, ring can grow during frame
+    void createBlockDescriptorSets(uint32_t blockIndex);
     void createDescriptorSets();
     void deleteDescriptorSets();
-    void deleteDescriptorSets(PerInstanceData& instance);
 
     void updateDescriptorSet(uint32_t imageIndex,
                              const VkBuffer* shaderBuffer,
@@ -95,6 +92,7 @@ private:
                              VkDescriptorSet descriptorSet);
 
 private:
+    uint32_t _id;
     MaterialSettings _materialSettings;
 
     VulkanInstance* _vulkanInstance;
@@ -108,13 +106,14 @@ private:
     std::vector<VulkanShaderInfo*> _shaderList;
 
     VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
-    VkPipeline _pipeline;
+    static constexpr uint32_t VertexFormatCount = static_cast<uint32_t>(VertexFormat::Count);
+
+    // Pipelines differ only in vertex input state, null if format is not used by any mesh
+    VkPipeline _pipelines[VertexFormatCount] {};
     VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
 
-    std::vector<uint32_t> _mipLevels;
-    std::vector<VkImage> _textureImages;
-    std::vector<VkDeviceMemory> _textureImageMemoryList;
-    std::vector<VkImageView> _textureImageViews;
+    // Image files are shared through TextureManager, samplers are owned by it too
+    std::vector<std::shared_ptr<VulkanTexture>> _textures;
     std::vector<VkSampler> _textureSamplers;
     std::vector<std::string> _textureNames;
 
@@ -128,32 +127,32 @@ private:
     };
     std::vector<TextureData> _texturesData;
 
-    struct PerInstanceData
+    // Location of instance uniforms written this frame (for every shader) in uniform ring
+    struct UniformLocation
     {
-        std::vector<VkBuffer> vertexUniformBuffers;
-        std::vector<VkBuffer> fragmentUniformBuffer;
-        std::vector<VkBuffer> geometryUniformBuffer;
-        std::vector<VmaAllocation> uniformBuffersMemory;
-
-        VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+        uint32_t blockIndex = 0;
+        uint32_t offset = 0;
+    };
 
-        std::vector<VkDescriptorSet> vertexDescriptorSets;
-        std::vector<VkDescriptorSet> fragmentDescriptorSets;
-        std::vector<VkDescriptorSet> geometryDescriptorSets;
+    struct PerInstanceData
+    {
+        std::vector<UniformLocation> uniformLocations;
     };
 
     // for all instances
-    StorageData _storageData;
-    bool _storageUpdated = true;
+    // [shader][block * swapchainSize + image], empty for shaders without descriptor set
+    std::vector<std::vector<VkDescriptorSet>> _descriptorSets;
+    uint32_t _descriptorBlockCount = 0;
+
     VkDeviceSize _storageBufferSize = 0;
     std::vector<VkBuffer> _vertexStorageBuffers;
     std::vector<VmaAllocation> _storageBuffersMemory;
-    uint32_t _mainInstance = 0;
-    uint32_t _currentInstanceCount = 0;
-    bool _instancesRendered = false;
+    std::vector<char*> _storageBuffersData;
+    uint32_t _instanceCapacity = 0;
+    uint32_t _instanceDataCount = 0;
 
-    std::map<const Entity*, std::vector<uint32_t>> _entityInstanceMap;
-    std::vector<PerInstanceData> _instanceData;
+    // Free slots are reused by new instances
+    SlotMap<MaterialInstance, PerInstanceData> _instanceData;
 };
 
 } // namespace SVE
\ No newline at end of file
@@ -7,189 +7,174 @@
 #include "Engine.h"
 #include "VulkanMaterial.h"
 #include "VulkanInstance.h"
-#include "VulkanUtils.h"
-#include "VulkanException.h"
+#include "VulkanBindCache.h"
+#include "RecordingContext.h"
+#include "VertexQuantization.h"
+#include "Utils.h"
+#include <atomic>
+#include <algorithm>
+#include <cstring>
 
 namespace SVE
 {
+namespace
+{
+
+std::atomic<uint32_t> meshCounter { 0 };
+// Arena ranges are aligned the same way, so stream offsets keep attribute alignment
+constexpr VkDeviceSize StreamAlignment = 16;
 
-VulkanMesh::VulkanMesh(MeshSettings meshSettings)
-    : _vulkanInstance(Engine::getInstance()->getVulkanInstance())
-    , _vulkanUtils(_vulkanInstance->getVulkanUtils())
-    , _meshSettings(std::move(meshSettings))
+VkDeviceSize alignOffset(VkDeviceSize offset)
 {
-    createGeometryBuffers();
+    return (offset + StreamAlignment - 1) / StreamAlignment * StreamAlignment;
 }
 
-VulkanMesh::~VulkanMesh()
+// Interleave attribute list into vertex stream, missing attributes stay zero
+template <typename Vertex, typename T>
+void copyAttribute(const std::vector<T>& data, Vertex* vertices, size_t vertexCount, T Vertex::* attribute)
 {
-    deleteGeometryBuffers();
+    auto count = std::min(data.size(), vertexCount);
+    for (auto i = 0u; i < count; i++)
+        vertices[i].*attribute = data[i];
+}
+
+} // anon namespace
+
+VulkanMesh::VulkanMesh(const MeshSettings& meshSettings)
+    : _id(++meshCounter)
+    , _vulkanInstance(Engine::getInstance()->getVulkanInstance())
+    , _vertexFormat(meshSettings.vertexFormat)
+{
+    createGeometryBuffers(meshSettings);
 }
 
-void VulkanMesh::updateMesh(MeshSettings meshSettings)
+VulkanMesh::~VulkanMesh()
 {
     deleteGeometryBuffers();
-    _meshSettings = std::move(meshSettings);
-    createGeometryBuffers();
 }
 
-void VulkanMesh::applyDrawingCommands(uint32_t bufferIndex, uint32_t instanceCount)
+void VulkanMesh::updateMesh(const MeshSettings& meshSettings)
 {
-    auto commandBuffer = _vulkanInstance->getCommandBuffer(bufferIndex);
+    // Old range is freed after frames in flight which draw it are finished
+    auto oldGeometry = _geometry;
+    createGeometryBuffers(meshSettings);
+    _vulkanInstance->getGeometryArena()->retire(oldGeometry);
+}
 
-    std::vector<VkDeviceSize> offsets(_vertexBufferList.size());
-    vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBufferList.size(), _vertexBufferList.data(), offsets.data());
-    vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+void VulkanMesh::applyDrawingCommands(const RecordingContext& context) const
+{
+    if (context.bindCache->isGeometryBindNeeded(this))
+    {
+        vkCmdBindVertexBuffers(context.commandBuffer, 0, _vertexStreamCount, _vertexBuffers, _vertexOffsets);
+        vkCmdBindIndexBuffer(context.commandBuffer, _geometry.buffer, _indexOffset, VK_INDEX_TYPE_UINT32);
+    }
 
-    vkCmdDrawIndexed(commandBuffer, _meshSettings.indexData.size(), instanceCount, 0, 0, 0);
+    vkCmdDrawIndexed(context.commandBuffer, _indexCount, context.instanceCount, 0, 0, context.firstInstance);
 }
 
-const MeshSettings& VulkanMesh::getMeshSettings() const
+VertexFormat VulkanMesh::getVertexFormat() const
 {
-    return _meshSettings;
+    return _vertexFormat;
 }
 
-void VulkanMesh::createGeometryBuffers()
+uint32_t VulkanMesh::getId() const
 {
-    // TODO: This can be optimized to use single buffer
-    if (!_meshSettings.vertexPosData.empty())
-    {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexPosData, 
-                              _vertexBufferList.back(), 
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    }
-    if (!_meshSettings.vertexColorData.empty())
-    {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexColorData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    }
-    if (!_meshSettings.vertexTexData.empty())
-    {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexTexData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    }
+    return _id;
+}
 
-    if (!_meshSettings.vertexNormalData.empty())
+void VulkanMesh::createGeometryBuffers(const MeshSettings& meshSettings)
+{
+    // Range layout: positions, surface attributes, bones, indices
+    const auto vertexCount = meshSettings.vertexPosData.size();
+    const auto hasSurface = !meshSettings.vertexColorData.empty() || !meshSettings.vertexTexData.empty() ||
+                            !meshSettings.vertexNormalData.empty() || !meshSettings.vertexBinormalData.empty() ||
+                            !meshSettings.vertexTangentData.empty();
+    const auto hasSkin = meshSettings.boneNum > 0;
+
+    // Compact streams are packed first to check if quantization keeps data precise enough
+    std::vector<CompactPositionVertex> compactPositions;
+    std::vector<CompactSurfaceVertex> compactSurface;
+    if (_vertexFormat == VertexFormat::Compact)
     {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexNormalData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        VertexQuantizationError error;
+        compactPositions.resize(vertexCount);
+        packCompactPositions(meshSettings, compactPositions.data(), error);
+        if (hasSurface)
+        {
+            compactSurface.resize(vertexCount);
+            packCompactSurface(meshSettings, compactSurface.data(), error);
+        }
+
+        if (!isQuantizationErrorAcceptable(error))
+        {
+            std::cout << "Mesh " << meshSettings.name << " can't be stored in compact vertex format, using full format" << std::endl;
+            _vertexFormat = VertexFormat::Full;
+            compactPositions.clear();
+            compactSurface.clear();
+        }
     }
-
-    if (!_meshSettings.vertexBinormalData.empty())
+    const auto isCompact = _vertexFormat == VertexFormat::Compact;
+
+    VkDeviceSize streamSizes[MaxVertexStreams] {};
+    streamSizes[toInt(VertexStream::Position)] = vertexCount * (isCompact ? sizeof(CompactPositionVertex) : sizeof(glm::vec3));
+    streamSizes[toInt(VertexStream::Surface)] = hasSurface
+            ? vertexCount * (isCompact ? sizeof(CompactSurfaceVertex) : sizeof(SurfaceVertex))
+            : 0;
+    streamSizes[toInt(VertexStream::Skin)] = hasSkin ? vertexCount * sizeof(SkinVertex) : 0;
+
+    VkDeviceSize size = 0;
+    _vertexStreamCount = 0;
+    for (auto stream = 0u; stream < MaxVertexStreams; stream++)
     {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexBinormalData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        _vertexOffsets[stream] = size;
+        size = alignOffset(size + streamSizes[stream]);
+        if (streamSizes[stream] > 0)
+            _vertexStreamCount = stream + 1;
     }
-
-    if (!_meshSettings.vertexTangentData.empty())
+    _indexOffset = size;
+    size += meshSettings.indexData.size() * sizeof(uint32_t);
+
+    std::vector<char> geometryData(size);
+    memcpy(geometryData.data() + _vertexOffsets[toInt(VertexStream::Position)],
+           isCompact ? static_cast<const void*>(compactPositions.data()) : meshSettings.vertexPosData.data(),
+           streamSizes[toInt(VertexStream::Position)]);
+    if (hasSurface && isCompact)
     {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexTangentData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        memcpy(geometryData.data() + _vertexOffsets[toInt(VertexStream::Surface)],
+               compactSurface.data(),
+               streamSizes[toInt(VertexStream::Surface)]);
+    } else if (hasSurface) {
+        auto* surface = reinterpret_cast<SurfaceVertex*>(geometryData.data() + _vertexOffsets[toInt(VertexStream::Surface)]);
+        copyAttribute(meshSettings.vertexColorData, surface, vertexCount, &SurfaceVertex::color);
+        copyAttribute(meshSettings.vertexTexData, surface, vertexCount, &SurfaceVertex::texCoord);
+        copyAttribute(meshSettings.vertexNormalData, surface, vertexCount, &SurfaceVertex::normal);
+        copyAttribute(meshSettings.vertexBinormalData, surface, vertexCount, &SurfaceVertex::binormal);
+        copyAttribute(meshSettings.vertexTangentData, surface, vertexCount, &SurfaceVertex::tangent);
     }
-
-    if (_meshSettings.boneNum > 0)
+    if (hasSkin)
     {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexBoneWeightData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexBoneIndexData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        auto* skin = reinterpret_cast<SkinVertex*>(geometryData.data() + _vertexOffsets[toInt(VertexStream::Skin)]);
+        copyAttribute(meshSettings.vertexBoneWeightData, skin, vertexCount, &SkinVertex::boneWeights);
+        copyAttribute(meshSettings.vertexBoneIndexData, skin, vertexCount, &SkinVertex::boneIds);
     }
+    memcpy(geometryData.data() + _indexOffset,
+           meshSettings.indexData.data(),
+           meshSettings.indexData.size() * sizeof(uint32_t));
 
-    if (!_meshSettings.vertexTangentData.empty())
+    _geometry = _vulkanInstance->getGeometryArena()->allocate(geometryData.data(), size);
+    for (auto stream = 0u; stream < MaxVertexStreams; stream++)
     {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexTangentData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        _vertexBuffers[stream] = _geometry.buffer;
+        _vertexOffsets[stream] += _geometry.offset;
     }
-    
-    createOptimizedBuffer(_meshSettings.indexData, _indexBuffer, _indexBufferMemory, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    _indexOffset += _geometry.offset;
+    _indexCount = static_cast<uint32_t>(meshSettings.indexData.size());
 }
 
 void VulkanMesh::deleteGeometryBuffers()
 {
-    vmaDestroyBuffer(_vulkanInstance->getAllocator(), _indexBuffer, _indexBufferMemory);
-
-    for (auto i = 0; i < _vertexBufferList.size(); ++i)
-    {
-        vmaDestroyBuffer(_vulkanInstance->getAllocator(), _vertexBufferList[i], _vertexBufferMemoryList[i]);
-    }
-
-    _vertexBufferList.clear();
-    _vertexBufferMemoryList.clear();
-}
-
-// This method will create fast GPU-local buffer (using transitional temporary CPU visible buffer)
-template <typename T>
-void VulkanMesh::createOptimizedBuffer(
-        const std::vector<T>& bufferData,
-        VkBuffer& buffer,
-        VmaAllocation& allocation,
-        VkBufferUsageFlags usage)
-{
-    VkDeviceSize bufferSize = sizeof(bufferData[0]) * bufferData.size();
-
-    // create temporary slow CPU visible memory
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingBufferMemory;
-    _vulkanUtils.createBuffer(bufferSize,
-                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                              VMA_MEMORY_USAGE_CPU_TO_GPU,
-                              stagingBuffer,
-                              stagingBufferMemory);
-
-    // Fill temporary buffer with vertex/index data
-    void* data;
-    vmaMapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory, &data);
-    memcpy(data, bufferData.data(), (size_t) bufferSize);
-    vmaUnmapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory);
-
-    // create fast GPU-local buffer for data
-    _vulkanUtils.createBuffer(bufferSize,
-                              VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
-                              VMA_MEMORY_USAGE_GPU_ONLY,
-                              buffer,
-                              allocation);
-
-    // copy slow CPU-visible buffer to fast GPU-local
-    _vulkanUtils.copyBuffer(stagingBuffer, buffer, bufferSize);
-
-    // destroy CPU-visible buffer
-    vmaDestroyBuffer(_vulkanInstance->getAllocator(), stagingBuffer, stagingBufferMemory);
+    _vulkanInstance->getGeometryArena()->free(_geometry);
+    _geometry = {};
 }
 
 } // namespace SVE
\ No newline at end of file
@@ -3,50 +3,53 @@
 // Licensed under the MIT License
 #pragma once
 #include "MeshSettings.h"
+#include "ShaderSettings.h"
 #include "VulkanHeaders.h"
+#include "VulkanGeometryArena.h"
 #include <memory>
-#include <vulkan/vk_mem_alloc.h>
 
 namespace SVE
 {
 class VulkanMaterial;
 class VulkanInstance;
-class VulkanUtils;
+struct RecordingContext;
 
 class VulkanMesh
 {
 public:
-    explicit VulkanMesh(MeshSettings meshSettings);
+    // Settings are only uploaded, mesh keeps draw data only
+    explicit VulkanMesh(const MeshSettings& meshSettings);
     ~VulkanMesh();
 
-    void updateMesh(MeshSettings meshSettings);
+    void updateMesh(const MeshSettings& meshSettings);
 
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t instanceCount = 1);
+    void applyDrawingCommands(const RecordingContext& context) const;
 
-    const MeshSettings& getMeshSettings() const;
+    // Format of position and surface streams, materials need pipeline for it
+    VertexFormat getVertexFormat() const;
+    // Unique mesh id, used for draw sorting
+    uint32_t getId() const;
 
 private:
-    void createGeometryBuffers();
+    void createGeometryBuffers(const MeshSettings& meshSettings);
     void deleteGeometryBuffers();
 
 private:
-    template <typename T>
-    void createOptimizedBuffer(
-            const std::vector<T>& data,
-            VkBuffer &buffer,
-            VmaAllocation& allocation,
-            VkBufferUsageFlags usage);
+    static constexpr uint32_t MaxVertexStreams = static_cast<uint32_t>(VertexStream::Count);
 
-private:
+    uint32_t _id;
     VulkanInstance* _vulkanInstance;
-    const VulkanUtils& _vulkanUtils;
 
-    MeshSettings _meshSettings;
+    uint32_t _indexCount = 0;
+    // Only switched from compact to full if updated data can't be quantized
+    VertexFormat _vertexFormat;
 
-    std::vector<VkBuffer> _vertexBufferList;
-    std::vector<VmaAllocation> _vertexBufferMemoryList;
-    VkBuffer _indexBuffer = VK_NULL_HANDLE;
-    VmaAllocation _indexBufferMemory = VK_NULL_HANDLE;
+    // Vertex streams and indices share one arena range, offsets are calculated on creation
+    VulkanGeometryArena::Allocation _geometry;
+    VkBuffer _vertexBuffers[MaxVertexStreams] {};
+    VkDeviceSize _vertexOffsets[MaxVertexStreams] {};
+    uint32_t _vertexStreamCount = 0;
+    VkDeviceSize _indexOffset = 0;
 };
 
 } // namespace SVE
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "VulkanInstance.h"
 #include "VulkanUtils.h"
 #include "VulkanComputeEntity.h"
+#include "VulkanBindCache.h"
+#include "RecordingContext.h"
 
 namespace SVE
 {
@@ -24,14 +26,13 @@ VulkanParticleSystem::~VulkanParticleSystem()
 {
 }
 
-void VulkanParticleSystem::applyDrawingCommands(uint32_t bufferIndex)
+void VulkanParticleSystem::applyDrawingCommands(const RecordingContext& context) const
 {
-    auto commandBuffer = _vulkanInstance->getCommandBuffer(bufferIndex);
-
     VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &_buffer, &offset);
+    vkCmdBindVertexBuffers(context.commandBuffer, 0, 1, &_buffer, &offset);
+    context.bindCache->resetGeometry();
 
-    vkCmdDraw(commandBuffer, _particleSettings.quota, 1, 0, 0);
+    vkCmdDraw(context.commandBuffer, _particleSettings.quota, 1, 0, 0);
 }
 
 
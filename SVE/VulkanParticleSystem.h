@@ -13,6 +13,7 @@ namespace SVE
 class VulkanUtils;
 class VulkanInstance;
 class VulkanComputeEntity;
+struct RecordingContext;
 
 class VulkanParticleSystem
 {
@@ -21,7 +22,7 @@ public:
                                   const VulkanComputeEntity& particleComputeEntity);
     ~VulkanParticleSystem();
 
-    void applyDrawingCommands(uint32_t bufferIndex);
+    void applyDrawingCommands(const RecordingContext& context) const;
 
 
 private:
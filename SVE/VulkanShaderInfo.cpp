@@ -7,7 +7,11 @@
 #include "Engine.h"
 #include "LightManager.h"
 #include "ResourceManager.h"
+#include "VulkanDescriptorAllocator.h"
+#include "Utils.h"
 #include <fstream>
+#include <algorithm>
+#include <cstddef>
 
 namespace SVE
 {
@@ -27,10 +31,46 @@ VkShaderStageFlagBits getVulkanShaderStage(const ShaderSettings& shaderSettings)
     return stageMap[static_cast<uint8_t>(shaderSettings.shaderType)];
 }
 
+struct VertexAttributeInfo
+{
+    VertexInfo::VertexDataType type;
+    VkFormat format;
+    VertexStream stream;
+    uint32_t streamOffset;
+};
+
+// Mesh attributes in shader location order
+const std::vector<VertexAttributeInfo>& getVertexAttributeList(VertexFormat vertexFormat)
+{
+    // Vertex fetch unpacks compact data to floats, so shader inputs are the same
+    static const std::vector<VertexAttributeInfo> compactAttributeList {
+            { VertexInfo::Position,     VK_FORMAT_R16G16B16A16_SFLOAT,  VertexStream::Position, 0 },
+            { VertexInfo::Color,        VK_FORMAT_R8G8B8A8_UNORM,       VertexStream::Surface,  offsetof(CompactSurfaceVertex, color) },
+            { VertexInfo::TexCoord,     VK_FORMAT_R16G16_SFLOAT,        VertexStream::Surface,  offsetof(CompactSurfaceVertex, texCoord) },
+            { VertexInfo::Normal,       VK_FORMAT_R8G8B8A8_SNORM,       VertexStream::Surface,  offsetof(CompactSurfaceVertex, normal) },
+            { VertexInfo::Binormal,     VK_FORMAT_R8G8B8A8_SNORM,       VertexStream::Surface,  offsetof(CompactSurfaceVertex, binormal) },
+            { VertexInfo::Tangent,      VK_FORMAT_R8G8B8A8_SNORM,       VertexStream::Surface,  offsetof(CompactSurfaceVertex, tangent) },
+            { VertexInfo::BoneWeights,  VK_FORMAT_R32G32B32A32_SFLOAT,  VertexStream::Skin,     offsetof(SkinVertex, boneWeights) },
+            { VertexInfo::BoneIds,      VK_FORMAT_R32G32B32A32_SINT,    VertexStream::Skin,     offsetof(SkinVertex, boneIds) },
+    };
+    static const std::vector<VertexAttributeInfo> attributeList {
+            { VertexInfo::Position,     VK_FORMAT_R32G32B32_SFLOAT,     VertexStream::Position, 0 },
+            { VertexInfo::Color,        VK_FORMAT_R32G32B32_SFLOAT,     VertexStream::Surface,  offsetof(SurfaceVertex, color) },
+            { VertexInfo::TexCoord,     VK_FORMAT_R32G32_SFLOAT,        VertexStream::Surface,  offsetof(SurfaceVertex, texCoord) },
+            { VertexInfo::Normal,       VK_FORMAT_R32G32B32_SFLOAT,     VertexStream::Surface,  offsetof(SurfaceVertex, normal) },
+            { VertexInfo::Binormal,     VK_FORMAT_R32G32B32_SFLOAT,     VertexStream::Surface,  offsetof(SurfaceVertex, binormal) },
+            { VertexInfo::Tangent,      VK_FORMAT_R32G32B32_SFLOAT,     VertexStream::Surface,  offsetof(SurfaceVertex, tangent) },
+            { VertexInfo::BoneWeights,  VK_FORMAT_R32G32B32A32_SFLOAT,  VertexStream::Skin,     offsetof(SkinVertex, boneWeights) },
+            { VertexInfo::BoneIds,      VK_FORMAT_R32G32B32A32_SINT,    VertexStream::Skin,     offsetof(SkinVertex, boneIds) },
+    };
+    return vertexFormat == VertexFormat::Compact ? compactAttributeList : attributeList;
+}
+
 } // anon namespace
 
 VulkanShaderInfo::VulkanShaderInfo(ShaderSettings shaderSettings)
         : _shaderSettings(std::move(shaderSettings))
+        , _uniformLayout(_shaderSettings)
         , _device(Engine::getInstance()->getVulkanInstance()->getLogicalDevice())
         , _shaderStage(getVulkanShaderStage(_shaderSettings))
 {
@@ -45,7 +85,7 @@ VulkanShaderInfo::~VulkanShaderInfo()
 
 VkPipelineShaderStageCreateInfo VulkanShaderInfo::createShaderStage()
 {
-    auto shaderCode = Engine::getInstance()->getResourceManager()->loadFileContent(_shaderSettings.filename);
+    auto shaderCode = Engine::getInstance()->getResourceManager()->loadFileView(_shaderSettings.filename);
     _shaderModule = createShaderModule(shaderCode);
 
     VkPipelineShaderStageCreateInfo shaderStageInfo{};
@@ -64,49 +104,12 @@ void VulkanShaderInfo::freeShaderModule()
 
 size_t VulkanShaderInfo::getShaderUniformsSize() const
 {
-    size_t size = 0;
-    const auto& sizeMap = getUniformSizeMap();
-    for (const auto& info : _shaderSettings.uniformList)
-    {
-        if (info.uniformType == UniformType::BoneMatrices)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxBonesSize;
-        } else if (info.uniformType == UniformType::LightPoint)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxShadowPointLightSize;
-        } else if (info.uniformType == UniformType::LightPointSimple)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxPointLightSize;
-        } else if (info.uniformType == UniformType::LightLine)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxLineLightSize;
-        } else if (info.uniformType == UniformType::LightPointViewProjectionList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxLightSize;
-        } else if (info.uniformType == UniformType::LightDirectViewProjectionList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxCascadeLightSize;
-        }
-        else if (info.uniformType == UniformType::ViewProjectionMatrixList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxViewProjectionMatrices;
-        }
-        else if (info.uniformType == UniformType::GlyphInfoList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxGlyphCount;
-        }
-        else if (info.uniformType == UniformType::TextSymbolList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxTextSize;
-        }
-        else
-        {
-            if (sizeMap.find(info.uniformType) != sizeMap.end())
-                size += sizeMap.at(info.uniformType);
-        }
-    }
+    return _uniformLayout.getSize();
+}
 
-    return size;
+const UniformLayout& VulkanShaderInfo::getUniformLayout() const
+{
+    return _uniformLayout;
 }
 
 size_t VulkanShaderInfo::getShaderStorageBuffersSize() const
@@ -131,229 +134,93 @@ VkDescriptorSetLayout VulkanShaderInfo::getDescriptorSetLayout() const
     return _descriptorSetLayout;
 }
 
-std::vector<VkVertexInputBindingDescription> VulkanShaderInfo::getBindingDescription() const
+const std::vector<VkDescriptorPoolSize>& VulkanShaderInfo::getDescriptorPoolSizes() const
 {
-    std::vector<VkVertexInputBindingDescription> bindingDescriptions;
-    uint32_t binding = 0;
-    uint32_t stride = 0;
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Position)
-    {
-        VkVertexInputBindingDescription positionBinding {};
-        positionBinding.binding = binding++;
-        positionBinding.stride = getVertexDataSize(VertexInfo::Position);
-        positionBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX; // per vertex or per instance
-        bindingDescriptions.push_back(positionBinding);
-        stride += positionBinding.stride;
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Color)
-    {
-        VkVertexInputBindingDescription colorBinding {};
-        colorBinding.binding = binding++;
-        colorBinding.stride = getVertexDataSize(VertexInfo::Color);
-        colorBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(colorBinding);
-        stride += colorBinding.stride;
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::TexCoord)
-    {
-        VkVertexInputBindingDescription texCoordBinding {};
-        texCoordBinding.binding = binding++;
-        texCoordBinding.stride = getVertexDataSize(VertexInfo::TexCoord);
-        texCoordBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(texCoordBinding);
-        stride += texCoordBinding.stride;
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Normal)
-    {
-        VkVertexInputBindingDescription normalBinding {};
-        normalBinding.binding = binding++;
-        normalBinding.stride = getVertexDataSize(VertexInfo::Normal);
-        normalBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(normalBinding);
-        stride += normalBinding.stride;
-    }
+    return _descriptorPoolSizes;
+}
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Binormal)
-    {
-        VkVertexInputBindingDescription binormalBinding {};
-        binormalBinding.binding = binding++;
-        binormalBinding.stride = getVertexDataSize(VertexInfo::Binormal);
-        binormalBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(binormalBinding);
-        stride += binormalBinding.stride;
-    }
+std::vector<VkVertexInputBindingDescription> VulkanShaderInfo::getBindingDescription(VertexFormat vertexFormat) const
+{
+    std::vector<VkVertexInputBindingDescription> bindingDescriptions;
+    const auto& vertexInfo = _shaderSettings.vertexInfo;
+    const uint32_t customCount = (vertexInfo.vertexDataFlags & VertexInfo::Custom) ? vertexInfo.customCount : 0;
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Tangent)
+    // for combined binding only one struct should be set, it has only attributes used by shader
+    if (!vertexInfo.separateBinding)
     {
-        VkVertexInputBindingDescription tangentBinding {};
-        tangentBinding.binding = binding++;
-        tangentBinding.stride = getVertexDataSize(VertexInfo::Tangent);
-        tangentBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(tangentBinding);
-        stride += tangentBinding.stride;
+        uint32_t stride = customCount * getVertexDataSize(VertexInfo::Custom);
+        for (const auto& attribute : getVertexAttributeList(VertexFormat::Full))
+        {
+            if (vertexInfo.vertexDataFlags & attribute.type)
+                stride += getVertexDataSize(attribute.type);
+        }
+        bindingDescriptions.push_back({ 0, stride, VK_VERTEX_INPUT_RATE_VERTEX });
+        return bindingDescriptions;
     }
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::BoneWeights)
+    // Mesh stream is bound if shader reads any of its attributes
+    uint32_t streamMask = 0;
+    for (const auto& attribute : getVertexAttributeList(vertexFormat))
     {
-        VkVertexInputBindingDescription boneWeightBinding {};
-        boneWeightBinding.binding = binding++;
-        boneWeightBinding.stride = getVertexDataSize(VertexInfo::BoneWeights);
-        boneWeightBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(boneWeightBinding);
-        stride += boneWeightBinding.stride;
+        if (vertexInfo.vertexDataFlags & attribute.type)
+            streamMask |= 1u << toInt(attribute.stream);
     }
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::BoneIds)
+    const auto isCompact = vertexFormat == VertexFormat::Compact;
+    const uint32_t streamStrides[] = {
+            isCompact ? static_cast<uint32_t>(sizeof(CompactPositionVertex)) : getVertexDataSize(VertexInfo::Position),
+            static_cast<uint32_t>(isCompact ? sizeof(CompactSurfaceVertex) : sizeof(SurfaceVertex)),
+            sizeof(SkinVertex) };
+    for (auto stream = 0u; stream < toInt(VertexStream::Count); stream++)
     {
-        VkVertexInputBindingDescription boneIdsBinding {};
-        boneIdsBinding.binding = binding++;
-        boneIdsBinding.stride = getVertexDataSize(VertexInfo::BoneIds);
-        boneIdsBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(boneIdsBinding);
-        stride += boneIdsBinding.stride;
+        if (streamMask & (1u << stream))
+            bindingDescriptions.push_back({ stream, streamStrides[stream], VK_VERTEX_INPUT_RATE_VERTEX });
     }
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Custom)
+    for (auto i = 0u; i < customCount; i++)
     {
-        for (auto i = 0; i < _shaderSettings.vertexInfo.customCount; i++)
-        {
-            VkVertexInputBindingDescription customBinding {};
-            customBinding.binding = binding++;
-            customBinding.stride = getVertexDataSize(VertexInfo::Custom);
-            customBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-            bindingDescriptions.push_back(customBinding);
-            stride += customBinding.stride;
-        }
-    }
-
-    // for combined binding only one struct should be set
-    if (!_shaderSettings.vertexInfo.separateBinding)
-    {
-        bindingDescriptions.clear();
-        VkVertexInputBindingDescription combinedBindingDescription {};
-        combinedBindingDescription.binding = 0;
-        combinedBindingDescription.stride = stride;
-        combinedBindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(combinedBindingDescription);
+        bindingDescriptions.push_back({ toInt(VertexStream::Count) + i,
+                                        getVertexDataSize(VertexInfo::Custom),
+                                        VK_VERTEX_INPUT_RATE_VERTEX });
     }
 
     return bindingDescriptions;
 }
 
-std::vector<VkVertexInputAttributeDescription> VulkanShaderInfo::getAttributeDescriptions() const
+std::vector<VkVertexInputAttributeDescription> VulkanShaderInfo::getAttributeDescriptions(VertexFormat vertexFormat) const
 {
     std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
-    uint32_t binding = 0;
+    const auto& vertexInfo = _shaderSettings.vertexInfo;
     uint32_t location = 0;
     uint32_t offset = 0;
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Position)
-    {
-        VkVertexInputAttributeDescription vertexAttrib {};
-        vertexAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        vertexAttrib.location = location++;
-        vertexAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        attributeDescriptions.push_back(vertexAttrib);
+    // Combined binding is filled by entity itself, it's always in full format
+    if (!vertexInfo.separateBinding)
+        vertexFormat = VertexFormat::Full;
 
-        offset += getVertexDataSize(VertexInfo::Position);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Color)
+    for (const auto& attribute : getVertexAttributeList(vertexFormat))
     {
-        VkVertexInputAttributeDescription colorAttrib {};
-        colorAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        colorAttrib.location = location++;
-        colorAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        colorAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(colorAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Color);
-    }
+        if (!(vertexInfo.vertexDataFlags & attribute.type))
+            continue;
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::TexCoord)
-    {
-        VkVertexInputAttributeDescription texCoordAttrib {};
-        texCoordAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        texCoordAttrib.location = location++;
-        texCoordAttrib.format = VK_FORMAT_R32G32_SFLOAT;
-        texCoordAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(texCoordAttrib);
-
-        offset += getVertexDataSize(VertexInfo::TexCoord);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Normal)
-    {
-        VkVertexInputAttributeDescription normalAttrib {};
-        normalAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        normalAttrib.location = location++;
-        normalAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        normalAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(normalAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Normal);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Binormal)
-    {
-        VkVertexInputAttributeDescription binormalAttrib {};
-        binormalAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        binormalAttrib.location = location++;
-        binormalAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        binormalAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(binormalAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Binormal);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Tangent)
-    {
-        VkVertexInputAttributeDescription tangentAttrib {};
-        tangentAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        tangentAttrib.location = location++;
-        tangentAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        tangentAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(tangentAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Tangent);
-    }
+        VkVertexInputAttributeDescription attributeDescription {};
+        attributeDescription.binding = vertexInfo.separateBinding ? toInt(attribute.stream) : 0;
+        attributeDescription.location = location++;
+        attributeDescription.format = attribute.format;
+        attributeDescription.offset = vertexInfo.separateBinding ? attribute.streamOffset : offset;
+        attributeDescriptions.push_back(attributeDescription);
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::BoneWeights)
-    {
-        VkVertexInputAttributeDescription boneWeightAttrib {};
-        boneWeightAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        boneWeightAttrib.location = location++;
-        boneWeightAttrib.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-        boneWeightAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(boneWeightAttrib);
-
-        offset += getVertexDataSize(VertexInfo::BoneWeights);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::BoneIds)
-    {
-        VkVertexInputAttributeDescription boneIndexAttrib {};
-        boneIndexAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        boneIndexAttrib.location = location++;
-        boneIndexAttrib.format = VK_FORMAT_R32G32B32A32_SINT;
-        boneIndexAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(boneIndexAttrib);
-
-        offset += getVertexDataSize(VertexInfo::BoneIds);
+        offset += getVertexDataSize(attribute.type);
     }
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Custom)
+    if (vertexInfo.vertexDataFlags & VertexInfo::Custom)
     {
-        for (auto i = 0; i < _shaderSettings.vertexInfo.customCount; i++)
+        for (auto i = 0u; i < vertexInfo.customCount; i++)
         {
             VkVertexInputAttributeDescription customAttribute {};
-            customAttribute.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
+            customAttribute.binding = vertexInfo.separateBinding ? toInt(VertexStream::Count) + i : 0;
             customAttribute.location = location++;
             customAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-            customAttribute.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
+            customAttribute.offset = vertexInfo.separateBinding ? 0 : offset;
             attributeDescriptions.push_back(customAttribute);
 
             offset += getVertexDataSize(VertexInfo::Custom);
@@ -398,7 +265,10 @@ void VulkanShaderInfo::createDescriptorSetLayout()
     {
         VkDescriptorSetLayoutBinding uboLayoutBinding{};
         uboLayoutBinding.binding = bindingNum; // binding in shader
-        uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        // Material uniforms live in shared uniform ring and are addressed by dynamic offsets
+        uboLayoutBinding.descriptorType = _shaderSettings.shaderType == ShaderType::ComputeShader
+                                          ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+                                          : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         uboLayoutBinding.descriptorCount = 1;
         uboLayoutBinding.stageFlags = _shaderStage;
         uboLayoutBinding.pImmutableSamplers = nullptr; // used for image sampling
@@ -439,17 +309,31 @@ void VulkanShaderInfo::createDescriptorSetLayout()
         throw VulkanException("Can't create Vulkan Descriptor Set layout");
     }
 
+    for (const auto& descriptor : descriptorList)
+    {
+        auto poolSizeIter = std::find_if(_descriptorPoolSizes.begin(), _descriptorPoolSizes.end(),
+                                         [&descriptor](const VkDescriptorPoolSize& poolSize)
+        {
+            return poolSize.type == descriptor.descriptorType;
+        });
+        if (poolSizeIter == _descriptorPoolSizes.end())
+            _descriptorPoolSizes.push_back({ descriptor.descriptorType, descriptor.descriptorCount });
+        else
+            poolSizeIter->descriptorCount += descriptor.descriptorCount;
+    }
 }
 
 void VulkanShaderInfo::deleteDescriptorSetLayout()
 {
+    if (_descriptorSetLayout != VK_NULL_HANDLE)
+        Engine::getInstance()->getVulkanInstance()->getDescriptorAllocator()->releaseLayout(_descriptorSetLayout);
     vkDestroyDescriptorSetLayout(_device,
                                  _descriptorSetLayout,
                                  nullptr);
     _descriptorSetLayout = VK_NULL_HANDLE;
 }
 
-VkShaderModule VulkanShaderInfo::createShaderModule(const std::string& code) const
+VkShaderModule VulkanShaderInfo::createShaderModule(const FileView& code) const
 {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -2,9 +2,11 @@
 // Copyright (c) 2018-2019, Igor Barinov
 // Licensed under the MIT License
 #pragma once
+#include "FileSystem.h"
 #include "VulkanHeaders.h"
 #include "VulkanUtils.h"
 #include "ShaderSettings.h"
+#include "UniformLayout.h"
 #include <vector>
 #include <map>
 
@@ -20,28 +22,34 @@ public:
     VkPipelineShaderStageCreateInfo createShaderStage();
     void freeShaderModule();
 
-    std::vector<VkVertexInputBindingDescription> getBindingDescription() const;
-    std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions() const;
+    // Vertex format is used only by separate binding, it should match format of drawn meshes
+    std::vector<VkVertexInputBindingDescription> getBindingDescription(VertexFormat vertexFormat = VertexFormat::Full) const;
+    std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions(VertexFormat vertexFormat = VertexFormat::Full) const;
 
     size_t getShaderUniformsSize() const;
+    const UniformLayout& getUniformLayout() const;
     size_t getShaderStorageBuffersSize() const;
     const ShaderSettings& getShaderSettings() const;
 
     VkDescriptorSetLayout getDescriptorSetLayout() const;
+    // Descriptors count by type for one set of layout
+    const std::vector<VkDescriptorPoolSize>& getDescriptorPoolSizes() const;
 private:
     void createDescriptorSetLayout();
     void deleteDescriptorSetLayout();
 
-    VkShaderModule createShaderModule(const std::string& code) const;
+    VkShaderModule createShaderModule(const FileView& code) const;
     uint32_t getVertexDataSize(VertexInfo::VertexDataType vertexDataType) const;
 
 private:
     VkDevice _device;
     ShaderSettings _shaderSettings;
+    UniformLayout _uniformLayout;
     VkShaderStageFlagBits _shaderStage;
     VkShaderModule _shaderModule = VK_NULL_HANDLE;
 
     VkDescriptorSetLayout _descriptorSetLayout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorPoolSize> _descriptorPoolSizes;
 };
 
 } // namespace SVE
\ No newline at end of file
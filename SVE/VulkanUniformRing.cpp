@@ -0,0 +1,97 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanUniformRing.h"
+#include "VulkanInstance.h"
+#include "VulkanException.h"
+#include <algorithm>
+
+namespace SVE
+{
+namespace
+{
+
+constexpr VkDeviceSize UniformBlockSize = 1024 * 1024;
+
+} // anon namespace
+
+VulkanUniformRing::VulkanUniformRing(const VulkanInstance* instance)
+    : _vulkanInstance(instance)
+    , _imageCount(instance->getSwapchainSize())
+    , _alignment(std::max<VkDeviceSize>(instance->getGPUInfo().limits.minUniformBufferOffsetAlignment, 1))
+{
+    addBlock();
+}
+
+VulkanUniformRing::~VulkanUniformRing()
+{
+    // Persistently mapped memory is unmapped by allocator on free
+    for (auto& imageBlocks : _blocks)
+    {
+        for (auto& block : imageBlocks)
+            vmaDestroyBuffer(_vulkanInstance->getAllocator(), block.buffer, block.allocation);
+    }
+}
+
+void VulkanUniformRing::startFrame(uint32_t imageIndex)
+{
+    _imageIndex = imageIndex;
+    _currentBlock = 0;
+    _offset = 0;
+}
+
+VulkanUniformRing::Allocation VulkanUniformRing::allocate(size_t size)
+{
+    if (size > UniformBlockSize)
+        throw VulkanException("Uniform data doesn't fit uniform ring block");
+
+    if (_offset + size > UniformBlockSize)
+    {
+        ++_currentBlock;
+        _offset = 0;
+        if (_currentBlock == _blocks.size())
+            addBlock();
+    }
+
+    const auto& block = _blocks[_currentBlock][_imageIndex];
+    Allocation allocation { _currentBlock, static_cast<uint32_t>(_offset), block.data + _offset };
+    _offset = (_offset + size + _alignment - 1) / _alignment * _alignment;
+
+    return allocation;
+}
+
+VkBuffer VulkanUniformRing::getBuffer(uint32_t blockIndex, uint32_t imageIndex) const
+{
+    return _blocks[blockIndex][imageIndex].buffer;
+}
+
+VkDeviceSize VulkanUniformRing::getBlockSize() const
+{
+    return UniformBlockSize;
+}
+
+uint32_t VulkanUniformRing::getBlockCount() const
+{
+    return static_cast<uint32_t>(_blocks.size());
+}
+
+void VulkanUniformRing::addBlock()
+{
+    // Block is added for all images, so block indexes are the same for every frame
+    std::vector<Block> imageBlocks(_imageCount);
+    for (auto& block : imageBlocks)
+    {
+        void* data = nullptr;
+        _vulkanInstance->getVulkanUtils().createBuffer(
+                UniformBlockSize,
+                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                VMA_MEMORY_USAGE_CPU_TO_GPU,
+                block.buffer,
+                block.allocation,
+                &data);
+        block.data = reinterpret_cast<char*>(data);
+    }
+    _blocks.push_back(std::move(imageBlocks));
+}
+
+} // namespace SVE
\ No newline at end of file
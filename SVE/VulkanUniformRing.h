@@ -0,0 +1,60 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <vulkan/vk_mem_alloc.h>
+#include <vector>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Uniform buffers shared by all materials. Every swapchain image has list of persistently mapped blocks,
+// uniforms are sub-allocated from them linearly and addressed with dynamic offsets.
+// Block list grows when frame data doesn't fit, new blocks are kept for next frames.
+class VulkanUniformRing
+{
+public:
+    struct Allocation
+    {
+        uint32_t blockIndex;
+        uint32_t offset;
+        char* data;
+    };
+
+    explicit VulkanUniformRing(const VulkanInstance* instance);
+    ~VulkanUniformRing();
+
+    // Rewind buffers of image, should be called at frame start after image was acquired
+    void startFrame(uint32_t imageIndex);
+    // Memory is valid until the same swapchain image is rendered again
+    Allocation allocate(size_t size);
+
+    VkBuffer getBuffer(uint32_t blockIndex, uint32_t imageIndex) const;
+    VkDeviceSize getBlockSize() const;
+    uint32_t getBlockCount() const;
+
+private:
+    struct Block
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        char* data = nullptr;
+    };
+
+    void addBlock();
+
+private:
+    const VulkanInstance* _vulkanInstance;
+    size_t _imageCount;
+    VkDeviceSize _alignment;
+
+    // [block][image]
+    std::vector<std::vector<Block>> _blocks;
+    uint32_t _imageIndex = 0;
+    uint32_t _currentBlock = 0;
+    VkDeviceSize _offset = 0;
+};
+
+} // namespace SVE
\ No newline at end of file
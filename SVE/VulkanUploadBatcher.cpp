@@ -0,0 +1,202 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanUploadBatcher.h"
+#include "VulkanInstance.h"
+#include "VulkanException.h"
+#include <cstring>
+
+namespace SVE
+{
+namespace
+{
+
+constexpr VkDeviceSize StagingRingSize = 32 * 1024 * 1024;
+// Enough for buffer copies and buffer to image copies of all used formats
+constexpr VkDeviceSize StagingAlignment = 16;
+
+} // anon namespace
+
+VulkanUploadBatcher::VulkanUploadBatcher(const VulkanInstance* instance)
+    : _vulkanInstance(instance)
+    , _device(instance->getLogicalDevice())
+{
+    void* stagingData = nullptr;
+    _vulkanInstance->getVulkanUtils().createBuffer(StagingRingSize,
+                                                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                   VMA_MEMORY_USAGE_CPU_ONLY,
+                                                   _stagingBuffer,
+                                                   _stagingAllocation,
+                                                   &stagingData);
+    _stagingData = static_cast<char*>(stagingData);
+
+    VkFenceCreateInfo fenceCreateInfo {};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(_device, &fenceCreateInfo, nullptr, &_fence) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create upload fence");
+    }
+}
+
+VulkanUploadBatcher::~VulkanUploadBatcher()
+{
+    flush();
+    vkDestroyFence(_device, _fence, nullptr);
+    vmaDestroyBuffer(_vulkanInstance->getAllocator(), _stagingBuffer, _stagingAllocation);
+}
+
+void VulkanUploadBatcher::beginBatch()
+{
+    ++_batchDepth;
+}
+
+void VulkanUploadBatcher::endBatch()
+{
+    assert(_batchDepth > 0);
+    if (--_batchDepth == 0)
+        flush();
+}
+
+bool VulkanUploadBatcher::isBatchActive() const
+{
+    return _batchDepth > 0;
+}
+
+VkCommandBuffer VulkanUploadBatcher::getCommandBuffer()
+{
+    assert(isBatchActive());
+    if (_commandBuffer == VK_NULL_HANDLE)
+    {
+        VkCommandBufferAllocateInfo allocInfo {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = _vulkanInstance->getCommandPool(0);
+        allocInfo.commandBufferCount = 1;
+        vkAllocateCommandBuffers(_device, &allocInfo, &_commandBuffer);
+
+        VkCommandBufferBeginInfo beginInfo {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(_commandBuffer, &beginInfo);
+    }
+
+    return _commandBuffer;
+}
+
+VulkanUploadBatcher::StagingRange VulkanUploadBatcher::allocateStaging(VkDeviceSize size)
+{
+    assert(isBatchActive());
+    if (size > StagingRingSize)
+    {
+        TemporaryBuffer temporaryBuffer;
+        void* data = nullptr;
+        _vulkanInstance->getVulkanUtils().createBuffer(size,
+                                                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                       VMA_MEMORY_USAGE_CPU_ONLY,
+                                                       temporaryBuffer.buffer,
+                                                       temporaryBuffer.allocation,
+                                                       &data);
+        _temporaryBuffers.push_back(temporaryBuffer);
+        return { temporaryBuffer.buffer, 0, static_cast<char*>(data) };
+    }
+
+    // Ring is full, previous copies are submitted to reuse it
+    if (_stagingOffset + size > StagingRingSize)
+        flush();
+
+    StagingRange range { _stagingBuffer, _stagingOffset, _stagingData + _stagingOffset };
+    _stagingOffset = (_stagingOffset + size + StagingAlignment - 1) / StagingAlignment * StagingAlignment;
+    return range;
+}
+
+void VulkanUploadBatcher::uploadBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset)
+{
+    // Frames are submitted to the same queue after upload, so standalone upload doesn't wait for fence
+    auto isStandalone = !isBatchActive();
+    beginBatch();
+
+    auto staging = allocateStaging(size);
+    memcpy(staging.data, data, static_cast<size_t>(size));
+
+    VkBufferCopy copyRegion {};
+    copyRegion.srcOffset = staging.offset;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size = size;
+    vkCmdCopyBuffer(getCommandBuffer(), staging.buffer, dstBuffer, 1, &copyRegion);
+
+    if (isStandalone)
+    {
+        --_batchDepth;
+        submit();
+    }
+    else
+    {
+        endBatch();
+    }
+}
+
+uint32_t VulkanUploadBatcher::getSubmitCount() const
+{
+    return _submitCount;
+}
+
+void VulkanUploadBatcher::flush()
+{
+    submit();
+    waitPendingSubmit();
+    // Standalone uploads don't rewind the ring, so it's rewound only when all copies are finished
+    _stagingOffset = 0;
+}
+
+void VulkanUploadBatcher::submit()
+{
+    if (_commandBuffer != VK_NULL_HANDLE)
+    {
+        // Fence is reused, so previous submit should be finished
+        waitPendingSubmit();
+
+        // Copies become visible to commands submitted later to the queue
+        VkMemoryBarrier memoryBarrier {};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                      VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(_commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                             0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+        vkEndCommandBuffer(_commandBuffer);
+
+        VkSubmitInfo submitInfo {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &_commandBuffer;
+        if (vkQueueSubmit(_vulkanInstance->getGraphicsQueue(), 1, &submitInfo, _fence) != VK_SUCCESS)
+        {
+            throw VulkanException("Can't submit upload commands");
+        }
+        ++_submitCount;
+
+        _pendingCommandBuffer = _commandBuffer;
+        _commandBuffer = VK_NULL_HANDLE;
+    }
+
+    _pendingTemporaryBuffers.insert(_pendingTemporaryBuffers.end(), _temporaryBuffers.begin(), _temporaryBuffers.end());
+    _temporaryBuffers.clear();
+}
+
+void VulkanUploadBatcher::waitPendingSubmit()
+{
+    if (_pendingCommandBuffer != VK_NULL_HANDLE)
+    {
+        // Only upload commands are waited, frames in flight continue rendering
+        vkWaitForFences(_device, 1, &_fence, VK_TRUE, UINT64_MAX);
+        vkResetFences(_device, 1, &_fence);
+        vkFreeCommandBuffers(_device, _vulkanInstance->getCommandPool(0), 1, &_pendingCommandBuffer);
+        _pendingCommandBuffer = VK_NULL_HANDLE;
+    }
+
+    for (auto& temporaryBuffer : _pendingTemporaryBuffers)
+        vmaDestroyBuffer(_vulkanInstance->getAllocator(), temporaryBuffer.buffer, temporaryBuffer.allocation);
+    _pendingTemporaryBuffers.clear();
+}
+
+} // namespace SVE
\ No newline at end of file
@@ -0,0 +1,77 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <vulkan/vk_mem_alloc.h>
+#include <vector>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Collects upload and other one time commands (see VulkanUtils::beginRecordingCommands) into one command buffer.
+// Batches can be nested, commands are submitted when outermost batch ends and the call returns after
+// fence is signaled. Data is copied through persistently mapped staging ring, which is rewound after that.
+// Buffer upload outside of batch (e.g. mesh update during game) is submitted without waiting,
+// its fence is waited only by next submit, ring isn't rewound until then.
+class VulkanUploadBatcher
+{
+public:
+    struct StagingRange
+    {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+        char* data;
+    };
+
+    explicit VulkanUploadBatcher(const VulkanInstance* instance);
+    ~VulkanUploadBatcher();
+
+    void beginBatch();
+    void endBatch();
+    bool isBatchActive() const;
+
+    // Command buffer of current batch, it's started on first use
+    VkCommandBuffer getCommandBuffer();
+
+    // Memory is valid until batch is submitted. Should be called inside batch and not between
+    // VulkanUtils::beginRecordingCommands and endRecordingAndSubmitCommands, full ring submits the batch.
+    StagingRange allocateStaging(VkDeviceSize size);
+    void uploadBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset = 0);
+
+    // Number of command buffers submitted since creation
+    uint32_t getSubmitCount() const;
+
+private:
+    void flush();
+    void submit();
+    void waitPendingSubmit();
+
+private:
+    const VulkanInstance* _vulkanInstance;
+    VkDevice _device;
+
+    VkBuffer _stagingBuffer = VK_NULL_HANDLE;
+    VmaAllocation _stagingAllocation = VK_NULL_HANDLE;
+    char* _stagingData = nullptr;
+    VkDeviceSize _stagingOffset = 0;
+
+    // Uploads bigger than staging ring get own buffers, freed after submit
+    struct TemporaryBuffer
+    {
+        VkBuffer buffer;
+        VmaAllocation allocation;
+    };
+    std::vector<TemporaryBuffer> _temporaryBuffers;
+
+    VkCommandBuffer _commandBuffer = VK_NULL_HANDLE;
+    VkFence _fence = VK_NULL_HANDLE;
+    // Submitted commands and their resources, which are released after fence is signaled
+    VkCommandBuffer _pendingCommandBuffer = VK_NULL_HANDLE;
+    std::vector<TemporaryBuffer> _pendingTemporaryBuffers;
+    uint32_t _batchDepth = 0;
+    uint32_t _submitCount = 0;
+};
+
+} // namespace SVE
\ No newline at end of file
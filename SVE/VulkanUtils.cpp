@@ -8,6 +8,7 @@
 #include "Engine.h"
 #include "VulkanUtils.h"
 #include "VulkanInstance.h"
+#include "VulkanUploadBatcher.h"
 #include "VulkanException.h"
 
 
@@ -30,7 +31,8 @@ void VulkanUtils::createBuffer(
         VkBufferUsageFlags usage,
         VmaMemoryUsage memoryUsage,
         VkBuffer& buffer,
-        VmaAllocation& allocation) const
+        VmaAllocation& allocation,
+        void** mappedData) const
 {
     // Create buffer
     VkBufferCreateInfo bufferInfo {};
@@ -42,15 +44,20 @@ void VulkanUtils::createBuffer(
 
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage = memoryUsage;
+    if (mappedData)
+        allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
-
-    if (vmaCreateBuffer(_vulkanInstance->getAllocator(), &bufferInfo, &allocInfo, &buffer, &allocation, nullptr))
+    VmaAllocationInfo allocationInfo = {};
+    if (vmaCreateBuffer(_vulkanInstance->getAllocator(), &bufferInfo, &allocInfo, &buffer, &allocation, &allocationInfo))
     {
         throw VulkanException("Can't create Vulkan buffer");
     }
+
+    if (mappedData)
+        *mappedData = allocationInfo.pMappedData;
 }
 
-void VulkanUtils::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) const
+void VulkanUtils::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset) const
 {
     // copying buffer is similar to graphical commands -
     // copy commands should be added to command buffer and submitted to queue
@@ -59,17 +66,18 @@ void VulkanUtils::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSiz
 
     VkBufferCopy copyRegion {};
     copyRegion.size = size;
+    copyRegion.dstOffset = dstOffset;
     vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion); // copy buffer command
 
     endRecordingAndSubmitCommands(commandBuffer);
 }
 
-void VulkanUtils::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) const
+void VulkanUtils::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkDeviceSize bufferOffset) const
 {
     auto commandBuffer = beginRecordingCommands();
 
     VkBufferImageCopy region {};
-    region.bufferOffset = 0;
+    region.bufferOffset = bufferOffset;
     region.bufferRowLength = 0;
     region.bufferImageHeight = 0;
     region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -91,21 +99,6 @@ void VulkanUtils::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t wid
 void VulkanUtils::createOptimizedBuffer(const void *bufferData, VkDeviceSize bufferSize, VkBuffer &buffer,
                                         VmaAllocation& allocation, VkBufferUsageFlags usage) const
 {
-    // create temporary slow CPU visible memory
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingBufferMemory;
-    createBuffer(bufferSize,
-                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VMA_MEMORY_USAGE_CPU_ONLY,
-                 stagingBuffer,
-                 stagingBufferMemory);
-
-    // Fill temporary buffer with vertex/index data
-    void* data;
-    vmaMapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory, &data);
-    memcpy(data, bufferData, (size_t) bufferSize);
-    vmaUnmapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory);
-
     // create fast GPU-local buffer for data
     createBuffer(bufferSize,
                  VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
@@ -113,11 +106,8 @@ void VulkanUtils::createOptimizedBuffer(const void *bufferData, VkDeviceSize buf
                  buffer,
                  allocation);
 
-    // copy slow CPU-visible buffer to fast GPU-local
-    copyBuffer(stagingBuffer, buffer, bufferSize);
-
-    // destroy CPU-visible buffer
-    vmaDestroyBuffer(_vulkanInstance->getAllocator(), stagingBuffer, stagingBufferMemory);
+    // copy data through CPU-visible staging memory to fast GPU-local
+    _vulkanInstance->getUploadBatcher()->uploadBuffer(bufferData, bufferSize, buffer);
 }
 
 void VulkanUtils::createImage(uint32_t width,
@@ -347,6 +337,10 @@ void VulkanUtils::generateMipmaps(
 
 VkCommandBuffer VulkanUtils::beginRecordingCommands() const
 {
+    auto* uploadBatcher = _vulkanInstance->getUploadBatcher();
+    if (uploadBatcher && uploadBatcher->isBatchActive())
+        return uploadBatcher->getCommandBuffer();
+
     // Allocate command buffer for copy command
     VkCommandBufferAllocateInfo allocInfo {};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -369,6 +363,11 @@ VkCommandBuffer VulkanUtils::beginRecordingCommands() const
 
 void VulkanUtils::endRecordingAndSubmitCommands(VkCommandBuffer commandBuffer) const
 {
+    // Batch command buffer is submitted when batch ends
+    auto* uploadBatcher = _vulkanInstance->getUploadBatcher();
+    if (uploadBatcher && uploadBatcher->isBatchActive())
+        return;
+
     // Finish recording
     vkEndCommandBuffer(commandBuffer);
 
@@ -29,9 +29,10 @@ public:
             VkBufferUsageFlags usage,
             VmaMemoryUsage memoryUsage,
             VkBuffer& buffer,
-            VmaAllocation& allocation) const;
-    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) const;
-    void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) const;
+            VmaAllocation& allocation,
+            void** mappedData = nullptr) const; // if set, buffer is persistently mapped
+    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset = 0) const;
+    void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, VkDeviceSize bufferOffset = 0) const;
 
     // This method will create fast GPU-local buffer (using transitional temporary CPU visible buffer)
     void createOptimizedBuffer(
@@ -76,6 +77,8 @@ public:
                          int32_t texHeight,
                          uint32_t mipLevels) const;
 
+    // If upload batch is open, commands are recorded to batch command buffer and submitted with it,
+    // otherwise they are submitted immediately and call waits for queue to finish
     VkCommandBuffer beginRecordingCommands() const;
     void endRecordingAndSubmitCommands(VkCommandBuffer commandBuffer) const;
 
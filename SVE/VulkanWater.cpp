@@ -63,7 +63,7 @@ VkImageView VulkanWater::getImageView(PassType passType)
     return _resolveImageView[static_cast<uint8_t>(passType)];
 }
 
-void VulkanWater::fillUniformData(UniformData& data, PassType passType)
+void VulkanWater::fillUniformData(PassUniformData& data, PassType passType)
 {
     auto camera = Engine::getInstance()->getSceneManager()->getMainCamera();
 
@@ -9,7 +9,7 @@ namespace SVE
 {
 class VulkanUtils;
 class VulkanInstance;
-struct UniformData;
+struct PassUniformData;
 
 class VulkanWater
 {
@@ -28,7 +28,7 @@ public:
     VkSampler getSampler(PassType passType);
     VkImageView getImageView(PassType passType);
 
-    void fillUniformData(UniformData& data, PassType passType);
+    void fillUniformData(PassUniformData& data, PassType passType);
 
     void reallocateCommandBuffers();
     void startRenderCommandBufferCreation(PassType passType);
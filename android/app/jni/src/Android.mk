@@ -16,10 +16,15 @@ LOCAL_CPP_FEATURES := exceptions
 LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     AndroidFS.h \
     AndroidFS.cpp \
+    SVE/BakedMesh.cpp \
+    SVE/BakedMesh.h \
+    SVE/BoundingBox.cpp \
+    SVE/BoundingBox.h \
     SVE/CameraNode.cpp \
     SVE/CameraNode.h \
     SVE/CameraSettings.cpp \
     SVE/CameraSettings.h \
+    SVE/CommandsType.h \
     SVE/ComputeEntity.cpp \
     SVE/ComputeEntity.h \
     SVE/ComputeSettings.cpp \
@@ -30,8 +35,16 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/EngineSettings.h \
     SVE/Entity.cpp \
     SVE/Entity.h \
+    SVE/FlatScene.cpp \
+    SVE/FlatScene.h \
     SVE/FontManager.cpp \
     SVE/FontManager.h \
+    SVE/FrameUniforms.cpp \
+    SVE/FrameUniforms.h \
+    SVE/Frustum.cpp \
+    SVE/Frustum.h \
+    SVE/KtxTexture.cpp \
+    SVE/KtxTexture.h \
     SVE/Libs.h \
     SVE/LightManager.cpp \
     SVE/LightManager.h \
@@ -40,6 +53,7 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/LightSettings.h \
     SVE/Material.cpp \
     SVE/Material.h \
+    SVE/MaterialInstance.h \
     SVE/MaterialManager.cpp \
     SVE/MaterialManager.h \
     SVE/MaterialSettings.cpp \
@@ -49,6 +63,8 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/MeshDefs.h \
     SVE/MeshEntity.cpp \
     SVE/MeshEntity.h \
+    SVE/MeshImporter.cpp \
+    SVE/MeshImporter.h \
     SVE/MeshManager.cpp \
     SVE/MeshManager.h \
     SVE/MeshSettings.cpp \
@@ -58,6 +74,10 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/OverlayManager.cpp \
     SVE/OverlayManager.h \
     SVE/OverlaySettings.h \
+    SVE/PackedArchive.cpp \
+    SVE/PackedArchive.h \
+    SVE/PackedFS.cpp \
+    SVE/PackedFS.h \
     SVE/ParticleSystemEntity.cpp \
     SVE/ParticleSystemEntity.h \
     SVE/ParticleSystemManager.cpp \
@@ -68,6 +88,11 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/PipelineCacheManager.h \
     SVE/PostEffectManager.cpp \
     SVE/PostEffectManager.h \
+    SVE/RecordingContext.h \
+    SVE/RenderQueue.cpp \
+    SVE/RenderQueue.h \
+    SVE/RenderSortKey.cpp \
+    SVE/RenderSortKey.h \
     SVE/ResourceManager.cpp \
     SVE/ResourceManager.h \
     SVE/SceneManager.cpp \
@@ -78,23 +103,40 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/ShaderInfo.h \
     SVE/ShaderManager.cpp \
     SVE/ShaderManager.h \
+    SVE/ShaderLoader.cpp \
+    SVE/ShaderLoader.h \
     SVE/ShaderSettings.cpp \
     SVE/ShaderSettings.h \
     SVE/ShadowMap.cpp \
     SVE/ShadowMap.h \
     SVE/Skybox.cpp \
     SVE/Skybox.h \
+    SVE/SlotMap.h \
     SVE/TextEntity.cpp \
     SVE/TextEntity.h \
     SVE/TextSettings.h \
+    SVE/TextureManager.cpp \
+    SVE/TextureManager.h \
+    SVE/ThreadPool.cpp \
+    SVE/ThreadPool.h \
+    SVE/UniformLayout.cpp \
+    SVE/UniformLayout.h \
     SVE/Utils.h \
+    SVE/VertexQuantization.cpp \
+    SVE/VertexQuantization.h \
+    SVE/VulkanBindCache.cpp \
+    SVE/VulkanBindCache.h \
     SVE/VulkanCommandsManager.h \
     SVE/VulkanComputeEntity.cpp \
     SVE/VulkanComputeEntity.h \
+    SVE/VulkanDescriptorAllocator.cpp \
+    SVE/VulkanDescriptorAllocator.h \
     SVE/VulkanDirectShadowMap.cpp \
     SVE/VulkanDirectShadowMap.h \
     SVE/VulkanException.cpp \
     SVE/VulkanException.h \
+    SVE/VulkanGeometryArena.cpp \
+    SVE/VulkanGeometryArena.h \
     SVE/VulkanInstance.cpp \
     SVE/VulkanInstance.h \
     SVE/VulkanMaterial.cpp \
@@ -115,6 +157,10 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/VulkanScreenQuad.h \
     SVE/VulkanShaderInfo.cpp \
     SVE/VulkanShaderInfo.h \
+    SVE/VulkanUniformRing.cpp \
+    SVE/VulkanUniformRing.h \
+    SVE/VulkanUploadBatcher.cpp \
+    SVE/VulkanUploadBatcher.h \
     SVE/VulkanUtils.cpp \
     SVE/VulkanUtils.h \
     SVE/VulkanWater.cpp \
@@ -180,6 +226,8 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     Game/Level/Enemies/Knight.h \
     Game/Level/Enemies/Nun.cpp \
     Game/Level/Enemies/Nun.h \
+    Game/Level/Enemies/PathMap.cpp \
+    Game/Level/Enemies/PathMap.h \
     Game/Level/Enemies/Projectile.cpp \
     Game/Level/Enemies/Projectile.h \
     Game/Level/Enemies/RandomWalkerAI.cpp \
@@ -85,6 +85,24 @@ FSEntityPtr AndroidFS::getEntity(const std::string& localPath, bool isDirectory)
     return std::make_shared<AndroidFSEntity>(localPath, isDirectory, _assetManager);
 }
 
+FileView AndroidFS::mapAsset(const std::string& path) const
+{
+    auto* asset = AAssetManager_open(_assetManager, path.c_str(), AASSET_MODE_BUFFER);
+    if (!asset)
+    {
+        throw VulkanException("Can't open asset " + path);
+    }
+
+    std::shared_ptr<AAsset> assetPtr(asset, AAsset_close);
+    auto* data = static_cast<const char*>(AAsset_getBuffer(asset));
+    if (!data)
+    {
+        throw VulkanException("Can't map asset " + path);
+    }
+
+    return FileView(std::shared_ptr<const char>(assetPtr, data), static_cast<size_t>(AAsset_getLength64(asset)));
+}
+
 std::string AndroidFS::getSavePath() const
 {
     char *path = SDL_GetPrefPath("TurbulentSoftware", "Chewman");
@@ -122,9 +140,14 @@ AndroidFSEntity::AndroidFSEntity(std::string path, bool isDir, AAssetManager* as
 AndroidFSEntity::~AndroidFSEntity()
 {
     if (!_isDirectory)
-        AAsset_close(Handle);
-    else
+    {
+        if (Handle)
+            AAsset_close(Handle);
+    }
+    else if (Dir)
+    {
         AAssetDir_close(Dir);
+    }
 
 }
 bool AndroidFSEntity::isDirectory() const
@@ -134,7 +157,7 @@ bool AndroidFSEntity::isDirectory() const
 
 bool AndroidFSEntity::exist() const
 {
-    return true;
+    return _isDirectory ? Dir != nullptr : Handle != nullptr;
 }
 
 std::string AndroidFSEntity::getPath() const
@@ -45,6 +45,9 @@ public:
 
     std::string getSavePath() const override;
 
+    // Asset buffer without copying, it's memory mapped if asset is stored uncompressed in APK
+    FileView mapAsset(const std::string& path) const;
+
 private:
     AAssetManager* _assetManager;
     mutable std::unordered_map<std::string, FSEntityPtr> _dirCache;
@@ -28,6 +28,7 @@
 #include "Game/Controls/ControlDocument.h"
 
 #include "AndroidFS.h"
+#include "SVE/PackedFS.h"
 
 #define SVE_ASSERT(message) assert(!message)
 
@@ -258,7 +259,15 @@ int SDL_main(int argc, char *argv[]) {
         auto androidFS = std::make_shared<SVE::AndroidFS>(getAssetManager());
         auto resolution = setResolution(*androidFS);
 
-        SVE::Engine *engine = SVE::Engine::createInstance(window, "resources/main.engine", androidFS, resolution);
+        // Packed archive (see tools/AssetPacker.cpp) replaces resources folder if it's present
+        std::shared_ptr<SVE::FileSystem> fileSystem = androidFS;
+        if (androidFS->getEntity("resources.pack")->exist())
+        {
+            std::cout << "Using packed resources." << std::endl;
+            fileSystem = std::make_shared<SVE::PackedFS>(androidFS->mapAsset("resources.pack"), androidFS);
+        }
+
+        SVE::Engine *engine = SVE::Engine::createInstance(window, "resources/main.engine", fileSystem, resolution);
         engine->setIsFirstRun(firstRun);
         auto& graphicsManager = Chewman::GraphicsManager::getInstance();
         std::cout << "Render window size by SDL: " << engine->getRenderWindowSize().x << " " << engine->getRenderWindowSize().y << std::endl;
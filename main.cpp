@@ -13,11 +13,14 @@
 #include "Game/Controls/ControlDocument.h"
 #include "Game/Level/GameUtils.h"
 #include "DesktopFS.h"
+#include "SVE/PackedFS.h"
 
 #include <SDL2/SDL.h>
 #include "VulkanHeaders.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
+#include <chrono>
+#include <functional>
 
 // Thanks to:
 // Karl "ThinMatrix" for his video blogs on OpenGL techniques
@@ -68,7 +71,16 @@ int runGame()
         return 1;
     }
 
-    SVE::Engine* engine = SVE::Engine::createInstance(window, "resources/main.engine", std::make_shared<SVE::DesktopFS>());
+    // Packed archive (see tools/AssetPacker.cpp) replaces resources folder if it's present
+    auto desktopFS = std::make_shared<SVE::DesktopFS>();
+    std::shared_ptr<SVE::FileSystem> fileSystem = desktopFS;
+    if (desktopFS->getEntity("resources.pack")->exist())
+    {
+        std::cout << "Using packed resources." << std::endl;
+        fileSystem = std::make_shared<SVE::PackedFS>(SVE::DesktopFS::mapFile("resources.pack"), desktopFS);
+    }
+
+    SVE::Engine* engine = SVE::Engine::createInstance(window, "resources/main.engine", fileSystem);
     {
         auto windowSize = engine->getRenderWindowSize();
         auto camera = engine->getSceneManager()->createMainCamera();
@@ -84,19 +96,37 @@ int runGame()
         }
         engine->renderFrame(0.0f);
 
+        // Loading screen is redrawn with folder progress mapped to its part of progress bar
+        auto progressControl = loadingScreen->getControlByName("progress");
+        auto progressSize = loadingScreen->getControlByName("progressAll")->getSize();
+        auto updateProgress = [&](float percent)
+        {
+            progressControl->setSize({progressSize.x * percent, progressSize.y});
+            engine->renderFrame();
+        };
+        auto updateProgressBetween = [&](float start, float end, float percent)
+        {
+            updateProgress(start + (end-start)*percent);
+        };
+
         // load resources
+        // Cold start time for different thread counts is measured by setting "loadingThreads" in main.engine
+        auto loadingStartTime = std::chrono::high_resolution_clock::now();
         engine->getPipelineCacheManager()->load();
 #ifdef FLATTEN_FS
-        engine->getResourceManager()->loadFolder("resflat");
+        engine->getResourceManager()->loadFolder("resflat", updateProgress);
 #else
-        engine->getResourceManager()->loadFolder("resources/shaders");
-        engine->getResourceManager()->loadFolder("resources/materials");
-        engine->getResourceManager()->loadFolder("resources/materials/skins");
-        engine->getResourceManager()->loadFolder("resources/models");
-        engine->getResourceManager()->loadFolder("resources/fonts");
-        engine->getResourceManager()->loadFolder("resources");
+        using namespace std::placeholders;
+        updateProgress(0.0f);
+        engine->getResourceManager()->loadFolder("resources/shaders", std::bind(updateProgressBetween, 0.0f, 0.1f, _1));
+        engine->getResourceManager()->loadFolder("resources/materials", std::bind(updateProgressBetween, 0.1f, 0.45f, _1));
+        engine->getResourceManager()->loadFolder("resources/materials/skins", std::bind(updateProgressBetween, 0.45f, 0.55f, _1));
+        engine->getResourceManager()->loadFolder("resources/models", std::bind(updateProgressBetween, 0.55f, 0.85f, _1));
+        engine->getResourceManager()->loadFolder("resources/fonts", std::bind(updateProgressBetween, 0.85f, 0.9f, _1));
+        engine->getResourceManager()->loadFolder("resources", std::bind(updateProgressBetween, 0.9f, 1.0f, _1));
 #endif
-        std::cout << "Resources loading finished." << std::endl;
+        auto loadingDuration = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - loadingStartTime).count();
+        std::cout << "Resources loading finished in " << loadingDuration << " ms." << std::endl;
         loadingScreen->hide();
 
         // Create game controller
@@ -0,0 +1,157 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Baked mesh round trip and rejection of truncated or inconsistent data.
+#include "SVE/BakedMesh.h"
+#include "SVE/VulkanException.h"
+#include "tests/TestUtils.h"
+#include <cstring>
+#include <functional>
+
+using namespace SVE;
+
+namespace
+{
+
+// Quad with two bones animated by one animation
+MeshSettings createMesh()
+{
+    MeshSettings meshSettings {};
+    meshSettings.materialName = "material";
+    meshSettings.vertexPosData = { {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0} };
+    meshSettings.vertexTexData = { {0, 0}, {1, 0}, {1, 1}, {0, 1} };
+    meshSettings.indexData = { 0, 1, 2, 2, 3, 0 };
+    meshSettings.boneNum = 2;
+    meshSettings.vertexBoneIndexData.assign(4, {0, 1, 0, 0});
+    meshSettings.vertexBoneWeightData.assign(4, {0.5f, 0.5f, 0, 0});
+
+    meshSettings.animation = std::make_shared<AnimationSettings>();
+    auto& animation = *meshSettings.animation;
+    animation.boneOffset.resize(2);
+    animation.nodes.resize(3);
+    animation.nodes[0].name = "root";
+    animation.nodes[1].name = "bone0";
+    animation.nodes[1].parent = 0;
+    animation.nodes[1].boneIndex = 0;
+    animation.nodes[2].name = "bone1";
+    animation.nodes[2].parent = 1;
+    animation.nodes[2].boneIndex = 1;
+    animation.nodes[2].attachmentBoneIndex = 0;
+
+    animation.animations.resize(1);
+    auto& skeletonAnimation = animation.animations[0];
+    skeletonAnimation.duration = 10.0;
+    skeletonAnimation.nodeChannels = { -1, 0, 1 };
+    skeletonAnimation.channels.resize(2);
+    for (auto& channel : skeletonAnimation.channels)
+    {
+        channel.positionKeys.resize(2);
+        channel.rotationKeys.resize(1);
+        channel.scalingKeys.resize(1);
+    }
+    return meshSettings;
+}
+
+bool isRejected(const std::string& data)
+{
+    try
+    {
+        loadBakedMesh(FileView(data));
+    }
+    catch (const VulkanException&)
+    {
+        return true;
+    }
+    return false;
+}
+
+bool isRejected(const std::function<void(MeshSettings&)>& corrupt)
+{
+    auto meshSettings = createMesh();
+    corrupt(meshSettings);
+    return isRejected(bakeMesh(meshSettings));
+}
+
+void testRoundTrip()
+{
+    auto source = createMesh();
+    auto data = bakeMesh(source);
+    TEST_CHECK(isBakedMesh(FileView(data)));
+
+    auto meshSettings = loadBakedMesh(FileView(data));
+    TEST_CHECK(meshSettings.materialName == source.materialName);
+    TEST_CHECK(meshSettings.vertexPosData.size() == source.vertexPosData.size());
+    TEST_CHECK(meshSettings.vertexTexData.size() == source.vertexTexData.size());
+    TEST_CHECK(meshSettings.indexData == source.indexData);
+    TEST_CHECK(meshSettings.boneNum == source.boneNum);
+    TEST_CHECK(meshSettings.vertexBoneIndexData.size() == source.vertexBoneIndexData.size());
+    if (!TEST_CHECK(meshSettings.animation != nullptr))
+        return;
+
+    const auto& animation = *meshSettings.animation;
+    TEST_CHECK(animation.boneOffset.size() == 2);
+    if (TEST_CHECK(animation.nodes.size() == 3))
+    {
+        TEST_CHECK(animation.nodes[2].name == "bone1");
+        TEST_CHECK(animation.nodes[2].parent == 1);
+        TEST_CHECK(animation.nodes[2].boneIndex == 1);
+        TEST_CHECK(animation.nodes[2].attachmentBoneIndex == 0);
+    }
+    if (TEST_CHECK(animation.animations.size() == 1))
+    {
+        TEST_CHECK(animation.animations[0].duration == 10.0);
+        TEST_CHECK(animation.animations[0].nodeChannels == source.animation->animations[0].nodeChannels);
+        TEST_CHECK(animation.animations[0].channels.size() == 2);
+        TEST_CHECK(animation.animations[0].channels[1].positionKeys.size() == 2);
+    }
+}
+
+void testTruncatedData()
+{
+    auto data = bakeMesh(createMesh());
+    auto rejectedCount = 0u;
+    for (auto size = 0u; size < data.size(); size++)
+        rejectedCount += isRejected(data.substr(0, size)) ? 1 : 0;
+    TEST_CHECK(rejectedCount == data.size());
+}
+
+void testHugeCount()
+{
+    auto meshSettings = createMesh();
+    meshSettings.materialName.clear();
+    auto data = bakeMesh(meshSettings);
+
+    // Vertex positions count follows header and empty material name, it's checked before allocation
+    size_t countOffset = 6 * sizeof(uint32_t) + sizeof(uint32_t);
+    uint32_t count = 0xFFFFFFF0u;
+    memcpy(&data[countOffset], &count, sizeof(count));
+    TEST_CHECK(isRejected(data));
+}
+
+void testInconsistentData()
+{
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.indexData[4] = 4; }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->nodes[1].parent = 1; }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->nodes[1].parent = 2; }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->nodes[1].parent = -2; }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->nodes[2].boneIndex = 2; }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->nodes[2].attachmentBoneIndex = 2; }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->animations[0].nodeChannels.pop_back(); }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->animations[0].nodeChannels[0] = 2; }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->animations[0].channels[0].positionKeys.clear(); }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->animations[0].channels[1].rotationKeys.clear(); }));
+    TEST_CHECK(isRejected([](MeshSettings& meshSettings) { meshSettings.animation->animations[0].channels[1].scalingKeys.clear(); }));
+}
+
+} // anon namespace
+
+int main()
+{
+    testRoundTrip();
+    testTruncatedData();
+    testHugeCount();
+    testInconsistentData();
+
+    return Test::getResult();
+}
\ No newline at end of file
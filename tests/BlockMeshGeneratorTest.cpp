@@ -0,0 +1,437 @@
+// Chewman Vulkan game
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Welded and greedy-merged level geometry must cover the same triangles as separate 6-vertex quads per cell.
+#include "Game/Level/BlockMeshGenerator.h"
+#include "tests/TestUtils.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <random>
+
+using namespace Chewman;
+
+namespace
+{
+
+constexpr float CellSize = 3.0f;
+constexpr float Epsilon = 1e-4f;
+
+// Position, texture coordinate, normal, binormal, tangent and color
+using VertexData = std::array<float, 17>;
+using Triangle = std::array<VertexData, 3>;
+
+VertexData makeVertex(glm::vec3 point, glm::vec2 texCoord, glm::vec3 normal, glm::vec3 binormal, glm::vec3 tangent,
+                      glm::vec3 color)
+{
+    return { point.x, point.y, point.z, texCoord.x, texCoord.y, normal.x, normal.y, normal.z,
+             binormal.x, binormal.y, binormal.z, tangent.x, tangent.y, tangent.z, color.x, color.y, color.z };
+}
+
+// Old generator output: every quad is expanded to 6 separate vertices
+std::vector<Triangle> getSeparateTriangles(const std::vector<Submesh>& submeshes)
+{
+    std::vector<Triangle> triangles;
+    for (const auto& submesh : submeshes)
+    {
+        for (size_t i = 0; i + 2 < submesh.indices.size(); i += 3)
+        {
+            Triangle triangle;
+            for (auto j = 0; j < 3; ++j)
+            {
+                auto index = submesh.indices[i + j];
+                triangle[j] = makeVertex(submesh.points[index], submesh.texCoords[index], submesh.normals[index],
+                                         submesh.binormals[index], submesh.tangents[index], submesh.colors[index]);
+            }
+            triangles.push_back(triangle);
+        }
+    }
+    return triangles;
+}
+
+std::vector<Triangle> getIndexedTriangles(const SVE::MeshSettings& meshSettings)
+{
+    std::vector<Triangle> triangles;
+    for (size_t i = 0; i + 2 < meshSettings.indexData.size(); i += 3)
+    {
+        Triangle triangle;
+        for (auto j = 0; j < 3; ++j)
+        {
+            auto index = meshSettings.indexData[i + j];
+            triangle[j] = makeVertex(meshSettings.vertexPosData[index], meshSettings.vertexTexData[index],
+                                     meshSettings.vertexNormalData[index], meshSettings.vertexBinormalData[index],
+                                     meshSettings.vertexTangentData[index], meshSettings.vertexColorData[index]);
+        }
+        triangles.push_back(triangle);
+    }
+    return triangles;
+}
+
+bool hasValidIndices(const SVE::MeshSettings& meshSettings)
+{
+    auto vertexCount = meshSettings.vertexPosData.size();
+    return meshSettings.indexData.size() % 3 == 0 &&
+           std::all_of(meshSettings.indexData.begin(), meshSettings.indexData.end(),
+                       [vertexCount](uint32_t index) { return index < vertexCount; });
+}
+
+glm::vec3 getPosition(size_t x, size_t y)
+{
+    return glm::vec3(y * CellSize, 0, -(float)x * CellSize);
+}
+
+// Signed doubled area of triangle projected to XZ plane
+float getArea(const Triangle& triangle)
+{
+    return (triangle[1][0] - triangle[0][0]) * (triangle[2][2] - triangle[0][2]) -
+           (triangle[2][0] - triangle[0][0]) * (triangle[1][2] - triangle[0][2]);
+}
+
+// Barycentric coordinates of point in XZ plane, false if point is outside
+bool getBarycentric(const Triangle& triangle, float x, float z, std::array<float, 3>& weights)
+{
+    auto area = getArea(triangle);
+    if (std::abs(area) < Epsilon)
+        return false;
+    for (auto i = 0; i < 3; ++i)
+    {
+        const auto& a = triangle[(i + 1) % 3];
+        const auto& b = triangle[(i + 2) % 3];
+        weights[i] = ((b[0] - a[0]) * (z - a[2]) - (x - a[0]) * (b[2] - a[2])) / area;
+        if (weights[i] < -Epsilon)
+            return false;
+    }
+    return true;
+}
+
+float interpolate(const Triangle& triangle, const std::array<float, 3>& weights, size_t component)
+{
+    return triangle[0][component] * weights[0] + triangle[1][component] * weights[1] +
+           triangle[2][component] * weights[2];
+}
+
+bool isSameFraction(float a, float b)
+{
+    auto difference = std::abs((a - std::floor(a)) - (b - std::floor(b)));
+    return difference < Epsilon || difference > 1.0f - Epsilon;
+}
+
+// Every sample of old triangle is found in merged geometry with the same height, texture and tangent space
+bool isCoveredBy(const Triangle& triangle, const std::vector<Triangle>& merged)
+{
+    const float samples[][3] = {
+            { 1.0f / 3, 1.0f / 3, 1.0f / 3 },
+            { 0.8f, 0.1f, 0.1f },
+            { 0.1f, 0.8f, 0.1f },
+            { 0.1f, 0.1f, 0.8f }
+    };
+    for (const auto& sample : samples)
+    {
+        std::array<float, 3> weights = { sample[0], sample[1], sample[2] };
+        auto x = interpolate(triangle, weights, 0);
+        auto z = interpolate(triangle, weights, 2);
+
+        auto found = std::find_if(merged.begin(), merged.end(), [&](const Triangle& other)
+        {
+            std::array<float, 3> otherWeights;
+            if (!getBarycentric(other, x, z, otherWeights))
+                return false;
+            if ((getArea(other) > 0) != (getArea(triangle) > 0))
+                return false;
+            if (std::abs(interpolate(other, otherWeights, 1) - interpolate(triangle, weights, 1)) > Epsilon)
+                return false;
+            for (size_t component = 3; component < 5; ++component)
+            {
+                if (!isSameFraction(interpolate(other, otherWeights, component),
+                                    interpolate(triangle, weights, component)))
+                    return false;
+            }
+            return std::equal(other[0].begin() + 5, other[0].end(), triangle[0].begin() + 5);
+        });
+        if (found == merged.end())
+            return false;
+    }
+    return true;
+}
+
+float getTotalArea(const std::vector<Triangle>& triangles)
+{
+    float area = 0.0f;
+    for (const auto& triangle : triangles)
+        area += std::abs(getArea(triangle));
+    return area;
+}
+
+std::vector<HorizontalPlane> createRandomPlanes(std::mt19937& random, size_t width, size_t height)
+{
+    // Cells often repeat previous one, so there are long runs to merge
+    std::vector<HorizontalPlane> planes(width * height);
+    for (size_t i = 0; i < planes.size(); ++i)
+    {
+        if (i > 0 && random() % 3 != 0)
+            planes[i] = planes[i - 1];
+        else
+            planes[i] = static_cast<HorizontalPlane>(random() % 3);
+    }
+    return planes;
+}
+
+void testMergedPlanesCoverCells()
+{
+    std::mt19937 random(5);
+    BlockMeshGenerator meshGenerator(CellSize);
+    for (auto iteration = 0; iteration < 100; ++iteration)
+    {
+        size_t width = 1 + random() % 12;
+        size_t height = 1 + random() % 12;
+        auto planes = createRandomPlanes(random, width, height);
+        auto rects = meshGenerator.MergePlanes(planes, width);
+
+        std::vector<int> coverCount(planes.size(), 0);
+        for (const auto& rect : rects)
+        {
+            TEST_CHECK(rect.plane != HorizontalPlane::None);
+            TEST_CHECK(rect.rows > 0 && rect.columns > 0);
+            TEST_CHECK(rect.row + rect.rows <= height && rect.column + rect.columns <= width);
+            for (auto x = rect.row; x < rect.row + rect.rows && x < height; ++x)
+            {
+                for (auto y = rect.column; y < rect.column + rect.columns && y < width; ++y)
+                {
+                    ++coverCount[x * width + y];
+                    TEST_CHECK(planes[x * width + y] == rect.plane);
+                }
+            }
+        }
+        for (size_t i = 0; i < planes.size(); ++i)
+            TEST_CHECK(coverCount[i] == (planes[i] == HorizontalPlane::None ? 0 : 1));
+    }
+}
+
+void testMergedPlanesGeometry()
+{
+    std::mt19937 random(13);
+    BlockMeshGenerator meshGenerator(CellSize);
+    for (auto iteration = 0; iteration < 40; ++iteration)
+    {
+        size_t width = 1 + random() % 10;
+        size_t height = 1 + random() % 10;
+        size_t startX = random() % 20;
+        size_t startY = random() % 20;
+        auto planes = createRandomPlanes(random, width, height);
+
+        for (auto plane : { HorizontalPlane::WallTop, HorizontalPlane::Floor })
+        {
+            std::vector<Submesh> cellMeshes;
+            for (size_t x = 0; x < height; ++x)
+            {
+                for (size_t y = 0; y < width; ++y)
+                {
+                    if (planes[x * width + y] != plane)
+                        continue;
+                    auto position = getPosition(startX + x, startY + y);
+                    auto cell = plane == HorizontalPlane::WallTop ? meshGenerator.GenerateWall(position, Top)
+                                                                  : meshGenerator.GenerateFloor(position, Bottom);
+                    cellMeshes.insert(cellMeshes.end(), cell.begin(), cell.end());
+                }
+            }
+
+            std::vector<Submesh> mergedMeshes;
+            for (const auto& rect : meshGenerator.MergePlanes(planes, width))
+            {
+                if (rect.plane != plane)
+                    continue;
+                auto merged = meshGenerator.GenerateHorizontalPlane(
+                        getPosition(startX + rect.row, startY + rect.column), rect);
+                mergedMeshes.insert(mergedMeshes.end(), merged.begin(), merged.end());
+            }
+
+            auto meshSettings = meshGenerator.CombineMeshes("Merged", mergedMeshes);
+            TEST_CHECK(hasValidIndices(meshSettings));
+            TEST_CHECK(meshSettings.vertexPosData.size() <= cellMeshes.size() * 4);
+
+            auto cellTriangles = getSeparateTriangles(cellMeshes);
+            auto mergedTriangles = getIndexedTriangles(meshSettings);
+            TEST_CHECK(mergedTriangles.size() <= cellTriangles.size());
+            auto cellArea = getTotalArea(cellTriangles);
+            TEST_CHECK(std::abs(cellArea - getTotalArea(mergedTriangles)) <= Epsilon * cellArea);
+            for (const auto& triangle : cellTriangles)
+                TEST_CHECK(isCoveredBy(triangle, mergedTriangles));
+        }
+    }
+}
+
+void testWeldedVerticalFaces()
+{
+    // Welding keeps exactly the same triangles, only shared vertices are removed
+    std::mt19937 random(17);
+    BlockMeshGenerator meshGenerator(CellSize);
+    for (auto iteration = 0; iteration < 40; ++iteration)
+    {
+        int width = 1 + random() % 10;
+        int height = 1 + random() % 10;
+        std::vector<Submesh> submeshes;
+        for (auto x = 0; x < height; ++x)
+        {
+            for (auto y = 0; y < width; ++y)
+            {
+                auto position = getPosition(x, y);
+                std::vector<Submesh> cell;
+                switch (random() % 3)
+                {
+                    case 0:
+                        cell = meshGenerator.GenerateWall(position, Vertical);
+                        break;
+                    case 1:
+                        cell = meshGenerator.GenerateFloor(position, Vertical);
+                        break;
+                    default:
+                        cell = meshGenerator.GenerateLiquid(position, Vertical, x, y, height - 1, width - 1);
+                        break;
+                }
+                submeshes.insert(submeshes.end(), cell.begin(), cell.end());
+            }
+        }
+
+        auto meshSettings = meshGenerator.CombineMeshes("Welded", submeshes);
+        TEST_CHECK(hasValidIndices(meshSettings));
+        TEST_CHECK(meshSettings.vertexPosData.size() <= submeshes.size() * 4);
+        TEST_CHECK(meshSettings.indexData.size() == submeshes.size() * 6);
+
+        auto separateTriangles = getSeparateTriangles(submeshes);
+        auto weldedTriangles = getIndexedTriangles(meshSettings);
+        std::sort(separateTriangles.begin(), separateTriangles.end());
+        std::sort(weldedTriangles.begin(), weldedTriangles.end());
+        TEST_CHECK(separateTriangles == weldedTriangles);
+    }
+}
+
+CellInfoMap createRandomMap(std::mt19937& random, size_t width, size_t height)
+{
+    CellInfoMap mapData(height, std::vector<CellInfo>(width));
+    auto cellType = CellType::Wall;
+    for (auto& row : mapData)
+    {
+        for (auto& cell : row)
+        {
+            if (random() % 3 == 0)
+                cellType = static_cast<CellType>(random() % 4);
+            cell.cellType = cellType;
+        }
+    }
+    return mapData;
+}
+
+using PointKey = std::array<long, 3>;
+
+PointKey getPointKey(const VertexData& vertex)
+{
+    return { std::lround(vertex[0] / Epsilon), std::lround(vertex[1] / Epsilon), std::lround(vertex[2] / Epsilon) };
+}
+
+// Point lies on segment between its ends
+bool isInsideEdge(const VertexData& point, const VertexData& start, const VertexData& end)
+{
+    float edgeLength = 0.0f;
+    float startDistance = 0.0f;
+    float endDistance = 0.0f;
+    for (auto i = 0; i < 3; ++i)
+    {
+        edgeLength += (end[i] - start[i]) * (end[i] - start[i]);
+        startDistance += (point[i] - start[i]) * (point[i] - start[i]);
+        endDistance += (point[i] - end[i]) * (point[i] - end[i]);
+    }
+    edgeLength = std::sqrt(edgeLength);
+    startDistance = std::sqrt(startDistance);
+    endDistance = std::sqrt(endDistance);
+    return startDistance > Epsilon && endDistance > Epsilon && startDistance + endDistance - edgeLength < Epsilon;
+}
+
+// Outer edges of merged planes can't have vertices of any level face inside them (T-junctions),
+// they give pixel cracks between plane and wall faces. Inner edges are shared by two triangles of plane.
+void testWatertightPlanes()
+{
+    std::mt19937 random(23);
+    BlockMeshGenerator meshGenerator(CellSize);
+    for (auto iteration = 0; iteration < 20; ++iteration)
+    {
+        size_t width = 1 + random() % 20;
+        size_t height = 1 + random() % 20;
+        auto mapData = createRandomMap(random, width, height);
+        auto chunkColumns = (width + MapChunkSize - 1) / MapChunkSize;
+        auto chunkCount = (height + MapChunkSize - 1) / MapChunkSize * chunkColumns;
+
+        std::vector<Triangle> planeTriangles;
+        std::vector<Triangle> triangles;
+        for (size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+        {
+            auto submeshes = meshGenerator.GenerateChunk(mapData, width, height, chunkColumns, chunkIndex);
+            for (auto i = 0; i < 3; ++i)
+            {
+                auto chunkTriangles = getSeparateTriangles(submeshes[i]);
+                if (i < 2)
+                    planeTriangles.insert(planeTriangles.end(), chunkTriangles.begin(), chunkTriangles.end());
+                triangles.insert(triangles.end(), chunkTriangles.begin(), chunkTriangles.end());
+            }
+        }
+
+        std::map<std::pair<PointKey, PointKey>, std::pair<VertexData, VertexData>> outerEdges;
+        for (const auto& triangle : planeTriangles)
+        {
+            for (auto i = 0; i < 3; ++i)
+            {
+                const auto& start = triangle[i];
+                const auto& end = triangle[(i + 1) % 3];
+                auto startKey = getPointKey(start);
+                auto endKey = getPointKey(end);
+                auto key = std::make_pair(std::min(startKey, endKey), std::max(startKey, endKey));
+                auto edgeIt = outerEdges.find(key);
+                if (edgeIt != outerEdges.end())
+                    outerEdges.erase(edgeIt);
+                else
+                    outerEdges.emplace(key, std::make_pair(start, end));
+            }
+        }
+
+        std::map<PointKey, VertexData> points;
+        for (const auto& triangle : triangles)
+        {
+            for (const auto& vertex : triangle)
+                points.emplace(getPointKey(vertex), vertex);
+        }
+
+        size_t junctionCount = 0;
+        for (const auto& edge : outerEdges)
+        {
+            for (const auto& point : points)
+                junctionCount += isInsideEdge(point.second, edge.second.first, edge.second.second) ? 1 : 0;
+        }
+        TEST_CHECK(junctionCount == 0);
+    }
+}
+
+void testWeldedDuplicates()
+{
+    BlockMeshGenerator meshGenerator(CellSize);
+    auto cell = meshGenerator.GenerateFloor(getPosition(0, 0), Bottom);
+    cell.push_back(cell.front());
+
+    auto meshSettings = meshGenerator.CombineMeshes("Duplicates", cell);
+    TEST_CHECK(meshSettings.vertexPosData.size() == 4);
+    TEST_CHECK(meshSettings.indexData.size() == 12);
+    TEST_CHECK(std::equal(meshSettings.indexData.begin(), meshSettings.indexData.begin() + 6,
+                          meshSettings.indexData.begin() + 6));
+}
+
+} // anon namespace
+
+int main()
+{
+    testMergedPlanesCoverCells();
+    testMergedPlanesGeometry();
+    testWeldedVerticalFaces();
+    testWatertightPlanes();
+    testWeldedDuplicates();
+    return Test::getResult();
+}
\ No newline at end of file
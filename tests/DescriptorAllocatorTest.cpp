@@ -0,0 +1,185 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Descriptor allocator under entity spawn/destroy churn, Vulkan pool functions are replaced by counting fakes.
+#include "SVE/VulkanDescriptorAllocator.h"
+#include "tests/TestUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <random>
+
+namespace
+{
+
+struct FakePool
+{
+    uint32_t maxSets;
+    uint32_t allocatedSets;
+};
+
+std::map<uint64_t, FakePool> fakePools;
+uint64_t lastHandle = 0;
+size_t createdPoolCount = 0;
+size_t allocatedSetCount = 0;
+
+// Non-dispatchable handles are pointers or uint64_t depending on platform
+template <typename Handle>
+Handle makeHandle(uint64_t value)
+{
+    Handle handle {};
+    memcpy(&handle, &value, sizeof(Handle));
+    return handle;
+}
+
+template <typename Handle>
+uint64_t getHandleValue(Handle handle)
+{
+    uint64_t value = 0;
+    memcpy(&value, &handle, sizeof(Handle));
+    return value;
+}
+
+} // anon namespace
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDescriptorPool(VkDevice, const VkDescriptorPoolCreateInfo* createInfo,
+                                                      const VkAllocationCallbacks*, VkDescriptorPool* descriptorPool)
+{
+    *descriptorPool = makeHandle<VkDescriptorPool>(++lastHandle);
+    fakePools[lastHandle] = { createInfo->maxSets, 0 };
+    ++createdPoolCount;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyDescriptorPool(VkDevice, VkDescriptorPool descriptorPool, const VkAllocationCallbacks*)
+{
+    fakePools.erase(getHandleValue(descriptorPool));
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateDescriptorSets(VkDevice, const VkDescriptorSetAllocateInfo* allocateInfo,
+                                                        VkDescriptorSet* descriptorSets)
+{
+    auto& pool = fakePools.at(getHandleValue(allocateInfo->descriptorPool));
+    if (pool.allocatedSets + allocateInfo->descriptorSetCount > pool.maxSets)
+        return VK_ERROR_OUT_OF_POOL_MEMORY;
+
+    pool.allocatedSets += allocateInfo->descriptorSetCount;
+    for (auto i = 0u; i < allocateInfo->descriptorSetCount; i++)
+        descriptorSets[i] = makeHandle<VkDescriptorSet>(++lastHandle);
+    allocatedSetCount += allocateInfo->descriptorSetCount;
+    return VK_SUCCESS;
+}
+
+using namespace SVE;
+
+namespace
+{
+
+constexpr uint32_t SwapchainSize = 3;
+// Sets per entity, one for every swapchain image
+constexpr uint32_t EntitySetCount = SwapchainSize;
+
+struct Entity
+{
+    VkDescriptorSet descriptorSets[EntitySetCount];
+};
+
+void testSpawnDestroyStress()
+{
+    // 100k particle systems spawned and destroyed while at most 200 are alive
+    constexpr size_t SpawnCount = 100000;
+    constexpr size_t MaxLiveCount = 200;
+    constexpr size_t SpawnsPerFrame = 20;
+
+    std::mt19937 random(9);
+    const auto layout = makeHandle<VkDescriptorSetLayout>(1000000000);
+    const std::vector<VkDescriptorPoolSize> setSizes = {
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2 }
+    };
+
+    {
+        VulkanDescriptorAllocator allocator(makeHandle<VkDevice>(1), SwapchainSize);
+        std::vector<Entity> liveEntities;
+        // Sets freed during last frames can't be reused until their image is rendered again
+        std::vector<size_t> freedPerImage(SwapchainSize, 0);
+        size_t peakUsedSetCount = 0;
+        size_t poolCountAfterWarmup = 0;
+
+        size_t spawned = 0;
+        for (uint32_t frame = 0; spawned < SpawnCount; ++frame)
+        {
+            auto imageIndex = frame % SwapchainSize;
+            allocator.startFrame(imageIndex);
+            freedPerImage[imageIndex] = 0;
+
+            for (size_t i = 0; i < SpawnsPerFrame; ++i, ++spawned)
+            {
+                if (liveEntities.size() == MaxLiveCount || (!liveEntities.empty() && random() % 2 == 0))
+                {
+                    auto position = random() % liveEntities.size();
+                    allocator.free(layout, EntitySetCount, liveEntities[position].descriptorSets);
+                    liveEntities[position] = liveEntities.back();
+                    liveEntities.pop_back();
+                    freedPerImage[imageIndex] += EntitySetCount;
+                }
+
+                Entity entity {};
+                allocator.allocate(layout, setSizes, EntitySetCount, entity.descriptorSets);
+                liveEntities.push_back(entity);
+            }
+
+            size_t usedSetCount = liveEntities.size() * EntitySetCount;
+            for (auto freedCount : freedPerImage)
+                usedSetCount += freedCount;
+            peakUsedSetCount = std::max(peakUsedSetCount, usedSetCount);
+            if (spawned == SpawnCount / 10)
+                poolCountAfterWarmup = fakePools.size();
+        }
+
+        // Vulkan sets are allocated only when no freed set can be reused
+        TEST_CHECK(allocatedSetCount <= peakUsedSetCount);
+        TEST_CHECK(fakePools.size() == poolCountAfterWarmup);
+        TEST_CHECK(fakePools.size() == createdPoolCount);
+        TEST_CHECK(fakePools.size() < 10);
+
+        allocator.releaseLayout(layout);
+        TEST_CHECK(fakePools.empty());
+    }
+}
+
+void testDestroyReleasesPools()
+{
+    const auto layout = makeHandle<VkDescriptorSetLayout>(2000000000);
+    const std::vector<VkDescriptorPoolSize> setSizes = { { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 } };
+    {
+        VulkanDescriptorAllocator allocator(makeHandle<VkDevice>(1), SwapchainSize);
+        std::vector<VkDescriptorSet> descriptorSets(100);
+        allocator.allocate(layout, setSizes, descriptorSets.size(), descriptorSets.data());
+        TEST_CHECK(!fakePools.empty());
+
+        // Sets freed on image 0 are reused only when image 0 starts again
+        auto allocatedBefore = allocatedSetCount;
+        allocator.free(layout, 10, descriptorSets.data());
+        allocator.startFrame(1);
+        VkDescriptorSet descriptorSet;
+        allocator.allocate(layout, setSizes, 1, &descriptorSet);
+        TEST_CHECK(allocatedSetCount == allocatedBefore + 1);
+        allocator.startFrame(2);
+        allocator.startFrame(0);
+        allocator.allocate(layout, setSizes, 1, &descriptorSet);
+        TEST_CHECK(allocatedSetCount == allocatedBefore + 1);
+        TEST_CHECK(std::find(descriptorSets.begin(), descriptorSets.begin() + 10, descriptorSet) != descriptorSets.begin() + 10);
+    }
+    TEST_CHECK(fakePools.empty());
+}
+
+} // anon namespace
+
+int main()
+{
+    testSpawnDestroyStress();
+    testDestroyReleasesPools();
+    return Test::getResult();
+}
\ No newline at end of file
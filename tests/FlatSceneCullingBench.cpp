@@ -0,0 +1,140 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Frustum culling of 10k bounded nodes by FlatScene, nodes are placed in grid and camera sees part of it.
+// Grouped scene has node per 10x10 block, so invisible blocks are skipped with their subtrees,
+// flat scene has all nodes attached to root, so every node is tested.
+// Fails if culling result differs from testing every node against frustum.
+#include "SVE/FlatScene.h"
+#include "tests/SceneTestUtils.h"
+#include "tests/TestUtils.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+
+using namespace SVE;
+
+namespace
+{
+
+constexpr int GridSize = 100;
+constexpr int BlockSize = 10;
+constexpr float NodeSpacing = 2.0f;
+constexpr int Iterations = 100;
+
+glm::mat4 getTranslation(int x, int z)
+{
+    return glm::translate(glm::mat4(1), glm::vec3(x * NodeSpacing, 0.0f, z * NodeSpacing));
+}
+
+std::shared_ptr<SceneNode> createNode(glm::mat4 transformation, const std::shared_ptr<Entity>& entity)
+{
+    auto node = std::make_shared<SceneNode>();
+    node->setNodeTransformation(transformation);
+    if (entity)
+        node->attachEntity(entity);
+    return node;
+}
+
+std::shared_ptr<SceneNode> createScene(bool isGrouped)
+{
+    BoundingBox box;
+    box.merge(glm::vec3(-0.5f));
+    box.merge(glm::vec3(0.5f));
+
+    auto root = std::make_shared<SceneNode>();
+    for (auto blockX = 0; blockX < GridSize; blockX += BlockSize)
+    {
+        for (auto blockZ = 0; blockZ < GridSize; blockZ += BlockSize)
+        {
+            auto blockNode = isGrouped ? createNode(getTranslation(blockX, blockZ), nullptr) : root;
+            for (auto x = blockX; x < blockX + BlockSize; ++x)
+            {
+                for (auto z = blockZ; z < blockZ + BlockSize; ++z)
+                {
+                    auto transformation = isGrouped ? getTranslation(x - blockX, z - blockZ) : getTranslation(x, z);
+                    blockNode->attachSceneNode(createNode(transformation, std::make_shared<Test::BoxEntity>(box)));
+                }
+            }
+            if (isGrouped)
+                root->attachSceneNode(blockNode);
+        }
+    }
+    return root;
+}
+
+// Camera stands outside grid corner and looks at its center, far plane cuts the opposite part
+Frustum createFrustum()
+{
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 120.0f);
+    auto view = glm::lookAt(glm::vec3(-10.0f, 20.0f, -10.0f),
+                            glm::vec3(GridSize * NodeSpacing * 0.5f, 0.0f, GridSize * NodeSpacing * 0.5f),
+                            glm::vec3(0.0f, 1.0f, 0.0f));
+    return Frustum(projection * view);
+}
+
+size_t measureScene(const char* name, bool isGrouped)
+{
+    auto root = createScene(isGrouped);
+    std::vector<FrustumList> passFrustums { { createFrustum() } };
+    const uint32_t passMask = 1u << static_cast<uint32_t>(CommandsType::MainPass);
+
+    FlatScene flatScene;
+    flatScene.update(root);
+
+    using Duration = std::chrono::duration<double, std::micro>;
+    Duration boundsTime {};
+    Duration cullTime {};
+    for (auto i = 0; i < Iterations; ++i)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        flatScene.updateBounds();
+        auto cullStartTime = std::chrono::high_resolution_clock::now();
+        flatScene.cull(passFrustums, passMask);
+        auto finishTime = std::chrono::high_resolution_clock::now();
+        boundsTime += cullStartTime - startTime;
+        cullTime += finishTime - cullStartTime;
+    }
+
+    size_t visitedCount = 0;
+    size_t boundedCount = 0;
+    size_t culledCount = 0;
+    bool isSameAsBruteForce = true;
+    for (auto i = 0u; i < flatScene.getNodeCount(); ++i)
+    {
+        // Node bounds are tested only if parent subtree is visible
+        auto parent = flatScene.getParent(i);
+        if (parent == FlatScene::NoParent || flatScene.isSubtreeVisible(parent, passMask))
+            ++visitedCount;
+
+        auto entities = flatScene.getEntities(i);
+        if (entities.begin() == entities.end())
+            continue;
+        ++boundedCount;
+        auto isVisible = flatScene.isEntitiesVisible(i, passMask);
+        if (!isVisible)
+            ++culledCount;
+        isSameAsBruteForce &= isVisible == passFrustums[0][0].isVisible(flatScene.getEntitiesBounds(i));
+    }
+
+    std::cout << name << ": " << flatScene.getNodeCount() << " nodes, " << visitedCount << " visited, "
+              << culledCount << " of " << boundedCount << " bounded culled, update bounds "
+              << boundsTime.count() / Iterations << " us, cull " << cullTime.count() / Iterations << " us"
+              << std::endl;
+    TEST_CHECK(boundedCount == GridSize * GridSize);
+    TEST_CHECK(culledCount > 0 && culledCount < boundedCount);
+    TEST_CHECK(isSameAsBruteForce);
+    return boundedCount - culledCount;
+}
+
+} // anon namespace
+
+int main()
+{
+    std::cout << "Average of " << Iterations << " frames" << std::endl;
+    auto groupedVisibleCount = measureScene("Grouped", true);
+    auto flatVisibleCount = measureScene("Flat", false);
+    TEST_CHECK(groupedVisibleCount == flatVisibleCount);
+
+    return Test::getResult();
+}
\ No newline at end of file
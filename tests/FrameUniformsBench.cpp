@@ -0,0 +1,152 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Heap allocations and CPU time of per-frame uniform blocks: frame arena against heap block per object.
+// Fails if arena still allocates after warm-up frames.
+#include "SVE/CommandsType.h"
+#include "SVE/FrameUniforms.h"
+#include "tests/TestUtils.h"
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+namespace
+{
+
+size_t allocationCount = 0;
+
+} // anon namespace
+
+void* operator new(size_t size)
+{
+    ++allocationCount;
+    if (auto* data = std::malloc(size > 0 ? size : 1))
+        return data;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* data) noexcept
+{
+    std::free(data);
+}
+
+void operator delete(void* data, size_t) noexcept
+{
+    std::free(data);
+}
+
+using namespace SVE;
+
+namespace
+{
+
+// Roughly a busy level: every 10th object is skinned, every 50th is text
+constexpr size_t ObjectCount = 2000;
+constexpr size_t SkinnedEvery = 10;
+constexpr size_t BoneCount = 64;
+constexpr size_t TextEvery = 50;
+constexpr size_t TextSymbolCount = 100;
+constexpr size_t WarmupFrames = 3;
+constexpr size_t MeasuredFrames = 200;
+
+void fillPassData(FrameUniforms& frameUniforms)
+{
+    for (auto i = 0; i < PassCount; ++i)
+    {
+        auto& passData = frameUniforms.getPassData(static_cast<CommandsType>(i));
+        passData.view = glm::mat4(1.0f);
+        passData.projection = glm::mat4(2.0f);
+        passData.viewProjectionList.assign(24, glm::mat4(1.0f));
+        passData.lightDirectViewProjectionList.assign(5, glm::mat4(1.0f));
+        passData.lightPointViewProjectionList.assign(6, glm::mat4(1.0f));
+        passData.shadowPointLightList.resize(4);
+        passData.pointLightList.resize(20);
+        passData.lineLightList.resize(15);
+    }
+    frameUniforms.updateViewProjections();
+}
+
+size_t runArenaFrame(FrameUniforms& frameUniforms)
+{
+    frameUniforms.reset();
+    fillPassData(frameUniforms);
+
+    size_t checksum = 0;
+    for (size_t i = 0; i < ObjectCount; ++i)
+    {
+        auto& objectData = frameUniforms.createObjectData(glm::mat4(1.0f));
+        if (i % SkinnedEvery == 0)
+            objectData.bones = { frameUniforms.allocateArray<glm::mat4>(BoneCount), BoneCount };
+        if (i % TextEvery == 0)
+            objectData.textSymbolList = { frameUniforms.allocateArray<TextSymbolInfo>(TextSymbolCount), TextSymbolCount };
+        checksum += objectData.bones.size + objectData.textSymbolList.size;
+    }
+    return checksum;
+}
+
+// Separate heap block for every object and its arrays, kept alive until the end of frame
+struct HeapObjectData
+{
+    std::shared_ptr<ObjectUniformData> object;
+    std::vector<glm::mat4> bones;
+    std::vector<TextSymbolInfo> textSymbols;
+};
+
+size_t runHeapFrame(FrameUniforms& frameUniforms)
+{
+    frameUniforms.reset();
+    fillPassData(frameUniforms);
+
+    std::vector<HeapObjectData> objects;
+    size_t checksum = 0;
+    for (size_t i = 0; i < ObjectCount; ++i)
+    {
+        HeapObjectData objectData;
+        objectData.object = std::make_shared<ObjectUniformData>();
+        objectData.object->model = glm::mat4(1.0f);
+        if (i % SkinnedEvery == 0)
+            objectData.bones.resize(BoneCount);
+        if (i % TextEvery == 0)
+            objectData.textSymbols.resize(TextSymbolCount);
+        checksum += objectData.bones.size() + objectData.textSymbols.size();
+        objects.push_back(std::move(objectData));
+    }
+    return checksum;
+}
+
+template <typename FrameFunc>
+void measure(const char* name, FrameFunc frameFunc, size_t& steadyAllocations)
+{
+    FrameUniforms frameUniforms;
+    size_t checksum = 0;
+    for (size_t i = 0; i < WarmupFrames; ++i)
+        checksum += frameFunc(frameUniforms);
+
+    auto startCount = allocationCount;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < MeasuredFrames; ++i)
+        checksum += frameFunc(frameUniforms);
+    auto duration = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - startTime);
+    steadyAllocations = allocationCount - startCount;
+
+    std::cout << name << ": " << static_cast<double>(steadyAllocations) / MeasuredFrames << " allocations/frame, "
+              << duration.count() / MeasuredFrames << " us/frame (checksum " << checksum << ")" << std::endl;
+}
+
+} // anon namespace
+
+int main()
+{
+    std::cout << ObjectCount << " objects per frame, " << MeasuredFrames << " frames after "
+              << WarmupFrames << " warm-up frames" << std::endl;
+
+    size_t heapAllocations = 0;
+    measure("Heap block per object", runHeapFrame, heapAllocations);
+    size_t arenaAllocations = 0;
+    measure("Frame arena", runArenaFrame, arenaAllocations);
+
+    TEST_CHECK(arenaAllocations == 0);
+    return Test::getResult();
+}
\ No newline at end of file
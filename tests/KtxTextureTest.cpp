@@ -0,0 +1,153 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// KTX2 round trip of written textures and rejection of truncated or unsupported files.
+#include "SVE/KtxTexture.h"
+#include "SVE/VulkanException.h"
+#include "tests/TestUtils.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace SVE;
+
+namespace
+{
+
+// Header fields offsets (KTX2 specification, section 3)
+constexpr size_t LevelCountOffset = 40;
+constexpr size_t SupercompressionOffset = 44;
+constexpr size_t LevelIndexOffset = 80;
+constexpr size_t LevelIndexSize = 24;
+
+constexpr uint32_t Width = 8;
+constexpr uint32_t Height = 4;
+
+// 8x4 texture with full mip chain, every level is filled with its number (starting from 1)
+std::vector<std::vector<uint8_t>> createLevels()
+{
+    std::vector<std::vector<uint8_t>> levels;
+    for (auto level = 0u; (Width >> level) > 0 || (Height >> level) > 0; level++)
+    {
+        auto width = std::max(Width >> level, 1u);
+        auto height = std::max(Height >> level, 1u);
+        levels.emplace_back(width * height * 4, static_cast<uint8_t>(level + 1));
+    }
+    return levels;
+}
+
+template <typename T>
+void patch(std::string& data, size_t offset, T value)
+{
+    memcpy(&data[offset], &value, sizeof(value));
+}
+
+bool isRejected(const std::string& data)
+{
+    try
+    {
+        readKtxTexture(FileView(data));
+    }
+    catch (const VulkanException&)
+    {
+        return true;
+    }
+    return false;
+}
+
+void testRoundTrip()
+{
+    auto levels = createLevels();
+    TEST_CHECK(levels.size() == 4);
+
+    auto data = writeKtxTexture(Width, Height, levels);
+    TEST_CHECK(isKtxTexture(FileView(data)));
+
+    auto textureInfo = readKtxTexture(FileView(data));
+    TEST_CHECK(textureInfo.format == VK_FORMAT_R8G8B8A8_UNORM);
+    TEST_CHECK(textureInfo.width == Width);
+    TEST_CHECK(textureInfo.height == Height);
+    if (!TEST_CHECK(textureInfo.levels.size() == levels.size()))
+        return;
+
+    for (auto i = 0u; i < levels.size(); i++)
+    {
+        const auto& level = textureInfo.levels[i];
+        TEST_CHECK(level.width == std::max(Width >> i, 1u));
+        TEST_CHECK(level.height == std::max(Height >> i, 1u));
+        TEST_CHECK(level.size == levels[i].size());
+        TEST_CHECK(memcmp(data.data() + level.offset, levels[i].data(), levels[i].size()) == 0);
+    }
+}
+
+void testWriteWrongLevelSize()
+{
+    auto levels = createLevels();
+    levels[2].pop_back();
+    auto isThrown = false;
+    try
+    {
+        writeKtxTexture(Width, Height, levels);
+    }
+    catch (const VulkanException&)
+    {
+        isThrown = true;
+    }
+    TEST_CHECK(isThrown);
+}
+
+void testTruncatedData()
+{
+    // Largest level is stored last, so every truncation cuts some level or header
+    auto data = writeKtxTexture(Width, Height, createLevels());
+    auto rejectedCount = 0u;
+    for (auto size = 0u; size < data.size(); size++)
+        rejectedCount += isRejected(data.substr(0, size)) ? 1 : 0;
+    TEST_CHECK(rejectedCount == data.size());
+}
+
+void testWrongLevelSize()
+{
+    auto data = writeKtxTexture(Width, Height, createLevels());
+    patch<uint64_t>(data, LevelIndexOffset + LevelIndexSize + sizeof(uint64_t), 4 * 2 * 4 - 4);
+    TEST_CHECK(isRejected(data));
+
+    data = writeKtxTexture(Width, Height, createLevels());
+    patch<uint64_t>(data, LevelIndexOffset, data.size());
+    TEST_CHECK(isRejected(data));
+}
+
+void testTooManyLevels()
+{
+    auto data = writeKtxTexture(Width, Height, createLevels());
+    patch<uint32_t>(data, LevelCountOffset, 5);
+    TEST_CHECK(isRejected(data));
+
+    patch<uint32_t>(data, LevelCountOffset, 0xFFFFFFFFu);
+    TEST_CHECK(isRejected(data));
+}
+
+void testUnsupportedSupercompression()
+{
+    auto data = writeKtxTexture(Width, Height, createLevels());
+    // BasisLZ
+    patch<uint32_t>(data, SupercompressionOffset, 1);
+    TEST_CHECK(isRejected(data));
+    // Zstandard
+    patch<uint32_t>(data, SupercompressionOffset, 2);
+    TEST_CHECK(isRejected(data));
+}
+
+} // anon namespace
+
+int main()
+{
+    testRoundTrip();
+    testWriteWrongLevelSize();
+    testTruncatedData();
+    testWrongLevelSize();
+    testTooManyLevels();
+    testUnsupportedSupercompression();
+
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+// Chewman Vulkan game
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Level geometry rebuild after single wall is destroyed: every chunk against only the chunk with changed cell.
+// Levels are taken from map files passed in arguments, every wall cell is opened in turn.
+// Static objects mark only their own cell, their extent doesn't change geometry cost much.
+#include "Game/Level/BlockMeshGenerator.h"
+#include "tests/TestUtils.h"
+#include <chrono>
+#include <fstream>
+
+using namespace Chewman;
+
+namespace
+{
+
+struct LevelMap
+{
+    size_t width = 0;
+    size_t height = 0;
+    CellInfoMap mapData;
+};
+
+// Cell types as set by GameMapLoader, objects standing on floor are floor
+CellType getCellType(char mapChar)
+{
+    switch (mapChar)
+    {
+        case 'W':
+            return CellType::Wall;
+        case 'L':
+            return CellType::Liquid;
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case 'J':
+        case 'D':
+        case 'V':
+        case 'Z':
+        case 'Y':
+            return CellType::InvisibleWallWithFloor;
+        default:
+            return CellType::Floor;
+    }
+}
+
+bool loadLevel(const std::string& path, LevelMap& level)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    // Size, star times, style, light and treasure type are followed by level name line
+    uint16_t unused;
+    file >> level.width >> level.height >> unused >> unused >> unused >> unused >> unused >> unused;
+    std::string name;
+    std::getline(file, name);
+
+    level.mapData.assign(level.height, std::vector<CellInfo>(level.width));
+    auto nextIsRotation = 0;
+    for (auto row = 0u; row < level.height; ++row)
+    {
+        auto& cells = level.mapData[level.height - row - 1];
+        for (auto column = 0u; column < level.width; ++column)
+        {
+            char ch;
+            file >> ch;
+            if (nextIsRotation)
+            {
+                // Rotation of static object takes map cell, it's taken by object
+                nextIsRotation--;
+                cells[column].cellType = CellType::InvisibleWallWithFloor;
+                continue;
+            }
+            cells[column].cellType = getCellType(ch);
+            if (ch == 'J' || ch == 'D' || ch == 'V' || ch == 'Z' || ch == 'Y')
+                nextIsRotation = ch == 'D' ? 2 : 1;
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+// Same work as buildLevelChunk does before upload
+size_t buildChunk(BlockMeshGenerator& meshGenerator, const LevelMap& level, size_t chunkColumns, size_t chunkIndex)
+{
+    size_t indexCount = 0;
+    for (auto& submeshes : meshGenerator.GenerateChunk(level.mapData, level.width, level.height, chunkColumns, chunkIndex))
+    {
+        if (!submeshes.empty())
+            indexCount += meshGenerator.CombineMeshes("Chunk", std::move(submeshes)).indexData.size();
+    }
+    return indexCount;
+}
+
+void measureLevel(const std::string& path)
+{
+    LevelMap level;
+    if (!TEST_CHECK(loadLevel(path, level)))
+        return;
+
+    BlockMeshGenerator meshGenerator(CellSize);
+    auto chunkRows = (level.height + MapChunkSize - 1) / MapChunkSize;
+    auto chunkColumns = (level.width + MapChunkSize - 1) / MapChunkSize;
+    auto chunkCount = chunkRows * chunkColumns;
+
+    std::chrono::duration<double, std::micro> fullTime {};
+    std::chrono::duration<double, std::micro> chunkTime {};
+    size_t changeCount = 0;
+    size_t fullIndexCount = 0;
+    size_t chunkIndexCount = 0;
+    for (size_t x = 0; x < level.height; ++x)
+    {
+        for (size_t y = 0; y < level.width; ++y)
+        {
+            auto& cell = level.mapData[x][y];
+            if (cell.cellType != CellType::Wall)
+                continue;
+
+            cell.cellType = CellType::Floor;
+            ++changeCount;
+
+            auto startTime = std::chrono::high_resolution_clock::now();
+            for (size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+                fullIndexCount += buildChunk(meshGenerator, level, chunkColumns, chunkIndex);
+            auto chunkStartTime = std::chrono::high_resolution_clock::now();
+            auto changedChunk = getChunkIndex(glm::ivec2(x, y), chunkColumns);
+            chunkIndexCount += buildChunk(meshGenerator, level, chunkColumns, changedChunk);
+            auto finishTime = std::chrono::high_resolution_clock::now();
+
+            fullTime += chunkStartTime - startTime;
+            chunkTime += finishTime - chunkStartTime;
+            cell.cellType = CellType::Wall;
+        }
+    }
+    if (!TEST_CHECK(changeCount > 0))
+        return;
+
+    std::cout << path.substr(path.find_last_of("/\\") + 1) << " " << level.width << "x" << level.height << ", "
+              << chunkCount << " chunks: all chunks " << fullTime.count() / changeCount << " us ("
+              << fullIndexCount / changeCount << " indices), changed chunk " << chunkTime.count() / changeCount
+              << " us (" << chunkIndexCount / changeCount << " indices)" << std::endl;
+    TEST_CHECK(chunkIndexCount <= fullIndexCount);
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    std::cout << "Average time of geometry rebuild after one wall cell became floor" << std::endl;
+    for (auto i = 1; i < argc; i++)
+        measureLevel(argv[i]);
+
+    return Test::getResult();
+}
\ No newline at end of file
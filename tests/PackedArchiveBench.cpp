@@ -0,0 +1,256 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Reading every resource file through DesktopFS against packed archive mapped by DesktopFS::mapFile.
+// Every run is done in its own child process, so its peak RSS doesn't include other runs.
+// Cold run drops cached pages of read files first (posix_fadvise), warm run reads them again.
+// Views are kept until all files are read, as resource data is kept while resources are loaded.
+// Usage: PackedArchiveBench resources
+#include "DesktopFS.h"
+#include "SVE/PackedArchive.h"
+#include "SVE/PackedFS.h"
+#include "SVE/VulkanException.h"
+#include "tests/TestUtils.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace SVE;
+
+namespace
+{
+
+const char ArchivePath[] = "PackedArchiveBench.pack";
+
+// Same as AssetPacker, big files start at page boundary
+constexpr size_t PageAlignedFileSize = 64 * 1024;
+constexpr uint32_t PageAlignment = 4096;
+
+// Header and table of contents entry layout (see SVE/PackedArchive.cpp)
+constexpr size_t EntriesOffsetOffset = 16;
+constexpr size_t EntryOriginalSizeOffset = 16;
+constexpr size_t EntryCompressionOffset = 32;
+
+enum class ReadMode
+{
+    Baseline,
+    Desktop,
+    Packed
+};
+
+struct RunResult
+{
+    double seconds = 0.0;
+    uint64_t checksum = 0;
+    long maxRss = 0;
+};
+
+void collectFiles(const DesktopFS& desktopFS, const FSEntityPtr& dir, std::vector<std::string>& paths)
+{
+    for (auto& entity : desktopFS.getFileList(dir))
+    {
+        if (entity->isDirectory())
+            collectFiles(desktopFS, entity, paths);
+        else
+            paths.push_back(entity->getPath());
+    }
+}
+
+void writeArchive(const DesktopFS& desktopFS, const std::vector<std::string>& paths)
+{
+    std::vector<PackedFile> files;
+    for (auto& path : paths)
+    {
+        PackedFile file;
+        file.path = path;
+        file.data = desktopFS.getFileContent(desktopFS.getEntity(path));
+        file.alignment = file.data.size() >= PageAlignedFileSize ? PageAlignment : PackedArchiveAlignment;
+        files.push_back(std::move(file));
+    }
+
+    auto data = writePackedArchive(std::move(files));
+    std::ofstream file(ArchivePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+    if (!file)
+        throw VulkanException("Can't write file " + std::string(ArchivePath));
+}
+
+void dropCachedPages(const std::string& path)
+{
+    auto file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return;
+    fdatasync(file);
+    posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+    close(file);
+}
+
+uint64_t getChecksum(const FileView& fileView)
+{
+    // FNV-1a, every byte is touched as loader would do
+    uint64_t checksum = 14695981039346656037ull;
+    for (size_t i = 0; i < fileView.size(); i++)
+        checksum = (checksum ^ static_cast<uint8_t>(fileView.data()[i])) * 1099511628211ull;
+    return checksum;
+}
+
+uint64_t readFiles(const FileSystem& fileSystem, const std::vector<std::string>& paths)
+{
+    std::vector<FileView> fileViews;
+    fileViews.reserve(paths.size());
+    uint64_t checksum = 0;
+    for (auto& path : paths)
+    {
+        fileViews.push_back(fileSystem.getFileView(fileSystem.getEntity(path)));
+        checksum += getChecksum(fileViews.back());
+    }
+    return checksum;
+}
+
+uint64_t runMode(ReadMode mode, const std::vector<std::string>& paths)
+{
+    switch (mode)
+    {
+        case ReadMode::Baseline:
+            return 0;
+        case ReadMode::Desktop:
+            return readFiles(DesktopFS(), paths);
+        case ReadMode::Packed:
+            return readFiles(PackedFS(DesktopFS::mapFile(ArchivePath), nullptr), paths);
+    }
+    return 0;
+}
+
+RunResult runChild(ReadMode mode, bool isCold, const std::vector<std::string>& paths)
+{
+    int resultPipe[2];
+    if (pipe(resultPipe) != 0)
+        throw VulkanException("Can't create pipe");
+
+    auto pid = fork();
+    if (pid < 0)
+        throw VulkanException("Can't start child process");
+
+    if (pid == 0)
+    {
+        close(resultPipe[0]);
+        if (isCold)
+        {
+            for (auto& path : paths)
+                dropCachedPages(path);
+            dropCachedPages(ArchivePath);
+        }
+
+        RunResult result;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        result.checksum = runMode(mode, paths);
+        result.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+        auto isWritten = write(resultPipe[1], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+        _exit(isWritten ? 0 : 1);
+    }
+
+    close(resultPipe[1]);
+    RunResult result;
+    auto isRead = read(resultPipe[0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+    close(resultPipe[0]);
+
+    int status = 0;
+    rusage usage {};
+    wait4(pid, &status, 0, &usage);
+    if (!isRead || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        throw VulkanException("Child process failed");
+    result.maxRss = usage.ru_maxrss;
+    return result;
+}
+
+bool isRejected(const std::string& data)
+{
+    try
+    {
+        PackedArchive archive((FileView(data)));
+    }
+    catch (const VulkanException&)
+    {
+        return true;
+    }
+    return false;
+}
+
+// Compressed entry sizes are checked before anything is allocated for decompression
+void testEntryValidation()
+{
+    PackedFile file;
+    file.path = "file";
+    file.data = std::string(1000, 'a');
+    auto data = writePackedArchive({file});
+    TEST_CHECK(!isRejected(data));
+
+    uint64_t entriesOffset = 0;
+    memcpy(&entriesOffset, &data[EntriesOffsetOffset], sizeof(entriesOffset));
+    auto patch = [&](PackedCompression compression, uint64_t originalSize)
+    {
+        auto patchedData = data;
+        memcpy(&patchedData[entriesOffset + EntryCompressionOffset], &compression, sizeof(compression));
+        memcpy(&patchedData[entriesOffset + EntryOriginalSizeOffset], &originalSize, sizeof(originalSize));
+        return patchedData;
+    };
+
+    TEST_CHECK(isRejected(patch(PackedCompression::None, 1001)));
+    TEST_CHECK(isRejected(patch(static_cast<PackedCompression>(2), 1000)));
+    TEST_CHECK(!isRejected(patch(PackedCompression::LZ4, 255 * 1000)));
+    TEST_CHECK(isRejected(patch(PackedCompression::LZ4, 256 * 1000)));
+    TEST_CHECK(isRejected(patch(PackedCompression::LZ4, 0xFFFFFFFFFFFFull)));
+}
+
+void printResult(const char* name, const RunResult& result, long baselineRss)
+{
+    std::cout << std::setw(16) << std::left << name << std::fixed << std::setprecision(2)
+              << result.seconds * 1000.0 << " ms, peak RSS +" << result.maxRss - baselineRss << " KB" << std::endl;
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    testEntryValidation();
+
+    if (argc < 2)
+    {
+        std::cout << "Usage: PackedArchiveBench resources" << std::endl;
+        return 1;
+    }
+
+    DesktopFS desktopFS;
+    std::vector<std::string> paths;
+    collectFiles(desktopFS, desktopFS.getEntity(argv[1], true), paths);
+    if (!TEST_CHECK(!paths.empty()))
+        return Test::getResult();
+    writeArchive(desktopFS, paths);
+
+    auto baseline = runChild(ReadMode::Baseline, false, paths);
+    auto desktopCold = runChild(ReadMode::Desktop, true, paths);
+    auto desktopWarm = runChild(ReadMode::Desktop, false, paths);
+    auto packedCold = runChild(ReadMode::Packed, true, paths);
+    auto packedWarm = runChild(ReadMode::Packed, false, paths);
+    std::remove(ArchivePath);
+
+    std::cout << paths.size() << " files" << std::endl;
+    printResult("DesktopFS cold", desktopCold, baseline.maxRss);
+    printResult("DesktopFS warm", desktopWarm, baseline.maxRss);
+    printResult("PackedFS cold", packedCold, baseline.maxRss);
+    printResult("PackedFS warm", packedWarm, baseline.maxRss);
+
+    TEST_CHECK(desktopCold.checksum == desktopWarm.checksum);
+    TEST_CHECK(packedCold.checksum == desktopCold.checksum);
+    TEST_CHECK(packedWarm.checksum == desktopCold.checksum);
+
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+// Chewman Vulkan game
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Path map build time on open and maze maps of growing size, single thread against worker threads.
+// Shipped levels are up to 20x20 cells. Fails if worker threads give different table.
+#include "Game/Level/Enemies/PathMap.h"
+#include "tests/TestUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
+using namespace Chewman;
+
+namespace
+{
+
+constexpr int MapSizes[] = { 16, 32, 48, 64 };
+constexpr int Iterations = 5;
+
+// Floor everywhere except border walls
+CellInfoMap createOpenMap(int size)
+{
+    CellInfoMap mapData(size, std::vector<CellInfo>(size));
+    for (auto x = 0; x < size; ++x)
+    {
+        for (auto y = 0; y < size; ++y)
+        {
+            auto isBorder = x == 0 || y == 0 || x == size - 1 || y == size - 1;
+            mapData[x][y].cellType = isBorder ? CellType::Wall : CellType::Floor;
+        }
+    }
+    return mapData;
+}
+
+// Perfect maze carved by randomized depth-first search, paths are long and have one cell width
+CellInfoMap createMazeMap(int size)
+{
+    CellInfoMap mapData(size, std::vector<CellInfo>(size));
+    for (auto& row : mapData)
+    {
+        for (auto& cell : row)
+            cell.cellType = CellType::Wall;
+    }
+
+    std::mt19937 random(size);
+    std::vector<glm::ivec2> stack { {1, 1} };
+    mapData[1][1].cellType = CellType::Floor;
+    while (!stack.empty())
+    {
+        auto cell = stack.back();
+        const glm::ivec2 steps[] = { {2, 0}, {-2, 0}, {0, 2}, {0, -2} };
+        std::vector<glm::ivec2> nextCells;
+        for (auto& step : steps)
+        {
+            glm::ivec2 next(cell.x + step.x, cell.y + step.y);
+            if (next.x > 0 && next.y > 0 && next.x < size - 1 && next.y < size - 1 &&
+                mapData[next.x][next.y].cellType == CellType::Wall)
+                nextCells.push_back(next);
+        }
+        if (nextCells.empty())
+        {
+            stack.pop_back();
+            continue;
+        }
+
+        auto next = nextCells[random() % nextCells.size()];
+        mapData[(cell.x + next.x) / 2][(cell.y + next.y) / 2].cellType = CellType::Floor;
+        mapData[next.x][next.y].cellType = CellType::Floor;
+        stack.push_back(next);
+    }
+    return mapData;
+}
+
+double measureBuild(PathMap& pathMap, const CellInfoMap& mapData, int size)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (auto i = 0; i < Iterations; ++i)
+        pathMap.build(mapData, size, size);
+    auto duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime);
+    return duration.count() / Iterations;
+}
+
+bool isSameTable(const PathMap& a, const PathMap& b, int size)
+{
+    for (auto targetX = 0; targetX < size; ++targetX)
+    for (auto targetY = 0; targetY < size; ++targetY)
+    for (auto x = 0; x < size; ++x)
+    for (auto y = 0; y < size; ++y)
+    {
+        glm::ivec2 target(targetX, targetY);
+        glm::ivec2 from(x, y);
+        if (a.getDirection(target, from) != b.getDirection(target, from))
+            return false;
+    }
+    return true;
+}
+
+void measureMap(const char* name, const CellInfoMap& mapData, int size)
+{
+    PathMap singleThreadMap;
+    singleThreadMap.setThreadCount(1);
+    auto singleThreadTime = measureBuild(singleThreadMap, mapData, size);
+
+    PathMap workerThreadsMap;
+    auto workerThreadsTime = measureBuild(workerThreadsMap, mapData, size);
+
+    std::cout << name << " " << size << "x" << size << ": single thread " << singleThreadTime
+              << " ms, worker threads " << workerThreadsTime << " ms" << std::endl;
+    TEST_CHECK(isSameTable(singleThreadMap, workerThreadsMap, size));
+}
+
+} // anon namespace
+
+int main()
+{
+    std::cout << "Worker threads: " << std::max(1u, std::thread::hardware_concurrency()) << ", average of "
+              << Iterations << " builds" << std::endl;
+
+    for (auto size : MapSizes)
+    {
+        measureMap("Open", createOpenMap(size), size);
+        measureMap("Maze", createMazeMap(size), size);
+    }
+
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+// Chewman Vulkan game
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Randomized check of incremental path map repair against full rebuild.
+#include "Game/Level/Enemies/PathMap.h"
+#include "tests/TestUtils.h"
+#include <random>
+
+using namespace Chewman;
+
+namespace
+{
+
+CellInfoMap createRandomMap(std::mt19937& random, size_t width, size_t height)
+{
+    CellInfoMap mapData(height, std::vector<CellInfo>(width));
+    for (auto& row : mapData)
+    {
+        for (auto& cell : row)
+            cell.cellType = random() % 2 ? CellType::Floor : CellType::Wall;
+    }
+    return mapData;
+}
+
+// Opens walls in random square, duplicate cells are added as game can report them
+std::vector<glm::ivec2> openRandomWalls(std::mt19937& random, CellInfoMap& mapData, int width, int height)
+{
+    std::vector<glm::ivec2> changedCells;
+    int centerX = random() % height;
+    int centerY = random() % width;
+    int radius = random() % 3;
+    for (auto x = centerX - radius; x <= centerX + radius; ++x)
+    {
+        for (auto y = centerY - radius; y <= centerY + radius; ++y)
+        {
+            if (x >= 0 && y >= 0 && x < height && y < width && mapData[x][y].cellType == CellType::Wall)
+            {
+                mapData[x][y].cellType = CellType::Floor;
+                changedCells.emplace_back(x, y);
+            }
+        }
+    }
+    if (changedCells.size() > 1)
+        changedCells.push_back(changedCells.front());
+    return changedCells;
+}
+
+bool isSameAsRebuild(const PathMap& pathMap, const CellInfoMap& mapData, int width, int height)
+{
+    PathMap rebuiltMap;
+    rebuiltMap.build(mapData, width, height);
+    for (auto targetX = 0; targetX < height; ++targetX)
+    for (auto targetY = 0; targetY < width; ++targetY)
+    for (auto x = 0; x < height; ++x)
+    for (auto y = 0; y < width; ++y)
+    {
+        glm::ivec2 target(targetX, targetY);
+        glm::ivec2 from(x, y);
+        if (pathMap.getDirection(target, from) != rebuiltMap.getDirection(target, from))
+            return false;
+    }
+    return true;
+}
+
+void testOpenedWalls()
+{
+    std::mt19937 random(7);
+    for (auto iteration = 0; iteration < 60; ++iteration)
+    {
+        int width = 4 + random() % 14;
+        int height = 4 + random() % 14;
+        auto mapData = createRandomMap(random, width, height);
+
+        PathMap pathMap;
+        pathMap.build(mapData, width, height);
+        for (auto step = 0; step < 8; ++step)
+        {
+            auto changedCells = openRandomWalls(random, mapData, width, height);
+            pathMap.update(mapData, width, height, changedCells);
+            TEST_CHECK(isSameAsRebuild(pathMap, mapData, width, height));
+        }
+    }
+}
+
+void testClosedCells()
+{
+    // Closing cells falls back to full rebuild, mixed changes must give the same result
+    std::mt19937 random(11);
+    for (auto iteration = 0; iteration < 50; ++iteration)
+    {
+        int width = 4 + random() % 14;
+        int height = 4 + random() % 14;
+        auto mapData = createRandomMap(random, width, height);
+
+        PathMap pathMap;
+        pathMap.build(mapData, width, height);
+        std::vector<glm::ivec2> changedCells;
+        for (auto i = 0; i < 5; ++i)
+        {
+            int x = random() % height;
+            int y = random() % width;
+            auto& cell = mapData[x][y];
+            cell.cellType = cell.cellType == CellType::Floor ? CellType::Wall : CellType::Floor;
+            changedCells.emplace_back(x, y);
+        }
+        pathMap.update(mapData, width, height, changedCells);
+        TEST_CHECK(isSameAsRebuild(pathMap, mapData, width, height));
+    }
+}
+
+void testOutOfMapRequests()
+{
+    CellInfoMap mapData(3, std::vector<CellInfo>(4));
+    for (auto& row : mapData)
+        for (auto& cell : row)
+            cell.cellType = CellType::Floor;
+
+    PathMap pathMap;
+    pathMap.build(mapData, 4, 3);
+    TEST_CHECK(pathMap.getDirection({-1, 0}, {0, 0}) == MoveDirection::None);
+    TEST_CHECK(pathMap.getDirection({0, 0}, {3, 0}) == MoveDirection::None);
+    TEST_CHECK(pathMap.getDirection({0, 4}, {0, 0}) == MoveDirection::None);
+    TEST_CHECK(pathMap.getDirection({0, 0}, {0, 0}) == MoveDirection::None);
+    TEST_CHECK(pathMap.getDirection({0, 0}, {0, 1}) != MoveDirection::None);
+}
+
+} // anon namespace
+
+int main()
+{
+    testOpenedWalls();
+    testClosedCells();
+    testOutOfMapRequests();
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,301 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Render queue sort keys and bind deduplication without Vulkan device. Items sorted by keys should be
+// grouped by material, then mesh, then go front to back, and bind cache should skip only repeated binds.
+// Recording is replaced by mock which records commands the way VulkanMaterial and VulkanMesh do.
+#include "SVE/RenderSortKey.h"
+#include "SVE/VulkanBindCache.h"
+#include "tests/TestUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace SVE;
+
+namespace
+{
+
+constexpr uint32_t ItemCount = 1000;
+constexpr uint32_t MaterialCount = 8;
+constexpr uint32_t MeshCount = 5;
+
+struct TestItem
+{
+    uint64_t sortKey;
+    RenderStage stage;
+    bool isOrdered;
+    uint32_t materialId;
+    uint32_t meshId;
+    float depth;
+    uint32_t sceneOrder;
+};
+
+enum class CommandType
+{
+    BindPipeline,
+    BindGeometry,
+    Draw
+};
+
+struct Command
+{
+    CommandType type;
+    uint64_t value;
+};
+
+// Non-dispatchable handles are pointers or uint64_t depending on platform
+VkPipeline makePipeline(uint64_t value)
+{
+    VkPipeline pipeline {};
+    memcpy(&pipeline, &value, sizeof(pipeline));
+    return pipeline;
+}
+
+class RecordingMock
+{
+public:
+    void reset()
+    {
+        bindCache.reset();
+    }
+
+    void draw(uint32_t materialId, uint32_t meshId)
+    {
+        if (bindCache.isPipelineBindNeeded(makePipeline(materialId)))
+            commands.push_back({ CommandType::BindPipeline, materialId });
+        if (bindCache.isGeometryBindNeeded(reinterpret_cast<const void*>(static_cast<uintptr_t>(meshId))))
+            commands.push_back({ CommandType::BindGeometry, meshId });
+        commands.push_back({ CommandType::Draw, static_cast<uint64_t>(materialId) << 32u | meshId });
+    }
+
+    // Particle systems bind their own buffers
+    void drawParticles(uint32_t materialId)
+    {
+        if (bindCache.isPipelineBindNeeded(makePipeline(materialId)))
+            commands.push_back({ CommandType::BindPipeline, materialId });
+        bindCache.resetGeometry();
+        commands.push_back({ CommandType::Draw, static_cast<uint64_t>(materialId) << 32u });
+    }
+
+    size_t getCommandCount(CommandType type) const
+    {
+        return std::count_if(commands.begin(), commands.end(), [type](const Command& command)
+        {
+            return command.type == type;
+        });
+    }
+
+    // Every draw should see pipeline and geometry it asked for
+    bool isBoundStateCorrect() const
+    {
+        uint64_t pipeline = 0;
+        uint64_t geometry = 0;
+        for (auto& command : commands)
+        {
+            switch (command.type)
+            {
+                case CommandType::BindPipeline:
+                    pipeline = command.value;
+                    break;
+                case CommandType::BindGeometry:
+                    geometry = command.value;
+                    break;
+                case CommandType::Draw:
+                    if (command.value >> 32u != pipeline)
+                        return false;
+                    if ((command.value & 0xFFFFFFFFu) != 0 && (command.value & 0xFFFFFFFFu) != geometry)
+                        return false;
+                    break;
+            }
+        }
+        return true;
+    }
+
+    VulkanBindCache bindCache;
+    std::vector<Command> commands;
+};
+
+std::vector<TestItem> createItems()
+{
+    std::mt19937 random(7);
+    std::vector<TestItem> items;
+    for (auto i = 0u; i < ItemCount; i++)
+    {
+        TestItem item {};
+        item.stage = static_cast<RenderStage>(random() % 3);
+        item.isOrdered = item.stage == RenderStage::RenderLast || random() % 5 == 0;
+        item.materialId = 1 + random() % MaterialCount;
+        item.meshId = 1 + random() % MeshCount;
+        // Depth is compared coarsely, distances differ enough to keep their order
+        item.depth = static_cast<float>(1 + random() % 64);
+        item.sceneOrder = i;
+        item.sortKey = item.isOrdered
+                ? createSortKey(item.stage, item.sceneOrder)
+                : createStateSortKey(item.stage, item.materialId, item.meshId, item.depth, item.sceneOrder);
+        items.push_back(item);
+    }
+
+    std::sort(items.begin(), items.end(), [](const TestItem& left, const TestItem& right)
+    {
+        return left.sortKey < right.sortKey;
+    });
+    return items;
+}
+
+// Material and mesh runs of sorted items, every state should make single run inside stage
+size_t countStateRuns(const std::vector<TestItem>& items, bool byMesh)
+{
+    size_t runCount = 0;
+    for (auto i = 0u; i < items.size(); i++)
+    {
+        if (items[i].isOrdered)
+            continue;
+        auto isSameRun = i > 0 && !items[i - 1].isOrdered && items[i - 1].stage == items[i].stage &&
+                         items[i - 1].materialId == items[i].materialId &&
+                         (!byMesh || items[i - 1].meshId == items[i].meshId);
+        if (!isSameRun)
+            ++runCount;
+    }
+    return runCount;
+}
+
+size_t countDistinctStates(const std::vector<TestItem>& items, bool byMesh)
+{
+    std::vector<uint64_t> states;
+    for (auto& item : items)
+    {
+        if (!item.isOrdered)
+            states.push_back(static_cast<uint64_t>(item.stage) << 40u | item.materialId << 20u |
+                             (byMesh ? item.meshId : 0));
+    }
+    std::sort(states.begin(), states.end());
+    return std::unique(states.begin(), states.end()) - states.begin();
+}
+
+void testSortKeys()
+{
+    auto items = createItems();
+
+    bool isStageOrdered = true;
+    bool isOrderedLast = true;
+    bool isSceneOrderKept = true;
+    bool isFrontToBack = true;
+    for (auto i = 1u; i < items.size(); i++)
+    {
+        auto& previous = items[i - 1];
+        auto& item = items[i];
+        isStageOrdered &= previous.stage <= item.stage;
+        if (previous.stage != item.stage)
+            continue;
+
+        // Blended items are drawn over state sorted ones of the same stage
+        isOrderedLast &= !previous.isOrdered || item.isOrdered;
+        if (previous.isOrdered && item.isOrdered)
+            isSceneOrderKept &= previous.sceneOrder < item.sceneOrder;
+        if (!previous.isOrdered && !item.isOrdered && previous.materialId == item.materialId &&
+            previous.meshId == item.meshId)
+            isFrontToBack &= previous.depth <= item.depth;
+    }
+
+    TEST_CHECK(isStageOrdered);
+    TEST_CHECK(isOrderedLast);
+    TEST_CHECK(isSceneOrderKept);
+    TEST_CHECK(isFrontToBack);
+    TEST_CHECK(countStateRuns(items, false) == countDistinctStates(items, false));
+    TEST_CHECK(countStateRuns(items, true) == countDistinctStates(items, true));
+
+    // Material is more significant than mesh and depth
+    TEST_CHECK(createStateSortKey(RenderStage::Regular, 1, 2, 0.0f, 0) <
+               createStateSortKey(RenderStage::Regular, 2, 1, 0.0f, 0));
+    TEST_CHECK(createStateSortKey(RenderStage::Regular, 1, 1, 100.0f, 0) <
+               createStateSortKey(RenderStage::Regular, 1, 2, 1.0f, 0));
+    TEST_CHECK(createStateSortKey(RenderStage::Regular, 1, 1, 1.0f, 1) <
+               createStateSortKey(RenderStage::Regular, 1, 1, 100.0f, 0));
+    TEST_CHECK(createStateSortKey(RenderStage::RenderLast, 0, 0, 0.0f, 0) >
+               createSortKey(RenderStage::Instanced, ItemCount));
+}
+
+void testRepeatedBindsSkipped()
+{
+    RecordingMock mock;
+    mock.reset();
+    mock.draw(1, 1);
+    mock.draw(1, 1);
+    mock.draw(1, 2);
+    mock.draw(2, 2);
+    mock.draw(2, 2);
+    mock.draw(1, 2);
+
+    TEST_CHECK(mock.getCommandCount(CommandType::Draw) == 6);
+    TEST_CHECK(mock.getCommandCount(CommandType::BindPipeline) == 3);
+    TEST_CHECK(mock.getCommandCount(CommandType::BindGeometry) == 2);
+    TEST_CHECK(mock.isBoundStateCorrect());
+
+    auto& statistics = mock.bindCache.getStatistics();
+    TEST_CHECK(statistics.pipelineBinds == 3 && statistics.pipelineBindsSkipped == 3);
+    TEST_CHECK(statistics.geometryBinds == 2 && statistics.geometryBindsSkipped == 4);
+}
+
+void testBindsRestored()
+{
+    RecordingMock mock;
+    mock.reset();
+    mock.draw(1, 1);
+    // Geometry bound bypassing cache should be bound again
+    mock.drawParticles(1);
+    mock.draw(1, 1);
+    TEST_CHECK(mock.getCommandCount(CommandType::BindPipeline) == 1);
+    TEST_CHECK(mock.getCommandCount(CommandType::BindGeometry) == 2);
+
+    // New command buffer has nothing bound
+    mock.reset();
+    mock.draw(1, 1);
+    TEST_CHECK(mock.getCommandCount(CommandType::BindPipeline) == 2);
+    TEST_CHECK(mock.getCommandCount(CommandType::BindGeometry) == 3);
+    TEST_CHECK(mock.isBoundStateCorrect());
+
+    mock.bindCache.resetStatistics();
+    TEST_CHECK(mock.bindCache.getStatistics().pipelineBinds == 0);
+}
+
+// Sorted queue binds pipeline once per material run and geometry once per mesh run
+void testSortedQueueBinds()
+{
+    auto items = createItems();
+    RecordingMock sortedMock;
+    sortedMock.reset();
+    for (auto& item : items)
+        sortedMock.draw(item.materialId, item.meshId);
+
+    std::sort(items.begin(), items.end(), [](const TestItem& left, const TestItem& right)
+    {
+        return left.sceneOrder < right.sceneOrder;
+    });
+    RecordingMock sceneOrderMock;
+    sceneOrderMock.reset();
+    for (auto& item : items)
+        sceneOrderMock.draw(item.materialId, item.meshId);
+
+    TEST_CHECK(sortedMock.isBoundStateCorrect());
+    TEST_CHECK(sceneOrderMock.isBoundStateCorrect());
+    TEST_CHECK(sortedMock.getCommandCount(CommandType::Draw) == ItemCount);
+    TEST_CHECK(sortedMock.getCommandCount(CommandType::BindPipeline) <
+               sceneOrderMock.getCommandCount(CommandType::BindPipeline));
+    TEST_CHECK(sortedMock.getCommandCount(CommandType::BindGeometry) <
+               sceneOrderMock.getCommandCount(CommandType::BindGeometry));
+}
+
+} // anon namespace
+
+int main()
+{
+    testSortKeys();
+    testRepeatedBindsSkipped();
+    testBindsRestored();
+    testSortedQueueBinds();
+
+    return Test::getResult();
+}
\ No newline at end of file
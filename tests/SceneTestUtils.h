@@ -0,0 +1,49 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "SVE/Engine.h"
+#include "SVE/SceneNode.h"
+
+// Engine is used only by Entity::pauseTime, scene tests don't call it, so Engine isn't linked.
+// Include this header once per test executable.
+SVE::Engine* SVE::Engine::getInstance()
+{
+    return nullptr;
+}
+
+float SVE::Engine::getTime()
+{
+    return 0.0f;
+}
+
+namespace Test
+{
+
+// Entity with fixed bounds which doesn't draw anything
+class BoxEntity : public SVE::Entity
+{
+public:
+    explicit BoxEntity(const SVE::BoundingBox& box)
+        : _box(box)
+    {
+    }
+
+    SVE::BoundingBox getBoundingBox() const override
+    {
+        return _box;
+    }
+
+    void updateUniforms(SVE::FrameUniforms& frameUniforms, const glm::mat4& model) const override
+    {
+    }
+
+    void applyDrawingCommands(const SVE::RecordingContext& context) const override
+    {
+    }
+
+private:
+    SVE::BoundingBox _box;
+};
+
+} // namespace Test
\ No newline at end of file
@@ -0,0 +1,349 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Per frame scene traversals for 1k, 10k and 100k nodes: recursive walk over SceneNode child lists,
+// as engine did before FlatScene, against FlatScene linear scans.
+// Frame has same steps as Engine::renderFrameImpl: frame numbers, bounds, culling, compute entities,
+// draw commands of main pass (three stages) and uniforms, entities only report what they would do.
+// Nodes are 10x10 blocks of unit boxes on grid, camera sees part of it. Fails if walks draw different entities.
+#include "SVE/FlatScene.h"
+#include "tests/SceneTestUtils.h"
+#include "tests/TestUtils.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <cmath>
+
+using namespace SVE;
+
+namespace
+{
+
+constexpr int NodeCounts[] = { 1000, 10000, 100000 };
+constexpr int BlockSize = 10;
+constexpr float NodeSpacing = 2.0f;
+constexpr int Iterations = 20;
+
+const uint32_t MainPassMask = 1u << static_cast<uint32_t>(CommandsType::MainPass);
+
+enum class PassStage : uint8_t
+{
+    Start,
+    Instanced,
+    Deferred
+};
+
+// Work done by entities is replaced by counters
+struct FrameResult
+{
+    size_t computeEntityCount = 0;
+    size_t drawCount = 0;
+    size_t uniformsCount = 0;
+    float transformationSum = 0;
+
+    bool operator==(const FrameResult& other) const
+    {
+        return computeEntityCount == other.computeEntityCount && drawCount == other.drawCount &&
+               uniformsCount == other.uniformsCount && transformationSum == other.transformationSum;
+    }
+};
+
+bool isDrawnInStage(const Entity* entity, PassStage stage)
+{
+    auto isRenderLast = entity->isRenderLast();
+    auto isInstanced = entity->isInstanceRendering();
+    switch (stage)
+    {
+        case PassStage::Start:
+            return !isRenderLast && !isInstanced;
+        case PassStage::Instanced:
+            return !isRenderLast && isInstanced;
+        case PassStage::Deferred:
+            return isRenderLast;
+    }
+    return false;
+}
+
+uint32_t getVisiblePasses(const BoundingBox& box, const std::vector<FrustumList>& passFrustums, uint32_t passMask)
+{
+    if (box.isInfinite)
+        return passMask;
+    if (box.isEmpty())
+        return 0;
+
+    for (auto i = 0u; i < passFrustums.size(); i++)
+    {
+        if (!(passMask & (1u << i)) || passFrustums[i].empty())
+            continue;
+
+        bool isVisible = false;
+        for (const auto& frustum : passFrustums[i])
+        {
+            if (frustum.isVisible(box))
+            {
+                isVisible = true;
+                break;
+            }
+        }
+        if (!isVisible)
+            passMask &= ~(1u << i);
+    }
+    return passMask;
+}
+
+// Recursive walks over child lists as before FlatScene, culling data was kept in SceneNode
+class ListSceneNode : public SceneNode
+{
+public:
+    BoundingBox entitiesBounds;
+    BoundingBox subtreeBounds;
+    uint32_t entitiesPassMask = 0;
+    uint32_t subtreePassMask = 0;
+};
+
+ListSceneNode* getListNode(const std::shared_ptr<SceneNode>& node)
+{
+    return static_cast<ListSceneNode*>(node.get());
+}
+
+void setFrameNumber(const std::shared_ptr<SceneNode>& node, uint64_t frameId)
+{
+    node->setCurrentFrame(frameId);
+    for (auto& child : node->getChildren())
+        setFrameNumber(child, frameId);
+}
+
+BoundingBox updateNodeBounds(const std::shared_ptr<SceneNode>& node)
+{
+    const auto& transform = node->getWorldTransformation();
+
+    BoundingBox entitiesBounds;
+    for (auto& entity : node->getAttachedEntities())
+        entitiesBounds.merge(entity->getBoundingBox().transform(transform));
+
+    auto subtreeBounds = entitiesBounds;
+    for (auto& child : node->getChildren())
+        subtreeBounds.merge(updateNodeBounds(child));
+
+    getListNode(node)->entitiesBounds = entitiesBounds;
+    getListNode(node)->subtreeBounds = subtreeBounds;
+    return subtreeBounds;
+}
+
+void cullNode(const std::shared_ptr<SceneNode>& node, const std::vector<FrustumList>& passFrustums, uint32_t passMask)
+{
+    auto* listNode = getListNode(node);
+    listNode->subtreePassMask = getVisiblePasses(listNode->subtreeBounds, passFrustums, passMask);
+    listNode->entitiesPassMask = getVisiblePasses(listNode->entitiesBounds, passFrustums, listNode->subtreePassMask);
+    if (!listNode->subtreePassMask)
+        return;
+
+    for (auto& child : node->getChildren())
+        cullNode(child, passFrustums, listNode->subtreePassMask);
+}
+
+void createNodeComputeCommands(const std::shared_ptr<SceneNode>& node, FrameResult& result)
+{
+    for (auto& entity : node->getAttachedEntities())
+    {
+        if (entity->isComputeEntity())
+            ++result.computeEntityCount;
+    }
+
+    for (auto& child : node->getChildren())
+        createNodeComputeCommands(child, result);
+}
+
+void createNodeStageDrawCommands(const std::shared_ptr<SceneNode>& node, PassStage stage, FrameResult& result)
+{
+    auto* listNode = getListNode(node);
+    if (!(listNode->subtreePassMask & MainPassMask))
+        return;
+
+    if (listNode->entitiesPassMask & MainPassMask)
+    {
+        for (auto& entity : node->getAttachedEntities())
+        {
+            if (isDrawnInStage(entity.get(), stage))
+                ++result.drawCount;
+        }
+    }
+
+    for (auto& child : node->getChildren())
+        createNodeStageDrawCommands(child, stage, result);
+}
+
+void updateNode(const std::shared_ptr<SceneNode>& node, FrameResult& result)
+{
+    auto* listNode = getListNode(node);
+    if (!listNode->subtreePassMask)
+        return;
+
+    if (listNode->entitiesPassMask && !node->getAttachedEntities().empty())
+    {
+        result.transformationSum += node->getWorldTransformation()[3].x;
+        result.uniformsCount += node->getAttachedEntities().size();
+    }
+
+    for (auto& child : node->getChildren())
+        updateNode(child, result);
+}
+
+FrameResult renderListFrame(const std::shared_ptr<SceneNode>& root, uint64_t frameId,
+                            const std::vector<FrustumList>& passFrustums)
+{
+    FrameResult result;
+    setFrameNumber(root, frameId);
+    updateNodeBounds(root);
+    cullNode(root, passFrustums, MainPassMask);
+    createNodeComputeCommands(root, result);
+    for (auto stage : { PassStage::Start, PassStage::Instanced, PassStage::Deferred })
+        createNodeStageDrawCommands(root, stage, result);
+    updateNode(root, result);
+    return result;
+}
+
+// Linear scans, same as in Engine.cpp
+FrameResult renderFlatFrame(FlatScene& scene, const std::shared_ptr<SceneNode>& root, uint64_t frameId,
+                            const std::vector<FrustumList>& passFrustums)
+{
+    FrameResult result;
+    scene.update(root);
+    for (auto i = 0u; i < scene.getNodeCount(); i++)
+        scene.getNode(i)->setCurrentFrame(frameId);
+
+    scene.updateBounds();
+    scene.cull(passFrustums, MainPassMask);
+
+    for (auto* entity : scene.getAllEntities())
+    {
+        if (entity->isComputeEntity())
+            ++result.computeEntityCount;
+    }
+
+    for (auto stage : { PassStage::Start, PassStage::Instanced, PassStage::Deferred })
+    {
+        for (auto i = 0u; i < scene.getNodeCount();)
+        {
+            if (!scene.isSubtreeVisible(i, MainPassMask))
+            {
+                i = scene.getSubtreeEnd(i);
+                continue;
+            }
+
+            if (scene.isEntitiesVisible(i, MainPassMask))
+            {
+                for (auto* entity : scene.getEntities(i))
+                {
+                    if (isDrawnInStage(entity, stage))
+                        ++result.drawCount;
+                }
+            }
+            ++i;
+        }
+    }
+
+    for (auto i = 0u; i < scene.getNodeCount();)
+    {
+        if (!scene.isSubtreeVisible(i, ~0u))
+        {
+            i = scene.getSubtreeEnd(i);
+            continue;
+        }
+
+        auto entities = scene.getEntities(i);
+        if (scene.isEntitiesVisible(i, ~0u) && entities.begin() != entities.end())
+        {
+            result.transformationSum += scene.getNode(i)->getWorldTransformation()[3].x;
+            result.uniformsCount += entities.end() - entities.begin();
+        }
+        ++i;
+    }
+    return result;
+}
+
+glm::mat4 getTranslation(float x, float z)
+{
+    return glm::translate(glm::mat4(1), glm::vec3(x * NodeSpacing, 0.0f, z * NodeSpacing));
+}
+
+std::shared_ptr<SceneNode> createScene(int nodeCount, size_t& totalNodeCount)
+{
+    BoundingBox box;
+    box.merge(glm::vec3(-0.5f));
+    box.merge(glm::vec3(0.5f));
+
+    auto root = std::make_shared<ListSceneNode>();
+    auto blockCount = nodeCount / (BlockSize * BlockSize);
+    auto gridBlocks = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(blockCount))));
+    totalNodeCount = 1;
+    for (auto block = 0; block < blockCount; ++block)
+    {
+        auto blockNode = std::make_shared<ListSceneNode>();
+        blockNode->setNodeTransformation(getTranslation(static_cast<float>(block % gridBlocks * BlockSize),
+                                                        static_cast<float>(block / gridBlocks * BlockSize)));
+        for (auto x = 0; x < BlockSize; ++x)
+        {
+            for (auto z = 0; z < BlockSize; ++z)
+            {
+                auto node = std::make_shared<ListSceneNode>();
+                node->setNodeTransformation(getTranslation(static_cast<float>(x), static_cast<float>(z)));
+                node->attachEntity(std::make_shared<Test::BoxEntity>(box));
+                blockNode->attachSceneNode(node);
+            }
+        }
+        root->attachSceneNode(blockNode);
+        totalNodeCount += 1 + BlockSize * BlockSize;
+    }
+    return root;
+}
+
+// Camera stands outside grid corner, far plane limits visible part, so draw work is close for all scene sizes
+Frustum createFrustum()
+{
+    auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 120.0f);
+    auto view = glm::lookAt(glm::vec3(-10.0f, 20.0f, -10.0f), glm::vec3(50.0f, 0.0f, 50.0f),
+                            glm::vec3(0.0f, 1.0f, 0.0f));
+    return Frustum(projection * view);
+}
+
+void measureScene(int nodeCount)
+{
+    size_t totalNodeCount = 0;
+    auto root = createScene(nodeCount, totalNodeCount);
+    std::vector<FrustumList> passFrustums { { createFrustum() } };
+
+    using Duration = std::chrono::duration<double, std::milli>;
+    FrameResult listResult;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (auto i = 0; i < Iterations; ++i)
+        listResult = renderListFrame(root, i, passFrustums);
+    Duration listTime = std::chrono::high_resolution_clock::now() - startTime;
+
+    // First update builds arrays, that's done only when scene structure changes
+    FlatScene flatScene;
+    flatScene.update(root);
+    FrameResult flatResult;
+    startTime = std::chrono::high_resolution_clock::now();
+    for (auto i = 0; i < Iterations; ++i)
+        flatResult = renderFlatFrame(flatScene, root, i, passFrustums);
+    Duration flatTime = std::chrono::high_resolution_clock::now() - startTime;
+
+    std::cout << totalNodeCount << " nodes, " << flatResult.drawCount << " drawn: list walk "
+              << listTime.count() / Iterations << " ms, flat scan " << flatTime.count() / Iterations << " ms"
+              << std::endl;
+    TEST_CHECK(flatScene.getNodeCount() == totalNodeCount);
+    TEST_CHECK(flatResult.drawCount > 0);
+    TEST_CHECK(listResult == flatResult);
+}
+
+} // anon namespace
+
+int main()
+{
+    std::cout << "Average of " << Iterations << " frames" << std::endl;
+    for (auto nodeCount : NodeCounts)
+        measureScene(nodeCount);
+
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Long session soak: entities spawn and die every frame for 10 minutes of game time.
+// Material instances kept by entity pointer map with never compacted list against slot map.
+#include "SVE/MaterialInstance.h"
+#include "SVE/SlotMap.h"
+#include "tests/TestUtils.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <new>
+
+namespace
+{
+
+size_t heapSize = 0;
+
+// Size is kept before returned block to track live heap size
+constexpr size_t HeaderSize = 16;
+
+} // anon namespace
+
+void* operator new(size_t size)
+{
+    auto* data = static_cast<char*>(std::malloc(size + HeaderSize));
+    if (!data)
+        throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(data) = size;
+    heapSize += size;
+    return data + HeaderSize;
+}
+
+void operator delete(void* data) noexcept
+{
+    if (!data)
+        return;
+    auto* block = reinterpret_cast<size_t*>(reinterpret_cast<uintptr_t>(data) - HeaderSize);
+    heapSize -= *block;
+    std::free(block);
+}
+
+void operator delete(void* data, size_t) noexcept
+{
+    operator delete(data);
+}
+
+using namespace SVE;
+
+namespace
+{
+
+constexpr size_t Frames = 36000; // 10 minutes at 60 fps
+constexpr size_t SpawnsPerFrame = 2;
+constexpr size_t LifetimeFrames = 60;
+constexpr size_t InstancesPerEntity = 2; // main and depth pass
+constexpr size_t ShaderCount = 3;
+
+struct InstanceData
+{
+    std::vector<uint32_t> uniformLocations;
+};
+
+// Material instances before slot map: looked up by entity pointer, deleted slots are cleared but never reused
+class EntityMapInstances
+{
+public:
+    uint32_t getInstanceForEntity(const void* entity, uint32_t index)
+    {
+        auto instanceIter = _entityInstanceMap.find(entity);
+        if (instanceIter != _entityInstanceMap.end())
+        {
+            if (instanceIter->second.size() > index)
+                return instanceIter->second[index];
+            instanceIter->second.push_back(0);
+        } else {
+            _entityInstanceMap[entity] = std::vector<uint32_t>(1);
+        }
+
+        _instanceData.push_back({ std::vector<uint32_t>(ShaderCount) });
+        _entityInstanceMap[entity][index] = _instanceData.size() - 1;
+        return _instanceData.size() - 1;
+    }
+
+    void deleteInstancesForEntity(const void* entity)
+    {
+        auto instanceIter = _entityInstanceMap.find(entity);
+        if (instanceIter == _entityInstanceMap.end())
+            return;
+        for (auto index : instanceIter->second)
+            _instanceData[index] = {};
+        _entityInstanceMap.erase(instanceIter);
+    }
+
+    InstanceData& get(uint32_t index)
+    {
+        return _instanceData[index];
+    }
+
+    size_t getSlotCount() const
+    {
+        return _instanceData.size();
+    }
+
+private:
+    std::map<const void*, std::vector<uint32_t>> _entityInstanceMap;
+    std::vector<InstanceData> _instanceData;
+};
+
+struct Entity
+{
+    MaterialInstance instances[InstancesPerEntity];
+    size_t deathFrame;
+};
+
+struct SessionResult
+{
+    size_t slotCount;
+    size_t endHeapSize;
+    double milliseconds;
+    size_t checksum;
+};
+
+SessionResult runEntityMapSession()
+{
+    auto startHeapSize = heapSize;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    size_t checksum = 0;
+    EntityMapInstances instances;
+    std::deque<Entity*> entities;
+    for (size_t frame = 0; frame < Frames; ++frame)
+    {
+        while (!entities.empty() && entities.front()->deathFrame == frame)
+        {
+            instances.deleteInstancesForEntity(entities.front());
+            delete entities.front();
+            entities.pop_front();
+        }
+        for (size_t i = 0; i < SpawnsPerFrame; ++i)
+            entities.push_back(new Entity { {}, frame + LifetimeFrames });
+
+        // Every entity is drawn in every pass
+        for (auto* entity : entities)
+        {
+            for (uint32_t pass = 0; pass < InstancesPerEntity; ++pass)
+                checksum += instances.get(instances.getInstanceForEntity(entity, pass)).uniformLocations.size();
+        }
+    }
+    auto duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime);
+    SessionResult result { instances.getSlotCount(), heapSize - startHeapSize, duration.count(), checksum };
+    for (auto* entity : entities)
+        delete entity;
+    return result;
+}
+
+SessionResult runSlotMapSession()
+{
+    auto startHeapSize = heapSize;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    size_t checksum = 0;
+    SlotMap<MaterialInstance, InstanceData> instances;
+    std::deque<Entity> entities;
+    for (size_t frame = 0; frame < Frames; ++frame)
+    {
+        while (!entities.empty() && entities.front().deathFrame == frame)
+        {
+            for (auto instance : entities.front().instances)
+                instances.remove(instance);
+            entities.pop_front();
+        }
+        for (size_t i = 0; i < SpawnsPerFrame; ++i)
+        {
+            Entity entity {};
+            entity.deathFrame = frame + LifetimeFrames;
+            for (auto& instance : entity.instances)
+            {
+                instance = instances.create();
+                instances.get(instance).uniformLocations.resize(ShaderCount);
+            }
+            entities.push_back(entity);
+        }
+
+        for (const auto& entity : entities)
+        {
+            for (auto instance : entity.instances)
+                checksum += instances.get(instance).uniformLocations.size();
+        }
+    }
+    auto duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime);
+    return { instances.getSlotCount(), heapSize - startHeapSize, duration.count(), checksum };
+}
+
+void printResult(const char* name, const SessionResult& result)
+{
+    std::cout << name << ": " << result.slotCount << " slots, " << result.endHeapSize / 1024 << " KiB kept, "
+              << result.milliseconds << " ms (checksum " << result.checksum << ")" << std::endl;
+}
+
+} // anon namespace
+
+int main()
+{
+    std::cout << Frames << " frames, " << SpawnsPerFrame << " spawns per frame, " << LifetimeFrames
+              << " frames lifetime, " << InstancesPerEntity << " instances per entity" << std::endl;
+
+    auto entityMapResult = runEntityMapSession();
+    printResult("Entity pointer map", entityMapResult);
+    auto slotMapResult = runSlotMapSession();
+    printResult("Slot map", slotMapResult);
+
+    const auto maxLiveInstances = SpawnsPerFrame * LifetimeFrames * InstancesPerEntity;
+    TEST_CHECK(slotMapResult.slotCount <= maxLiveInstances);
+    TEST_CHECK(slotMapResult.checksum == entityMapResult.checksum);
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Slot map behind material instances: slots are recycled and stale handles are rejected.
+#include "SVE/MaterialInstance.h"
+#include "SVE/SlotMap.h"
+#include "tests/TestUtils.h"
+#include <algorithm>
+#include <random>
+
+using namespace SVE;
+
+namespace
+{
+
+struct InstanceData
+{
+    std::vector<uint32_t> locations;
+};
+
+// Small generation to reach overflow quickly, handling is the same as for 32-bit generation
+struct SmallHandle
+{
+    uint32_t index = 0;
+    uint8_t generation = 0;
+};
+
+void testStaleHandleRejected()
+{
+    SlotMap<MaterialInstance, InstanceData> instances;
+    auto first = instances.create();
+    auto second = instances.create();
+    instances.get(first).locations.push_back(7);
+    instances.remove(first);
+    TEST_CHECK(!instances.isValid(first));
+
+    // Slot of first instance is reused, old handle has the same index but must not match
+    auto reused = instances.create();
+    TEST_CHECK(reused.index == first.index);
+    TEST_CHECK(reused.generation != first.generation);
+    TEST_CHECK(instances.isValid(reused));
+    TEST_CHECK(!instances.isValid(first));
+    TEST_CHECK(instances.isValid(second));
+
+    // Removing by stale handle doesn't touch new owner of slot
+    instances.remove(first);
+    TEST_CHECK(instances.isValid(reused));
+    TEST_CHECK(instances.getSize() == 2);
+
+    // Item memory is kept for reuse
+    TEST_CHECK(instances.get(reused).locations.capacity() > 0);
+}
+
+void testDefaultHandleInvalid()
+{
+    SlotMap<MaterialInstance, InstanceData> instances;
+    TEST_CHECK(!instances.isValid(MaterialInstance()));
+    auto instance = instances.create();
+    TEST_CHECK(instance.generation != 0);
+    TEST_CHECK(!instances.isValid(MaterialInstance()));
+    TEST_CHECK(!instances.isValid({ instance.index + 1, instance.generation }));
+    instances.remove(MaterialInstance());
+    TEST_CHECK(instances.isValid(instance));
+}
+
+void testGenerationWrapSkipsZero()
+{
+    SlotMap<SmallHandle, InstanceData> instances;
+    auto handle = instances.create();
+    auto firstHandle = handle;
+    for (auto i = 0; i < 600; ++i)
+    {
+        TEST_CHECK(handle.generation != 0);
+        TEST_CHECK(handle.index == firstHandle.index);
+        instances.remove(handle);
+        TEST_CHECK(!instances.isValid(handle));
+        handle = instances.create();
+    }
+    // Generation goes 1..255 and then starts from 1 again, zero is never handed out
+    TEST_CHECK(handle.generation == 600 % 255 + 1);
+    TEST_CHECK(instances.getSlotCount() == 1);
+}
+
+void testSpawnDestroyStress()
+{
+    // Projectiles and effects: live instances stay bounded, so slot count must not grow with spawn count
+    constexpr size_t SpawnCount = 100000;
+    constexpr size_t MaxLiveCount = 300;
+
+    std::mt19937 random(3);
+    SlotMap<MaterialInstance, InstanceData> instances;
+    std::vector<MaterialInstance> liveInstances;
+    size_t peakLiveCount = 0;
+    size_t staleHandleCount = 0;
+    for (size_t spawned = 0; spawned < SpawnCount; ++spawned)
+    {
+        if (liveInstances.size() == MaxLiveCount || (!liveInstances.empty() && random() % 2 == 0))
+        {
+            auto position = random() % liveInstances.size();
+            auto instance = liveInstances[position];
+            liveInstances[position] = liveInstances.back();
+            liveInstances.pop_back();
+            instances.remove(instance);
+            if (instances.isValid(instance))
+                ++staleHandleCount;
+        }
+
+        auto instance = instances.create();
+        instances.get(instance).locations.resize(4);
+        liveInstances.push_back(instance);
+        peakLiveCount = std::max(peakLiveCount, liveInstances.size());
+    }
+
+    TEST_CHECK(staleHandleCount == 0);
+    TEST_CHECK(instances.getSize() == liveInstances.size());
+    TEST_CHECK(instances.getSlotCount() == peakLiveCount);
+    TEST_CHECK(std::all_of(liveInstances.begin(), liveInstances.end(), [&instances](MaterialInstance instance)
+    {
+        return instances.isValid(instance);
+    }));
+
+    for (auto instance : liveInstances)
+        instances.remove(instance);
+    TEST_CHECK(instances.getSize() == 0);
+    TEST_CHECK(instances.getSlotCount() == peakLiveCount);
+}
+
+} // anon namespace
+
+int main()
+{
+    testStaleHandleRejected();
+    testDefaultHandleInvalid();
+    testGenerationWrapSkipsZero();
+    testSpawnDestroyStress();
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <iostream>
+
+// Minimal checks for headless test executables, test fails with non-zero exit code
+namespace Test
+{
+
+inline int& getFailureCount()
+{
+    static int failureCount = 0;
+    return failureCount;
+}
+
+inline bool check(bool condition, const char* expression, const char* file, int line)
+{
+    if (!condition)
+    {
+        ++getFailureCount();
+        std::cout << file << ":" << line << ": check failed: " << expression << std::endl;
+    }
+    return condition;
+}
+
+inline int getResult()
+{
+    if (getFailureCount() > 0)
+    {
+        std::cout << getFailureCount() << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
+
+} // namespace Test
+
+#define TEST_CHECK(condition) Test::check((condition), #condition, __FILE__, __LINE__)
\ No newline at end of file
@@ -0,0 +1,268 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Compiled uniform layouts against per-uniform byte vectors for every shader resource passed in arguments.
+// Both paths must write the same bytes for every uniform.
+#include "SVE/ShaderLoader.h"
+#include "SVE/UniformLayout.h"
+#include "SVE/VulkanException.h"
+#include "tests/TestUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace SVE;
+
+namespace
+{
+
+constexpr size_t Iterations = 20000;
+
+template <typename T>
+std::vector<char> toBytes(const T* values, size_t count)
+{
+    const char* byteData = reinterpret_cast<const char*>(values);
+    return std::vector<char>(byteData, byteData + sizeof(T) * count);
+}
+
+template <typename T>
+std::vector<char> toBytes(const T& value)
+{
+    return toBytes(&value, 1);
+}
+
+// Serialisation used before UniformLayout: new byte vector for every uniform, arrays are packed by current size
+std::vector<char> getUniformDataByType(const UniformData& data, UniformType type)
+{
+    switch (type)
+    {
+        case UniformType::ModelMatrix:
+            return toBytes(data.object.model);
+        case UniformType::ViewMatrix:
+            return toBytes(data.pass.view);
+        case UniformType::ProjectionMatrix:
+            return toBytes(data.pass.projection);
+        case UniformType::InverseModelMatrix:
+            return toBytes(glm::inverse(data.object.model));
+        case UniformType::ModelViewProjectionMatrix:
+            return toBytes(data.pass.projection * data.pass.view * data.object.model);
+        case UniformType::ViewProjectionMatrix:
+            return toBytes(data.pass.projection * data.pass.view);
+        case UniformType::ViewProjectionMatrixList:
+            return toBytes(data.pass.viewProjectionList.data(), data.pass.viewProjectionList.size());
+        case UniformType::ViewProjectionMatrixSize:
+        {
+            uint32_t vpListSize[4] = { static_cast<uint32_t>(data.pass.viewProjectionList.size()) };
+            return toBytes(vpListSize, 4);
+        }
+        case UniformType::CameraPosition:
+            return toBytes(data.pass.cameraPos);
+        case UniformType::MaterialInfo:
+            return toBytes(data.object.materialInfo);
+        case UniformType::LightInfo:
+            return toBytes(data.pass.lightInfo);
+        case UniformType::LightDirectional:
+            return toBytes(data.pass.dirLight);
+        case UniformType::LightPoint:
+            return toBytes(data.pass.shadowPointLightList.data(), data.pass.shadowPointLightList.size());
+        case UniformType::LightPointSimple:
+            return toBytes(data.pass.pointLightList.data(), data.pass.pointLightList.size());
+        case UniformType::LightLine:
+            return toBytes(data.pass.lineLightList.data(), data.pass.lineLightList.size());
+        case UniformType::LightSpot:
+            return toBytes(data.pass.spotLight);
+        case UniformType::LightPointViewProjectionList:
+            return toBytes(data.pass.lightPointViewProjectionList.data(), data.pass.lightPointViewProjectionList.size());
+        case UniformType::LightDirectViewProjectionList:
+            return toBytes(data.pass.lightDirectViewProjectionList.data(), data.pass.lightDirectViewProjectionList.size());
+        case UniformType::LightDirectViewProjection:
+            return toBytes(data.pass.lightDirectViewProjectionList.front());
+        case UniformType::BoneMatrices:
+            return toBytes(data.object.bones.data, data.object.bones.size);
+        case UniformType::ClipPlane:
+            return toBytes(data.pass.clipPlane);
+        case UniformType::ParticleEmitter:
+            return toBytes(data.object.particleEmitter);
+        case UniformType::ParticleAffector:
+            return toBytes(data.object.particleAffector);
+        case UniformType::ParticleCount:
+            return toBytes(data.object.particleCount);
+        case UniformType::SpritesheetSize:
+            return toBytes(data.object.spritesheetSize);
+        case UniformType::ImageSize:
+            return toBytes(data.pass.imageSize);
+        case UniformType::TextInfo:
+            return toBytes(data.object.textInfo);
+        case UniformType::GlyphInfoList:
+            return toBytes(data.object.glyphList.data, data.object.glyphList.size);
+        case UniformType::TextSymbolList:
+            return toBytes(data.object.textSymbolList.data, data.object.textSymbolList.size);
+        case UniformType::OverlayInfo:
+            return toBytes(data.object.overlayInfo);
+        case UniformType::CustomFloat:
+            return toBytes(data.object.customFloat);
+        case UniformType::CustomVec4:
+            return toBytes(data.object.customVec4);
+        case UniformType::CustomMat4:
+            return toBytes(data.object.customMat4);
+        case UniformType::Time:
+            return toBytes(data.object.time);
+        case UniformType::DeltaTime:
+            return toBytes(data.object.deltaTime);
+    }
+    return {};
+}
+
+template <typename T>
+void fillPattern(T& value, uint8_t pattern)
+{
+    memset(static_cast<void*>(&value), pattern, sizeof(T));
+}
+
+template <typename T>
+void fillList(std::vector<T>& list, size_t count, uint8_t pattern)
+{
+    list.resize(count);
+    for (auto& value : list)
+        fillPattern(value, pattern++);
+}
+
+// Uniform sources of typical frame, lists are as long as shader allows.
+// Matrices are scaled by powers of two, so products and inverse are exact in both paths.
+struct UniformSources
+{
+    explicit UniformSources(const ShaderSettings& shaderSettings)
+    {
+        pass.view = glm::mat4(1.0f);
+        pass.projection = glm::mat4(0.5f);
+        pass.viewProjection = pass.projection * pass.view;
+        fillList(pass.viewProjectionList, std::min(shaderSettings.maxViewProjectionMatrices, 6u), 1);
+        fillList(pass.lightDirectViewProjectionList, std::max(1u, std::min(shaderSettings.maxCascadeLightSize, 5u)), 2);
+        fillList(pass.lightPointViewProjectionList, std::min(shaderSettings.maxLightSize, 6u), 3);
+        fillList(pass.shadowPointLightList, std::min(shaderSettings.maxShadowPointLightSize, 4u), 4);
+        fillList(pass.pointLightList, std::min(shaderSettings.maxPointLightSize, 10u), 5);
+        fillList(pass.lineLightList, std::min(shaderSettings.maxLineLightSize, 10u), 6);
+        fillPattern(pass.cameraPos, 7);
+        fillPattern(pass.clipPlane, 8);
+        fillPattern(pass.dirLight, 9);
+        fillPattern(pass.spotLight, 10);
+        fillPattern(pass.lightInfo, 11);
+        fillPattern(pass.imageSize, 12);
+
+        object.model = glm::mat4(2.0f);
+        fillPattern(object.materialInfo, 13);
+        fillPattern(object.particleEmitter, 14);
+        fillPattern(object.particleAffector, 15);
+        fillPattern(object.textInfo, 16);
+        fillPattern(object.overlayInfo, 17);
+        fillPattern(object.customMat4, 18);
+        fillPattern(object.customVec4, 19);
+        object.customFloat = 0.25f;
+        object.time = 1.5f;
+        object.deltaTime = 0.0625f;
+        object.particleCount = 100;
+
+        fillList(bones, std::min(shaderSettings.maxBonesSize, 64u), 20);
+        fillList(glyphs, std::min(shaderSettings.maxGlyphCount, 100u), 21);
+        fillList(textSymbols, std::min(shaderSettings.maxTextSize, 50u), 22);
+        object.bones = { bones.data(), bones.size() };
+        object.glyphList = { glyphs.data(), glyphs.size() };
+        object.textSymbolList = { textSymbols.data(), textSymbols.size() };
+    }
+
+    PassUniformData pass;
+    ObjectUniformData object;
+    std::vector<glm::mat4> bones;
+    std::vector<GlyphInfo> glyphs;
+    std::vector<TextSymbolInfo> textSymbols;
+};
+
+bool isSameData(const UniformLayout& layout, const UniformData& data)
+{
+    std::vector<char> mappedData(layout.getSize());
+    layout.write(data, mappedData.data());
+    for (const auto& entry : layout.getEntries())
+    {
+        auto uniformBytes = getUniformDataByType(data, entry.uniformType);
+        if (uniformBytes.size() > entry.size ||
+            memcmp(mappedData.data() + entry.offset, uniformBytes.data(), uniformBytes.size()) != 0)
+            return false;
+    }
+    return true;
+}
+
+double measureOldPath(const ShaderSettings& shaderSettings, const UniformData& data, std::vector<char>& mappedData)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < Iterations; ++i)
+    {
+        char* mappedUniformData = mappedData.data();
+        for (const auto& r : shaderSettings.uniformList)
+        {
+            auto uniformBytes = getUniformDataByType(data, r.uniformType);
+            memcpy(mappedUniformData, uniformBytes.data(), uniformBytes.size());
+            mappedUniformData += uniformBytes.size();
+        }
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+double measureLayout(const UniformLayout& layout, const UniformData& data, std::vector<char>& mappedData)
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < Iterations; ++i)
+    {
+        // Every draw is a new object block in frame, so inverse model is not cached between iterations
+        data.object.isInverseModelReady = false;
+        layout.write(data, mappedData.data());
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+} // anon namespace
+
+int main(int argc, char** argv)
+{
+    double oldTotal = 0;
+    double layoutTotal = 0;
+    for (auto i = 1; i < argc; ++i)
+    {
+        std::ifstream file(argv[i], std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        TEST_CHECK(!content.empty());
+
+        ShaderSettings shaderSettings;
+        try
+        {
+            shaderSettings = loadShaderSettings(content);
+        }
+        catch (const VulkanException& exception)
+        {
+            Test::check(false, exception.what(), argv[i], 0);
+            continue;
+        }
+        if (shaderSettings.uniformList.empty())
+            continue;
+
+        UniformLayout layout(shaderSettings);
+        UniformSources sources(shaderSettings);
+        UniformData data { sources.pass, sources.object };
+        if (!Test::check(isSameData(layout, data), "isSameData(layout, data)", argv[i], 0))
+            continue;
+
+        std::vector<char> mappedData(layout.getSize());
+        auto oldTime = measureOldPath(shaderSettings, data, mappedData) / Iterations;
+        auto layoutTime = measureLayout(layout, data, mappedData) / Iterations;
+        oldTotal += oldTime;
+        layoutTotal += layoutTime;
+        std::cout << shaderSettings.name << ": " << shaderSettings.uniformList.size() << " uniforms, "
+                  << layout.getSize() << " bytes, byte vectors " << oldTime << " ns, layout " << layoutTime << " ns"
+                  << std::endl;
+    }
+
+    std::cout << "All shaders: byte vectors " << oldTotal << " ns, layout " << layoutTotal << " ns" << std::endl;
+    return Test::getResult();
+}
\ No newline at end of file
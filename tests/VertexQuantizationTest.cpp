@@ -0,0 +1,124 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Compact vertex format error against tolerance for synthetic meshes and for every mesh resource passed in arguments.
+// Meshes with compact vertex format must be inside tolerance, error of other meshes is only printed.
+#include "SVE/BakedMesh.h"
+#include "SVE/MeshImporter.h"
+#include "SVE/VertexQuantization.h"
+#include "SVE/VulkanException.h"
+#include "tests/TestUtils.h"
+#include <rapidjson/document.h>
+#include <fstream>
+#include <iterator>
+
+using namespace SVE;
+
+namespace rj = rapidjson;
+
+namespace
+{
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file)
+        throw VulkanException("Can't open file " + path);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+std::string getDirectory(const std::string& path)
+{
+    auto separatorPos = path.find_last_of("/\\");
+    return separatorPos == std::string::npos ? std::string() : path.substr(0, separatorPos + 1);
+}
+
+MeshSettings createQuad(glm::vec3 offset, float size)
+{
+    MeshSettings meshSettings;
+    meshSettings.name = "quad";
+    meshSettings.vertexPosData = { offset, offset + glm::vec3(size, 0, 0), offset + glm::vec3(size, size, 0), offset + glm::vec3(0, size, 0) };
+    meshSettings.vertexColorData = { {1, 1, 1}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1} };
+    meshSettings.vertexTexData = { {0, 0}, {1, 0}, {1, 1}, {0, 1} };
+    meshSettings.vertexNormalData.assign(4, {0, 0, 1});
+    meshSettings.vertexBinormalData.assign(4, {0, 1, 0});
+    meshSettings.vertexTangentData.assign(4, {1, 0, 0});
+    meshSettings.indexData = { 0, 1, 2, 2, 3, 0 };
+    return meshSettings;
+}
+
+void testSyntheticMeshes()
+{
+    TEST_CHECK(isQuantizationErrorAcceptable(getCompactFormatError(createQuad(glm::vec3(-0.5f), 1.0f))));
+
+    // Half floats lose precision far from origin
+    TEST_CHECK(!isQuantizationErrorAcceptable(getCompactFormatError(createQuad(glm::vec3(1000.0f), 1.0f))));
+
+    auto brightMesh = createQuad(glm::vec3(0.0f), 1.0f);
+    brightMesh.vertexColorData[0] = glm::vec3(1.5f);
+    TEST_CHECK(!isQuantizationErrorAcceptable(getCompactFormatError(brightMesh)));
+
+    auto tiledMesh = createQuad(glm::vec3(0.0f), 1.0f);
+    tiledMesh.vertexTexData[2] = glm::vec2(100.3f);
+    TEST_CHECK(!isQuantizationErrorAcceptable(getCompactFormatError(tiledMesh)));
+
+    // Directions are clamped to [-1, 1], so they must be normalized
+    auto scaledMesh = createQuad(glm::vec3(0.0f), 1.0f);
+    scaledMesh.vertexNormalData[1] = glm::vec3(0.0f, 0.0f, 1.2f);
+    TEST_CHECK(!isQuantizationErrorAcceptable(getCompactFormatError(scaledMesh)));
+}
+
+// Model is taken the same way as by resource manager: baked mesh as is, other files are imported
+void testMeshFile(const std::string& meshFilePath)
+{
+    rj::Document document;
+    document.Parse(readFile(meshFilePath).c_str());
+    if (!TEST_CHECK(!document.HasParseError() && document.IsObject()))
+        return;
+
+    MeshLoadSettings meshLoadSettings {};
+    meshLoadSettings.name = document["name"].GetString();
+    meshLoadSettings.filename = getDirectory(meshFilePath) + document["filename"].GetString();
+    if (document.HasMember("switchYZ"))
+        meshLoadSettings.switchYZ = document["switchYZ"].GetBool();
+    if (document.HasMember("scale"))
+    {
+        const auto& scale = document["scale"].GetArray();
+        meshLoadSettings.scale = {scale[0].GetFloat(), scale[1].GetFloat(), scale[2].GetFloat()};
+    }
+    auto isCompact = document.HasMember("vertexFormat") && std::string(document["vertexFormat"].GetString()) == "Compact";
+
+    FileView fileView(readFile(meshLoadSettings.filename));
+    auto meshSettings = isBakedMesh(fileView) ? loadBakedMesh(fileView) : importMesh(meshLoadSettings, fileView);
+    auto error = getCompactFormatError(meshSettings);
+    auto isAcceptable = isQuantizationErrorAcceptable(error);
+
+    std::cout << meshLoadSettings.name << (isCompact ? " (compact)" : "") << ": position " << error.position
+              << ", texCoord " << error.texCoord << ", color " << error.color << ", direction " << error.direction
+              << (isAcceptable ? "" : " - over tolerance") << std::endl;
+    if (isCompact)
+        TEST_CHECK(isAcceptable);
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    testSyntheticMeshes();
+
+    for (auto i = 1; i < argc; i++)
+    {
+        try
+        {
+            testMeshFile(argv[i]);
+        }
+        catch (const std::exception& ex)
+        {
+            std::cout << argv[i] << ": " << ex.what() << std::endl;
+            TEST_CHECK(!"mesh can't be loaded");
+        }
+    }
+
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// World transformations of all nodes per frame: cached SceneNode::getWorldTransformation with dirty flags
+// propagated to children against full top-down recomputation from node transformations.
+// Scenes are deep chain and wide two level tree, frames have nothing moved, one leaf moved or root moved.
+// Fails if cached transformations differ from recomputed ones.
+#include "SVE/SceneNode.h"
+#include "tests/SceneTestUtils.h"
+#include "tests/TestUtils.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+
+using namespace SVE;
+
+namespace
+{
+
+constexpr int ChainDepth = 1000;
+constexpr int TreeWidth = 100;
+constexpr int Iterations = 100;
+
+enum class MoveType
+{
+    None,
+    Leaf,
+    Root
+};
+
+struct Scene
+{
+    std::shared_ptr<SceneNode> root;
+    std::shared_ptr<SceneNode> leaf;
+    // Parents go before children, as in FlatScene
+    std::vector<SceneNode*> nodes;
+};
+
+glm::mat4 getTranslation(float offset)
+{
+    return glm::translate(glm::mat4(1), glm::vec3(offset, 1.0f, 0.0f));
+}
+
+void collectNodes(SceneNode* node, std::vector<SceneNode*>& nodes)
+{
+    nodes.push_back(node);
+    for (auto& child : node->getChildren())
+        collectNodes(child.get(), nodes);
+}
+
+Scene createChain()
+{
+    Scene scene;
+    scene.root = std::make_shared<SceneNode>();
+    scene.leaf = scene.root;
+    for (auto i = 1; i < ChainDepth; ++i)
+    {
+        auto node = std::make_shared<SceneNode>();
+        node->setNodeTransformation(getTranslation(0.1f));
+        scene.leaf->attachSceneNode(node);
+        scene.leaf = node;
+    }
+    collectNodes(scene.root.get(), scene.nodes);
+    return scene;
+}
+
+Scene createTree()
+{
+    Scene scene;
+    scene.root = std::make_shared<SceneNode>();
+    for (auto i = 0; i < TreeWidth; ++i)
+    {
+        auto groupNode = std::make_shared<SceneNode>();
+        groupNode->setNodeTransformation(getTranslation(static_cast<float>(i)));
+        for (auto j = 0; j < TreeWidth; ++j)
+        {
+            scene.leaf = std::make_shared<SceneNode>();
+            scene.leaf->setNodeTransformation(getTranslation(static_cast<float>(j)));
+            groupNode->attachSceneNode(scene.leaf);
+        }
+        scene.root->attachSceneNode(groupNode);
+    }
+    collectNodes(scene.root.get(), scene.nodes);
+    return scene;
+}
+
+void moveNode(const Scene& scene, MoveType moveType, int frame)
+{
+    auto transformation = getTranslation(static_cast<float>(frame % 2));
+    if (moveType == MoveType::Leaf)
+        scene.leaf->setNodeTransformation(transformation);
+    else if (moveType == MoveType::Root)
+        scene.root->setNodeTransformation(transformation);
+}
+
+void recomputeWorld(const SceneNode* node, const glm::mat4& parentTransformation, std::vector<glm::mat4>& transformations)
+{
+    transformations.push_back(parentTransformation * node->getNodeTransformation());
+    auto world = transformations.back();
+    for (auto& child : node->getChildren())
+        recomputeWorld(child.get(), world, transformations);
+}
+
+void measureScene(const char* name, const Scene& scene, MoveType moveType)
+{
+    using Duration = std::chrono::duration<double, std::micro>;
+    std::vector<glm::mat4> cachedTransformations(scene.nodes.size());
+    Duration cachedTime {};
+    for (auto i = 0; i < Iterations; ++i)
+    {
+        // Dirty flags are propagated when node moves, so it's timed as well
+        auto startTime = std::chrono::high_resolution_clock::now();
+        moveNode(scene, moveType, i);
+        for (auto j = 0u; j < scene.nodes.size(); ++j)
+            cachedTransformations[j] = scene.nodes[j]->getWorldTransformation();
+        cachedTime += std::chrono::high_resolution_clock::now() - startTime;
+    }
+
+    std::vector<glm::mat4> recomputedTransformations;
+    recomputedTransformations.reserve(scene.nodes.size());
+    Duration recomputedTime {};
+    for (auto i = 0; i < Iterations; ++i)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        moveNode(scene, moveType, i);
+        recomputedTransformations.clear();
+        recomputeWorld(scene.root.get(), glm::mat4(1), recomputedTransformations);
+        recomputedTime += std::chrono::high_resolution_clock::now() - startTime;
+    }
+
+    std::cout << name << ": cached " << cachedTime.count() / Iterations << " us, full recomputation "
+              << recomputedTime.count() / Iterations << " us" << std::endl;
+    TEST_CHECK(cachedTransformations == recomputedTransformations);
+}
+
+} // anon namespace
+
+int main()
+{
+    std::cout << "Average of " << Iterations << " frames" << std::endl;
+
+    auto chain = createChain();
+    std::cout << "Chain of " << chain.nodes.size() << " nodes" << std::endl;
+    measureScene("  Nothing moved", chain, MoveType::None);
+    measureScene("  Leaf moved", chain, MoveType::Leaf);
+    measureScene("  Root moved", chain, MoveType::Root);
+
+    auto tree = createTree();
+    std::cout << "Tree of " << tree.nodes.size() << " nodes" << std::endl;
+    measureScene("  Nothing moved", tree, MoveType::None);
+    measureScene("  Leaf moved", tree, MoveType::Leaf);
+    measureScene("  Root moved", tree, MoveType::Root);
+
+    return Test::getResult();
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Packs resource folders to single archive loaded through PackedFS.
+// Usage: AssetPacker [--lz4] resources.pack folder [folder ...]
+// Files keep paths they have relative to current directory, so "resources" folder packed from
+// game directory is found at the same paths as with DesktopFS.
+// With --lz4 (requires SVE_PACK_LZ4 build) entries are compressed if it makes them smaller,
+// except formats which are already compressed or are read in place (KTX2 levels are staged directly).
+#include "SVE/PackedArchive.h"
+#include "SVE/VulkanException.h"
+
+#include <cppfs/fs.h>
+#include <cppfs/FileHandle.h>
+#include <cppfs/FileIterator.h>
+#include <cppfs/FilePath.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+
+namespace
+{
+
+// Big files start at page boundary, so their mapped pages aren't shared with other entries
+constexpr size_t PageAlignedFileSize = 64 * 1024;
+constexpr uint32_t PageAlignment = 4096;
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file)
+        throw SVE::VulkanException("Can't open file " + path);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+void writeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw SVE::VulkanException("Can't write file " + path);
+    file.write(data.data(), data.size());
+}
+
+bool isCompressible(const std::string& path)
+{
+    static const std::set<std::string> storedExtensions { ".png", ".jpg", ".ogg", ".ktx2" };
+    return storedExtensions.find(cppfs::FilePath(path).extension()) == storedExtensions.end();
+}
+
+void addFolder(const std::string& folder, SVE::PackedCompression compression, std::vector<SVE::PackedFile>& files)
+{
+    auto dirHandle = cppfs::fs::open(folder);
+    if (!dirHandle.isDirectory())
+        throw SVE::VulkanException("Folder " + folder + " doesn't exist");
+
+    cppfs::FilePath dirPath(dirHandle.path());
+    for (cppfs::FileIterator it = dirHandle.begin(); it != dirHandle.end(); ++it)
+    {
+        auto path = dirPath.resolve(*it).fullPath();
+        auto handle = cppfs::fs::open(path);
+        if (handle.isDirectory())
+        {
+            addFolder(path, compression, files);
+            continue;
+        }
+
+        SVE::PackedFile file;
+        file.path = path;
+        file.data = readFile(path);
+        file.alignment = file.data.size() >= PageAlignedFileSize ? PageAlignment : SVE::PackedArchiveAlignment;
+        file.compression = isCompressible(path) ? compression : SVE::PackedCompression::None;
+        files.push_back(std::move(file));
+    }
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    auto argIndex = 1;
+    auto compression = SVE::PackedCompression::None;
+    if (argIndex < argc && std::string(argv[argIndex]) == "--lz4")
+    {
+        compression = SVE::PackedCompression::LZ4;
+        ++argIndex;
+    }
+
+    if (argc - argIndex < 2)
+    {
+        std::cout << "Usage: AssetPacker [--lz4] resources.pack folder [folder ...]" << std::endl;
+        return 1;
+    }
+    if (!SVE::isCompressionSupported(compression))
+    {
+        std::cout << "LZ4 compression isn't supported, AssetPacker should be built with SVE_PACK_LZ4" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        std::string archivePath = argv[argIndex++];
+        std::vector<SVE::PackedFile> files;
+        for (; argIndex < argc; argIndex++)
+            addFolder(argv[argIndex], compression, files);
+
+        size_t filesSize = 0;
+        for (auto& file : files)
+            filesSize += file.data.size();
+        auto fileCount = files.size();
+
+        auto archiveData = SVE::writePackedArchive(std::move(files));
+        writeFile(archivePath, archiveData);
+
+        std::cout << archivePath << ": " << fileCount << " files, " << filesSize / 1024 << " KB packed to "
+                  << archiveData.size() / 1024 << " KB" << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cout << "Can't pack resources: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Bakes models referenced by .mesh files, so they are loaded without Assimp import.
+// Usage: MeshBaker [--compact] file.mesh [file.mesh ...]
+// Model is imported with settings from mesh file and saved next to it with .bmesh extension.
+// Mesh file is updated to reference baked model, original model is kept in "sourceFilename"
+// and is used when mesh is baked again.
+// With --compact vertex format of mesh file is set to compact if quantization error is inside tolerance,
+// otherwise full format is kept.
+#include "SVE/BakedMesh.h"
+#include "SVE/MeshImporter.h"
+#include "SVE/VertexQuantization.h"
+#include "SVE/VulkanException.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace rj = rapidjson;
+
+namespace
+{
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file)
+        throw SVE::VulkanException("Can't open file " + path);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+void writeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw SVE::VulkanException("Can't write file " + path);
+    file.write(data.data(), data.size());
+}
+
+std::string getDirectory(const std::string& path)
+{
+    auto separatorPos = path.find_last_of("/\\");
+    return separatorPos == std::string::npos ? std::string() : path.substr(0, separatorPos + 1);
+}
+
+std::string replaceExtension(const std::string& path, const std::string& extension)
+{
+    auto dotPos = path.find_last_of('.');
+    auto separatorPos = path.find_last_of("/\\");
+    if (dotPos == std::string::npos || (separatorPos != std::string::npos && dotPos < separatorPos))
+        return path + extension;
+    return path.substr(0, dotPos) + extension;
+}
+
+// Returns true if mesh was switched to compact format
+bool selectVertexFormat(rj::Document& document, const SVE::MeshSettings& meshSettings)
+{
+    auto error = SVE::getCompactFormatError(meshSettings);
+    auto isCompact = SVE::isQuantizationErrorAcceptable(error);
+    std::cout << "Quantization error: position " << error.position
+              << ", texCoord " << error.texCoord << ", color " << error.color
+              << ", direction " << error.direction << (isCompact ? "" : " (over tolerance)") << std::endl;
+
+    auto& allocator = document.GetAllocator();
+    auto vertexFormat = isCompact ? "Compact" : "Full";
+    if (document.HasMember("vertexFormat"))
+        document["vertexFormat"].SetString(vertexFormat, allocator);
+    else
+        document.AddMember("vertexFormat", rj::Value(vertexFormat, allocator), allocator);
+    return isCompact;
+}
+
+void bakeMeshFile(const std::string& meshFilePath, bool selectCompactFormat)
+{
+    rj::Document document;
+    document.Parse(readFile(meshFilePath).c_str());
+    if (document.HasParseError() || !document.IsObject())
+        throw SVE::VulkanException("Can't parse mesh file " + meshFilePath);
+
+    // Model paths are relative to mesh file
+    std::string sourceFilename = document.HasMember("sourceFilename")
+                                 ? document["sourceFilename"].GetString()
+                                 : document["filename"].GetString();
+    auto directory = getDirectory(meshFilePath);
+
+    SVE::MeshLoadSettings meshLoadSettings {};
+    meshLoadSettings.name = document["name"].GetString();
+    meshLoadSettings.filename = directory + sourceFilename;
+    if (document.HasMember("switchYZ"))
+        meshLoadSettings.switchYZ = document["switchYZ"].GetBool();
+    if (document.HasMember("scale"))
+    {
+        const auto& scale = document["scale"].GetArray();
+        meshLoadSettings.scale = {scale[0].GetFloat(), scale[1].GetFloat(), scale[2].GetFloat()};
+    }
+
+    auto meshSettings = SVE::importMesh(meshLoadSettings, SVE::FileView(readFile(meshLoadSettings.filename)));
+    auto bakedFilename = replaceExtension(sourceFilename, ".bmesh");
+    auto bakedData = SVE::bakeMesh(meshSettings);
+    writeFile(directory + bakedFilename, bakedData);
+
+    // Switch mesh file to baked model, scale and axes are already applied but are kept for rebaking
+    auto& allocator = document.GetAllocator();
+    auto isCompact = selectCompactFormat && selectVertexFormat(document, meshSettings);
+    if (!document.HasMember("sourceFilename"))
+        document.AddMember("sourceFilename", rj::Value(sourceFilename.c_str(), allocator), allocator);
+    document["filename"].SetString(bakedFilename.c_str(), allocator);
+
+    rj::StringBuffer buffer;
+    rj::PrettyWriter<rj::StringBuffer> writer(buffer);
+    document.Accept(writer);
+    writeFile(meshFilePath, buffer.GetString());
+
+    std::cout << meshFilePath << ": " << meshSettings.vertexPosData.size() << " vertices, "
+              << meshSettings.indexData.size() << " indices, baked to " << bakedFilename
+              << " (" << bakedData.size() / 1024 << " KB)" << (isCompact ? ", compact format" : "") << std::endl;
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    auto firstFile = 1;
+    auto selectCompactFormat = argc > 1 && std::string(argv[1]) == "--compact";
+    if (selectCompactFormat)
+        ++firstFile;
+
+    if (argc <= firstFile)
+    {
+        std::cout << "Usage: MeshBaker [--compact] file.mesh [file.mesh ...]" << std::endl;
+        return 1;
+    }
+
+    auto result = 0;
+    for (auto i = firstFile; i < argc; i++)
+    {
+        try
+        {
+            bakeMeshFile(argv[i], selectCompactFormat);
+        }
+        catch (const std::exception& ex)
+        {
+            std::cout << "Can't bake " << argv[i] << ": " << ex.what() << std::endl;
+            result = 1;
+        }
+    }
+
+    return result;
+}
\ No newline at end of file
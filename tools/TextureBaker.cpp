@@ -0,0 +1,133 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Bakes full mip chains of textures, so they are uploaded without decoding and mip generation.
+// Usage: TextureBaker image.png [image.png ...]
+// Image is saved next to the source with .ktx2 extension as uncompressed RGBA8 levels.
+// Block compressed variants ("name.bc7.ktx2", "name.etc2.ktx2", "name.astc.ktx2") are produced
+// by external encoders (toktx, astcenc, compressonator) and are preferred by loader if GPU supports them.
+#define STB_IMAGE_IMPLEMENTATION
+#include "SVE/KtxTexture.h"
+#include "SVE/VulkanException.h"
+
+#include <stb/stb_image.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file)
+        throw SVE::VulkanException("Can't open file " + path);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+void writeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw SVE::VulkanException("Can't write file " + path);
+    file.write(data.data(), data.size());
+}
+
+std::string replaceExtension(const std::string& path, const std::string& extension)
+{
+    auto dotPos = path.find_last_of('.');
+    auto separatorPos = path.find_last_of("/\\");
+    if (dotPos == std::string::npos || (separatorPos != std::string::npos && dotPos < separatorPos))
+        return path + extension;
+    return path.substr(0, dotPos) + extension;
+}
+
+// 2x2 box filter, odd edge of source is clamped
+std::vector<uint8_t> downsampleLevel(const std::vector<uint8_t>& source, uint32_t width, uint32_t height)
+{
+    auto levelWidth = std::max(width / 2, 1u);
+    auto levelHeight = std::max(height / 2, 1u);
+    std::vector<uint8_t> level(levelWidth * levelHeight * 4);
+
+    for (auto y = 0u; y < levelHeight; y++)
+    {
+        auto y0 = std::min(y * 2, height - 1);
+        auto y1 = std::min(y * 2 + 1, height - 1);
+        for (auto x = 0u; x < levelWidth; x++)
+        {
+            auto x0 = std::min(x * 2, width - 1);
+            auto x1 = std::min(x * 2 + 1, width - 1);
+            for (auto channel = 0u; channel < 4; channel++)
+            {
+                auto sum = source[(y0 * width + x0) * 4 + channel] + source[(y0 * width + x1) * 4 + channel] +
+                           source[(y1 * width + x0) * 4 + channel] + source[(y1 * width + x1) * 4 + channel];
+                level[(y * levelWidth + x) * 4 + channel] = static_cast<uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+
+    return level;
+}
+
+void bakeTextureFile(const std::string& imagePath)
+{
+    int texWidth, texHeight, texChannels;
+    auto fileContent = readFile(imagePath);
+    stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(fileContent.data()), fileContent.size(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+    if (!pixels)
+        throw SVE::VulkanException("Can't decode image " + imagePath);
+
+    auto width = static_cast<uint32_t>(texWidth);
+    auto height = static_cast<uint32_t>(texHeight);
+    std::vector<std::vector<uint8_t>> levels;
+    levels.emplace_back(pixels, pixels + width * height * 4);
+    stbi_image_free(pixels);
+
+    // Same chain length as generated on GPU: down to 1x1
+    while (width > 1 || height > 1)
+    {
+        levels.push_back(downsampleLevel(levels.back(), width, height));
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+
+    auto bakedPath = replaceExtension(imagePath, ".ktx2");
+    auto bakedData = SVE::writeKtxTexture(static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), levels);
+
+    // Check that loader accepts the file
+    SVE::readKtxTexture(SVE::FileView(bakedData));
+    writeFile(bakedPath, bakedData);
+
+    std::cout << imagePath << ": " << texWidth << "x" << texHeight << ", " << levels.size()
+              << " levels, baked to " << bakedPath << " (" << bakedData.size() / 1024 << " KB)" << std::endl;
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: TextureBaker image.png [image.png ...]" << std::endl;
+        return 1;
+    }
+
+    auto result = 0;
+    for (auto i = 1; i < argc; i++)
+    {
+        try
+        {
+            bakeTextureFile(argv[i]);
+        }
+        catch (const std::exception& ex)
+        {
+            std::cout << "Can't bake " << argv[i] << ": " << ex.what() << std::endl;
+            result = 1;
+        }
+    }
+
+    return result;
+}
\ No newline at end of file